@@ -39,6 +39,7 @@ static const char *TAG = "can";
 #include "can.h"
 #include "canlog.h"
 #include "canplay.h"
+#include "can_ring.h"
 #include "dbc.h"
 #include "dbc_app.h"
 #include <algorithm>
@@ -46,6 +47,8 @@ static const char *TAG = "can";
 #include <string.h>
 #include <iomanip>
 #include <cstdio>
+#include <sys/time.h>
+#include <esp_timer.h>
 #include "ovms_config.h"
 #include "ovms_command.h"
 #include "metrics_standard.h"
@@ -388,6 +391,9 @@ void can_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
     writer->printf("Wdg Timer: %20" PRId32 " sec(s)\n",monotonictime-sbus->m_watchdog_timer);
     }
   writer->printf("Err Resets:%20d\n",sbus->m_status.error_resets);
+
+  sbus->m_latency_callback.Print(writer, "Rx latency to callback");
+  sbus->m_latency_vehicle.Print(writer, "Rx latency to vehicle");
   }
 
 void can_explain_flags(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
@@ -442,6 +448,12 @@ void can_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, con
     }
   }
 
+void can_readers(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  MyCan.GetRing()->Status(writer);
+  MyCan.ListenerStatus(writer);
+  }
+
 void can_clearstatus(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   const char* bus = cmd->GetParent()->GetName();
@@ -509,6 +521,8 @@ void can_set_register(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
 
 canfilter::canfilter()
   {
+  m_tables = NULL;
+  m_readers = 0;
   }
 
 canfilter::~canfilter()
@@ -518,11 +532,87 @@ canfilter::~canfilter()
 
 void canfilter::ClearFilters()
   {
+  OvmsMutexLock lock(&m_mutex);
   for (CAN_filter_t* filter : m_filters)
     {
     delete filter;
     }
   m_filters.clear();
+  Compile();
+  }
+
+void canfilter::FreeTables(tables_t* tables)
+  {
+  if (tables->stdmap)
+    free(tables->stdmap);
+  delete tables;
+  }
+
+/**
+ * Compile: rebuild the lookup tables from the filter list.
+ * Called on every filter change with m_mutex locked. The new tables are
+ * built aside and published by a pointer swap, so IsFiltered() in the CAN
+ * task needs no lock. The old tables are freed when no IsFiltered() call
+ * is running anymore.
+ */
+void canfilter::Compile()
+  {
+  tables_t* tables = NULL;
+  if (!m_filters.empty())
+    {
+    tables = new tables_t;
+    for (CAN_filter_t* filter : m_filters)
+      tables->list.push_back(*filter);
+    tables->stdmap = (uint8_t*) ExternalRamMalloc((CAN_MAXBUSES+1) * CANFILTER_STDMAP_BYTES);
+    if (tables->stdmap)
+      memset(tables->stdmap, 0, (CAN_MAXBUSES+1) * CANFILTER_STDMAP_BYTES);
+
+    for (int buskey = 0; buskey <= CAN_MAXBUSES; buskey++)
+      {
+      CAN_filter_ranges_t& ranges = tables->ranges[buskey];
+      uint8_t* map = tables->stdmap ? (tables->stdmap + buskey * CANFILTER_STDMAP_BYTES) : NULL;
+      for (CAN_filter_t* filter : m_filters)
+        {
+        if ((filter->bus)&&(filter->bus != buskey)) continue;
+        if (map && filter->id_from < CANFILTER_STDMAP_IDS)
+          {
+          uint32_t id_to = std::min(filter->id_to, (uint32_t)CANFILTER_STDMAP_IDS-1);
+          for (uint32_t id = filter->id_from; id <= id_to; id++)
+            map[id >> 3] |= (1 << (id & 7));
+          }
+        if (filter->id_to >= CANFILTER_STDMAP_IDS)
+          {
+          CAN_filter_range_t range;
+          range.id_from = std::max(filter->id_from, (uint32_t)CANFILTER_STDMAP_IDS);
+          range.id_to = filter->id_to;
+          ranges.push_back(range);
+          }
+        }
+
+      // Sort & merge overlapping and adjacent ranges:
+      std::sort(ranges.begin(), ranges.end(),
+        [](const CAN_filter_range_t& a, const CAN_filter_range_t& b) { return a.id_from < b.id_from; });
+      size_t n = 0;
+      for (size_t k = 0; k < ranges.size(); k++)
+        {
+        if (n > 0 && (ranges[n-1].id_to == UINT32_MAX || ranges[k].id_from <= ranges[n-1].id_to + 1))
+          ranges[n-1].id_to = std::max(ranges[n-1].id_to, ranges[k].id_to);
+        else
+          ranges[n++] = ranges[k];
+        }
+      ranges.resize(n);
+      ranges.shrink_to_fit();
+      }
+    }
+
+  // Publish, then wait for readers still using the old tables:
+  tables_t* old = m_tables.exchange(tables);
+  if (old)
+    {
+    while (m_readers.load() > 0)
+      vTaskDelay(1);
+    FreeTables(old);
+    }
   }
 
 /** Add a filter to the list (what is allowed).
@@ -547,7 +637,9 @@ bool canfilter::AddFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
   f->bus = bus;
   f->id_from = id_from;
   f->id_to = id_to;
+  OvmsMutexLock lock(&m_mutex);
   m_filters.push_back(f);
+  Compile();
   return true;
   }
 /** Add a filter string.
@@ -613,6 +705,7 @@ bool canfilter::RemoveFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
   {
   if (bus >= (uint8_t)'0')
     bus -= '0';
+  OvmsMutexLock lock(&m_mutex);
   for (CAN_filter_list_t::iterator it = m_filters.begin(); it != m_filters.end(); ++it)
     {
     CAN_filter_t* filter = *it;
@@ -622,6 +715,7 @@ bool canfilter::RemoveFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
       {
       delete filter;
       m_filters.erase(it);
+      Compile();
       return true;
       }
     }
@@ -630,25 +724,65 @@ bool canfilter::RemoveFilter(uint8_t bus, uint32_t id_from, uint32_t id_to)
 
 bool canfilter::IsFiltered(const CAN_frame_t* p_frame)
   {
-  if (m_filters.size() == 0) return true;
-  if (! p_frame) return false;
+  // Lock free, see Compile():
+  m_readers++;
+  const tables_t* tables = m_tables.load();
+  bool result;
 
-  uint8_t buskey = 0;
-  if (p_frame->origin)
-    buskey = (p_frame->origin->m_busnumber + 1);
+  if (!tables)
+    result = true;
+  else if (!p_frame)
+    result = false;
+  else
+    {
+    uint8_t buskey = 0;
+    if (p_frame->origin)
+      buskey = (p_frame->origin->m_busnumber + 1);
+    uint32_t id = p_frame->MsgID;
 
-  for (CAN_filter_t* filter : m_filters)
+    if (buskey > CAN_MAXBUSES || (id < CANFILTER_STDMAP_IDS && !tables->stdmap))
+      {
+      result = IsFilteredList(tables, buskey, id);
+      }
+    else if (id < CANFILTER_STDMAP_IDS)
+      {
+      result = (tables->stdmap[buskey * CANFILTER_STDMAP_BYTES + (id >> 3)] & (1 << (id & 7))) != 0;
+      }
+    else
+      {
+      // Binary search for the last range starting at or below id:
+      const CAN_filter_ranges_t& ranges = tables->ranges[buskey];
+      size_t lo = 0, hi = ranges.size();
+      while (lo < hi)
+        {
+        size_t mid = (lo + hi) / 2;
+        if (ranges[mid].id_from <= id)
+          lo = mid + 1;
+        else
+          hi = mid;
+        }
+      result = (lo > 0 && id <= ranges[lo-1].id_to);
+      }
+    }
+
+  m_readers--;
+  return result;
+  }
+
+bool canfilter::IsFilteredList(const tables_t* tables, uint8_t buskey, uint32_t id)
+  {
+  for (const CAN_filter_t& filter : tables->list)
     {
-    if ((filter->bus)&&(filter->bus != buskey)) continue;
-    if ((p_frame->MsgID >= filter->id_from) && (p_frame->MsgID <= filter->id_to))
+    if ((filter.bus)&&(filter.bus != buskey)) continue;
+    if ((id >= filter.id_from) && (id <= filter.id_to))
       return true;
     }
-
   return false;
   }
 
 bool canfilter::IsFiltered(canbus* bus)
   {
+  OvmsMutexLock lock(&m_mutex);
   if (m_filters.size() == 0) return true;
   if (bus == NULL) return true;
 
@@ -666,6 +800,7 @@ std::string canfilter::Info()
   {
   std::ostringstream buf;
 
+  OvmsMutexLock lock(&m_mutex);
   for (CAN_filter_t* filter : m_filters)
     {
     if (filter->bus > 0) buf << std::setfill(' ') << std::dec << char('0'+ filter->bus) << ':';
@@ -708,6 +843,60 @@ const char* GetCanLogTypeName(CAN_log_type_t type)
   return CAN_log_type_names[type];
   }
 
+/**
+ * GetCanFrameTime: get the wall time of a frame
+ *  Converts the frame timestamp (driver receive / TX done) to wall time,
+ *  frames without timestamp get the current time.
+ */
+void GetCanFrameTime(const CAN_frame_t* frame, struct timeval* tv)
+  {
+  gettimeofday(tv, NULL);
+  if (frame->timestamp == 0)
+    return;
+  int64_t age = esp_timer_get_time() - frame->timestamp;
+  if (age <= 0)
+    return;
+  int64_t us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec - age;
+  tv->tv_sec = us / 1000000;
+  tv->tv_usec = us % 1000000;
+  }
+
+////////////////////////////////////////////////////////////////////////
+// CAN_latency_t: RX latency histogram
+////////////////////////////////////////////////////////////////////////
+
+void CAN_latency_t::Add(const CAN_frame_t* frame)
+  {
+  int64_t latency = esp_timer_get_time() - frame->timestamp;
+  if (latency < 0 || frame->timestamp == 0)
+    return;
+  uint32_t us = (latency > UINT32_MAX) ? UINT32_MAX : latency;
+  int bucket = 0;
+  while (bucket < CAN_LATENCY_BUCKETS-1 && us >= (32U << bucket))
+    bucket++;
+  count[bucket]++;
+  total++;
+  sum += us;
+  if (us > max) max = us;
+  }
+
+void CAN_latency_t::Print(OvmsWriter* writer, const char* title) const
+  {
+  if (total == 0)
+    return;
+  writer->printf("\n%s: %" PRIu32 " frames, avg %" PRIu32 " us, max %" PRIu32 " us\n",
+    title, total, (uint32_t)(sum / total), max);
+  for (int i = 0; i < CAN_LATENCY_BUCKETS; i++)
+    {
+    if (count[i] == 0)
+      continue;
+    if (i < CAN_LATENCY_BUCKETS-1)
+      writer->printf("  < %6u us: %10" PRIu32 " %5.1f%%\n", 32U << i, count[i], (float)count[i] * 100 / total);
+    else
+      writer->printf("  >=%6u us: %10" PRIu32 " %5.1f%%\n", 32U << (i-1), count[i], (float)count[i] * 100 / total);
+    }
+  }
+
 void can::LogFrame(canbus* bus, CAN_log_type_t type, const CAN_frame_t* frame)
   {
   OvmsRecMutexLock lock(&m_loggermap_mutex);
@@ -906,6 +1095,7 @@ uint32_t can::AddPlayer(canplay* player, int filterc, const char* const* filterv
   OvmsMutexLock lock(&m_playermap_mutex);
   uint32_t id = m_player_id++;
   m_playermap[id] = player;
+  player->Start();
 
   return id;
   }
@@ -935,8 +1125,8 @@ bool can::RemovePlayer(uint32_t id)
   auto k = m_playermap.find(id);
   if (k != m_playermap.end())
     {
+    k->second->Stop();
     k->second->Close();
-    vTaskDelay(pdMS_TO_TICKS(100)); // give logger task time to finish
     delete k->second;
     m_playermap.erase(k);
     return true;
@@ -950,8 +1140,8 @@ void can::RemovePlayers()
 
   for (canplay_map_t::iterator it=m_playermap.begin(); it!=m_playermap.end();)
     {
+    it->second->Stop();
     it->second->Close();
-    vTaskDelay(pdMS_TO_TICKS(100)); // give logger task time to finish
     delete it->second;
     it = m_playermap.erase(it);
     }
@@ -1109,6 +1299,10 @@ can::can()
     }
 
   cmd_can->RegisterCommand("list", "List CAN buses", can_list);
+  cmd_can->RegisterCommand("readers", "Show CAN frame ring readers", can_readers);
+
+  m_ring = new CanRing();
+  m_ring->Init(CONFIG_OVMS_HW_CAN_RING_SIZE);
 
   m_rxqueue = xQueueCreate(CONFIG_OVMS_HW_CAN_RX_QUEUE_SIZE,sizeof(CAN_queue_msg_t));
   xTaskCreatePinnedToCore(CAN_rxtask, "OVMS CanRx", 2*2048, (void*)this, 23, &m_rxtask, CORE(0));
@@ -1142,31 +1336,47 @@ void can::IncomingFrame(CAN_frame_t* p_frame)
   p_frame->origin->m_status.packets_rx++;
   p_frame->origin->m_watchdog_timer = monotonictime;
 
-  ExecuteCallbacks(p_frame, false, true /*ignored*/);
-  p_frame->origin->LogFrame(CAN_LogFrame_RX, p_frame);
-  NotifyListeners(p_frame, false);
+  // Frames injected by players & tools have no driver timestamp.
+  // Stamp a copy, callers may reuse their frame for the next injection:
+  CAN_frame_t frame = *p_frame;
+  if (frame.timestamp)
+    frame.origin->m_latency_callback.Add(&frame);
+  else
+    frame.timestamp = esp_timer_get_time();
+
+  ExecuteCallbacks(&frame, false, true /*ignored*/);
+  frame.origin->LogFrame(CAN_LogFrame_RX, &frame);
+  NotifyListeners(&frame, false);
   }
 
 /**
  * RegisterListener: register an asynchronous CAN frame processor
  * 
- * This is the standard mechanism to hook into the CAN framework. All RX frames
- * and all TX results for all CAN buses get copied to all listener queues as
- * CAN_frame_t objects, to be processed asynchronously by application tasks.
+ * All RX frames and all TX results for all CAN buses get copied to all
+ * listener queues as CAN_frame_t objects, to be processed asynchronously by
+ * application tasks.
+ * 
+ * New code should use a CanRingReader instead (see can_ring.h): frames are
+ * stored once in the MyCan frame ring and read by each consumer at its own
+ * cursor, with overruns counted per reader. Queue listeners are kept for
+ * compatibility.
  * 
  * Queue creation template:
  *   my_rx_queue = xQueueCreate(CONFIG_OVMS_HW_CAN_RX_QUEUE_SIZE, sizeof(CAN_frame_t));
  * 
  * You're free to use whatever queue size is appropriate for your task, but be
- * aware the system will silently drop queue overflows. The vehicle poller
- * takes care of registering a queue and provides an additional filter API.
+ * aware the system will drop queue overflows. Drops are counted per queue and
+ * shown by "can readers". The vehicle poller takes care of receiving frames
+ * and provides an additional filter API.
  * 
  * If you need to process incoming frames or TX results as fast as possible,
  * register a synchronous CAN callback -- see below.
  */
 void can::RegisterListener(QueueHandle_t queue, bool txfeedback /*=false*/)
   {
-  m_listeners[queue] = txfeedback;
+  CanListener_t& listener = m_listeners[queue];
+  listener.txfeedback = txfeedback;
+  listener.dropped = 0;
   }
 
 void can::DeregisterListener(QueueHandle_t queue)
@@ -1178,10 +1388,29 @@ void can::DeregisterListener(QueueHandle_t queue)
 
 void can::NotifyListeners(const CAN_frame_t* frame, bool tx)
   {
+  // The ring is only fed while readers are attached, a reader starts
+  //  reading at the next frame written anyway:
+  if (m_ring->HasReaders())
+    m_ring->Write(frame, tx);
   for (CanListenerMap_t::iterator it = m_listeners.begin(); it != m_listeners.end(); ++it)
     {
-    if (!tx || (tx && it->second))
-      xQueueSend(it->first,frame,0);
+    if (!tx || (tx && it->second.txfeedback))
+      {
+      if (xQueueSend(it->first,frame,0) != pdTRUE)
+        it->second.dropped++;
+      }
+    }
+  }
+
+void can::ListenerStatus(OvmsWriter* writer)
+  {
+  if (m_listeners.empty())
+    return;
+  writer->printf("Listener queues: %d\n", (int)m_listeners.size());
+  for (CanListenerMap_t::iterator it = m_listeners.begin(); it != m_listeners.end(); ++it)
+    {
+    writer->printf("  Queue %p: waiting %d, dropped %" PRIu32 "\n",
+      it->first, (int)uxQueueMessagesWaiting(it->first), it->second.dropped);
     }
   }
 
@@ -1336,6 +1565,8 @@ esp_err_t canbus::WriteReg( uint8_t reg, uint8_t value )
 void canbus::ClearStatus()
   {
   memset(&m_status, 0, sizeof(m_status));
+  memset(&m_latency_callback, 0, sizeof(m_latency_callback));
+  memset(&m_latency_vehicle, 0, sizeof(m_latency_vehicle));
   m_status_chksum = 0;
   m_watchdog_timer = monotonictime;
   }
@@ -1402,6 +1633,8 @@ bool canbus::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesRe
 
 void canbus::TxCallback(CAN_frame_t* p_frame, bool success)
   {
+  if (!p_frame->timestamp)
+    p_frame->timestamp = esp_timer_get_time();
   if (success)
     {
     m_status.packets_tx++;
@@ -1433,6 +1666,7 @@ esp_err_t canbus::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0
   {
   m_tx_frame = *p_frame; // save a local copy of this frame to be used later in txcallback
   m_tx_frame.origin = this;
+  m_tx_frame.timestamp = 0; // set by the driver on TX done
   return ESP_OK;
   }
 
@@ -1442,16 +1676,19 @@ esp_err_t canbus::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0
  */
 esp_err_t canbus::QueueWrite(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0*/)
   {
-  if (xQueueSend(m_txqueue, p_frame, maxqueuewait) == pdTRUE)
+  // The caller's timestamp is not ours, clear it on the queued copy:
+  CAN_frame_t frame = *p_frame;
+  frame.timestamp = 0;
+  if (xQueueSend(m_txqueue, &frame, maxqueuewait) == pdTRUE)
     {
     m_status.txbuf_delay++;
-    LogFrame(CAN_LogFrame_TX_Queue, p_frame);
+    LogFrame(CAN_LogFrame_TX_Queue, &frame);
     return ESP_QUEUED;
     }
   else
     {
     m_status.txbuf_overflow++;
-    LogFrame(CAN_LogFrame_TX_Fail, p_frame);
+    LogFrame(CAN_LogFrame_TX_Fail, &frame);
     return ESP_FAIL;
     }
   }
@@ -40,8 +40,10 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include <stdint.h>
+#include <atomic>
 #include <functional>
 #include <list>
+#include <vector>
 #include "pcp.h"
 #include <esp_err.h>
 #include "ovms_events.h"
@@ -135,6 +137,8 @@ struct CAN_frame_t
     uint32_t  u32[2];                   // Payload u32 access (Att: little endian!)
     uint64_t  u64;                      // Payload u64 access (Att: little endian!)
     } data;
+  int64_t     timestamp;                // RX: driver receive time, TX result: TX done time
+                                        //  [us, esp_timer_get_time()], 0 = not set
 
   esp_err_t Write(canbus* bus=NULL, TickType_t maxqueuewait=0);  // bus: NULL=origin
   };
@@ -158,6 +162,21 @@ typedef struct
   uint32_t error_time;              // monotonictime of last error state detection
   } CAN_status_t;
 
+// CAN frame latency histogram (time since driver receive)
+#define CAN_LATENCY_BUCKETS     12    // bucket n: < 32<<n us, last: all above
+
+class OvmsWriter;
+typedef struct CAN_latency_t
+  {
+  uint32_t count[CAN_LATENCY_BUCKETS];
+  uint32_t total;
+  uint32_t max;                     // [us]
+  uint64_t sum;                     // [us]
+
+  void Add(const CAN_frame_t* frame);
+  void Print(OvmsWriter* writer, const char* title) const;
+  } CAN_latency_t;
+
 // CAN error states
 typedef enum
   {
@@ -212,11 +231,26 @@ typedef struct
 
 typedef std::list<CAN_filter_t*> CAN_filter_list_t;
 
+// Compiled filter: per bus key (0=no origin, 1..CAN_MAXBUSES) a bitmap
+// for IDs below CANFILTER_STDMAP_IDS and sorted merged ranges above.
+#define CANFILTER_STDMAP_IDS    2048
+#define CANFILTER_STDMAP_BYTES  (CANFILTER_STDMAP_IDS/8)
+
+typedef struct
+  {
+  uint32_t id_from;
+  uint32_t id_to;
+  } CAN_filter_range_t;
+
+typedef std::vector<CAN_filter_range_t> CAN_filter_ranges_t;
+
 class canfilter
   {
   public:
     canfilter();
     virtual ~canfilter();
+    canfilter(const canfilter&) = delete;             // owns m_tables
+    canfilter& operator=(const canfilter&) = delete;
 
   public:
     void ClearFilters();
@@ -230,11 +264,27 @@ class canfilter
     std::string Info();
     bool HasFilters()
       {
+      OvmsMutexLock lock(&m_mutex);
       return !m_filters.empty();
       }
 
   protected:
+    typedef struct
+      {
+      uint8_t* stdmap;                              // [CAN_MAXBUSES+1][CANFILTER_STDMAP_BYTES], NULL = use list
+      CAN_filter_ranges_t ranges[CAN_MAXBUSES+1];
+      std::vector<CAN_filter_t> list;               // Copy of the filter list for bus keys/IDs not mapped
+      } tables_t;
+
+    void Compile();
+    static void FreeTables(tables_t* tables);
+    static bool IsFilteredList(const tables_t* tables, uint8_t buskey, uint32_t id);
+
+  protected:
+    OvmsMutex m_mutex;                              // Protects m_filters & serializes Compile()
     CAN_filter_list_t m_filters;
+    std::atomic<tables_t*> m_tables;                // Compiled lookup tables, NULL = no filters
+    std::atomic<int> m_readers;                     // IsFiltered() calls using m_tables
   };
 
 ////////////////////////////////////////////////////////////////////////
@@ -280,6 +330,7 @@ typedef struct
   } CAN_log_message_t;
 
 extern const char* GetCanLogTypeName(CAN_log_type_t type);
+extern void GetCanFrameTime(const CAN_frame_t* frame, struct timeval* tv);
 
 ////////////////////////////////////////////////////////////////////////
 // canbus - the definition of a CAN bus
@@ -334,6 +385,8 @@ class canbus : public pcp, public InternalRamAllocated
     CAN_speed_t m_speed;
     CAN_mode_t m_mode;
     CAN_status_t m_status;
+    CAN_latency_t m_latency_callback;   // RX latency driver → CAN task (callbacks)
+    CAN_latency_t m_latency_vehicle;    // RX latency driver → vehicle task
     CAN_frame_t m_tx_frame;       // saved copy of last TX frame to be used in txcallback
     uint32_t m_status_chksum;
     uint32_t m_watchdog_timer;
@@ -351,7 +404,13 @@ class canbus : public pcp, public InternalRamAllocated
 // can - the CAN system controller
 ////////////////////////////////////////////////////////////////////////
 
-typedef std::map<QueueHandle_t, bool> CanListenerMap_t;
+struct CanListener_t
+  {
+  bool txfeedback;                    // Also send TX results
+  uint32_t dropped;                   // Frames lost by queue overflows
+  };
+typedef std::map<QueueHandle_t, CanListener_t> CanListenerMap_t;
+class CanRing;
 
 
 class CanFrameCallbackEntry
@@ -385,9 +444,11 @@ class can : public InternalRamAllocated
     QueueHandle_t m_rxqueue;
 
   public:
+    CanRing* GetRing() { return m_ring; }
     void RegisterListener(QueueHandle_t queue, bool txfeedback=false);
     void DeregisterListener(QueueHandle_t queue);
     void NotifyListeners(const CAN_frame_t* frame, bool tx);
+    void ListenerStatus(OvmsWriter* writer);
 
   public:
     void RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback=false);
@@ -431,7 +492,8 @@ class can : public InternalRamAllocated
 
   private:
     canbus* m_buslist[CAN_MAXBUSES];
-    CanListenerMap_t m_listeners;
+    CanRing* m_ring;                  // Frame broadcast ring for CanRingReaders
+    CanListenerMap_t m_listeners;     // Legacy listener queues
     CanFrameCallbackList_t m_rxcallbacks;
     CanFrameCallbackList_t m_txcallbacks;
     TaskHandle_t m_rxtask;            // Task to handle reception
@@ -0,0 +1,287 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN broadcast ring
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "can-ring";
+
+#include <stdlib.h>
+#include <new>
+#include "ovms_malloc.h"
+#include "ovms_command.h"
+#include "can_ring.h"
+
+// Slot sequence marker while a frame is being written:
+#define CANRING_BUSY            0x80000000
+
+
+CanRing::CanRing()
+  : m_entries(NULL), m_size(0), m_seq(0), m_readercnt(0), m_waking(0)
+  {
+  for (int i = 0; i < CANRING_MAXREADERS; i++)
+    m_readers[i].store(NULL, std::memory_order_relaxed);
+  }
+
+CanRing::~CanRing()
+  {
+  if (m_entries)
+    free(m_entries);
+  }
+
+/**
+ * Init: allocate the ring
+ *  The size is rounded up to the next power of 2. Must be called before
+ *  the first Write(), the ring can't be resized while in use.
+ */
+bool CanRing::Init(size_t size)
+  {
+  if (m_entries)
+    return true;
+  uint32_t sz = 64;
+  while (sz < size) sz <<= 1;
+  entry_t* entries = (entry_t*) ExternalRamMalloc(sz * sizeof(entry_t));
+  if (!entries)
+    {
+    ESP_LOGE(TAG, "Init: cannot allocate %" PRIu32 " slots", sz);
+    return false;
+    }
+  for (uint32_t i = 0; i < sz; i++)
+    new (&entries[i].seq) std::atomic<uint32_t>(CANRING_BUSY);
+  m_size = sz;
+  m_entries = entries;
+  return true;
+  }
+
+/**
+ * Write: add a frame to the ring & wake up waiting readers
+ */
+void CanRing::Write(const CAN_frame_t* frame, bool tx)
+  {
+  if (!m_entries)
+    return;
+
+  // Take the slot from readers:
+  uint32_t seq = m_seq.fetch_add(1, std::memory_order_acq_rel);
+  entry_t& e = m_entries[seq & (m_size - 1)];
+  e.seq.store(seq ^ CANRING_BUSY, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  e.tx = tx;
+  e.frame = *frame;
+
+  // Commit:
+  e.seq.store(seq, std::memory_order_release);
+  WakeReaders();
+  }
+
+void CanRing::WakeReaders()
+  {
+  m_waking.fetch_add(1, std::memory_order_acq_rel);
+  // Pairs with the fence in CanRingReader::Read() (commit vs. waiting flag):
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for (int i = 0; i < CANRING_MAXREADERS; i++)
+    {
+    CanRingReader* reader = m_readers[i].load(std::memory_order_acquire);
+    if (reader && reader->m_waiting.load(std::memory_order_relaxed)
+        && reader->m_waiting.exchange(false, std::memory_order_acq_rel))
+      xSemaphoreGive(reader->m_wakeup);
+    }
+  m_waking.fetch_sub(1, std::memory_order_release);
+  }
+
+/**
+ * Attach: set cursor to the next frame written
+ */
+void CanRing::Attach(CanRingCursor& cursor)
+  {
+  cursor.seq = GetNextSeq();
+  cursor.lost = 0;
+  }
+
+/**
+ * Read: copy the next frame at the cursor
+ *  Returns false if no frame is available (yet).
+ */
+bool CanRing::Read(CanRingCursor& cursor, CAN_frame_t* frame, bool* tx /*=NULL*/)
+  {
+  if (!m_entries)
+    return false;
+  for (;;)
+    {
+    uint32_t next = GetNextSeq();
+    if (cursor.seq == next)
+      return false;
+    if (next - cursor.seq > m_size)
+      {
+      // Overrun: skip to the oldest frame likely to still be there
+      uint32_t skip = next - cursor.seq - m_size + m_size / 8;
+      cursor.lost += skip;
+      cursor.seq += skip;
+      }
+
+    entry_t& e = m_entries[cursor.seq & (m_size - 1)];
+    if (e.seq.load(std::memory_order_acquire) != cursor.seq)
+      {
+      // Frame still being written, or slot already reused:
+      if (GetNextSeq() - cursor.seq > m_size)
+        continue;
+      return false;
+      }
+
+    *frame = e.frame;
+    bool t = e.tx;
+
+    // Check the slot hasn't been reused while copying:
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (e.seq.load(std::memory_order_relaxed) != cursor.seq)
+      {
+      cursor.lost++;
+      cursor.seq++;
+      continue;
+      }
+
+    if (tx) *tx = t;
+    cursor.seq++;
+    return true;
+    }
+  }
+
+bool CanRing::AddReader(CanRingReader* reader)
+  {
+  for (int i = 0; i < CANRING_MAXREADERS; i++)
+    {
+    CanRingReader* expected = NULL;
+    if (m_readers[i].compare_exchange_strong(expected, reader, std::memory_order_acq_rel))
+      {
+      m_readercnt.fetch_add(1, std::memory_order_relaxed);
+      return true;
+      }
+    }
+  ESP_LOGE(TAG, "AddReader: no free slot for reader '%s'", reader->m_name);
+  return false;
+  }
+
+/**
+ * RemoveReader: detach a reader
+ *  Waits for producers possibly still accessing the reader.
+ */
+void CanRing::RemoveReader(CanRingReader* reader)
+  {
+  for (int i = 0; i < CANRING_MAXREADERS; i++)
+    {
+    CanRingReader* expected = reader;
+    if (m_readers[i].compare_exchange_strong(expected, NULL, std::memory_order_acq_rel))
+      m_readercnt.fetch_sub(1, std::memory_order_relaxed);
+    }
+  while (m_waking.load(std::memory_order_acquire) > 0)
+    vTaskDelay(1);
+  }
+
+void CanRing::Status(OvmsWriter* writer)
+  {
+  writer->printf("Frame ring: %" PRIu32 " slots, %" PRIu32 " frames written\n", m_size, GetNextSeq());
+  for (int i = 0; i < CANRING_MAXREADERS; i++)
+    {
+    CanRingReader* reader = m_readers[i].load(std::memory_order_acquire);
+    if (!reader)
+      continue;
+    writer->printf("  Reader %-12s: read %" PRIu32 ", lost %" PRIu32 ", backlog %" PRIu32 "\n",
+      reader->GetName(), reader->GetReadCount(), reader->GetLostCount(), reader->GetBacklog());
+    }
+  }
+
+
+CanRingReader::CanRingReader(const char* name, bool txfeedback /*=false*/, CanRing* ring /*=NULL*/)
+  : m_waiting(false)
+  {
+  m_ring = ring ? ring : MyCan.GetRing();
+  m_name = name;
+  m_txfeedback = txfeedback;
+  m_readcnt = 0;
+  m_wakeup = xSemaphoreCreateBinary();
+  m_ring->Attach(m_cursor);
+  m_attached = m_ring->AddReader(this);
+  }
+
+CanRingReader::~CanRingReader()
+  {
+  if (m_attached)
+    m_ring->RemoveReader(this);
+  vSemaphoreDelete(m_wakeup);
+  }
+
+/**
+ * Read: get the next frame, wait up to maxwait ticks
+ *  May return false before maxwait has passed (Wakeup() or a skipped TX
+ *  result), callers should just loop. A reader that could not be attached
+ *  (no free slot) blocks for maxwait and returns false.
+ */
+bool CanRingReader::Read(CAN_frame_t* frame, TickType_t maxwait /*=portMAX_DELAY*/, bool* tx /*=NULL*/)
+  {
+  if (!m_attached)
+    {
+    // No frames will come, but don't let reader loops spin:
+    xSemaphoreTake(m_wakeup, maxwait);
+    return false;
+    }
+
+  bool istx = false;
+  bool armed = false;
+  for (;;)
+    {
+    while (m_ring->Read(m_cursor, frame, &istx))
+      {
+      if (istx && !m_txfeedback)
+        continue;
+      if (armed)
+        m_waiting.store(false, std::memory_order_relaxed);
+      m_readcnt++;
+      if (tx) *tx = istx;
+      return true;
+      }
+    if (maxwait == 0)
+      return false;
+    if (!armed)
+      {
+      // Flag waiting, then check again so a frame committed meanwhile isn't missed:
+      m_waiting.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      armed = true;
+      continue;
+      }
+    bool woken = (xSemaphoreTake(m_wakeup, maxwait) == pdTRUE);
+    m_waiting.store(false, std::memory_order_relaxed);
+    if (!woken)
+      return false;
+    maxwait = 0;  // read what's there, don't block again
+    armed = false;
+    }
+  }
+
+/**
+ * Wakeup: let a blocked Read() return
+ */
+void CanRingReader::Wakeup()
+  {
+  xSemaphoreGive(m_wakeup);
+  }
@@ -0,0 +1,146 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN broadcast ring
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CAN_RING_H__
+#define __CAN_RING_H__
+
+#include <stdint.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "can.h"
+
+#define CANRING_MAXREADERS      8         // Max readers attached to a ring
+
+/**
+ * CanRing: fixed size multi producer / multi reader broadcast ring of frames
+ *
+ *  Every RX frame (and TX result) is stored once, each reader follows the
+ *  ring at its own cursor (sequence number). This replaces copying each
+ *  frame into every listener queue.
+ *
+ *  Producers (normally only the CAN rx task, but frames may also be
+ *  injected by players & tools) reserve a sequence number atomically and
+ *  commit the slot by storing its sequence number last. Readers copy the
+ *  frame, then check the slot hasn't been reused meanwhile. Producers never
+ *  wait for readers: a reader falling behind by more than the ring size
+ *  loses the oldest frames, the loss is counted per reader.
+ *
+ *  Readers block on their own binary semaphore. A producer only gives it
+ *  if the reader has flagged it is waiting, so a busy reader costs no
+ *  FreeRTOS call per frame.
+ */
+
+class CanRingReader;
+
+struct CanRingCursor
+  {
+  uint32_t seq = 0;                         // Sequence number of next frame
+  uint32_t lost = 0;                        // Frames lost by overruns
+  };
+
+class CanRing
+  {
+  friend class CanRingReader;
+
+  public:
+    CanRing();
+    ~CanRing();
+
+  public:
+    bool Init(size_t size);
+    void Write(const CAN_frame_t* frame, bool tx);
+    bool Read(CanRingCursor& cursor, CAN_frame_t* frame, bool* tx=NULL);
+    void Attach(CanRingCursor& cursor);
+    uint32_t GetNextSeq() { return m_seq.load(std::memory_order_acquire); }
+    size_t GetSize() { return m_size; }
+
+  public:
+    bool AddReader(CanRingReader* reader);
+    void RemoveReader(CanRingReader* reader);
+    void Status(OvmsWriter* writer);
+    bool HasReaders() { return m_readercnt.load(std::memory_order_relaxed) > 0; }
+
+  protected:
+    void WakeReaders();
+
+  protected:
+    struct entry_t
+      {
+      std::atomic<uint32_t> seq;            // Sequence number of frame (committed)
+      bool tx;                              // TX result (else RX frame)
+      CAN_frame_t frame;
+      };
+
+  protected:
+    entry_t* m_entries;                     // Frame slots (PSRAM)
+    uint32_t m_size;                        // Slot count, power of 2
+    std::atomic<uint32_t> m_seq;            // Sequence number of next frame
+    std::atomic<CanRingReader*> m_readers[CANRING_MAXREADERS];
+    std::atomic<int> m_readercnt;           // Readers attached
+    std::atomic<int> m_waking;              // Producers in WakeReaders()
+  };
+
+/**
+ * CanRingReader: consumer of the MyCan frame ring
+ *
+ *  Usage (in the consumer task):
+ *    CanRingReader reader("mytask");
+ *    CAN_frame_t frame;
+ *    while (running)
+ *      if (reader.Read(&frame)) Process(&frame);
+ *
+ *  Use Wakeup() to unblock the reader task, e.g. for shutdown.
+ */
+class CanRingReader
+  {
+  friend class CanRing;
+
+  public:
+    CanRingReader(const char* name, bool txfeedback=false, CanRing* ring=NULL);
+    ~CanRingReader();
+
+  public:
+    bool Read(CAN_frame_t* frame, TickType_t maxwait=portMAX_DELAY, bool* tx=NULL);
+    void Wakeup();
+    bool IsAttached() { return m_attached; }
+
+  public:
+    const char* GetName() { return m_name; }
+    uint32_t GetReadCount() { return m_readcnt; }
+    uint32_t GetLostCount() { return m_cursor.lost; }
+    uint32_t GetBacklog() { return m_ring->GetNextSeq() - m_cursor.seq; }
+
+  protected:
+    CanRing* m_ring;
+    const char* m_name;
+    bool m_txfeedback;                      // Also read TX results
+    bool m_attached;
+    CanRingCursor m_cursor;
+    uint32_t m_readcnt;
+    std::atomic<bool> m_waiting;            // Blocked in Read(), needs a wakeup
+    SemaphoreHandle_t m_wakeup;
+  };
+
+#endif //#ifndef __CAN_RING_H__
@@ -28,6 +28,8 @@
 static const char *TAG = "canformat";
 
 #include "canformat.h"
+#include <ctype.h>
+#include <limits.h>
 
 canformat::canformat_serve_mode_t GetFormatModeType(std::string name)
   {
@@ -39,6 +41,89 @@ canformat::canformat_serve_mode_t GetFormatModeType(std::string name)
     return canformat::Discard;
   }
 
+////////////////////////////////////////////////////////////////////////
+// canformat_scanner: text line scanner
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Match: check if the text at the current position starts with token
+ */
+bool canformat_scanner::Match(const char* token) const
+  {
+  for (size_t i = 0; token[i]; i++)
+    {
+    if (Peek(i) != token[i])
+      return false;
+    }
+  return true;
+  }
+
+/**
+ * Scan: parse an unsigned number like strtoul(), return the magnitude
+ *  Leaves the position unchanged if there are no digits.
+ */
+uint64_t canformat_scanner::Scan(int base, bool* negative, bool* overflow)
+  {
+  const char* start = m_pos;
+  *negative = false;
+  *overflow = false;
+  while (isspace((unsigned char)Peek()))
+    m_pos++;
+  if (Peek() == '+' || Peek() == '-')
+    {
+    *negative = (Peek() == '-');
+    m_pos++;
+    }
+  if (base == 16 && Peek() == '0' && (Peek(1) == 'x' || Peek(1) == 'X') && isxdigit((unsigned char)Peek(2)))
+    m_pos += 2;
+
+  uint64_t value = 0;
+  bool digits = false;
+  for (;;)
+    {
+    char c = Peek();
+    int d;
+    if (c >= '0' && c <= '9')       d = c - '0';
+    else if (c >= 'a' && c <= 'z')  d = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'Z')  d = c - 'A' + 10;
+    else break;
+    if (d >= base) break;
+    if (value > (UINT64_MAX - d) / base)
+      *overflow = true;
+    else
+      value = value * base + d;
+    digits = true;
+    m_pos++;
+    }
+
+  if (!digits)
+    {
+    m_pos = start;
+    *negative = false;
+    return 0;
+    }
+  return value;
+  }
+
+long canformat_scanner::Long(int base)
+  {
+  bool neg, ovf;
+  uint64_t value = Scan(base, &neg, &ovf);
+  if (!neg)
+    return (ovf || value > (uint64_t)LONG_MAX) ? LONG_MAX : (long)value;
+  else
+    return (ovf || value > (uint64_t)LONG_MAX + 1) ? LONG_MIN : (long)(0 - value);
+  }
+
+unsigned long canformat_scanner::ULong(int base)
+  {
+  bool neg, ovf;
+  uint64_t value = Scan(base, &neg, &ovf);
+  if (ovf || value > (uint64_t)ULONG_MAX)
+    return ULONG_MAX;
+  return neg ? 0 - (unsigned long)value : (unsigned long)value;
+  }
+
 OvmsCanFormatFactory MyCanFormatFactory __attribute__ ((init_priority (4500)));
 
 OvmsCanFormatFactory::OvmsCanFormatFactory()
@@ -90,9 +175,16 @@ const char* canformat::type()
   return m_type;
   }
 
+size_t canformat::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
+  {
+  return 0;
+  }
+
 std::string canformat::get(CAN_log_message_t* message)
   {
-  return std::string("");
+  char buf[CANFORMAT_MAXLEN];
+  size_t len = format(message, (uint8_t*)buf, sizeof(buf));
+  return std::string(buf, len);
   }
 
 std::string canformat::getheader(struct timeval *time)
@@ -151,6 +243,49 @@ size_t canformat::Serve(uint8_t *buffer, size_t len, canlogconnection* clc)
   return consumed;
   }
 
+/**
+ * GetLine: get the next input line for text formats, without heap allocation
+ *  A complete line is returned in place from the input buffer. A partial
+ *  line is kept in m_buf and assembled in m_line once its end arrives
+ *  (truncated to CANFORMAT_MAXLEN bytes). The line end (CR, LF or CR LF)
+ *  is consumed but not included.
+ *  Returns true if a line is available, *consumed is set to the input
+ *  bytes used in both cases.
+ */
+bool canformat::GetLine(const char** line, size_t* linelen, uint8_t* buffer, size_t len, size_t* consumed)
+  {
+  size_t n = 0;
+  while (n < len && buffer[n] != '\r' && buffer[n] != '\n')
+    n++;
+  if (n == len)
+    {
+    // No line end yet, keep the partial line:
+    *consumed = Stuff(buffer, len);
+    return false;
+    }
+
+  size_t end = n;
+  if (buffer[end] == '\r') end++;
+  if (end < len && buffer[end] == '\n') end++;
+  *consumed = end;
+
+  if (m_buf.UsedSpace() == 0)
+    {
+    *line = (const char*)buffer;
+    *linelen = n;
+    return true;
+    }
+
+  // Complete the partial line from the previous input:
+  size_t plen = m_buf.Pop(sizeof(m_line), (uint8_t*)m_line);
+  m_buf.EmptyAll();
+  size_t add = (n < sizeof(m_line) - plen) ? n : sizeof(m_line) - plen;
+  memcpy(m_line + plen, buffer, add);
+  *line = m_line;
+  *linelen = plen + add;
+  return true;
+  }
+
 size_t canformat::Stuff(uint8_t *buffer, size_t len)
   {
   // Stuff incoming data into the put buffer
@@ -38,9 +38,40 @@
 using namespace std;
 
 #define CANFORMAT_SERVE_BUFFERSIZE 1024
+#define CANFORMAT_MAXLEN 256              // Maximum length of a single formatted message
 
 class canlogconnection;
 
+/**
+ * canformat_scanner: bounded scanner for text format input lines
+ *  Works directly on a line span (not NUL terminated, no copy). Reading
+ *  beyond the end yields NUL, skipping stops at the end. Number parsing
+ *  follows strtol() / strtoul() (leading white space, sign, "0x" prefix
+ *  for base 16, saturation on overflow) without locale & errno.
+ */
+class canformat_scanner
+  {
+  public:
+    canformat_scanner(const char* line, size_t len) : m_pos(line), m_end(line+len) {}
+
+  public:
+    inline char Peek(size_t offset=0) const { return (offset < Remaining()) ? m_pos[offset] : 0; }
+    inline bool AtEnd() const { return Peek() == 0; }
+    inline const char* Pos() const { return m_pos; }
+    inline size_t Remaining() const { return (m_pos < m_end) ? m_end - m_pos : 0; }
+    inline void Skip(size_t n=1) { m_pos = (n < Remaining()) ? m_pos + n : m_end; }
+    bool Match(const char* token) const;
+    long Long(int base);
+    unsigned long ULong(int base);
+
+  protected:
+    uint64_t Scan(int base, bool* negative, bool* overflow);
+
+  protected:
+    const char* m_pos;
+    const char* m_end;
+  };
+
 class canformat
   {
   public:
@@ -54,7 +85,12 @@ class canformat
     const char* type();
 
   public: // Conversion from OVMS CAN log messages to specific format
-    virtual std::string get(CAN_log_message_t* message);
+    // format(): serialise message into buffer (no heap allocation), returns
+    //  bytes written or 0 if the message is not represented by the format
+    //  or does not fit. The output is not NUL terminated.
+    virtual size_t format(CAN_log_message_t* message, uint8_t* buffer, size_t size);
+    // get(): std::string convenience wrapper around format()
+    std::string get(CAN_log_message_t* message);
     virtual std::string getheader(struct timeval *time = NULL);
 
   public: // Conversion from specific format to OVMS CAN log messages
@@ -72,10 +108,14 @@ class canformat
     virtual size_t Serve(uint8_t *buffer, size_t len, canlogconnection* clc=NULL);
     virtual size_t Stuff(uint8_t *buffer, size_t len);
 
+  protected:
+    bool GetLine(const char** line, size_t* linelen, uint8_t* buffer, size_t len, size_t* consumed);
+
   protected:
     canformat_serve_mode_t m_servemode;
     bool m_servediscarding;
     OvmsBuffer m_buf;
+    char m_line[CANFORMAT_MAXLEN];      // Assembly of lines split across inputs
   };
 
 template<typename Type> canformat* CreateCanFormat(const char* type)
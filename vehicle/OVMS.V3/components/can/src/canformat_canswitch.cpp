@@ -55,10 +55,8 @@ canformat_cs11::~canformat_cs11()
   {
   }
 
-std::string canformat_cs11::get(CAN_log_message_t* message)
+size_t canformat_cs11::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
   {
-  char buf[CANFORMAT_CS11_MAXLEN];
-
   char busnumber;
   if (message->origin != NULL)
     { busnumber = message->origin->m_busnumber + '1'; }
@@ -68,21 +66,22 @@ std::string canformat_cs11::get(CAN_log_message_t* message)
   switch (message->type)
     {
     case CAN_LogFrame_RX:
-      if (message->frame.FIR.B.FF == CAN_frame_std)
+      if ((message->frame.FIR.B.FF == CAN_frame_std) &&
+          ((size_t)message->frame.FIR.B.DLC+4 <= size))
         {
-        buf[0] = message->frame.FIR.B.DLC + 3;
-        buf[1] = busnumber - '1';
-        buf[2] = message->frame.MsgID & 0xff;
-        buf[3] = (message->frame.MsgID >> 8) & 0xff;
-        memcpy(buf+4,message->frame.data.u8,message->frame.FIR.B.DLC);
-        return std::string(buf,message->frame.FIR.B.DLC+4);
+        buffer[0] = message->frame.FIR.B.DLC + 3;
+        buffer[1] = busnumber - '1';
+        buffer[2] = message->frame.MsgID & 0xff;
+        buffer[3] = (message->frame.MsgID >> 8) & 0xff;
+        memcpy(buffer+4,message->frame.data.u8,message->frame.FIR.B.DLC);
+        return message->frame.FIR.B.DLC+4;
         }
       break;
     default:
       break;
     }
 
-  return std::string("");
+  return 0;
   }
 
 std::string canformat_cs11::getheader(struct timeval *time)
@@ -54,10 +54,12 @@ canformat_crtd::~canformat_crtd()
   {
   }
 
-std::string canformat_crtd::get(CAN_log_message_t* message)
+size_t canformat_crtd::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
   {
-  char buf[CANFORMAT_CRTD_MAXLEN];
+  char *buf = (char*)buffer;
   char *p;
+  int len;
+  bool isframe = false;
 
   char busnumber;
   if (message->origin != NULL)
@@ -69,25 +71,19 @@ std::string canformat_crtd::get(CAN_log_message_t* message)
     {
     case CAN_LogFrame_RX:
     case CAN_LogFrame_TX:
-      snprintf(buf,sizeof(buf),"%l" PRId32 ".%06ld %c%c%s %0*" PRIX32,
+      len = snprintf(buf,size,"%l" PRId32 ".%06ld %c%c%s %0*" PRIX32,
         message->timestamp.tv_sec, message->timestamp.tv_usec,
         busnumber,
         (message->type == CAN_LogFrame_RX) ? 'R' : 'T',
         (message->frame.FIR.B.FF == CAN_frame_std) ? "11":"29",
         (message->frame.FIR.B.FF == CAN_frame_std) ? 3 : 8,
         message->frame.MsgID);
-      p = buf+strlen(buf);
-      for (int k=0; k<message->frame.FIR.B.DLC; k++)
-        {
-        *p++ = ' ';
-        p = HexByte(p,message->frame.data.u8[k]);
-        }
-      *p = 0;
+      isframe = true;
       break;
 
     case CAN_LogFrame_TX_Queue:
     case CAN_LogFrame_TX_Fail:
-      snprintf(buf,sizeof(buf),"%l" PRId32 ".%06ld %cCER %s %c%s %0*" PRIX32,
+      len = snprintf(buf,size,"%l" PRId32 ".%06ld %cCER %s %c%s %0*" PRIX32,
         message->timestamp.tv_sec, message->timestamp.tv_usec,
         busnumber,
         GetCanLogTypeName(message->type),
@@ -95,18 +91,12 @@ std::string canformat_crtd::get(CAN_log_message_t* message)
         (message->frame.FIR.B.FF == CAN_frame_std) ? "11":"29",
         (message->frame.FIR.B.FF == CAN_frame_std) ? 3 : 8,
         message->frame.MsgID);
-        p = buf+strlen(buf);
-        for (int k=0; k<message->frame.FIR.B.DLC; k++)
-          {
-          *p++ = ' ';
-          p = HexByte(p,message->frame.data.u8[k]);
-          }
-        *p = 0;
+      isframe = true;
       break;
 
     case CAN_LogStatus_Error:
     case CAN_LogStatus_Statistics:
-      snprintf(buf,sizeof(buf),
+      len = snprintf(buf,size,
         "%l" PRId32 ".%06ld %c%s %s intr=%" PRId32 " rxpkt=%" PRId32 " txpkt=%" PRId32 " errflags=%#" PRIx32 " rxerr=%d txerr=%d"
         " rxinval=%d rxovr=%d txovr=%d txdelay=%" PRId32 " txfail=%" PRId32 " wdgreset=%d errreset=%d txqueue=%" PRId32,
         message->timestamp.tv_sec, message->timestamp.tv_usec,
@@ -124,7 +114,7 @@ std::string canformat_crtd::get(CAN_log_message_t* message)
     case CAN_LogInfo_Config:
     case CAN_LogInfo_Event:
     case CAN_LogInfo_Metric:
-      snprintf(buf,sizeof(buf),"%l" PRId32 ".%06ld %c%s %s %s",
+      len = snprintf(buf,size,"%l" PRId32 ".%06ld %c%s %s %s",
         message->timestamp.tv_sec, message->timestamp.tv_usec,
         busnumber,
         (message->type == CAN_LogInfo_Event) ? "CEV" : (message->type == CAN_LogInfo_Metric) ? "CMT" : "CXX",
@@ -133,12 +123,36 @@ std::string canformat_crtd::get(CAN_log_message_t* message)
       break;
 
     default:
-      buf[0] = 0;
-      break;
+      return 0;
     }
 
-  strcat(buf,"\n");
-  return std::string(buf);
+  if (len < 0)
+    return 0;
+
+  if (isframe)
+    {
+    // Frames need to fit completely:
+    if ((size_t)len + message->frame.FIR.B.DLC*3 + 1 > size)
+      return 0;
+    p = buf+len;
+    for (int k=0; k<message->frame.FIR.B.DLC; k++)
+      {
+      *p++ = ' ';
+      p = HexByte(p,message->frame.data.u8[k]);
+      }
+    *p++ = '\n';
+    return p - buf;
+    }
+  else
+    {
+    // Status & info lines get truncated as necessary:
+    if (size < 2)
+      return 0;
+    if ((size_t)len > size-2)
+      len = size-2;
+    buf[len++] = '\n';
+    return len;
+    }
   }
 
 std::string canformat_crtd::getheader(struct timeval *time)
@@ -164,125 +178,129 @@ size_t canformat_crtd::put(CAN_log_message_t* message, uint8_t *buffer, size_t l
   if (m_buf.FreeSpace()==0) SetServeDiscarding(true); // Buffer full, so discard from now on
   if (IsServeDiscarding()) return len;  // Quick return if discarding
 
-  size_t consumed = Stuff(buffer,len);  // Stuff m_buf with as much as possible
-  if (m_buf.HasLine()<0)
+  const char* line;
+  size_t linelen, consumed;
+  if (!GetLine(&line, &linelen, buffer, len, &consumed))
     {
     return consumed; // No line, so quick exit
     }
-  else
-    {
-    *hasmore = true;  // Call us again to see if we have more frames to process
-    std::string line = m_buf.ReadLine();
-    const char *b = line.c_str();
 
-    // We look for something like
-    // 1524311386.811100 1R11 100 01 02 03
-    if (!isdigit(b[0])) return consumed;    // Discard invalid line
-    for (;((*b != 0)&&(*b != ' '));b++) {}
-    if (*b == 0) return consumed;           // Discard invalid line
-    b++;
-    char bus = '1';
-    if (isdigit(*b))
-      {
-      bus = *b;
-      b++;
-      }
+  *hasmore = true;  // Call us again to see if we have more frames to process
+  canformat_scanner b(line, linelen);
 
-    if ((b[0]=='R')&&(b[1]=='1')&&(b[2]=='1'))
-      {
-      // R11 incoming CAN frame
-      message->type = CAN_LogFrame_RX;
-      message->frame.FIR.B.FF = CAN_frame_std;
-      }
-    else if ((b[0]=='R')&&(b[1]=='2')&&(b[2]=='9'))
-      {
-      // R29 incoming CAN frame
-      message->type = CAN_LogFrame_RX;
-      message->frame.FIR.B.FF = CAN_frame_ext;
-      }
-    else if ((b[0]=='T')&&(b[1]=='1')&&(b[2]=='1'))
-      {
-      // T11 outgoing CAN frame
-      message->type = CAN_LogFrame_TX;
-      message->frame.FIR.B.FF = CAN_frame_std;
-      }
-    else if ((b[0]=='T')&&(b[1]=='2')&&(b[2]=='9'))
-      {
-      // T29 outgoingCAN frame
-      message->type = CAN_LogFrame_TX;
-      message->frame.FIR.B.FF = CAN_frame_ext;
-      }
-    else if ((b[0]=='C')&&(b[1]=='B')&&(b[2]=='C'))
-      {
-      // A command to configure a CAN bus
-      CAN_mode_t mode = (b[4]=='A')?CAN_MODE_ACTIVE:CAN_MODE_LISTEN;
-      CAN_speed_t speed;
-      switch (atoi(b+6))
-        {
-        case 33333:   speed = CAN_SPEED_33KBPS; break;
-        case 50000:   speed = CAN_SPEED_50KBPS; break;
-        case 83333:   speed = CAN_SPEED_83KBPS; break;
-        case 100000:  speed = CAN_SPEED_100KBPS; break;
-        case 125000:  speed = CAN_SPEED_125KBPS; break;
-        case 250000:  speed = CAN_SPEED_250KBPS; break;
-        case 500000:  speed = CAN_SPEED_500KBPS; break;
-        case 1000000: speed = CAN_SPEED_1000KBPS; break;
-        default:
-          return consumed;
-        }
-      if (clc) clc->ControlBusConfigure(MyCan.GetBus(bus - '1'), mode, speed);
-      return consumed;
-      }
-    else if ((b[0]=='C')&&(b[1]=='D')&&(b[2]=='P'))
-      {
-      // A command to pause the transmission of messages
-      if (clc) clc->PauseTransmission();
-      return consumed;
-      }
-    else if ((b[0]=='C')&&(b[1]=='D')&&(b[2]=='R'))
-      {
-      // A command to resume the transmission of messages
-      if (clc) clc->ResumeTransmission();
-      return consumed;
-      }
-    else if ((b[0]=='C')&&(b[1]=='F')&&(b[2]=='C'))
-      {
-      // A command to clear all filters for this connection
-      if (clc) clc->ClearFilters();
-      return consumed;
-      }
-    else if ((b[0]=='C')&&(b[1]=='F')&&(b[2]=='A'))
+  // We look for something like
+  // 1524311386.811100 1R11 100 01 02 03
+  if (!isdigit((unsigned char)b.Peek())) return consumed;    // Discard invalid line
+  message->timestamp.tv_sec = b.Long(10);
+  if (b.Peek() == '.')
+    {
+    long usec = 0;
+    int digits = 0;
+    for (b.Skip();isdigit((unsigned char)b.Peek());b.Skip())
       {
-      // A command to add a filter for this connection
-      std::string filter(b+4);
-      if (clc) clc->AddFilter(filter);
-      return consumed;
+      if (digits++ < 6) usec = usec*10 + (b.Peek()-'0');
       }
-    else
-      return consumed;  // Discard invalid line
-
-    if (b[3] != ' ') return consumed; // Discard invalid line
-    b += 4;
+    for (;digits<6;digits++) usec *= 10;
+    message->timestamp.tv_usec = usec;
+    }
+  for (;((!b.AtEnd())&&(b.Peek() != ' '));b.Skip()) {}
+  if (b.AtEnd()) return consumed;           // Discard invalid line
+  b.Skip();
+  char bus = '1';
+  if (isdigit((unsigned char)b.Peek()))
+    {
+    bus = b.Peek();
+    b.Skip();
+    }
 
-    char *p;
-    errno = 0;
-    message->frame.MsgID = (uint32_t)strtol(b,&p,16);
-    if ((message->frame.MsgID == 0)&&(errno != 0)) return consumed; // Discard invalid line
-    b = p;
-    for (int k=0;k<8;k++)
+  if (b.Match("R11"))
+    {
+    // R11 incoming CAN frame
+    message->type = CAN_LogFrame_RX;
+    message->frame.FIR.B.FF = CAN_frame_std;
+    }
+  else if (b.Match("R29"))
+    {
+    // R29 incoming CAN frame
+    message->type = CAN_LogFrame_RX;
+    message->frame.FIR.B.FF = CAN_frame_ext;
+    }
+  else if (b.Match("T11"))
+    {
+    // T11 outgoing CAN frame
+    message->type = CAN_LogFrame_TX;
+    message->frame.FIR.B.FF = CAN_frame_std;
+    }
+  else if (b.Match("T29"))
+    {
+    // T29 outgoingCAN frame
+    message->type = CAN_LogFrame_TX;
+    message->frame.FIR.B.FF = CAN_frame_ext;
+    }
+  else if (b.Match("CBC"))
+    {
+    // A command to configure a CAN bus
+    CAN_mode_t mode = (b.Peek(4)=='A')?CAN_MODE_ACTIVE:CAN_MODE_LISTEN;
+    CAN_speed_t speed;
+    b.Skip(6);
+    switch (b.Long(10))
       {
-      if (*b==0) break;
-      b++;
-      errno = 0;
-      long d = strtol(b,&p,16);
-      if ((d==0)&&(errno != 0)) break;
-      message->frame.data.u8[k] = (uint8_t)d;
-      message->frame.FIR.B.DLC++;
-      b = p;
+      case 33333:   speed = CAN_SPEED_33KBPS; break;
+      case 50000:   speed = CAN_SPEED_50KBPS; break;
+      case 83333:   speed = CAN_SPEED_83KBPS; break;
+      case 100000:  speed = CAN_SPEED_100KBPS; break;
+      case 125000:  speed = CAN_SPEED_125KBPS; break;
+      case 250000:  speed = CAN_SPEED_250KBPS; break;
+      case 500000:  speed = CAN_SPEED_500KBPS; break;
+      case 1000000: speed = CAN_SPEED_1000KBPS; break;
+      default:
+        return consumed;
       }
+    if (clc) clc->ControlBusConfigure(MyCan.GetBus(bus - '1'), mode, speed);
+    return consumed;
+    }
+  else if (b.Match("CDP"))
+    {
+    // A command to pause the transmission of messages
+    if (clc) clc->PauseTransmission();
+    return consumed;
+    }
+  else if (b.Match("CDR"))
+    {
+    // A command to resume the transmission of messages
+    if (clc) clc->ResumeTransmission();
+    return consumed;
+    }
+  else if (b.Match("CFC"))
+    {
+    // A command to clear all filters for this connection
+    if (clc) clc->ClearFilters();
+    return consumed;
+    }
+  else if (b.Match("CFA"))
+    {
+    // A command to add a filter for this connection
+    b.Skip(4);
+    std::string filter(b.Pos(), strnlen(b.Pos(), b.Remaining()));
+    if (clc) clc->AddFilter(filter);
+    return consumed;
+    }
+  else
+    return consumed;  // Discard invalid line
 
-    message->origin = MyCan.GetBus(bus - '1');
+  if (b.Peek(3) != ' ') return consumed; // Discard invalid line
+  b.Skip(4);
 
-    return consumed;
+  message->frame.MsgID = (uint32_t)b.Long(16);
+  for (int k=0;k<8;k++)
+    {
+    if (b.AtEnd()) break;
+    b.Skip();
+    message->frame.data.u8[k] = (uint8_t)b.Long(16);
+    message->frame.FIR.B.DLC++;
     }
+
+  message->origin = MyCan.GetBus(bus - '1');
+
+  return consumed;
   }
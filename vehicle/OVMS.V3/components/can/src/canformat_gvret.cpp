@@ -63,11 +63,6 @@ canformat_gvret::~canformat_gvret()
   {
   }
 
-std::string canformat_gvret::get(CAN_log_message_t* message)
-  {
-  return std::string("");
-  }
-
 std::string canformat_gvret::getheader(struct timeval *time)
   {
   return std::string("");
@@ -87,29 +82,35 @@ canformat_gvret_ascii::canformat_gvret_ascii(const char* type)
   {
   }
 
-std::string canformat_gvret_ascii::get(CAN_log_message_t* message)
+size_t canformat_gvret_ascii::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
   {
-  char buf[CANFORMAT_GVRET_MAXLEN];
+  char *buf = (char*)buffer;
 
   if ((message->type != CAN_LogFrame_RX)&&
       (message->type != CAN_LogFrame_TX))
     {
-    return std::string("");
+    return 0;
     }
 
   char busnumber = (message->origin != NULL)?message->origin->m_busnumber + '0':'0';
 
-  sprintf(buf,"%" PRIu32 " - %" PRIx32 " %s %c %d",
+  int len = snprintf(buf,size,"%" PRIu32 " - %" PRIx32 " %s %c %d",
     (uint32_t)((message->timestamp.tv_sec * 1000000) + message->timestamp.tv_usec),
     message->frame.MsgID,
     (message->frame.FIR.B.FF == CAN_frame_std) ? "S" : "X",
     busnumber,
     message->frame.FIR.B.DLC);
-    for (int k=0; k<message->frame.FIR.B.DLC; k++)
-      sprintf(buf+strlen(buf)," %02x", message->frame.data.u8[k]);
+  if ((len < 0) || ((size_t)len + message->frame.FIR.B.DLC*3 + 1 > size))
+    return 0;
 
-  strcat(buf,"\n");
-  return std::string(buf);
+  char *p = buf+len;
+  for (int k=0; k<message->frame.FIR.B.DLC; k++)
+    {
+    *p++ = ' ';
+    p = HexByte(p,message->frame.data.u8[k]);
+    }
+  *p++ = '\n';
+  return p - buf;
   }
 
 size_t canformat_gvret_ascii::put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc)
@@ -117,67 +118,62 @@ size_t canformat_gvret_ascii::put(CAN_log_message_t* message, uint8_t *buffer, s
   if (m_buf.FreeSpace()==0) SetServeDiscarding(true); // Buffer full, so discard from now on
   if (IsServeDiscarding()) return len;  // Quick return if discarding
 
-  size_t consumed = Stuff(buffer,len);  // Stuff m_buf with as much as possible
-
-  if (m_buf.HasLine()<0)
+  const char* line;
+  size_t linelen, consumed;
+  if (!GetLine(&line, &linelen, buffer, len, &consumed))
     {
     return consumed; // No line, so quick exit
     }
-  else
-    {
-    std::string line = m_buf.ReadLine();
-    char *b = strdup(line.c_str());
-
-    // We look for something like
-    // 1000 - 100 S 0 4 01 02 03 04
-    // timestamp, message ID (hex), S or X, length, data bytes
 
-    message->type = CAN_LogFrame_RX;
+  *hasmore = true;  // Call us again to see if we have more frames to process
+  canformat_scanner b(line, linelen);
 
-    uint32_t timestamp = strtol(b,&b,10);
-    message->timestamp.tv_sec = timestamp % 1000000;
-    message->timestamp.tv_usec = timestamp / 1000000;
+  // We look for something like
+  // 1000 - 100 S 0 4 01 02 03 04
+  // timestamp (us), message ID (hex), S or X, bus, length, data bytes
 
-    b += 2; // Skip the '-'
+  message->type = CAN_LogFrame_RX;
 
-    message->frame.MsgID = strtol(b,&b,16);
-    if (b[1] == 'S')
-      {
-      message->frame.FIR.B.FF = CAN_frame_std;
-      }
-    else if (b[1] == 'X')
-      {
-      message->frame.FIR.B.FF = CAN_frame_ext;
-      }
-    else
-      {
-      // Bad frame type - discard
-      free(b);
-      return consumed;
-      }
+  uint32_t timestamp = b.ULong(10);
+  message->timestamp.tv_sec = timestamp / 1000000;
+  message->timestamp.tv_usec = timestamp % 1000000;
 
-    b += 2; // Skip the frame type
+  b.Skip(2); // Skip the '-'
 
-    uint32_t busnumber = strtol(b,&b,10);
-
-    message->frame.FIR.B.DLC = strtol(b,&b,10);
-    if (message->frame.FIR.B.DLC > 8)
-      {
-      // Bad frame length - discard
-      free(b);
-      return consumed;
-      }
+  message->frame.MsgID = b.Long(16);
+  if (b.Peek(1) == 'S')
+    {
+    message->frame.FIR.B.FF = CAN_frame_std;
+    }
+  else if (b.Peek(1) == 'X')
+    {
+    message->frame.FIR.B.FF = CAN_frame_ext;
+    }
+  else
+    {
+    // Bad frame type - discard
+    return consumed;
+    }
 
-    for (size_t x=0;x<message->frame.FIR.B.DLC;x++)
-      {
-      message->frame.data.u8[x] = strtol(b,&b,16);
-      }
+  b.Skip(2); // Skip the frame type
 
-    message->origin = MyCan.GetBus(busnumber-'0');
+  uint32_t busnumber = b.Long(10);
 
-    free(b);
+  message->frame.FIR.B.DLC = b.Long(10);
+  if (message->frame.FIR.B.DLC > 8)
+    {
+    // Bad frame length - discard
     return consumed;
     }
+
+  for (size_t x=0;x<message->frame.FIR.B.DLC;x++)
+    {
+    message->frame.data.u8[x] = b.Long(16);
+    }
+
+  message->origin = MyCan.GetBus(busnumber);
+
+  return consumed;
   }
 
 ////////////////////////////////////////////////////////////////////////
@@ -189,17 +185,21 @@ canformat_gvret_binary::canformat_gvret_binary(const char* type)
   {
   }
 
-std::string canformat_gvret_binary::get(CAN_log_message_t* message)
+size_t canformat_gvret_binary::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
   {
-  gvret_binary_frame_t frame;
-  memset(&frame,0,sizeof(frame));
-
   if ((message->type != CAN_LogFrame_RX)&&
       (message->type != CAN_LogFrame_TX))
     {
-    return std::string("");
+    return 0;
     }
 
+  size_t len = 12 + message->frame.FIR.B.DLC;
+  if (len > size)
+    return 0;
+
+  gvret_binary_frame_t frame;
+  memset(&frame,0,sizeof(frame));
+
   char busnumber = (message->origin != NULL)?message->origin->m_busnumber:0;
 
   frame.startbyte = GVRET_START_BYTE;
@@ -210,7 +210,8 @@ std::string canformat_gvret_binary::get(CAN_log_message_t* message)
   frame.lenbus = message->frame.FIR.B.DLC + (busnumber<<4);
   for (int k=0; k<message->frame.FIR.B.DLC; k++)
     frame.data[k] = message->frame.data.u8[k];
-  return std::string((const char*)&frame,12 + message->frame.FIR.B.DLC);
+  memcpy(buffer, &frame, len);
+  return len;
   }
 
 std::string canformat_gvret_binary::getheader(struct timeval *time)
@@ -277,18 +278,10 @@ size_t canformat_gvret_binary::put(CAN_log_message_t* message, uint8_t *buffer,
 
             ESP_LOGD(TAG,"Rx BUILD_CAN_FRAME ID=%0" PRIx32,msg.MsgID);
             *hasmore = true;  // Call us again to see if we have more frames to process
-            // We have a frame to be transmitted / simulated
-            switch (m_servemode)
-              {
-              case Transmit:
-                if (msg.origin) msg.origin->Write(&msg);
-                break;
-              case Simulate:
-                if (msg.origin) MyCan.IncomingFrame(&msg);
-                break;
-              default:
-                break;
-              }
+            // We have a frame to be transmitted / simulated (by the caller).
+            // Note: the frame carries no timestamp, players send these immediately.
+            message->type = CAN_LogFrame_RX;
+            message->frame = msg;
             }
           }
         break;
@@ -168,7 +168,6 @@ class canformat_gvret : public canformat
     virtual ~canformat_gvret();
 
   public:
-    virtual std::string get(CAN_log_message_t* message);
     virtual std::string getheader(struct timeval *time);
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
   };
@@ -177,7 +176,7 @@ class canformat_gvret_ascii : public canformat_gvret
   {
   public:
     canformat_gvret_ascii(const char* type);
-    virtual std::string get(CAN_log_message_t* message);
+    virtual size_t format(CAN_log_message_t* message, uint8_t* buffer, size_t size);
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
   };
 
@@ -185,7 +184,7 @@ class canformat_gvret_binary : public canformat_gvret
   {
   public:
     canformat_gvret_binary(const char* type);
-    virtual std::string get(CAN_log_message_t* message);
+    virtual size_t format(CAN_log_message_t* message, uint8_t* buffer, size_t size);
     virtual std::string getheader(struct timeval *time);
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
 
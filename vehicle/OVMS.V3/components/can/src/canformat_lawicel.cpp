@@ -60,31 +60,39 @@ canformat_lawicel::~canformat_lawicel()
   {
   }
 
-std::string canformat_lawicel::get(CAN_log_message_t* message)
+size_t canformat_lawicel::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
   {
-  char buf[CANFORMAT_LAWICEL_MAXLEN];
+  char *buf = (char*)buffer;
+  int len;
 
   if ((message->type != CAN_LogFrame_RX)&&
       (message->type != CAN_LogFrame_TX))
     {
-    return std::string("");
+    return 0;
     }
 
   if (message->frame.FIR.B.FF == CAN_frame_std)
     {
-    sprintf(buf,"t%03" PRIx32 "%01d",message->frame.MsgID, message->frame.FIR.B.DLC);
+    len = snprintf(buf,size,"t%03" PRIx32 "%01d",message->frame.MsgID, message->frame.FIR.B.DLC);
     }
   else
     {
-    sprintf(buf,"T%08" PRIx32 "%01d",message->frame.MsgID, message->frame.FIR.B.DLC);
+    len = snprintf(buf,size,"T%08" PRIx32 "%01d",message->frame.MsgID, message->frame.FIR.B.DLC);
     }
+  if ((len < 0) || ((size_t)len + message->frame.FIR.B.DLC*2 + 4 + 1 > size))
+    return 0;
 
+  char *p = buf+len;
   for (int k=0; k<message->frame.FIR.B.DLC; k++)
-    sprintf(buf+strlen(buf),"%02x", message->frame.data.u8[k]);
-  sprintf(buf+strlen(buf),"%04lx", message->timestamp.tv_usec/1000);
+    p = HexByte(p,message->frame.data.u8[k]);
 
-  strcat(buf,"\n");
-  return std::string(buf);
+  // Timestamp: milliseconds, 4 hex digits
+  uint16_t ms = message->timestamp.tv_usec/1000;
+  p = HexByte(p, ms >> 8);
+  p = HexByte(p, ms & 0xff);
+
+  *p++ = '\n';
+  return p - buf;
   }
 
 std::string canformat_lawicel::getheader(struct timeval *time)
@@ -92,72 +100,76 @@ std::string canformat_lawicel::getheader(struct timeval *time)
   return std::string("");
   }
 
+// Fixed width hex field (like strtol() on the field, invalid digits end it):
+static uint32_t LawicelHex(const canformat_scanner& b, size_t offset, size_t digits)
+  {
+  uint32_t value = 0;
+  for (size_t i = 0; i < digits; i++)
+    {
+    char c = b.Peek(offset + i);
+    if (c >= '0' && c <= '9')       value = (value << 4) | (c - '0');
+    else if (c >= 'a' && c <= 'f')  value = (value << 4) | (c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')  value = (value << 4) | (c - 'A' + 10);
+    else break;
+    }
+  return value;
+  }
+
 size_t canformat_lawicel::put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc)
   {
   if (m_buf.FreeSpace()==0) SetServeDiscarding(true); // Buffer full, so discard from now on
   if (IsServeDiscarding()) return len;  // Quick return if discarding
 
-  size_t consumed = Stuff(buffer,len);  // Stuff m_buf with as much as possible
-
-  if (m_buf.HasLine()<0)
+  const char* line;
+  size_t linelen, consumed;
+  if (!GetLine(&line, &linelen, buffer, len, &consumed))
     {
     return consumed; // No line, so quick exit
     }
+
+  *hasmore = true;  // Call us again to see if we have more frames to process
+  canformat_scanner b(line, linelen);
+
+  // We look for something like
+  // t100401020304000a
+  if (b.Peek() == 't')
+    {
+    // Standard frame
+    message->type = CAN_LogFrame_RX;
+    message->frame.FIR.B.FF = CAN_frame_std;
+    message->frame.MsgID = LawicelHex(b, 1, 3);
+    b.Skip(4);
+    }
+  else if (b.Peek() == 'T')
+    {
+    // Extended frame
+    message->type = CAN_LogFrame_RX;
+    message->frame.FIR.B.FF = CAN_frame_ext;
+    message->frame.MsgID = LawicelHex(b, 1, 8);
+    b.Skip(9);
+    }
   else
     {
-    *hasmore = true;  // Call us again to see if we have more frames to process
-    std::string line = m_buf.ReadLine();
-    const char *b = line.c_str();
-    char hex[9];
-
-    // We look for something like
-    // t100401020304000a
-    if (*b == 't')
-      {
-      // Standard frame
-      memcpy(hex,b+1,3);
-      hex[3] = 0;
-      message->type = CAN_LogFrame_RX;
-      message->frame.FIR.B.FF = CAN_frame_std;
-      message->frame.MsgID = strtol(hex,NULL,16);
-      b += 4;
-      }
-    else if (*b == 'T')
-      {
-      // Extended frame
-      memcpy(hex,b+1,8);
-      hex[8] = 0;
-      message->type = CAN_LogFrame_RX;
-      message->frame.FIR.B.FF = CAN_frame_ext;
-      message->frame.MsgID = strtol(hex,NULL,16);
-      b += 9;
-      }
-    else
-      {
-      // Unknown format - discard
-      return consumed; // Discard invalid line
-      }
-
-    message->frame.FIR.B.DLC = *b - '0';
-    if (message->frame.FIR.B.DLC > 8)
-      {
-      // Invalid length - discard
-      return consumed; // Discard invalid line
-      }
-
-    b++;
-    for (size_t x=0;x<message->frame.FIR.B.DLC;x++)
-      {
-      hex[0] = b[0];
-      hex[1] = b[2];
-      hex[2] = 0;
-      b += 2;
-      message->frame.data.u8[x] = (uint8_t)strtol(hex,NULL,16);
-      }
-
-    gettimeofday(&message->timestamp,NULL);
-    message->origin = MyCan.GetBus(0);
-
-    return consumed;
+    // Unknown format - discard
+    return consumed; // Discard invalid line
+    }
+
+  message->frame.FIR.B.DLC = b.Peek() - '0';
+  if (message->frame.FIR.B.DLC > 8)
+    {
+    // Invalid length - discard
+    return consumed; // Discard invalid line
     }
+
+  b.Skip();
+  for (size_t x=0;x<message->frame.FIR.B.DLC;x++)
+    {
+    message->frame.data.u8[x] = (uint8_t)LawicelHex(b, 0, 2);
+    b.Skip(2);
+    }
+
+  gettimeofday(&message->timestamp,NULL);
+  message->origin = MyCan.GetBus(0);
+
+  return consumed;
   }
@@ -38,7 +38,7 @@ class canformat_lawicel : public canformat
     virtual ~canformat_lawicel();
 
   public:
-    virtual std::string get(CAN_log_message_t* message);
+    virtual size_t format(CAN_log_message_t* message, uint8_t* buffer, size_t size);
     virtual std::string getheader(struct timeval *time);
     virtual size_t put(CAN_log_message_t* message, uint8_t *buffer, size_t len, bool* hasmore, canlogconnection* clc=NULL);
   };
@@ -53,15 +53,15 @@ canformat_pcap::~canformat_pcap()
   {
   }
 
-std::string canformat_pcap::get(CAN_log_message_t* message)
+size_t canformat_pcap::format(CAN_log_message_t* message, uint8_t* buffer, size_t size)
   {
-  pcaprec_can_t m;
-
-  if (message->type != CAN_LogFrame_RX)
+  if ((message->type != CAN_LogFrame_RX) || (size < sizeof(pcaprec_can_t)))
     {
-    return std::string("");
+    return 0;
     }
 
+  // Note: buffer may be unaligned, so we assemble the record on the stack
+  pcaprec_can_t m;
   memset(&m,0,sizeof(m));
 
   m.hdr.ts_sec = htobe32(message->timestamp.tv_sec);
@@ -77,7 +77,8 @@ std::string canformat_pcap::get(CAN_log_message_t* message)
 
   memcpy(m.data, message->frame.data.u8, message->frame.FIR.B.DLC);
 
-  return std::string((const char*)&m, sizeof(m));
+  memcpy(buffer,&m,sizeof(m));
+  return sizeof(m);
   }
 
 std::string canformat_pcap::getheader(struct timeval *time)
@@ -117,7 +118,6 @@ size_t canformat_pcap::put(CAN_log_message_t* message, uint8_t *buffer, size_t l
   if (m_buf.UsedSpace() < 24) return consumed; // Insufficient data so far
 
   // At this point, we have our 24 bytes...
-  *hasmore = true;  // Call us again to see if we have more frames to process
   m_buf.Peek(24,(uint8_t*)&m);
   uint32_t magic = be32toh(m.header.magic_number);
   if (magic == 0xa1b2c3d4)
@@ -130,6 +130,7 @@ size_t canformat_pcap::put(CAN_log_message_t* message, uint8_t *buffer, size_t l
       return consumed;
       }
     m_buf.Pop(24,(uint8_t*)&m);
+    *hasmore = true;  // Call us again to see if we have more frames to process
     }
   else if ((magic == 0xd4c3b2a1)||
            (magic == 0xa1b23c4d)||
@@ -143,6 +144,7 @@ size_t canformat_pcap::put(CAN_log_message_t* message, uint8_t *buffer, size_t l
   if (m_buf.UsedSpace() < sizeof(pcaprec_can_t)) return consumed; // Insufficient data so far
 
   m_buf.Pop(sizeof(pcaprec_can_t), (uint8_t*)&m);
+  *hasmore = true;  // Call us again to see if we have more frames to process
 
   uint32_t idf = be32toh(m.record.phdr.idflags);
   if (idf & CANFORMAT_PCAP_FL_MSG)
@@ -151,6 +153,8 @@ size_t canformat_pcap::put(CAN_log_message_t* message, uint8_t *buffer, size_t l
     return consumed;
     }
   message->type = CAN_LogFrame_RX;
+  message->timestamp.tv_sec = be32toh(m.record.hdr.ts_sec);
+  message->timestamp.tv_usec = be32toh(m.record.hdr.ts_usec);
   message->frame.FIR.B.RTR = (idf & CANFORMAT_PCAP_FL_RTR)?CAN_RTR:CAN_no_RTR;
   message->frame.FIR.B.FF = (idf & CANFORMAT_PCAP_FL_EXT)?CAN_frame_ext:CAN_frame_std;
   message->frame.MsgID = idf & CANFORMAT_PCAP_FL_MASK;
@@ -224,7 +224,7 @@ canlogconnection::~canlogconnection()
     }
   }
 
-void canlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
+void canlogconnection::OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len)
   {
   m_msgcount++;
 
@@ -238,11 +238,11 @@ void canlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
   // The standard base implemention here is for mongoose network connections
   if (m_nc != NULL)
     {
-    if (result.length()>0)
+    if (len>0)
       {
       if (m_nc->send_mbuf.len < 32768)
         {
-        mg_send(m_nc, (const char*)result.c_str(), result.length());
+        mg_send(m_nc, data, len);
         }
       else
         {
@@ -257,6 +257,10 @@ void canlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
     }
   }
 
+void canlogconnection::Flush()
+  {
+  }
+
 void canlogconnection::TransmitCallback(uint8_t *buffer, size_t len)
   {
   ESP_LOGD(TAG,"TransmitCallback on %s (%d bytes)",m_peer.c_str(),len);
@@ -420,21 +424,31 @@ void canlog::RxTask(void *context)
   CAN_log_message_t msg;
   while (1)
     {
-    if (xQueueReceive(me->m_queue, &msg, (portTickType)portMAX_DELAY) == pdTRUE)
+    if (xQueueReceive(me->m_queue, &msg, pdMS_TO_TICKS(CANLOG_FLUSH_TIMEOUT)) != pdTRUE)
       {
-      switch (msg.type)
+      // Idle: let the connections write out aged batches
+      me->Flush();
+      }
+    else
+      {
+      // Process all messages queued, then let the connections flush their batches:
+      do
         {
-        case CAN_LogInfo_Comment:
-        case CAN_LogInfo_Config:
-        case CAN_LogInfo_Event:
-        case CAN_LogInfo_Metric:
-          me->OutputMsg(msg);
-          free(msg.text);
-          break;
-        default:
-          me->OutputMsg(msg);
-          break;
-        }
+        switch (msg.type)
+          {
+          case CAN_LogInfo_Comment:
+          case CAN_LogInfo_Config:
+          case CAN_LogInfo_Event:
+          case CAN_LogInfo_Metric:
+            me->OutputMsg(msg);
+            free(msg.text);
+            break;
+          default:
+            me->OutputMsg(msg);
+            break;
+          }
+        } while (xQueueReceive(me->m_queue, &msg, 0) == pdTRUE);
+      me->Flush();
       }
     }
   }
@@ -528,8 +542,8 @@ void canlog::OutputMsg(CAN_log_message_t& msg)
     return;
     }
 
-  std::string result = m_formatter->get(&msg);
-  if (result.length()>0)
+  size_t len = m_formatter->format(&msg, m_fmtbuf, sizeof(m_fmtbuf));
+  if (len>0)
     {
     OvmsRecMutexLock lock(&m_cmmutex);
     for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
@@ -541,12 +555,21 @@ void canlog::OutputMsg(CAN_log_message_t& msg)
         }
       else
         {
-        it->second->OutputMsg(msg, result);
+        it->second->OutputMsg(msg, m_fmtbuf, len);
         }
       }
     }
   }
 
+void canlog::Flush()
+  {
+  OvmsRecMutexLock lock(&m_cmmutex);
+  for (conn_map_t::iterator it=m_connmap.begin(); it!=m_connmap.end(); ++it)
+    {
+    it->second->Flush();
+    }
+  }
+
 std::string canlog::GetInfo()
   {
   std::ostringstream buf;
@@ -620,7 +643,11 @@ void canlog::LogFrame(canbus* bus, CAN_log_type_t type, const CAN_frame_t* frame
     {
     CAN_log_message_t msg;
     msg.type = type;
-    gettimeofday(&msg.timestamp,NULL);
+    // Queued TX frames carry the timestamp of their source, if any:
+    if (type == CAN_LogFrame_TX_Queue)
+      gettimeofday(&msg.timestamp,NULL);
+    else
+      GetCanFrameTime(frame, &msg.timestamp);
     memcpy(&msg.frame,frame,sizeof(CAN_frame_t));
     msg.frame.origin = bus;
     m_msgcount++;
@@ -37,6 +37,8 @@
 #include "ovms_metrics.h"
 #include "id_filter.h"
 
+#define CANLOG_FLUSH_TIMEOUT      1000    // Max idle time between Flush() calls [ms]
+
 /**
  * canlog is the general interface and base implementation for all can loggers.
  *  It provides standard methods to open files and configure message filters
@@ -53,6 +55,12 @@
  * Log entries can be frames, status or info messages (see CAN_LogEntry_t).
  * The timestamp of the original event is preserved.
  *
+ * Messages are formatted once per logger into a static buffer and passed to
+ *  all connections. The logger task drains its queue in bursts and calls
+ *  Flush() when the queue is empty, and at least every CANLOG_FLUSH_TIMEOUT
+ *  ms while idle, so connections may batch their output and still write
+ *  out buffered data on a quiet bus.
+ *
  * Note: loggers get messages for all interfaces, if a log format does not
  *  allow multiple buses within a file, the logger needs to manage a set
  *  of files or may return false on Open() without a bus filter.
@@ -66,7 +74,8 @@ class canlogconnection: public InternalRamAllocated
     virtual ~canlogconnection();
 
   public:
-    virtual void OutputMsg(CAN_log_message_t& msg, std::string &result);
+    virtual void OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len);
+    virtual void Flush();
 
   public:
     virtual void TransmitCallback(uint8_t *buffer, size_t len);
@@ -120,6 +129,7 @@ class canlog : public InternalRamAllocated
     virtual bool IsOpen();
     virtual std::string GetInfo();
     virtual void OutputMsg(CAN_log_message_t& msg);
+    virtual void Flush();
 
   public:
     virtual void SetFilter(canfilter* filter);
@@ -155,6 +165,9 @@ class canlog : public InternalRamAllocated
     uint32_t            m_dropcount;
     uint32_t            m_filtercount;
 
+  protected:
+    uint8_t             m_fmtbuf[CANFORMAT_MAXLEN];
+
   protected:
     virtual void UpdatedConfig(std::string event, void* data);
     virtual void LoadConfig();
@@ -82,7 +82,7 @@ canlog_monitor_conn::~canlog_monitor_conn()
   {
   }
 
-void canlog_monitor_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
+void canlog_monitor_conn::OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len)
   {
   m_msgcount++;
 
@@ -92,7 +92,7 @@ void canlog_monitor_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
     return;
     }
 
-  if (result.length()>0)
+  if (len>0)
     {
     switch (msg.type)
       {
@@ -100,17 +100,17 @@ void canlog_monitor_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
       case CAN_LogFrame_TX:
       case CAN_LogFrame_TX_Queue:
       case CAN_LogFrame_TX_Fail:
-        ESP_LOGV(TAG,"%s",result.c_str());
+        ESP_LOGV(TAG,"%.*s",(int)len,(const char*)data);
         break;
       case CAN_LogStatus_Error:
-        ESP_LOGE(TAG,"%s",result.c_str());
+        ESP_LOGE(TAG,"%.*s",(int)len,(const char*)data);
         break;
       case CAN_LogStatus_Statistics:
       case CAN_LogInfo_Comment:
       case CAN_LogInfo_Config:
       case CAN_LogInfo_Event:
       case CAN_LogInfo_Metric:
-        ESP_LOGD(TAG,"%s",result.c_str());
+        ESP_LOGD(TAG,"%.*s",(int)len,(const char*)data);
         break;
       default:
         break;
@@ -51,7 +51,7 @@ udpcanlogconnection::~udpcanlogconnection()
   {
   }
 
-void udpcanlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
+void udpcanlogconnection::OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len)
   {
   m_msgcount++;
 
@@ -61,9 +61,9 @@ void udpcanlogconnection::OutputMsg(CAN_log_message_t& msg, std::string &result)
     return;
     }
 
-  if (result.length()>0)
+  if (len>0)
     {
-    sendto(m_sock, (const char*)result.c_str(), result.length(), 0, &m_sa, sizeof(m_sa));
+    sendto(m_sock, data, len, 0, &m_sa, sizeof(m_sa));
     }
   }
 
@@ -42,7 +42,7 @@ class udpcanlogconnection: public canlogconnection
     virtual ~udpcanlogconnection();
 
   public:
-    virtual void OutputMsg(CAN_log_message_t& msg, std::string &result);
+    virtual void OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len);
 
   public:
     void Tickle();
@@ -34,6 +34,15 @@ static const char *TAG = "canlog-vfs";
 #include "ovms_config.h"
 #include "ovms_peripherals.h"
 #include "ovms_vfs.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sstream>
+#include <esp_timer.h>
+#include "ovms.h"
+#include "ovms_malloc.h"
+
+static const char *CAN_PARAM = "can";
 
 void can_log_vfs_start(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
@@ -92,19 +101,137 @@ OvmsCanLogVFSInit::OvmsCanLogVFSInit()
 canlog_vfs_conn::canlog_vfs_conn(canlog* logger, std::string format, canformat::canformat_serve_mode_t mode)
   : canlogconnection(logger, format, mode), m_file_size(0)
   {
-  m_file = NULL;
+  int blocksize = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.blocksize", CANLOG_VFS_BLOCKSIZE);
+  if (blocksize < CANLOG_VFS_BLOCKSIZE_MIN) blocksize = CANLOG_VFS_BLOCKSIZE_MIN;
+  if (blocksize > CANLOG_VFS_BLOCKSIZE_MAX) blocksize = CANLOG_VFS_BLOCKSIZE_MAX;
+  m_blocksize = blocksize & ~(CANLOG_VFS_BLOCKSIZE_MIN-1);
+  m_fsync_interval = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.fsync", CANLOG_VFS_FSYNC);
+  m_rotate_size = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.rotate.size", 0) * 1024;
+  m_rotate_time = MyConfig.GetParamValueInt(CAN_PARAM, "log.vfs.rotate.time", 0) * 60;
+
+  m_freequeue = xQueueCreate(CANLOG_VFS_BLOCKS, sizeof(uint8_t*));
+  m_fullqueue = xQueueCreate(CANLOG_VFS_BLOCKS+1, sizeof(block_t));
+  for (int k=0; k<CANLOG_VFS_BLOCKS; k++)
+    {
+    m_blocks[k] = (uint8_t*)ExternalRamMalloc(m_blocksize);
+    if (m_blocks[k])
+      xQueueSend(m_freequeue, &m_blocks[k], 0);
+    else
+      ESP_LOGE(TAG, "Out of memory for %u byte write block", m_blocksize);
+    }
+  m_fill = NULL;
+  m_filllen = 0;
+  m_fill_started = 0;
+  m_pending = 0;
+
+  m_task = NULL;
+  m_done = xSemaphoreCreateBinary();
+  m_fd = -1;
+  m_sequence = 0;
+  m_file_opened = 0;
+  m_file_written = 0;
+  m_file_synced = 0;
+  m_file_dirty = false;
+  m_reopen_due = 0;
+
+  m_hiwater = 0;
+  m_blocked_count = 0;
+  m_blocked_time = 0;
+  m_written = 0;
+  m_write_time = 0;
+  m_write_errors = 0;
+  m_files = 0;
   }
 
 canlog_vfs_conn::~canlog_vfs_conn()
   {
-  if (m_file)
+  Stop();
+  CloseFile();
+  vQueueDelete(m_fullqueue);
+  vQueueDelete(m_freequeue);
+  vSemaphoreDelete(m_done);
+  for (int k=0; k<CANLOG_VFS_BLOCKS; k++)
+    {
+    if (m_blocks[k]) free(m_blocks[k]);
+    }
+  }
+
+/**
+ * Open: open the first log file and start the writer task
+ */
+bool canlog_vfs_conn::Open(std::string path)
+  {
+  m_path = path;
+
+  // Continue the sequence after existing files:
+  if (m_rotate_size || m_rotate_time)
+    {
+    struct stat st;
+    while (stat(NextFileName().c_str(), &st) == 0)
+      m_sequence++;
+    }
+
+  if (!OpenFile())
+    return false;
+
+  xTaskCreatePinnedToCore(WriterTask, "OVMS CanLogVFS", 3072, (void*)this, 5, &m_task, CORE(1));
+  return (m_task != NULL);
+  }
+
+/**
+ * Stop: write all pending data and stop the writer task
+ */
+void canlog_vfs_conn::Stop()
+  {
+  if (!m_task)
+    return;
+  SubmitBlock();
+  block_t stop = { NULL, 0 };
+  xQueueSend(m_fullqueue, &stop, portMAX_DELAY);
+  xSemaphoreTake(m_done, portMAX_DELAY);
+  m_task = NULL;
+  }
+
+bool canlog_vfs_conn::AcquireBlock()
+  {
+  if (xQueueReceive(m_freequeue, &m_fill, 0) != pdTRUE)
     {
-    fclose(m_file);
-    m_file = NULL;
+    // Writer is busy with all blocks, wait for one:
+    int64_t started = esp_timer_get_time();
+    BaseType_t ok = xQueueReceive(m_freequeue, &m_fill, pdMS_TO_TICKS(CANLOG_VFS_BLOCKWAIT));
+    m_blocked_time += esp_timer_get_time() - started;
+    m_blocked_count++;
+    if (ok != pdTRUE)
+      {
+      m_fill = NULL;
+      return false;
+      }
     }
+  m_filllen = 0;
+  m_fill_started = monotonictime;
+  return true;
   }
 
-void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
+void canlog_vfs_conn::SubmitBlock()
+  {
+  if (m_fill)
+    {
+    block_t block = { m_fill, m_filllen };
+    if (m_task)
+      {
+      xQueueSend(m_fullqueue, &block, portMAX_DELAY);
+      }
+    else
+      {
+      WriteBlock(block);
+      xQueueSend(m_freequeue, &m_fill, 0);
+      }
+    m_fill = NULL;
+    m_filllen = 0;
+    }
+  }
+
+void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len)
   {
   m_msgcount++;
 
@@ -114,11 +241,180 @@ void canlog_vfs_conn::OutputMsg(CAN_log_message_t& msg, std::string &result)
     return;
     }
 
-  if (result.length()>0)
+  if (len>0)
+    {
+    if (m_fill && m_filllen + len > m_blocksize)
+      SubmitBlock();
+    if ((!m_fill && !AcquireBlock()) || (len > m_blocksize))
+      {
+      m_dropcount++;
+      return;
+      }
+    memcpy(m_fill+m_filllen, data, len);
+    m_filllen += len;
+    m_file_size += len;
+    size_t pending = (m_pending += len);
+    if (pending > m_hiwater) m_hiwater = pending;
+    }
+  }
+
+void canlog_vfs_conn::Flush()
+  {
+  // Full blocks are submitted by OutputMsg(). Hand over a partial block
+  // once it has aged CANLOG_VFS_FLUSH seconds and only if the writer is
+  // idle, so low traffic doesn't result in a small write per frame and
+  // the next AcquireBlock() doesn't need to wait:
+  if (m_fill && m_filllen > 0 &&
+      monotonictime - m_fill_started >= CANLOG_VFS_FLUSH &&
+      uxQueueMessagesWaiting(m_freequeue) == CANLOG_VFS_BLOCKS-1)
+    {
+    SubmitBlock();
+    }
+  }
+
+void canlog_vfs_conn::WriterTask(void *context)
+  {
+  canlog_vfs_conn* me = (canlog_vfs_conn*) context;
+  me->WriterLoop();
+  xSemaphoreGive(me->m_done);
+  vTaskDelete(NULL);
+  }
+
+void canlog_vfs_conn::WriterLoop()
+  {
+  block_t block;
+  while (1)
+    {
+    if (xQueueReceive(m_fullqueue, &block, pdMS_TO_TICKS(1000)) == pdTRUE)
+      {
+      if (block.data == NULL)
+        break;
+      if (m_fd >= 0 &&
+          ((m_rotate_size && m_file_written > 0 && m_file_written + block.len > m_rotate_size) ||
+           (m_rotate_time && monotonictime - m_file_opened >= m_rotate_time)))
+        {
+        CloseFile();
+        if (!OpenFile())
+          {
+          ESP_LOGE(TAG, "Log rotation failed, retrying in %d seconds", CANLOG_VFS_REOPEN);
+          m_reopen_due = monotonictime + CANLOG_VFS_REOPEN;
+          }
+        }
+      if (m_fd < 0 && m_reopen_due && monotonictime >= m_reopen_due)
+        ReopenFile();
+      WriteBlock(block);
+      xQueueSend(m_freequeue, &block.data, 0);
+      }
+    else if (m_fd < 0 && m_reopen_due && monotonictime >= m_reopen_due)
+      {
+      ReopenFile();
+      }
+
+    if (m_file_dirty && m_fsync_interval && monotonictime - m_file_synced >= m_fsync_interval)
+      {
+      fsync(m_fd);
+      m_file_dirty = false;
+      m_file_synced = monotonictime;
+      }
+    }
+  }
+
+std::string canlog_vfs_conn::NextFileName()
+  {
+  if (!m_rotate_size && !m_rotate_time)
+    return m_path;
+
+  // Insert the sequence number before the extension:
+  std::string::size_type slash = m_path.find_last_of('/');
+  std::string::size_type dot = m_path.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    dot = m_path.length();
+  char seq[16];
+  snprintf(seq, sizeof(seq), "-%04" PRIu32, m_sequence+1);
+  return m_path.substr(0, dot) + seq + m_path.substr(dot);
+  }
+
+bool canlog_vfs_conn::OpenFile()
+  {
+  std::string filename = NextFileName();
+  int fd = open(filename.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  if (fd < 0)
+    {
+    ESP_LOGE(TAG, "Error: Can't write to '%s'", filename.c_str());
+    m_write_errors++;
+    return false;
+    }
+
+  OvmsMutexLock lock(&m_filemutex);
+  m_fd = fd;
+  m_filename = filename;
+  m_sequence++;
+  m_files++;
+  m_file_opened = m_file_synced = monotonictime;
+  m_file_written = 0;
+  m_file_dirty = false;
+  ESP_LOGI(TAG, "Now logging CAN messages to '%s'", filename.c_str());
+
+  std::string header = m_formatter->getheader();
+  if (header.length()>0)
     {
-    fwrite(result.c_str(),result.length(),1,m_file);
-    m_file_size += result.length();
+    if (write(m_fd, header.c_str(), header.length()) == (ssize_t)header.length())
+      {
+      m_written += header.length();
+      m_file_written += header.length();
+      }
     }
+  return true;
+  }
+
+void canlog_vfs_conn::ReopenFile()
+  {
+  if (OpenFile())
+    {
+    m_reopen_due = 0;
+    }
+  else
+    {
+    ESP_LOGE(TAG, "Reopening log file failed, retrying in %d seconds", CANLOG_VFS_REOPEN);
+    m_reopen_due = monotonictime + CANLOG_VFS_REOPEN;
+    }
+  }
+
+void canlog_vfs_conn::CloseFile()
+  {
+  OvmsMutexLock lock(&m_filemutex);
+  if (m_fd >= 0)
+    {
+    fsync(m_fd);
+    close(m_fd);
+    m_fd = -1;
+    m_file_dirty = false;
+    }
+  }
+
+void canlog_vfs_conn::WriteBlock(block_t& block)
+  {
+  if (m_fd >= 0 && block.len > 0)
+    {
+    int64_t started = esp_timer_get_time();
+    ssize_t written = write(m_fd, block.data, block.len);
+    m_write_time += esp_timer_get_time() - started;
+    if (written == (ssize_t)block.len)
+      {
+      m_written += block.len;
+      m_file_written += block.len;
+      m_file_dirty = true;
+      }
+    else
+      {
+      m_write_errors++;
+      }
+    }
+  else if (block.len > 0)
+    {
+    m_write_errors++;
+    }
+  m_pending -= block.len;
   }
 
 
@@ -172,24 +468,12 @@ bool canlog_vfs::Open()
 
   canlog_vfs_conn* clc = new canlog_vfs_conn(this, m_format, m_mode);
   clc->m_peer = m_path;
-
-  clc->m_file = fopen(m_path.c_str(), "w");
-  if (!clc->m_file)
+  if (!clc->Open(m_path))
     {
-    ESP_LOGE(TAG, "Error: Can't write to '%s'", m_path.c_str());
     delete clc;
     return false;
     }
 
-  ESP_LOGI(TAG, "Now logging CAN messages to '%s'", m_path.c_str());
-
-  std::string header = m_formatter->getheader();
-  if (header.length()>0)
-    {
-    fwrite(header.c_str(),header.length(),1,clc->m_file);
-    clc->m_file_size += header.length();
-    }
-
   m_connmap[NULL] = clc;
   m_isopen = true;
 
@@ -228,17 +512,30 @@ size_t canlog_vfs::GetFileSize()
   return result;
   }
 
+std::string canlog_vfs_conn::GetSummary()
+  {
+  OvmsMutexLock lock(&m_filemutex);
+  return m_filename.empty() ? m_peer : m_filename;
+  }
+
 std::string canlog_vfs_conn::GetStats()
   {
   char bufsize[15];
   format_file_size(bufsize, sizeof(bufsize), m_file_size);
 
-  std::string result = "Size:";
-  result.append(bufsize);
-  result.append(" ");
-  result.append(canlogconnection::GetStats());
+  std::ostringstream buf;
+  buf << "Size:" << bufsize
+    << " " << canlogconnection::GetStats();
 
-  return result;
+  // Writer statistics:
+  format_file_size(bufsize, sizeof(bufsize), m_hiwater);
+  buf << " Files:" << m_files
+    << " Write:" << ((m_write_time > 0) ? (uint32_t)(m_written * 1000 / m_write_time) : 0) << "kB/s"
+    << " Errors:" << m_write_errors
+    << " Blocked:" << m_blocked_count << "x/" << (uint32_t)(m_blocked_time / 1000) << "ms"
+    << " Buffer:" << bufsize << "/" << (CANLOG_VFS_BLOCKS * m_blocksize / 1024) << "kB";
+
+  return buf.str();
   }
 
 std::string canlog_vfs::GetStats()
@@ -28,9 +28,39 @@
 #ifndef __CANLOG_VFS_H__
 #define __CANLOG_VFS_H__
 
+#include <atomic>
 #include "canlog.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "ovms_mutex.h"
 
+#define CANLOG_VFS_BLOCKS         2       // Number of write blocks (double buffering)
+#define CANLOG_VFS_BLOCKSIZE      4096    // Default block size [bytes]
+#define CANLOG_VFS_BLOCKSIZE_MIN  512
+#define CANLOG_VFS_BLOCKSIZE_MAX  32768
+#define CANLOG_VFS_BLOCKWAIT      1000    // Max time to wait for a free block [ms]
+#define CANLOG_VFS_FSYNC          10      // Default fsync interval [s]
+#define CANLOG_VFS_REOPEN         10      // Retry interval after a failed file open [s]
+#define CANLOG_VFS_FLUSH          5       // Max age of a partially filled block [s]
 
+/**
+ * canlog_vfs_conn: log file writer
+ *
+ * The logger task collects the formatted messages in RAM blocks, full blocks
+ * are written by a separate writer task, so SD card latencies do not stall
+ * the logger. Partially filled blocks are submitted on Flush() when they are
+ * CANLOG_VFS_FLUSH seconds old and the writer is idle, so low traffic does not
+ * cause small writes. The logger task also calls Flush() on a quiet bus.
+ * The writer syncs the file every fsync interval and rotates the log file by
+ * size and/or age, adding a sequence number to the file name. If opening the
+ * next file fails, the writer retries every CANLOG_VFS_REOPEN seconds.
+ *
+ * Config (param "can"):
+ *  log.vfs.blocksize     Block size in bytes (default 4096)
+ *  log.vfs.fsync         Sync interval in seconds (default 10, 0 = on close only)
+ *  log.vfs.rotate.size   Rotate at file size in kB (default 0 = off)
+ *  log.vfs.rotate.time   Rotate at file age in minutes (default 0 = off)
+ */
 class canlog_vfs_conn: public canlogconnection
   {
   public:
@@ -38,12 +68,73 @@ class canlog_vfs_conn: public canlogconnection
     virtual ~canlog_vfs_conn();
 
   public:
-    virtual void OutputMsg(CAN_log_message_t& msg, std::string &result);
+    virtual void OutputMsg(CAN_log_message_t& msg, const uint8_t* data, size_t len);
+    virtual void Flush();
+    virtual std::string GetSummary();
     virtual std::string GetStats();
 
   public:
-    FILE*               m_file;
-    size_t              m_file_size;
+    bool Open(std::string path);
+    void Stop();
+
+  protected:
+    typedef struct
+      {
+      uint8_t*          data;
+      size_t            len;
+      } block_t;
+
+    bool AcquireBlock();
+    void SubmitBlock();
+    static void WriterTask(void *context);
+    void WriterLoop();
+    std::string NextFileName();
+    bool OpenFile();
+    void ReopenFile();
+    void CloseFile();
+    void WriteBlock(block_t& block);
+
+  public:
+    size_t              m_file_size;          // Total bytes logged
+
+  protected:
+    // Configuration:
+    std::string         m_path;
+    size_t              m_blocksize;
+    uint32_t            m_fsync_interval;     // seconds
+    uint32_t            m_rotate_size;        // bytes
+    uint32_t            m_rotate_time;        // seconds
+
+    // Buffers:
+    uint8_t*            m_blocks[CANLOG_VFS_BLOCKS];
+    QueueHandle_t       m_freequeue;
+    QueueHandle_t       m_fullqueue;
+    uint8_t*            m_fill;
+    size_t              m_filllen;
+    uint32_t            m_fill_started;       // monotonictime of block start
+    std::atomic<size_t> m_pending;
+
+    // Writer:
+    TaskHandle_t        m_task;
+    SemaphoreHandle_t   m_done;
+    OvmsMutex           m_filemutex;
+    std::string         m_filename;
+    int                 m_fd;
+    uint32_t            m_sequence;
+    uint32_t            m_file_opened;
+    size_t              m_file_written;
+    uint32_t            m_file_synced;
+    bool                m_file_dirty;
+    uint32_t            m_reopen_due;         // monotonictime of next open retry, 0 = none
+
+    // Statistics:
+    size_t              m_hiwater;
+    uint32_t            m_blocked_count;
+    int64_t             m_blocked_time;       // us
+    uint64_t            m_written;
+    int64_t             m_write_time;         // us
+    uint32_t            m_write_errors;
+    uint32_t            m_files;
   };
 
 
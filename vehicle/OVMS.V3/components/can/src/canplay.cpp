@@ -35,6 +35,8 @@ static const char *TAG = "canplay";
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <esp_timer.h>
+#include "rom/ets_sys.h"
 #include "ovms_config.h"
 #include "ovms_command.h"
 #include "ovms_events.h"
@@ -124,7 +126,7 @@ void can_play_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc
     }
   }
 
-void can_play_speed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+static void can_play_apply(OvmsWriter* writer, const char* id, std::function<void(canplay*)> apply)
   {
   if (!MyCan.HasPlayer())
     {
@@ -132,34 +134,64 @@ void can_play_speed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
     return;
     }
 
-  if (argc==2)
+  if (id)
     {
-    canplay* cl = MyCan.GetPlayer(atoi(argv[1]));
+    canplay* cl = MyCan.GetPlayer(atoi(id));
     if (cl)
       {
-      cl->SetSpeed(atoi(argv[0]));
+      apply(cl);
       writer->printf("CAN playing active: %s\n  Statistics: %s\n", cl->GetInfo().c_str(), cl->GetStats().c_str());
       }
     else
       {
       writer->puts("Error: Cannot find specified can player");
       }
-    return;
     }
   else
     {
-    // Set the speed for all players
+    // Apply to all players
     OvmsMutexLock lock(&MyCan.m_playermap_mutex);
     for (can::canplay_map_t::iterator it=MyCan.m_playermap.begin(); it!=MyCan.m_playermap.end(); ++it)
       {
       canplay* cl = it->second;
-      cl->SetSpeed(atoi(argv[0]));
+      apply(cl);
       writer->printf("CAN player #%" PRId32 ": %s\n  Statistics: %s\n",
         it->first, cl->GetInfo().c_str(), cl->GetStats().c_str());
       }
     }
   }
 
+void can_play_speed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  char* end;
+  float speed = strtof(argv[0], &end);
+  if (*end || speed < 0)
+    {
+    writer->puts("Error: invalid speed");
+    return;
+    }
+  can_play_apply(writer, (argc==2) ? argv[1] : NULL, [speed](canplay* cl) { cl->SetSpeed(speed); });
+  }
+
+void can_play_loop(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  bool loop = (strcmp(cmd->GetName(), "on") == 0);
+  can_play_apply(writer, (argc==1) ? argv[0] : NULL, [loop](canplay* cl) { cl->SetLoop(loop); });
+  }
+
+void can_play_seek(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  char* end;
+  float secs = strtof(argv[0], &end);
+  if (*end || secs < 0)
+    {
+    writer->puts("Error: invalid time");
+    return;
+    }
+  uint32_t ms = secs * 1000;
+  can_play_apply(writer, (argc==2) ? argv[1] : NULL, [ms](canplay* cl) { cl->Seek(ms); });
+  }
+
 ////////////////////////////////////////////////////////////////////////
 // CAN Play System initialisation
 ////////////////////////////////////////////////////////////////////////
@@ -182,7 +214,13 @@ OvmsCanPlayInit::OvmsCanPlayInit()
 
   OvmsCommand* cmd_canplay = cmd_can->RegisterCommand("play", "CAN play framework");
   cmd_canplay->RegisterCommand("stop", "Stop playing", can_play_stop,"[<id>]",0,1);
-  cmd_canplay->RegisterCommand("speed", "Set playback speed", can_play_speed,"<speed> [<id>]",1,2);
+  cmd_canplay->RegisterCommand("speed", "Set playback speed", can_play_speed,"<speed> [<id>]\n"
+    "<speed>: time scale factor, e.g. 0.5 = half speed, 0 = as fast as possible",1,2);
+  OvmsCommand* cmd_canplay_loop = cmd_canplay->RegisterCommand("loop", "Restart playing at end of input");
+  cmd_canplay_loop->RegisterCommand("on", "Enable looping", can_play_loop,"[<id>]",0,1);
+  cmd_canplay_loop->RegisterCommand("off", "Disable looping", can_play_loop,"[<id>]",0,1);
+  cmd_canplay->RegisterCommand("seek", "Seek to log time", can_play_seek,"<seconds> [<id>]\n"
+    "<seconds>: log time offset from the first frame",1,2);
   cmd_canplay->RegisterCommand("status", "Playing status", can_play_status,"[<id>]",0,1);
   cmd_canplay->RegisterCommand("list", "Playing list", can_play_list);
   cmd_canplay->RegisterCommand("start", "CAN play start framework");
@@ -197,21 +235,33 @@ canplay::canplay(const char* type, std::string format, canformat::canformat_serv
   m_type = type;
   m_format = format;
   m_formatter = MyCanFormatFactory.NewFormat(format.c_str());
-  m_formatter->SetServeMode(mode);
+  if (m_formatter) m_formatter->SetServeMode(mode);
   m_filter = NULL;
   m_speed = 1;
+  m_loop = false;
+
+  m_task = NULL;
+  m_done = xSemaphoreCreateBinary();
+  m_stopping = false;
+  m_resync = false;
+  m_seek = -1;
+  m_finished = false;
+  m_position = 0;
 
   m_msgcount = 0;
-  xTaskCreatePinnedToCore(PlayTask, "OVMS CanPlay", 4096, (void*)this, 10, &m_task, CORE(1));
+  m_filtercount = 0;
+  m_loopcount = 0;
+  m_resynccount = 0;
+  m_starttime = 0;
+  m_endtime = 0;
+  m_jittercount = 0;
+  m_jittersum = 0;
+  m_jittermax = 0;
   }
 
 canplay::~canplay()
   {
-  if (m_task)
-    {
-    vTaskDelete(m_task);
-    m_task = NULL;
-    }
+  Stop();
 
   if (m_formatter)
     {
@@ -224,23 +274,233 @@ canplay::~canplay()
     delete m_filter;
     m_filter = NULL;
     }
+
+  vSemaphoreDelete(m_done);
+  }
+
+/**
+ * Start: start the play task
+ *  Called after the player has been fully constructed & configured.
+ */
+void canplay::Start()
+  {
+  if (m_task || !m_formatter)
+    return;
+  m_stopping = false;
+  xTaskCreatePinnedToCore(PlayTask, "OVMS CanPlay", 4096, (void*)this, 10, &m_task, CORE(1));
+  }
+
+/**
+ * Stop: stop the play task
+ *  Sub classes need to call this before destroying their input.
+ *  The task is never deleted from outside, as it may hold the input mutex.
+ */
+void canplay::Stop()
+  {
+  if (!m_task)
+    return;
+  m_stopping = true;
+  xTaskNotifyGive(m_task);
+  while (xSemaphoreTake(m_done, pdMS_TO_TICKS(3000)) != pdTRUE)
+    {
+    ESP_LOGW(TAG, "Still waiting for play task to stop");
+    xTaskNotifyGive(m_task);
+    }
+  m_task = NULL;
   }
 
 void canplay::PlayTask(void *context)
   {
-//  canplay* me = (canplay*) context;
+  canplay* me = (canplay*) context;
+  me->Play();
+  xSemaphoreGive(me->m_done);
+  vTaskDelete(NULL);
+  }
 
-//  CAN_log_message_t msg;
-//  while (me->InputMsg(&msg))
-//    {
-//    vTaskDelay(pdMS_TO_TICKS(1000));
-//    }
+/**
+ * Wait: sleep until a point in time (esp_timer), spin on the remainder
+ *  Returns false if woken early by a control change.
+ */
+bool canplay::Wait(int64_t due)
+  {
+  const int64_t tick_us = portTICK_PERIOD_MS * 1000;
+  int64_t wait = due - esp_timer_get_time();
+  while (wait >= tick_us)
+    {
+    if (ulTaskNotifyTake(pdTRUE, wait / tick_us) > 0)
+      return false;
+    wait = due - esp_timer_get_time();
+    }
+  if (wait > 0 && wait <= CANPLAY_SPINWAIT_US)
+    ets_delay_us(wait);
+  return true;
+  }
 
-//  me->Close();
-  while(1)
+void canplay::Play()
+  {
+  CAN_log_message_t msg;
+  int64_t first = -1;             // Log time of first frame [us]
+  int64_t last = 0;               // Log time of previous frame [us]
+  int64_t anchor_log = 0;         // Schedule anchor: log time [us]
+  int64_t anchor_sys = 0;         // Schedule anchor: system time [us]
+  bool anchored = false;
+  bool reopened = false;
+
+  m_starttime = esp_timer_get_time();
+  m_endtime = 0;
+
+  while (!m_stopping)
     {
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    if (!IsOpen())
+      {
+      // Input not available (e.g. SD unmounted), wait for reopen:
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+      reopened = true;
+      continue;
+      }
+
+    // Rewind on reopen, seek backwards, or loop (if the last pass had any frames):
+    int64_t seek = GetSeek();
+    if (reopened || (seek >= 0 && seek < m_position)
+        || (m_finished && (seek >= 0 || (m_loop && first >= 0))))
+      {
+      if (!Rewind())
+        {
+        ESP_LOGE(TAG, "Cannot rewind input");
+        reopened = false;
+        ClearSeek(seek);
+        m_finished = true;
+        first = -1;
+        continue;
+        }
+      if (m_finished && seek < 0)
+        m_loopcount++;
+      reopened = false;
+      m_finished = false;
+      SetPosition(0);
+      m_endtime = 0;
+      first = -1;
+      anchored = false;
+      }
+    else if (m_finished)
+      {
+      // Wait for a seek, loop or stop request:
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+      }
+
+    if (!InputMsg(&msg))
+      {
+      if (m_stopping || !IsOpen())
+        continue;
+      seek = GetSeek();
+      if (seek >= 0)
+        {
+        ESP_LOGW(TAG, "Seek target beyond end of input");
+        ClearSeek(seek);
+        }
+      m_finished = true;
+      m_endtime = esp_timer_get_time();
+      if (!m_loop)
+        ESP_LOGI(TAG, "Playing finished: %s", GetStats().c_str());
+      continue;
+      }
+
+    if (msg.type != CAN_LogFrame_RX || msg.frame.origin == NULL)
+      continue;
+
+    int64_t ts = (int64_t)msg.timestamp.tv_sec * 1000000 + msg.timestamp.tv_usec;
+    if (first < 0)
+      first = ts;
+    if (ts < last)
+      anchored = false;   // time went backwards, e.g. concatenated logs
+    last = ts;
+    SetPosition(ts - first);
+
+    if (seek >= 0)
+      {
+      if (m_position < seek)
+        continue;
+      ClearSeek(seek);
+      anchored = false;
+      }
+
+    if (m_filter && !m_filter->IsFiltered(&msg.frame))
+      {
+      m_filtercount++;
+      continue;
+      }
+
+    if (m_speed > 0)
+      {
+      int64_t due;
+      for (;;)
+        {
+        // (Re)schedule, a speed change while waiting takes effect immediately:
+        float speed = m_speed;
+        if (!anchored || m_resync)
+          {
+          anchor_log = ts;
+          anchor_sys = esp_timer_get_time();
+          anchored = true;
+          m_resync = false;
+          }
+        due = (speed > 0) ? anchor_sys + (int64_t)((ts - anchor_log) / speed) : 0;
+        if (Wait(due) || m_stopping || GetSeek() >= 0)
+          break;
+        }
+      if (m_stopping || GetSeek() >= 0)
+        continue;
+      if (due)
+        {
+        int64_t now = esp_timer_get_time();
+        int64_t dev = now - due;
+        if (dev > CANPLAY_MAXLATE_US)
+          {
+          // Falling behind (e.g. slow input), don't try to catch up in a burst:
+          anchor_log = ts;
+          anchor_sys = now;
+          m_resynccount++;
+          }
+        else
+          {
+          uint32_t absdev = (dev < 0) ? -dev : dev;
+          m_jittercount++;
+          m_jittersum += absdev;
+          if (absdev > m_jittermax)
+            m_jittermax = absdev;
+          }
+        }
+      }
+
+    switch (m_formatter->GetServeMode())
+      {
+      case canformat::Simulate:
+        MyCan.IncomingFrame(&msg.frame);
+        break;
+      case canformat::Transmit:
+        msg.frame.origin->Write(&msg.frame, pdMS_TO_TICKS(500));
+        break;
+      default:
+        break;
+      }
+    m_msgcount++;
     }
+
+  m_endtime = esp_timer_get_time();
+  }
+
+/**
+ * ResetFormatter: drop input buffered by the formatter (on rewind)
+ */
+void canplay::ResetFormatter()
+  {
+  if (!m_formatter)
+    return;
+  canformat::canformat_serve_mode_t mode = m_formatter->GetServeMode();
+  delete m_formatter;
+  m_formatter = MyCanFormatFactory.NewFormat(m_format.c_str());
+  if (m_formatter) m_formatter->SetServeMode(mode);
   }
 
 const char* canplay::GetType()
@@ -253,9 +513,23 @@ const char* canplay::GetFormat()
   return m_format.c_str();
   }
 
-void canplay::SetSpeed(uint32_t speed)
+void canplay::SetSpeed(float speed)
   {
   m_speed = speed;
+  m_resync = true;
+  if (m_task) xTaskNotifyGive(m_task);
+  }
+
+void canplay::SetLoop(bool loop)
+  {
+  m_loop = loop;
+  if (m_task) xTaskNotifyGive(m_task);
+  }
+
+void canplay::Seek(uint32_t ms)
+  {
+  SetSeek((int64_t)ms * 1000);
+  if (m_task) xTaskNotifyGive(m_task);
   }
 
 bool canplay::InputMsg(CAN_log_message_t* msg)
@@ -263,6 +537,11 @@ bool canplay::InputMsg(CAN_log_message_t* msg)
   return false;
   }
 
+bool canplay::Rewind()
+  {
+  return false;
+  }
+
 std::string canplay::GetInfo()
   {
   std::ostringstream buf;
@@ -273,7 +552,12 @@ std::string canplay::GetInfo()
     buf << "(" << m_formatter->GetServeModeName() << ")";
     }
 
-  buf << " Speed:" << m_speed << "x";
+  if (m_speed > 0)
+    buf << " Speed:" << m_speed << "x";
+  else
+    buf << " Speed:max";
+  if (m_loop)
+    buf << " Loop:on";
 
   if (m_filter)
     {
@@ -291,7 +575,24 @@ std::string canplay::GetStats()
   {
   std::ostringstream buf;
 
-  buf << "total messages: " << m_msgcount;
+  int64_t elapsed = (m_endtime ? m_endtime : esp_timer_get_time()) - m_starttime;
+  buf << "total messages: " << m_msgcount
+      << ", filtered: " << m_filtercount
+      << std::fixed << std::setprecision(1)
+      << ", rate: " << ((m_starttime && elapsed > 0) ? (double)m_msgcount * 1000000 / elapsed : 0) << " fps"
+      << ", position: " << (double)GetPosition() / 1000000 << " s";
+  if (m_jittercount)
+    {
+    buf << std::setprecision(2)
+        << ", jitter avg/max: " << (double)m_jittersum / m_jittercount / 1000
+        << "/" << (double)m_jittermax / 1000 << " ms";
+    }
+  if (m_loopcount)
+    buf << ", loops: " << m_loopcount;
+  if (m_resynccount)
+    buf << ", resyncs: " << m_resynccount;
+  if (m_finished)
+    buf << ", finished";
 
   return buf.str();
   }
@@ -31,8 +31,18 @@
 #include "can.h"
 #include "canformat.h"
 
+#define CANPLAY_SPINWAIT_US     1000      // Busy wait for frames due within this time [us]
+#define CANPLAY_MAXLATE_US      1000000   // Resync the schedule when falling behind by more [us]
+
 /**
  * canplay is the general interface and base implementation for all can players.
+ *
+ * The play task reads messages via InputMsg() and injects RX frames into
+ * MyCan as if received (or transmits them in transmit mode). The original
+ * inter-frame timing is reproduced by scheduling each frame relative to an
+ * anchor (log time, system time), scaled by the speed factor. Speed 0 plays
+ * as fast as possible. The anchor is reset on start, speed change, seek,
+ * loop restart, and when the log time goes backwards.
  */
 class canplay : public InternalRamAllocated
   {
@@ -42,12 +52,21 @@ class canplay : public InternalRamAllocated
 
   public:
     static void PlayTask(void* context);
+    void Start();
+    void Stop();
+
+  protected:
+    void Play();
+    bool Wait(int64_t due);
+    void ResetFormatter();
 
   public:
     const char* GetType();
     const char* GetFormat();
     virtual std::string GetStats();
-    void SetSpeed(uint32_t speed);
+    void SetSpeed(float speed);
+    void SetLoop(bool loop);
+    void Seek(uint32_t ms);
 
   public:
     // Methods expected to be implemented by sub-classes
@@ -56,6 +75,7 @@ class canplay : public InternalRamAllocated
     virtual bool IsOpen() = 0;
     virtual std::string GetInfo();
     virtual bool InputMsg(CAN_log_message_t* msg);
+    virtual bool Rewind();
 
   public:
     virtual void SetFilter(canfilter* filter);
@@ -64,13 +84,39 @@ class canplay : public InternalRamAllocated
   public:
     const char*         m_type;
     std::string         m_format;
-    uint32_t            m_speed;
+    float               m_speed;                // Speed factor, 0 = as fast as possible
+    bool                m_loop;                 // Restart at end of input
     canformat*          m_formatter;
     canfilter*          m_filter;
 
   public:
     TaskHandle_t        m_task;
-    uint32_t            m_msgcount;
+    SemaphoreHandle_t   m_done;                 // Given by the play task on exit
+    volatile bool       m_stopping;
+    volatile bool       m_resync;               // Reset schedule anchor
+    bool                m_finished;             // End of input reached
+
+  protected:
+    // 64 bit values shared with the play task (no 64 bit atomics on ESP-IDF 3.3):
+    portMUX_TYPE        m_statelock = portMUX_INITIALIZER_UNLOCKED;
+    int64_t             m_seek;                 // Seek target [us from first frame], -1 = none
+    int64_t             m_position;             // Log time of current frame [us from first frame]
+    int64_t GetSeek()                   { portENTER_CRITICAL(&m_statelock); int64_t v = m_seek; portEXIT_CRITICAL(&m_statelock); return v; }
+    void SetSeek(int64_t v)             { portENTER_CRITICAL(&m_statelock); m_seek = v; portEXIT_CRITICAL(&m_statelock); }
+    void ClearSeek(int64_t v)           { portENTER_CRITICAL(&m_statelock); if (m_seek == v) m_seek = -1; portEXIT_CRITICAL(&m_statelock); }
+    int64_t GetPosition()               { portENTER_CRITICAL(&m_statelock); int64_t v = m_position; portEXIT_CRITICAL(&m_statelock); return v; }
+    void SetPosition(int64_t v)         { portENTER_CRITICAL(&m_statelock); m_position = v; portEXIT_CRITICAL(&m_statelock); }
+
+  public:
+    uint32_t            m_msgcount;             // Frames played
+    uint32_t            m_filtercount;          // Frames filtered
+    uint32_t            m_loopcount;
+    uint32_t            m_resynccount;          // Schedule resyncs due to falling behind
+    int64_t             m_starttime;            // Statistics period start [us]
+    int64_t             m_endtime;              // Statistics period end [us], 0 = running
+    uint32_t            m_jittercount;          // Timed frames
+    uint64_t            m_jittersum;            // Sum of absolute timing deviations [us]
+    uint32_t            m_jittermax;            // Max absolute timing deviation [us]
   };
 
 #endif // __CANPLAY_H__
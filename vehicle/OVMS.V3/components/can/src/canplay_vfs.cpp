@@ -91,6 +91,8 @@ canplay_vfs::canplay_vfs(std::string path, std::string format)
   {
   m_file = NULL;
   m_path = path;
+  m_bufpos = m_buflen = 0;
+  m_hasmore = false;
   using std::placeholders::_1;
   using std::placeholders::_2;
   MyEvents.RegisterEvent(IDTAG, "sd.mounted", std::bind(&canplay_vfs::MountListener, this, _1, _2));
@@ -100,6 +102,7 @@ canplay_vfs::canplay_vfs(std::string path, std::string format)
 canplay_vfs::~canplay_vfs()
   {
   MyEvents.DeregisterEvent(IDTAG);
+  Stop();
 
   if (m_file != NULL)
     {
@@ -109,6 +112,7 @@ canplay_vfs::~canplay_vfs()
 
 bool canplay_vfs::Open()
   {
+  OvmsMutexLock lock(&m_mutex);
   if (m_file)
     {
     fclose(m_file);
@@ -130,6 +134,8 @@ bool canplay_vfs::Open()
 #endif // #ifdef CONFIG_OVMS_COMP_SDCARD
 
   m_file = fopen(m_path.c_str(), "r");
+  m_bufpos = m_buflen = 0;
+  m_hasmore = false;
   if (!m_file)
     {
     ESP_LOGE(TAG, "Error: Can't read from '%s'", m_path.c_str());
@@ -143,6 +149,7 @@ bool canplay_vfs::Open()
 
 void canplay_vfs::Close()
   {
+  OvmsMutexLock lock(&m_mutex);
   if (m_file)
     {
     fclose(m_file);
@@ -173,10 +180,51 @@ void canplay_vfs::MountListener(std::string event, void* data)
     Open();
   }
 
+/**
+ * InputMsg: read the next message from the file
+ *  Feeds the file through the formatter's put() in chunks. Input buffered
+ *  by the formatter is drained before adding more, so its buffer can't
+ *  overflow. Returns false at end of file or if the file has been closed.
+ */
 bool canplay_vfs::InputMsg(CAN_log_message_t* msg)
   {
+  OvmsMutexLock lock(&m_mutex);
   if (m_file == NULL) return false;
   if (m_formatter == NULL) return false;
 
-  return false;
+  for (;;)
+    {
+    if (!m_hasmore && m_bufpos == m_buflen)
+      {
+      m_bufpos = 0;
+      m_buflen = fread(m_buf, 1, sizeof(m_buf), m_file);
+      if (m_buflen == 0)
+        return false;
+      }
+
+    memset(msg, 0, sizeof(*msg));
+    bool hasmore = false;
+    size_t len = m_hasmore ? 0 : m_buflen - m_bufpos;
+    size_t used = m_formatter->put(msg, m_buf + m_bufpos, len, &hasmore);
+    m_bufpos += used;
+    m_hasmore = hasmore;
+    if (msg->frame.origin != NULL)
+      return true;
+    if (used == 0 && len > 0 && !hasmore)
+      {
+      ESP_LOGE(TAG, "Formatter stalled, stopping input from '%s'", m_path.c_str());
+      return false;
+      }
+    }
+  }
+
+bool canplay_vfs::Rewind()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  if (m_file == NULL) return false;
+  if (fseek(m_file, 0, SEEK_SET) != 0) return false;
+  m_bufpos = m_buflen = 0;
+  m_hasmore = false;
+  ResetFormatter();
+  return (m_formatter != NULL);
   }
@@ -29,6 +29,9 @@
 #define __CANPLAY_VFS_H__
 
 #include "canplay.h"
+#include "ovms_mutex.h"
+
+#define CANPLAY_VFS_BUFSIZE     512       // File read buffer size [bytes]
 
 class canplay_vfs : public canplay
   {
@@ -44,6 +47,7 @@ class canplay_vfs : public canplay
 
   public:
     virtual bool InputMsg(CAN_log_message_t* msg);
+    virtual bool Rewind();
 
   public:
     virtual void MountListener(std::string event, void* data);
@@ -51,6 +55,11 @@ class canplay_vfs : public canplay
   public:
     std::string         m_path;
     FILE*               m_file;
+    OvmsMutex           m_mutex;                // Protects m_file (mount events vs. play task)
+    uint8_t             m_buf[CANPLAY_VFS_BUFSIZE];
+    size_t              m_bufpos;
+    size_t              m_buflen;
+    bool                m_hasmore;              // Formatter has buffered input left
   };
 
 #endif // __CANPLAY_VFS_H__
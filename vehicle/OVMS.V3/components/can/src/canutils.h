@@ -36,7 +36,9 @@
 #ifndef __CAN_UTILS_H__
 #define __CAN_UTILS_H__
 
+#include <stdlib.h>
 #include "can.h"
+#include "ovms_malloc.h"
 
 /**
  * canbitset<StoreType>: CAN data packed bit extraction utility
@@ -80,6 +82,204 @@ class canbitset
   };
 
 
+/**
+ * canidmap<T>: CAN message ID to object pointer dispatch table
+ *  Keys are the message ID for standard frames and the message ID with
+ *  bit 31 set for extended frames (DBC convention).
+ *  Standard IDs are resolved by a direct 2048 entry table, all other keys
+ *  by an open addressing hash table (linear probing, load factor <= 50%).
+ *  Both tables are allocated on first use. Find() does no allocation.
+ *  Not thread safe for concurrent updates, lookups are safe while no
+ *  update is running.
+ */
+#define CANIDMAP_STD_SIZE       2048
+#define CANIDMAP_EXT_INITSIZE   16
+#define CANIDMAP_EXT_FLAG       0x80000000
+#define CANIDMAP_EMPTY          0xffffffff
+
+template <typename T>
+class canidmap
+  {
+  private:
+    struct ext_entry
+      {
+      uint32_t key;
+      T* value;
+      };
+
+  private:
+    T** m_std;
+    ext_entry* m_ext;
+    uint32_t m_ext_size;          // power of 2
+    uint32_t m_ext_count;
+    uint32_t m_count;
+
+  public:
+    canidmap()
+      : m_std(NULL), m_ext(NULL), m_ext_size(0), m_ext_count(0), m_count(0)
+      {
+      }
+    ~canidmap()
+      {
+      Clear();
+      }
+
+  public:
+    static inline uint32_t Key(CAN_frame_format_t format, uint32_t id)
+      {
+      return (format == CAN_frame_ext) ? (id | CANIDMAP_EXT_FLAG) : (id & ~CANIDMAP_EXT_FLAG);
+      }
+
+    inline T* Find(uint32_t key) const
+      {
+      if (key < CANIDMAP_STD_SIZE)
+        return m_std ? m_std[key] : NULL;
+      if (m_ext_count == 0)
+        return NULL;
+      uint32_t mask = m_ext_size - 1;
+      for (uint32_t i = Hash(key) & mask; ; i = (i+1) & mask)
+        {
+        if (m_ext[i].key == key) return m_ext[i].value;
+        if (m_ext[i].key == CANIDMAP_EMPTY) return NULL;
+        }
+      }
+
+    inline T* Find(CAN_frame_format_t format, uint32_t id) const
+      {
+      return Find(Key(format, id));
+      }
+
+    bool Set(uint32_t key, T* value)
+      {
+      if (value == NULL)
+        {
+        Remove(key);
+        return true;
+        }
+      if (key < CANIDMAP_STD_SIZE)
+        {
+        if (!m_std)
+          {
+          m_std = (T**) ExternalRamCalloc(CANIDMAP_STD_SIZE, sizeof(T*));
+          if (!m_std) return false;
+          }
+        if (!m_std[key]) m_count++;
+        m_std[key] = value;
+        return true;
+        }
+      if (key == CANIDMAP_EMPTY)
+        return false;
+      if ((m_ext_count+1)*2 > m_ext_size &&
+          !Resize(m_ext_size ? m_ext_size*2 : CANIDMAP_EXT_INITSIZE))
+        return false;
+      uint32_t mask = m_ext_size - 1;
+      uint32_t i = Hash(key) & mask;
+      while (m_ext[i].key != CANIDMAP_EMPTY && m_ext[i].key != key)
+        i = (i+1) & mask;
+      if (m_ext[i].key == CANIDMAP_EMPTY)
+        {
+        m_ext[i].key = key;
+        m_ext_count++;
+        m_count++;
+        }
+      m_ext[i].value = value;
+      return true;
+      }
+
+    void Remove(uint32_t key)
+      {
+      if (key < CANIDMAP_STD_SIZE)
+        {
+        if (m_std && m_std[key])
+          {
+          m_std[key] = NULL;
+          m_count--;
+          }
+        return;
+        }
+      if (m_ext_count == 0)
+        return;
+      uint32_t mask = m_ext_size - 1;
+      uint32_t i = Hash(key) & mask;
+      while (m_ext[i].key != key)
+        {
+        if (m_ext[i].key == CANIDMAP_EMPTY) return;
+        i = (i+1) & mask;
+        }
+      // Backward shift deletion: move following cluster entries up
+      // if their home slot allows it, so no tombstones are needed.
+      for (uint32_t j = (i+1) & mask; m_ext[j].key != CANIDMAP_EMPTY; j = (j+1) & mask)
+        {
+        uint32_t home = Hash(m_ext[j].key) & mask;
+        if (((j - home) & mask) >= ((j - i) & mask))
+          {
+          m_ext[i] = m_ext[j];
+          i = j;
+          }
+        }
+      m_ext[i].key = CANIDMAP_EMPTY;
+      m_ext[i].value = NULL;
+      m_ext_count--;
+      m_count--;
+      }
+
+    void Clear()
+      {
+      if (m_std) free(m_std);
+      if (m_ext) free(m_ext);
+      m_std = NULL;
+      m_ext = NULL;
+      m_ext_size = m_ext_count = m_count = 0;
+      }
+
+    uint32_t GetCount() const
+      {
+      return m_count;
+      }
+
+    size_t GetMemoryUsage() const
+      {
+      return (m_std ? CANIDMAP_STD_SIZE*sizeof(T*) : 0) + m_ext_size*sizeof(ext_entry);
+      }
+
+  private:
+    static inline uint32_t Hash(uint32_t key)
+      {
+      // Fibonacci hashing, the table mask takes the low bits:
+      key *= 0x9E3779B1;
+      return key ^ (key >> 16);
+      }
+
+    bool Resize(uint32_t size)
+      {
+      ext_entry* table = (ext_entry*) ExternalRamMalloc(size * sizeof(ext_entry));
+      if (!table) return false;
+      for (uint32_t i = 0; i < size; i++)
+        {
+        table[i].key = CANIDMAP_EMPTY;
+        table[i].value = NULL;
+        }
+      uint32_t mask = size - 1;
+      for (uint32_t j = 0; j < m_ext_size; j++)
+        {
+        if (m_ext[j].key == CANIDMAP_EMPTY) continue;
+        uint32_t i = Hash(m_ext[j].key) & mask;
+        while (table[i].key != CANIDMAP_EMPTY)
+          i = (i+1) & mask;
+        table[i] = m_ext[j];
+        }
+      if (m_ext) free(m_ext);
+      m_ext = table;
+      m_ext_size = size;
+      return true;
+      }
+
+  private:
+    canidmap(const canidmap&) = delete;
+    canidmap& operator=(const canidmap&) = delete;
+  };
+
+
 // Helper macros for filling out the CAN frame 
 
 #define FRAME_FILL_0(frame) ;
@@ -44,7 +44,7 @@ CANopen::CANopen()
   ESP_LOGI(TAG, "Initialising CANopen (7000)");
 
   m_rxtask = NULL;
-  m_rxqueue = NULL;
+  m_rxreader = NULL;
 
   for (int i=0; i < CAN_INTERFACE_CNT; i++)
     m_worker[i] = NULL;
@@ -87,8 +87,8 @@ CANopen::~CANopen()
     }
   if (m_rxtask)
     {
-    vQueueDelete(m_rxqueue);
     vTaskDelete(m_rxtask);
+    delete m_rxreader;
     }
   }
 
@@ -109,7 +109,7 @@ void CANopen::CanRxTask()
 
   while(1)
     {
-    if (xQueueReceive(m_rxqueue, &frame, (portTickType)portMAX_DELAY) == pdTRUE)
+    if (m_rxreader->Read(&frame))
       {
       for (int i=0; i < CAN_INTERFACE_CNT; i++)
         {
@@ -139,10 +139,9 @@ CANopenWorker* CANopen::Start(canbus* bus)
   // start CAN rx task:
   if (m_rxtask == NULL)
     {
-    m_rxqueue = xQueueCreate(20, sizeof(CAN_frame_t));
+    m_rxreader = new CanRingReader("canopen");
     xTaskCreatePinnedToCore(CANopenRxTask, "OVMS COrx",
       CONFIG_OVMS_COMP_CANOPEN_RX_STACK, (void*)this, 15, &m_rxtask, CORE(0));
-    MyCan.RegisterListener(m_rxqueue);
     }
 
   // start worker:
@@ -185,10 +184,9 @@ bool CANopen::Stop(canbus* bus)
       if (--m_workercnt == 0)
         {
         // last worker stopped, stop CAN rx task:
-        MyCan.DeregisterListener(m_rxqueue);
-        vQueueDelete(m_rxqueue);
         vTaskDelete(m_rxtask);
-        m_rxqueue = NULL;
+        delete m_rxreader;
+        m_rxreader = NULL;
         m_rxtask = NULL;
         }
 
@@ -29,6 +29,7 @@
 #include <forward_list>
 
 #include "can.h"
+#include "can_ring.h"
 
 #include "ovms_log.h"
 #include "ovms_config.h"
@@ -413,7 +414,7 @@ class CANopen final
     static void shell_scan(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
 
   public:
-    QueueHandle_t         m_rxqueue;    // CAN rx queue
+    CanRingReader*        m_rxreader;   // CAN frame ring reader
     TaskHandle_t          m_rxtask;     // CAN rx task
 
     CANopenWorker*        m_worker[CAN_INTERFACE_CNT];
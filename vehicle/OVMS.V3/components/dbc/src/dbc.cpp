@@ -612,7 +612,7 @@ dbcMultiplexor_t::dbcMultiplexor_t()
 // dbcSignal
 
 dbcSignal::dbcSignal()
-  : m_start_bit(0), m_signal_size(0),
+  : m_message(nullptr), m_start_bit(0), m_signal_size(0),
   m_byte_order(DBC_BYTEORDER_BIG_ENDIAN),
   m_value_type(DBC_VALUETYPE_UNSIGNED),
   m_metric_unit(Native),
@@ -621,7 +621,7 @@ dbcSignal::dbcSignal()
   }
 
 dbcSignal::dbcSignal(std::string name)
-  : m_start_bit(0), m_signal_size(0),
+  : m_message(nullptr), m_start_bit(0), m_signal_size(0),
   m_byte_order(DBC_BYTEORDER_BIG_ENDIAN),
   m_value_type(DBC_VALUETYPE_UNSIGNED),
   m_metric_unit(Native),
@@ -639,6 +639,13 @@ dbcSignal::~dbcSignal()
     }
   }
 
+/// Notify the owning message of a layout or mux change
+void dbcSignal::Changed()
+  {
+  if (m_message != nullptr)
+    m_message->InvalidateDecodePlan();
+  }
+
 void dbcSignal::AddReceiver(std::string receiver)
   {
   m_receivers.push_back(receiver);
@@ -769,6 +776,7 @@ void dbcSignal::SetMultiplexSource()
     default:
       m_mux.multiplexed = DBC_MUX_MULTIPLEXSRC;
     }
+  Changed();
   }
 
 bool dbcSignal::IsMultiplexSwitchvalue(uint32_t value) const
@@ -785,6 +793,7 @@ bool dbcSignal::IsMultiplexSwitchvalue(uint32_t value) const
 
 bool dbcSignal::SetMultiplexed(const uint32_t switchvalue)
   {
+  Changed();
   switch (m_mux.multiplexed)
     {
     case DBC_MUX_MULTIPLEXED_MULTIPLEXSRC:
@@ -808,6 +817,7 @@ bool dbcSignal::SetMultiplexed(const uint32_t switchvalue)
 void dbcSignal::SetMultiplexSource(dbcSignal* source)
   {
   m_mux.source = source;
+  Changed();
   const char *type;
   switch (m_mux.multiplexed)
     {
@@ -835,10 +845,12 @@ void dbcSignal::SetMultiplexSource(dbcSignal* source)
 void dbcSignal::AddMultiplexRange(const dbcSwitchRange_t &range)
   {
   m_mux.switchvalues.insert(m_mux.switchvalues.end(), range);
+  Changed();
   }
 
 bool dbcSignal::ClearMultiplexed()
   {
+  Changed();
   switch (m_mux.multiplexed)
     {
     case DBC_MUX_MULTIPLEXED_MULTIPLEXSRC:
@@ -902,28 +914,33 @@ void dbcSignal::SetStartSize(const int startbit, const int size)
   {
   m_start_bit = startbit;
   m_signal_size = size;
+  Changed();
   }
 
 void dbcSignal::SetByteOrder(const dbcByteOrder_t order)
   {
   m_byte_order = order;
+  Changed();
   }
 
 void dbcSignal::SetValueType(const dbcValueType_t type)
   {
   m_value_type = type;
+  Changed();
   }
 
 void dbcSignal::SetFactorOffset(const dbcNumber factor, const dbcNumber offset)
   {
   m_factor = factor;
   m_offset = offset;
+  Changed();
   }
 
 void dbcSignal::SetFactorOffset(const double factor, const double offset)
   {
   m_factor = factor;
   m_offset = offset;
+  Changed();
   }
 
 void dbcSignal::SetMinMax(const dbcNumber minimum, const dbcNumber maximum)
@@ -1154,12 +1171,14 @@ dbcMessage::dbcMessage()
   {
   m_id = 0;
   m_size = 0;
+  m_plan_state = DBC_PLAN_DIRTY;
   }
 
 dbcMessage::dbcMessage(uint32_t id)
   {
   m_size = 0;
   m_id = id;
+  m_plan_state = DBC_PLAN_DIRTY;
   }
 
 dbcMessage::~dbcMessage()
@@ -1167,6 +1186,15 @@ dbcMessage::~dbcMessage()
   }
 
 void dbcMessage::DecodeSignal(const uint8_t* msg, uint8_t size, bool assignMetrics, OvmsWriter* writer) const
+  {
+  // The compiled plan covers metric assignment, the generic decoder
+  // additionally produces the formatted output for a writer.
+  if (writer == nullptr && DecodeSignalCompiled(msg, size, assignMetrics))
+    return;
+  DecodeSignalGeneric(msg, size, assignMetrics, writer);
+  }
+
+void dbcMessage::DecodeSignalGeneric(const uint8_t* msg, uint8_t size, bool assignMetrics, OvmsWriter* writer) const
   {
   // Gets the default multiplexor signal (the first one not also a sink/switch).
   dbcSignal* mux = GetMultiplexorSignal();
@@ -1315,21 +1343,295 @@ bool dbcMessage::HasComment(const std::string& comment) const
 void dbcMessage::AddSignal(dbcSignal* signal)
   {
   m_signals.push_back(signal);
+  signal->m_message = this;
+  InvalidateDecodePlan();
   }
 
 void dbcMessage::RemoveSignal(dbcSignal* signal, bool free)
   {
   m_signals.remove(signal);
-  if (free) delete signal;
+  InvalidateDecodePlan();
+  if (free)
+    delete signal;
+  else if (signal->m_message == this)
+    signal->m_message = nullptr;
   }
 
 void dbcMessage::RemoveAllSignals(bool free)
   {
   for (dbcSignal* signal : m_signals)
     {
-    if (free) delete signal;
+    if (free)
+      delete signal;
+    else if (signal->m_message == this)
+      signal->m_message = nullptr;
     }
   m_signals.clear();
+  InvalidateDecodePlan();
+  }
+
+void dbcMessage::InvalidateDecodePlan()
+  {
+  m_plan_state = DBC_PLAN_DIRTY;
+  }
+
+size_t dbcMessage::GetDecodePlanSize() const
+  {
+  return (m_plan_state == DBC_PLAN_READY) ? m_plan.size() : 0;
+  }
+
+/**
+ * dbc_plan_order: add a signal to the plan order after its mux sources.
+ * Returns false on a mux source loop.
+ */
+static bool dbc_plan_order(std::vector<dbcSignal*>& order, std::vector<dbcSignal*>& path,
+                           dbcSignal* sig, dbcSignal* mux)
+  {
+  if (std::find(order.begin(), order.end(), sig) != order.end())
+    return true;
+  if (std::find(path.begin(), path.end(), sig) != path.end())
+    return false;
+  if (sig->IsMultiplexSwitch())
+    {
+    dbcSignal* src = sig->GetMultiplexSource();
+    if (!src) src = mux;
+    if (src)
+      {
+      path.push_back(sig);
+      bool ok = dbc_plan_order(order, path, src, mux);
+      path.pop_back();
+      if (!ok) return false;
+      }
+    }
+  order.push_back(sig);
+  return true;
+  }
+
+/**
+ * dbc_plan_segments: precompute the frame byte segments of a signal,
+ * following the same walk as dbc_extract_bits_little/big_endian().
+ * Returns false if the signal needs more than DBC_PLAN_MAXSEGS segments.
+ */
+static bool dbc_plan_segments(dbcDecodeStep_t& step, unsigned int bpos, unsigned int bits,
+                              dbcByteOrder_t order)
+  {
+  unsigned int pos, aligner, shifter;
+  step.segcount = 0;
+  pos = (order == DBC_BYTEORDER_BIG_ENDIAN) ? bits : 0;
+  while (bits > 0)
+    {
+    if (step.segcount == DBC_PLAN_MAXSEGS || bpos / 8 > 255)
+      return false;
+    dbcBitSegment_t& seg = step.seg[step.segcount++];
+    if (order == DBC_BYTEORDER_BIG_ENDIAN)
+      {
+      shifter = MIN((bpos % 8) + 1, bits);
+      aligner = ((bpos % 8) + 1) - shifter;
+      pos -= shifter;
+      }
+    else
+      {
+      aligner = bpos % 8;
+      shifter = MIN(8 - aligner, bits);
+      }
+    seg.byte = bpos / 8;
+    seg.shift = aligner;
+    seg.mask = (1 << shifter) - 1;
+    seg.pos = pos;
+    if (order == DBC_BYTEORDER_BIG_ENDIAN)
+      bpos = ((bpos / 8) + 1) * 8 + 7;
+    else
+      {
+      pos += shifter;
+      bpos += shifter;
+      }
+    bits -= shifter;
+    }
+  return true;
+  }
+
+bool dbcMessage::CompileDecodePlan() const
+  {
+  m_plan.clear();
+  m_plan_ranges.clear();
+  m_plan_state = DBC_PLAN_UNSUPPORTED;
+
+  // Order signals so mux sources get decoded before their switched signals:
+  dbcSignal* mux = GetMultiplexorSignal();
+  std::vector<dbcSignal*> order, path, sources;
+  for (dbcSignal* sig : m_signals)
+    {
+    if (!dbc_plan_order(order, path, sig, mux))
+      {
+      ESP_LOGW(TAG, "Message %s: mux source loop, using generic decoder", m_name.c_str());
+      return false;
+      }
+    if (sig->IsMultiplexSwitch())
+      {
+      dbcSignal* src = sig->GetMultiplexSource();
+      if (!src) src = mux;
+      if (src && std::find(sources.begin(), sources.end(), src) == sources.end())
+        sources.push_back(src);
+      }
+    }
+  if (sources.size() > DBC_PLAN_MAXMUX)
+    {
+    ESP_LOGW(TAG, "Message %s: too many mux sources, using generic decoder", m_name.c_str());
+    return false;
+    }
+
+  m_plan.reserve(order.size());
+  for (dbcSignal* sig : order)
+    {
+    dbcDecodeStep_t step = {};
+    step.signal = sig;
+
+    if (sig->m_start_bit < 0 || sig->m_signal_size < 1 || sig->m_signal_size > 64 ||
+        !dbc_plan_segments(step, sig->m_start_bit, sig->m_signal_size, sig->m_byte_order))
+      {
+      ESP_LOGW(TAG, "Message %s: signal %s layout not compilable, using generic decoder",
+        m_name.c_str(), sig->m_name.c_str());
+      m_plan.clear();
+      m_plan_ranges.clear();
+      return false;
+      }
+    step.minsize = (sig->m_start_bit + sig->m_signal_size + 7) / 8;
+    step.signbit = sig->m_signal_size - 1;
+    if (sig->m_value_type != DBC_VALUETYPE_UNSIGNED)
+      step.flags |= DBC_STEP_SIGNED;
+    step.factor = sig->m_factor;
+    step.offset = sig->m_offset;
+    if (!(sig->m_factor == (uint32_t)1))
+      step.flags |= DBC_STEP_FACTOR;
+    if (!(sig->m_offset == (uint32_t)0))
+      step.flags |= DBC_STEP_OFFSET;
+
+    auto it = std::find(sources.begin(), sources.end(), sig);
+    step.slot = (it != sources.end()) ? (it - sources.begin()) : -1;
+
+    if (!sig->IsMultiplexSwitch())
+      step.parent = DBC_PLAN_ALWAYS;
+    else
+      {
+      dbcSignal* src = sig->GetMultiplexSource();
+      if (!src) src = mux;
+      if (!src)
+        step.parent = DBC_PLAN_NEVER;
+      else
+        step.parent = std::find(sources.begin(), sources.end(), src) - sources.begin();
+      step.switchvalue = sig->m_mux.switchvalue;
+      step.rangefirst = m_plan_ranges.size();
+      for (const dbcSwitchRange_t& range : sig->m_mux.switchvalues)
+        m_plan_ranges.push_back(range);
+      step.rangecount = m_plan_ranges.size() - step.rangefirst;
+      }
+
+    m_plan.push_back(step);
+    }
+
+  m_plan_state = DBC_PLAN_READY;
+  return true;
+  }
+
+static inline bool dbc_plan_switch(const dbcDecodeStep_t& step,
+                                   const std::vector<dbcSwitchRange_t>& ranges, uint32_t value)
+  {
+  if (step.switchvalue == value)
+    return true;
+  for (int k = step.rangefirst; k < step.rangefirst + step.rangecount; k++)
+    {
+    if (ranges[k].min_val <= value && value <= ranges[k].max_val)
+      return true;
+    }
+  return false;
+  }
+
+static inline dbcNumber dbc_plan_decode(const dbcDecodeStep_t& step, const uint8_t* msg, uint8_t size)
+  {
+  dbcNumber result;
+
+  if (size == 0)
+    return step.offset;
+  if (step.minsize > size)
+    return result; // empty value.
+
+  uint64_t val = 0;
+  for (int k = 0; k < step.segcount; k++)
+    {
+    const dbcBitSegment_t& seg = step.seg[k];
+    val |= ((uint64_t)((msg[seg.byte] >> seg.shift) & seg.mask)) << seg.pos;
+    }
+
+  if (step.flags & DBC_STEP_SIGNED)
+    {
+    int32_t signed_val = sign_extend<uint32_t, int32_t>((uint32_t)val, step.signbit);
+    result.Cast(static_cast<uint32_t>(signed_val), DBC_NUMBER_INTEGER_SIGNED);
+    }
+  else
+    result.Cast((uint32_t)val, DBC_NUMBER_INTEGER_UNSIGNED);
+
+  if (step.flags & DBC_STEP_FACTOR)
+    result = (result * step.factor);
+  if (step.flags & DBC_STEP_OFFSET)
+    result = (result + step.offset);
+
+  return result;
+  }
+
+/**
+ * DecodeSignalCompiled: decode a frame into the assigned metrics using
+ *  the compiled plan. Returns false if the message has no usable plan.
+ */
+bool dbcMessage::DecodeSignalCompiled(const uint8_t* msg, uint8_t size, bool assignMetrics) const
+  {
+  if (m_plan_state == DBC_PLAN_DIRTY)
+    CompileDecodePlan();
+  if (m_plan_state != DBC_PLAN_READY)
+    return false;
+  if (!assignMetrics)
+    return true;
+
+  bool mux_active[DBC_PLAN_MAXMUX];
+  uint32_t mux_value[DBC_PLAN_MAXMUX];
+
+  for (const dbcDecodeStep_t& step : m_plan)
+    {
+    bool active;
+    if (step.parent == DBC_PLAN_ALWAYS)
+      active = true;
+    else if (step.parent == DBC_PLAN_NEVER)
+      active = false;
+    else
+      active = mux_active[step.parent] && dbc_plan_switch(step, m_plan_ranges, mux_value[step.parent]);
+    if (step.slot >= 0)
+      mux_active[step.slot] = active;
+    if (!active)
+      continue;
+
+    // Mux sources are always needed, other signals only with a metric:
+    dbcMetric* m = step.signal->GetMetric();
+    if (m == nullptr && step.slot < 0)
+      continue;
+
+    dbcNumber value = dbc_plan_decode(step, msg, size);
+    if (step.slot >= 0)
+      mux_value[step.slot] = value.GetUnsignedInteger();
+
+    if (m != nullptr)
+      {
+      if (!step.signal->HasValues())
+        m->SetValue(value, step.signal->GetMetricUnit());
+      else
+        {
+        // Metric has an 'enum' .. assign the matching value.
+        uint32_t val = value.GetUnsignedInteger();
+        if (step.signal->HasValue(val))
+          m->SetValue(step.signal->GetValue(val));
+        }
+      }
+    }
+
+  return true;
   }
 
 dbcSignal* dbcMessage::FindSignal(std::string name)
@@ -1523,6 +1825,8 @@ dbcMessageTable::~dbcMessageTable()
 void dbcMessageTable::AddMessage(uint32_t id, dbcMessage* message)
   {
   m_entrymap[id] = message;
+  if (!m_idmap.Set(id, message))
+    ESP_LOGE(TAG, "Message %" PRIu32 ": out of memory for dispatch index", id);
   }
 
 void dbcMessageTable::RemoveMessage(uint32_t id, bool free)
@@ -1530,6 +1834,7 @@ void dbcMessageTable::RemoveMessage(uint32_t id, bool free)
   auto search = m_entrymap.find(id);
   if (search != m_entrymap.end())
     {
+    m_idmap.Remove(id);
     if (free) delete search->second;
     m_entrymap.erase(search);
     }
@@ -1537,25 +1842,12 @@ void dbcMessageTable::RemoveMessage(uint32_t id, bool free)
 
 dbcMessage* dbcMessageTable::FindMessage(uint32_t id) const
   {
-  auto search = m_entrymap.find(id);
-  if (search != m_entrymap.end())
-    return search->second;
-  else
-    return NULL;
+  return m_idmap.Find(id);
   }
 
 dbcMessage* dbcMessageTable::FindMessage(CAN_frame_format_t format, uint32_t id) const
   {
-  if (format == CAN_frame_ext)
-    id |= 0x80000000;
-  else
-    id &= 0x7FFFFFFF;
-
-  auto search = m_entrymap.find(id);
-  if (search != m_entrymap.end())
-    return search->second;
-  else
-    return NULL;
+  return m_idmap.Find(format, id);
   }
 
 void dbcMessageTable::Count(int* messages, int* signals, int* bits, int* covered) const
@@ -1577,6 +1869,12 @@ void dbcMessageTable::Count(int* messages, int* signals, int* bits, int* covered
     }
   }
 
+void dbcMessageTable::CompileDecodePlans() const
+  {
+  for (auto it : m_entrymap)
+    it.second->CompileDecodePlan();
+  }
+
 void dbcMessageTable::EmptyContent()
   {
   dbcMessageEntry_t::iterator it=m_entrymap.begin();
@@ -1586,6 +1884,7 @@ void dbcMessageTable::EmptyContent()
     ++it;
     }
   m_entrymap.clear();
+  m_idmap.Clear();
   }
 
 void dbcMessageTable::WriteFile(dbcOutputCallback callback, void* param) const
@@ -1690,6 +1989,8 @@ bool dbcfile::LoadFile(const char* name, const char* path, FILE* fd)
     fseek(fd,0,SEEK_SET);
     }
 
+  if (result)
+    m_messages.CompileDecodePlans();
   return result;
   }
 
@@ -1705,6 +2006,8 @@ bool dbcfile::LoadString(const char* name, const char* source, size_t length)
   bool result = (yyparse (this) == 0);
   yy_delete_buffer(buffer);
 
+  if (result)
+    m_messages.CompileDecodePlans();
   return result;
   }
 
@@ -34,10 +34,12 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 #include <functional>
 #include <iostream>
 #include "dbc_number.h"
 #include "can.h"
+#include "canutils.h"
 #include "ovms_metrics.h"
 
 #define DBC_MAX_LINELENGTH 2048
@@ -279,9 +281,12 @@ class dbcOvmsMetric : public dbcMetric
     metric_unit_t DefaultUnit() const override;
   };
 
+class dbcMessage;
 typedef std::list<std::string> dbcReceiverList_t;
 class dbcSignal
   {
+  friend class dbcMessage;
+
   public:
     dbcSignal();
     dbcSignal(std::string name);
@@ -360,6 +365,10 @@ class dbcSignal
     dbcValueTable m_values;
 
   protected:
+    void Changed();
+
+  protected:
+    dbcMessage* m_message;
     std::string m_name;
     dbcMultiplexor_t m_mux;
     int m_start_bit;
@@ -376,6 +385,53 @@ class dbcSignal
     dbcMetric* m_metric;
   };
 
+/**
+ * Decode plan: dbcMessage compiles its signals into a flat list of steps
+ * with precomputed byte segments and a flattened mux tree, so frames can
+ * be decoded without heap allocations. Steps are ordered so that mux
+ * sources are evaluated before the signals switched by them.
+ */
+#define DBC_PLAN_MAXSEGS        9       // Byte segments of a 64 bit signal
+#define DBC_PLAN_MAXMUX         16      // Mux sources per message
+#define DBC_PLAN_ALWAYS         -1      // Step parent: not multiplexed
+#define DBC_PLAN_NEVER          -2      // Step parent: mux source missing
+
+#define DBC_STEP_SIGNED         0x01
+#define DBC_STEP_FACTOR         0x02
+#define DBC_STEP_OFFSET         0x04
+
+typedef enum
+  {
+  DBC_PLAN_DIRTY = 0,
+  DBC_PLAN_READY,
+  DBC_PLAN_UNSUPPORTED
+  } dbcPlanState_t;
+
+struct dbcBitSegment_t
+  {
+  uint8_t byte;                         // Frame byte index
+  uint8_t shift;                        // Right shift to align the bits
+  uint8_t mask;                         // Mask after alignment
+  uint8_t pos;                          // Left shift into the raw value
+  };
+
+struct dbcDecodeStep_t
+  {
+  dbcSignal* signal;
+  int16_t parent;                       // Mux slot of the source, or DBC_PLAN_ALWAYS/NEVER
+  int16_t slot;                         // Mux slot to store the value in, or -1
+  uint16_t minsize;                     // Frame size needed to decode
+  uint16_t rangefirst;                  // Switch ranges in the plan range table
+  uint16_t rangecount;
+  uint8_t flags;                        // DBC_STEP_*
+  uint8_t signbit;
+  uint8_t segcount;
+  uint32_t switchvalue;
+  dbcNumber factor;
+  dbcNumber offset;
+  dbcBitSegment_t seg[DBC_PLAN_MAXSEGS];
+  };
+
 typedef std::list<dbcSignal*> dbcSignalList_t;
 class dbcMessage
   {
@@ -392,6 +448,13 @@ class dbcMessage
     void Count(int* signals, int* bits, int* covered) const;
 
     void DecodeSignal(const uint8_t* msg, uint8_t size, bool assignMetrics = true, OvmsWriter* writer = nullptr) const;
+    void DecodeSignalGeneric(const uint8_t* msg, uint8_t size, bool assignMetrics = true, OvmsWriter* writer = nullptr) const;
+    bool DecodeSignalCompiled(const uint8_t* msg, uint8_t size, bool assignMetrics = true) const;
+
+  public:
+    void InvalidateDecodePlan();
+    bool CompileDecodePlan() const;
+    size_t GetDecodePlanSize() const;
 
   public:
     void AddComment(const std::string& comment);
@@ -430,6 +493,11 @@ class dbcMessage
     std::string m_name;
     int m_size;
     std::string m_transmitter_node;
+
+  protected:
+    mutable dbcPlanState_t m_plan_state;
+    mutable std::vector<dbcDecodeStep_t> m_plan;
+    mutable std::vector<dbcSwitchRange_t> m_plan_ranges;
   };
 
 typedef std::map<uint32_t, dbcMessage*> dbcMessageEntry_t;
@@ -445,6 +513,7 @@ class dbcMessageTable
     dbcMessage* FindMessage(uint32_t id) const;
     dbcMessage* FindMessage(CAN_frame_format_t format, uint32_t id) const;
     void Count(int* messages, int* signals, int* bits, int* covered) const;
+    void CompileDecodePlans() const;
 
   public:
     void EmptyContent();
@@ -457,6 +526,9 @@ class dbcMessageTable
 
   public:
     dbcMessageEntry_t m_entrymap;
+
+  protected:
+    canidmap<dbcMessage> m_idmap;   // Frame dispatch index for m_entrymap
   };
 
 class dbcfile
@@ -39,6 +39,7 @@ static const char *TAG = "esp32can";
 #include "freertos/FreeRTOS.h"
 #include "freertos/portmacro.h"
 #include <string.h>
+#include <esp_timer.h>
 #include "esp32can.h"
 #include "esp32can_regdef.h"
 #include "ovms_peripherals.h"
@@ -129,6 +130,7 @@ static inline uint32_t ESP32CAN_rxframe(esp32can *me, BaseType_t* task_woken)
       memset(&msg,0,sizeof(msg));
       msg.type = CAN_frame;
       msg.body.frame.origin = me;
+      msg.body.frame.timestamp = esp_timer_get_time();
 
       // get FIR
       msg.body.frame.FIR.U = MODULE_ESP32CAN->MBX_CTRL.FCTRL.FIR.U;
@@ -272,6 +274,7 @@ static IRAM_ATTR void ESP32CAN_isr(void *pvParameters)
         msg.type = CAN_txcallback;
         }
       msg.body.frame = me->m_tx_frame;
+      msg.body.frame.timestamp = esp_timer_get_time();
       msg.body.bus = me;
       xQueueSendFromISR(MyCan.m_rxqueue, &msg, &task_woken);
       }
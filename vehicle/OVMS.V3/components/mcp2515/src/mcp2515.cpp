@@ -32,6 +32,7 @@
 static const char *TAG = "mcp2515";
 
 #include <string.h>
+#include <esp_timer.h>
 #include "mcp2515.h"
 #include "mcp2515_regdef.h"
 #include "soc/gpio_struct.h"
@@ -51,6 +52,7 @@ static IRAM_ATTR void MCP2515_isr(void *pvParameters)
   CAN_queue_msg_t msg = {};
   msg.type = CAN_asyncinterrupthandler;
   msg.body.bus = me;
+  msg.body.frame.timestamp = esp_timer_get_time();
 
   //send callback request to main CAN processor task
   xQueueSendFromISR(MyCan.m_rxqueue, &msg, &task_woken);
@@ -590,9 +592,13 @@ bool mcp2515::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesR
 
   if (intflag <= 2)
     {
-    // The indicated RX buffer has a message to be read
+    // The indicated RX buffer has a message to be read.
+    // The first frame gets the interrupt time, following frames
+    // read in the same handler loop the time of reading:
+    int64_t timestamp = frame->timestamp ? frame->timestamp : esp_timer_get_time();
     memset(frame,0,sizeof(*frame));
     frame->origin = this;
+    frame->timestamp = timestamp;
 
     // read RX buffer and clear interrupt flag:
     uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 13, 1, CMD_READ_RXBUF + ((intflag==1) ? 0 : 4));
@@ -617,6 +623,7 @@ bool mcp2515::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesR
     memcpy(&frame->data,p+5,8);
     *framesReceived = *framesReceived + 1;
     MyCan.IncomingFrame(frame);
+    frame->timestamp = 0;
     }
 
   // handle other interrupts that came in at the same time:
@@ -632,6 +639,7 @@ bool mcp2515::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesR
     CAN_queue_msg_t msg;
     msg.type = CAN_txcallback;
     msg.body.frame = m_tx_frame;
+    msg.body.frame.timestamp = esp_timer_get_time();
     msg.body.bus = this;
     xQueueSend(MyCan.m_rxqueue, &msg, 0);
     }
@@ -695,6 +703,7 @@ bool mcp2515::AsynchronousInterruptHandler(CAN_frame_t* frame, uint32_t* framesR
       CAN_queue_msg_t msg;
       msg.type = tx_aborted ? CAN_txfailedcallback : CAN_txcallback;
       msg.body.frame = m_tx_frame;
+      msg.body.frame.timestamp = esp_timer_get_time();
       msg.body.bus = this;
       xQueueSend(MyCan.m_rxqueue, &msg, 0);
       // …which will log the error as well
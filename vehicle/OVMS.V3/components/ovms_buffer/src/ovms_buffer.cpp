@@ -88,12 +88,15 @@ bool OvmsBuffer::Push(uint8_t *byte, size_t count)
   {
   if ((m_size-m_used)<count) return false;
 
-  m_used += count;
-  for (size_t k=0;k<count;k++)
+  while (count > 0)
     {
-    // ESP_LOGI(TAG, "Push() %02x at %d",byte[k],m_head);
-    m_buffer[m_head++] = byte[k];
-    if (m_head >= m_size) m_head=0;
+    uint8_t *span;
+    size_t n = WriteSpan(&span);
+    if (n > count) n = count;
+    memcpy(span, byte, n);
+    Commit(n);
+    byte += n;
+    count -= n;
     }
 
   return true;
@@ -112,15 +115,8 @@ uint8_t OvmsBuffer::Pop()
 
 size_t OvmsBuffer::Pop(size_t count, uint8_t *dest)
   {
-  size_t done = 0;
-
-  while ((m_used>0)&&(done < count))
-    {
-    m_used--;
-    dest[done++] = m_buffer[m_tail++];
-    if (m_tail >= m_size) m_tail=0;
-    }
-
+  size_t done = Peek(count, dest);
+  Consume(done);
   return done;
   }
 
@@ -133,16 +129,54 @@ uint8_t OvmsBuffer::Peek()
 
 size_t OvmsBuffer::Peek(size_t count, uint8_t *dest)
   {
-  size_t done = 0;
+  if (count > m_used) count = m_used;
 
-  size_t tail = m_tail;
-  while ((done<m_used)&&(done<count))
-    {
-    dest[done++] = m_buffer[tail++];
-    if (tail >= m_size) tail=0;
-    }
+  size_t first = m_size - m_tail;
+  if (first > count) first = count;
+  memcpy(dest, m_buffer+m_tail, first);
+  memcpy(dest+first, m_buffer, count-first);
 
-  return done;
+  return count;
+  }
+
+/**
+ * ReadSpan: get the contiguous region of data at the tail
+ *  Returns the region length (0 = empty). The data stays in the buffer
+ *  until released by Consume(); a second region may follow after the wrap.
+ */
+size_t OvmsBuffer::ReadSpan(uint8_t **data)
+  {
+  *data = m_buffer+m_tail;
+  size_t n = m_size - m_tail;
+  return (n < m_used) ? n : m_used;
+  }
+
+void OvmsBuffer::Consume(size_t count)
+  {
+  if (count > m_used) count = m_used;
+  m_used -= count;
+  m_tail += count;
+  if ((size_t)m_tail >= m_size) m_tail -= m_size;
+  }
+
+/**
+ * WriteSpan: get the contiguous free region at the head
+ *  Returns the region length (0 = full). Data written there is added to
+ *  the buffer by Commit().
+ */
+size_t OvmsBuffer::WriteSpan(uint8_t **data)
+  {
+  *data = m_buffer+m_head;
+  size_t n = m_size - m_head;
+  return (n < m_size-m_used) ? n : m_size-m_used;
+  }
+
+void OvmsBuffer::Commit(size_t count)
+  {
+  if (count > m_size-m_used) count = m_size-m_used;
+  m_used += count;
+  m_head += count;
+  if ((size_t)m_head >= m_size) m_head -= m_size;
   }
 
 void OvmsBuffer::Diagnostics()
@@ -55,6 +55,13 @@ class OvmsBuffer
     size_t Peek(size_t count, uint8_t *dest);
     void Diagnostics();
 
+  public:
+    // Zero copy access, regions are contiguous up to the wrap point:
+    size_t ReadSpan(uint8_t **data);
+    void Consume(size_t count);
+    size_t WriteSpan(uint8_t **data);
+    void Commit(size_t count);
+
   public:
     int HasLine();
     std::string ReadLine();
@@ -158,9 +158,14 @@ void GsmMuxChannel::ProcessFrame(uint8_t* frame, size_t length, size_t iframepos
       // GSM_UIH alone set for CGNSSINFO response
       if (frame[1] == (GSM_UIH + GSM_PF) || frame[1] == GSM_UIH )  
         {
-        for (size_t k=iframepos;k<length;k++)
-          m_buffer.Push(frame[k]);
-        m_mux->m_modem->IncomingMuxData(this);
+        // Pass on the payload directly if possible, else via the channel buffer:
+        size_t n = length-iframepos;
+        if ((n > 0)&&(m_buffer.UsedSpace() == 0)
+          &&(m_mux->m_receiver->IncomingMuxData(this, frame+iframepos, n)))
+          break;
+        if (n > m_buffer.FreeSpace()) n = m_buffer.FreeSpace();
+        m_buffer.Push(frame+iframepos, n);
+        m_mux->m_receiver->IncomingMuxData(this);
         }
       break;
     case ChanClosing:
@@ -175,6 +180,7 @@ GsmMux::GsmMux(modem* m, int channelcount, size_t maxframesize)
   m_channelcount = channelcount;
   m_state = DlciClosed;
   m_modem = m;
+  m_receiver = m;
   m_frame = new uint8_t[maxframesize];
   m_framesize = maxframesize;
   m_framepos = 0;
@@ -273,10 +279,61 @@ uint32_t GsmMux::GoodFrameAge()
   return (m_lastgoodrxframe > 0) ? (monotonictime-m_lastgoodrxframe) : 0;
   }
 
+// Frame length (including flags) from the header, 0 if incomplete:
+static inline size_t gsm_frame_length(const uint8_t* frame, size_t avail, size_t* ipos)
+  {
+  if (avail < 4) return 0;
+  if (frame[3] & GSM_EA)
+    {
+    *ipos = 4;
+    return (frame[3]>>1) + 6;
+    }
+  if (avail < 5) return 0;
+  *ipos = 5;
+  return (frame[3]>>1) + (frame[4]<<7) + 7;
+  }
+
 void GsmMux::Process(OvmsBuffer* buf)
   {
-  while (buf->UsedSpace()>0)
+  uint8_t* data;
+  size_t len;
+  while ((len = buf->ReadSpan(&data)) > 0)
+    {
+    buf->Consume(Process(data, len));
+    }
+  }
+
+/**
+ * Process: frame detection on a span of received data
+ *  Frames contained completely in the span are processed in place, only
+ *  frames split across spans (or receptions) are assembled in m_frame.
+ *  Returns the number of bytes consumed.
+ */
+size_t GsmMux::Process(uint8_t* data, size_t len)
+  {
+  size_t pos = 0;
+  while (pos < len)
     {
+    if (m_framepos == 0)
+      {
+      // Skip to start of frame, and over the end of the previous frame:
+      uint8_t* sof = (uint8_t*)memchr(data+pos, GSM0_SOF, len-pos);
+      if (sof == NULL) return len;
+      pos = sof - data;
+      while ((pos+1 < len)&&(data[pos+1] == GSM0_SOF)) pos++;
+
+      size_t ipos = 0;
+      size_t framelen = gsm_frame_length(data+pos, len-pos, &ipos);
+      if ((framelen > 0)&&(framelen <= m_framesize)&&(framelen <= len-pos)
+        &&(data[pos+framelen-1] == GSM0_SOF))
+        {
+        // We have a complete frame in the span...
+        ProcessFrame(data+pos, framelen, ipos);
+        pos += framelen;
+        continue;
+        }
+      }
+
     if (m_framepos == m_framesize)
       {
       // Overflow frame
@@ -288,11 +345,20 @@ void GsmMux::Process(OvmsBuffer* buf)
       m_framingerrors++;
       continue;
       }
-    uint8_t b = buf->Pop();
-    if ((m_framepos == 0)&&(b != GSM0_SOF))
+
+    if ((m_framepos >= 4)&&(!m_framemorelen)&&(m_framepos+1 < m_framelen))
       {
-      continue; // Skip to start of frame
+      // Frame body: copy up to the end flag
+      size_t n = m_framelen - 1 - m_framepos;
+      if (n > m_framesize - m_framepos) n = m_framesize - m_framepos;
+      if (n > len - pos) n = len - pos;
+      memcpy(m_frame+m_framepos, data+pos, n);
+      m_framepos += n;
+      pos += n;
+      continue;
       }
+
+    uint8_t b = data[pos++];
     if ((m_framepos == 1)&&(b == GSM0_SOF)) continue; // We found end of previous frame, so just skip it
     // ESP_LOGI(TAG, "Got %02x at %d (length sofar = %d)",b,m_framepos,m_framelen);
     m_frame[m_framepos++] = b;
@@ -325,7 +391,7 @@ void GsmMux::Process(OvmsBuffer* buf)
       if (b == GSM0_SOF)
         {
         // We have a complete frame...
-        ProcessFrame();
+        ProcessFrame(m_frame, m_framelen, m_frameipos);
         }
       else
         {
@@ -334,51 +400,44 @@ void GsmMux::Process(OvmsBuffer* buf)
         ESP_LOGW(TAG, "Frame error: EOF mismatch (CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%d)",
           channel, m_frame[1], m_frame[2], m_frame[m_framelen-2], m_framelen);
         MyCommandApp.HexDump(TAG, "Frame dump", (const char*)m_frame, m_framelen);
-        // find next frame:
-        m_framepos = 0;
-        m_framelen = 0;
-        m_framemorelen = false;
         m_framingerrors++;
         }
+      // find next frame:
+      m_framepos = 0;
+      m_frameipos = 0;
+      m_framelen = 0;
+      m_framemorelen = false;
       }
     }
+  return len;
   }
 
-void GsmMux::ProcessFrame()
+void GsmMux::ProcessFrame(uint8_t* frame, size_t framelen, size_t ipos)
   {
-  int channel = m_frame[1] >>2;
+  int channel = frame[1] >>2;
 
   ESP_LOGV(TAG, "ProcessFrame(CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%d)",
-    channel, m_frame[1], m_frame[2], m_frame[m_framelen-2], m_framelen);
+    channel, frame[1], frame[2], frame[framelen-2], framelen);
 
-  uint8_t fcs = 0xFF - gsm_fcs_add_block(FCS_INIT, m_frame+1, m_frameipos-1);
-  if (fcs != m_frame[m_framelen-2])
+  uint8_t fcs = 0xFF - gsm_fcs_add_block(FCS_INIT, frame+1, ipos-1);
+  if (fcs != frame[framelen-2])
     {
-    ESP_LOGW(TAG, "FCS mismatch (%02x != %02x)",fcs,m_frame[m_framelen-2]);
-    m_framepos = 0;
-    m_frameipos = 0;
-    m_framelen = 0;
+    ESP_LOGW(TAG, "FCS mismatch (%02x != %02x)",fcs,frame[framelen-2]);
     m_framingerrors++;
-    m_framemorelen = false;
     return;
     }
 
-  GsmMuxChannel* chan = m_channels[channel];
+  GsmMuxChannel* chan = ((size_t)channel < m_channels.size()) ? m_channels[channel] : NULL;
   if (chan)
     {
     m_lastgoodrxframe = monotonictime;
     m_rxframecount++;
-    chan->ProcessFrame(m_frame+1,m_framelen-3,m_frameipos-1);
+    chan->ProcessFrame(frame+1,framelen-3,ipos-1);
     }
   else
     {
     ESP_LOGW(TAG, "Incoming message for unrecognised channel #%d",channel);
     }
-
-  m_framepos = 0;
-  m_frameipos = 0;
-  m_framelen = 0;
-  m_framemorelen = false;
   }
 
 void GsmMux::txfcs(uint8_t* data, size_t size, size_t ipos)
@@ -38,6 +38,20 @@
 
 class modem; // Forward declared
 class GsmMux; // Forward declared
+class GsmMuxChannel; // Forward declared
+
+/**
+ * GsmMuxReceiver: consumer of channel payload (the modem, or a test sink)
+ */
+class GsmMuxReceiver
+  {
+  public:
+    virtual ~GsmMuxReceiver() {}
+    // Channel buffer has data:
+    virtual void IncomingMuxData(GsmMuxChannel* channel) = 0;
+    // Direct delivery of frame payload, return false to use the channel buffer:
+    virtual bool IncomingMuxData(GsmMuxChannel* channel, uint8_t* data, size_t len) = 0;
+  };
 
 class GsmMuxChannel : public InternalRamAllocated
   {
@@ -76,7 +90,8 @@ class GsmMux : public InternalRamAllocated
     void StartChannel(int channel);
     void StopChannel(int channel);
     void Process(OvmsBuffer* buf);
-    void ProcessFrame();
+    size_t Process(uint8_t* data, size_t len);
+    void ProcessFrame(uint8_t* frame, size_t framelen, size_t ipos);
     size_t tx(int channel, uint8_t* data, ssize_t size);
     size_t tx(int channel, const char* data, ssize_t size = -1);
     bool IsChannelOpen(int channel);
@@ -106,6 +121,7 @@ class GsmMux : public InternalRamAllocated
 
   public:
     modem* m_modem;
+    GsmMuxReceiver* m_receiver;
     uint8_t* m_frame;
     size_t m_framesize;
     size_t m_framepos;
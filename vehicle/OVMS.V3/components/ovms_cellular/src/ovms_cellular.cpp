@@ -1813,11 +1813,12 @@ void modem::IncomingMuxData(GsmMuxChannel* channel)
     {
     if (m_state1 == NetMode)
       {
-      uint8_t buf[32];
+      uint8_t* data;
       size_t n;
-      while ((m_ppp != NULL)&&(n = channel->m_buffer.Pop(sizeof(buf),buf)) > 0)
+      while ((m_ppp != NULL)&&(n = channel->m_buffer.ReadSpan(&data)) > 0)
         {
-        m_ppp->IncomingData(buf,n);
+        m_ppp->IncomingData(data,n);
+        channel->m_buffer.Consume(n);
         }
       }
     else
@@ -1839,6 +1840,20 @@ void modem::IncomingMuxData(GsmMuxChannel* channel)
     }
   }
 
+bool modem::IncomingMuxData(GsmMuxChannel* channel, uint8_t* data, size_t len)
+  {
+  // The MUX offers frame payload for direct delivery (zero copy),
+  // return false to have it passed via the channel buffer instead.
+  // Only PPP data qualifies, lwIP copies it into its own buffers.
+
+  if ((channel->m_channel == m_mux_channel_DATA)&&(m_state1 == NetMode)&&(m_ppp != NULL))
+    {
+    m_ppp->IncomingData(data,len);
+    return true;
+    }
+  return false;
+  }
+
 void modem::SendSetState1(modem_state1_t newstate)
   {
   modem_or_uart_event_t ev;
@@ -53,7 +53,7 @@ using namespace std;
 
 class modemdriver;  // Forward declaration
 
-class modem : public pcp, public InternalRamAllocated
+class modem : public pcp, public InternalRamAllocated, public GsmMuxReceiver
   {
   public:
     modem(const char* name, uart_port_t uartnum, int baud, int rxpin, int txpin, int pwregpio, int dtregpio);
@@ -237,7 +237,8 @@ class modem : public pcp, public InternalRamAllocated
     void Ticker(std::string event, void* data);
     void EventListener(std::string event, void* data);
     void ConfigChanged(std::string event, void *data);
-    void IncomingMuxData(GsmMuxChannel* channel);
+    virtual void IncomingMuxData(GsmMuxChannel* channel);
+    virtual bool IncomingMuxData(GsmMuxChannel* channel, uint8_t* data, size_t len);
     void SendSetState1(modem_state1_t newstate);
     bool IsStarted();
     void SetNetworkRegistration(network_regtype_t regtype, network_registration_t netreg);
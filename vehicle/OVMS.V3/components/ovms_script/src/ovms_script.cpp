@@ -37,6 +37,7 @@ static const char *TAG = "script";
 #include <string.h>
 #include <stdio.h>
 #include <dirent.h>
+#include <algorithm>
 #include <esp_task_wdt.h>
 #include "ovms_malloc.h"
 #include "ovms_module.h"
@@ -175,7 +176,6 @@ void OvmsScripts::AllScripts(std::string path)
   {
   DIR *dir;
   struct dirent *dp;
-  FILE *sf;
   std::set<std::string> files;
 
   // read dir, sort scripts by name:
@@ -191,10 +191,17 @@ void OvmsScripts::AllScripts(std::string path)
     closedir(dir);
     }
 
+  RunScripts(files);
+  }
+
+void OvmsScripts::RunScripts(const std::set<std::string>& files)
+  {
+  FILE *sf;
+
   // execute scripts:
   for (auto it = files.begin(); it != files.end(); it++)
     {
-    std::string fpath = *it;
+    const std::string& fpath = *it;
     sf = fopen(fpath.c_str(), "r");
     if (sf)
       {
@@ -205,9 +212,130 @@ void OvmsScripts::AllScripts(std::string path)
     }
   }
 
+/**
+ * BuildEventIndex: scan the event script directories of a storage root
+ *  (i.e. /store/events/<event>/<script>) into the index.
+ *  Note: called with m_index_mutex locked
+ */
+void OvmsScripts::BuildEventIndex(event_index_t& index)
+  {
+  DIR *dir, *evdir;
+  struct dirent *dp, *evdp;
+
+  index.scripts.clear();
+  if ((dir = opendir(index.root)) != NULL)
+    {
+    while ((dp = readdir(dir)) != NULL)
+      {
+      std::string evpath = index.root;
+      evpath.append("/");
+      evpath.append(dp->d_name);
+      if ((evdir = opendir(evpath.c_str())) == NULL)
+        continue;
+      std::set<std::string> files;
+      while ((evdp = readdir(evdir)) != NULL)
+        {
+        std::string fpath = evpath;
+        fpath.append("/");
+        fpath.append(evdp->d_name);
+        files.insert(fpath);
+        }
+      closedir(evdir);
+      if (!files.empty())
+        index.scripts[dp->d_name] = files;
+      }
+    closedir(dir);
+    }
+  index.valid = true;
+  ESP_LOGD(TAG, "Event script index for %s: %d events", index.root, index.scripts.size());
+  }
+
+bool OvmsScripts::GetEventScripts(event_index_t& index, const std::string& event, std::set<std::string>& files)
+  {
+  OvmsMutexLock lock(&m_index_mutex);
+  if (!index.valid)
+    {
+    m_index_misses++;
+    BuildEventIndex(index);
+    }
+  else
+    {
+    m_index_hits++;
+    }
+  auto it = index.scripts.find(event);
+  if (it == index.scripts.end())
+    {
+    m_index_skipped++;
+    return false;
+    }
+  files = it->second;
+  return true;
+  }
+
+/**
+ * InvalidateEventIndex: mark indexes covering the path as outdated
+ *  If path is NULL, all indexes are invalidated. The rebuild is done
+ *  on the next event script lookup.
+ */
+void OvmsScripts::InvalidateEventIndex(const char* path)
+  {
+  OvmsMutexLock lock(&m_index_mutex);
+  event_index_t* indexes[] = {
+#ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+    &m_index_sd,
+#endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+    &m_index_store };
+  for (event_index_t* index : indexes)
+    {
+    if (path)
+      {
+      // path may be within the root, or a parent directory of it:
+      size_t len = std::min(strlen(path), strlen(index->root));
+      if (strncmp(path, index->root, len) != 0)
+        continue;
+      }
+    index->valid = false;
+    }
+  }
+
+void OvmsScripts::EventIndexListener(std::string event, void* data)
+  {
+  if (event == "system.vfs.file.changed")
+    InvalidateEventIndex((const char*)data);
+  else if (event.compare(0, 7, "config.") == 0)
+    InvalidateEventIndex("/store");
+  else
+    InvalidateEventIndex("/sd");
+  }
+
+void OvmsScripts::EventIndexStatus(OvmsWriter* writer)
+  {
+  OvmsMutexLock lock(&m_index_mutex);
+  event_index_t* indexes[] = {
+#ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+    &m_index_sd,
+#endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+    &m_index_store };
+  writer->puts("Event script index:");
+  for (event_index_t* index : indexes)
+    {
+    if (!index->valid)
+      {
+      writer->printf("  %s: not loaded\n", index->root);
+      continue;
+      }
+    writer->printf("  %s: %d event(s) with scripts\n", index->root, index->scripts.size());
+    for (auto& it : index->scripts)
+      writer->printf("    %s: %d script(s)\n", it.first.c_str(), it.second.size());
+    }
+  writer->printf("Lookups: %" PRIu32 " hits, %" PRIu32 " misses (index rebuilds)\n",
+    m_index_hits, m_index_misses);
+  writer->printf("Directory scans saved: %" PRIu32 "\n", m_index_skipped);
+  }
+
 void OvmsScripts::EventScript(std::string event, void* data)
   {
-  std::string path;
+  std::set<std::string> files;
 
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   MyDuktape.EventScript(event, data);
@@ -215,15 +343,18 @@ void OvmsScripts::EventScript(std::string event, void* data)
 
 #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
   // run event scripts on external storage:
-  path=std::string("/sd/events/");
-  path.append(event);
-  AllScripts(path);
+  if (GetEventScripts(m_index_sd, event, files))
+    RunScripts(files);
 #endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
 
   // run event scripts on internal storage:
-  path=std::string("/store/events/");
-  path.append(event);
-  AllScripts(path);
+  if (GetEventScripts(m_index_store, event, files))
+    RunScripts(files);
+  }
+
+static void script_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  MyScripts.EventIndexStatus(writer);
   }
 
 OvmsScripts::OvmsScripts()
@@ -234,7 +365,18 @@ OvmsScripts::OvmsScripts()
   ESP_LOGI(TAG, "No javascript engines enabled (command scripting only)");
 #endif //#ifdef CONFIG_OVMS_SC_JAVASCRIPT_NONE
 
-  OvmsCommand* cmd_script = MyCommandApp.RegisterCommand("script","SCRIPT framework");
+#ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+  m_index_sd.root = "/sd/events";
+  m_index_sd.valid = false;
+#endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+  m_index_store.root = "/store/events";
+  m_index_store.valid = false;
+  m_index_hits = 0;
+  m_index_misses = 0;
+  m_index_skipped = 0;
+
+  OvmsCommand* cmd_script = MyCommandApp.RegisterCommand("script","SCRIPT framework", script_status, "", 0, 0, false);
+  cmd_script->RegisterCommand("status","Show event script index status",script_status);
   cmd_script->RegisterCommand("run","Run a script",script_run,"<path>",1,1,true, vfs_file_validate);
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   cmd_script->RegisterCommand("reload","Reload javascript framework",script_reload);
@@ -243,6 +385,16 @@ OvmsScripts::OvmsScripts()
   cmd_script->RegisterCommand("meminfo","Show heap memory status",script_meminfo);
 #endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   MyCommandApp.RegisterCommand(".","Run a script",script_run,"<path>",1,1, true, vfs_file_validate);
+
+  #undef bind  // Kludgy, but works
+  using std::placeholders::_1;
+  using std::placeholders::_2;
+  MyEvents.RegisterEvent(TAG, "system.vfs.file.changed", std::bind(&OvmsScripts::EventIndexListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "sd.mounted", std::bind(&OvmsScripts::EventIndexListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "sd.unmounting", std::bind(&OvmsScripts::EventIndexListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "config.mounted", std::bind(&OvmsScripts::EventIndexListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "config.unmounted", std::bind(&OvmsScripts::EventIndexListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "config.restore", std::bind(&OvmsScripts::EventIndexListener, this, _1, _2));
   }
 
 OvmsScripts::~OvmsScripts()
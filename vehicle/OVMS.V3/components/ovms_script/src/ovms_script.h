@@ -31,8 +31,12 @@
 #ifndef __SCRIPT_H__
 #define __SCRIPT_H__
 
+#include <map>
+#include <set>
+#include <string>
 #include "ovms_command.h"
 #include "ovms_utils.h"
+#include "ovms_mutex.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -51,6 +55,38 @@ class OvmsScripts
   public:
     void EventScript(std::string event, void* data);
     void AllScripts(std::string path);
+    void RunScripts(const std::set<std::string>& files);
+
+  public:
+    // Event script index: event name → script paths, per storage root.
+    // The index is only refreshed on system.vfs.file.changed (and SD card
+    // or config store mount changes), so code writing to /store/events or /sd/events
+    // must signal that event with the path, or call InvalidateEventIndex().
+    typedef std::map<std::string, std::set<std::string>> EventScriptMap;
+    typedef struct
+      {
+      const char* root;
+      bool valid;
+      EventScriptMap scripts;
+      } event_index_t;
+
+    void InvalidateEventIndex(const char* path = NULL);
+    void EventIndexStatus(OvmsWriter* writer);
+
+  protected:
+    void EventIndexListener(std::string event, void* data);
+    void BuildEventIndex(event_index_t& index);
+    bool GetEventScripts(event_index_t& index, const std::string& event, std::set<std::string>& files);
+
+  protected:
+    OvmsMutex m_index_mutex;
+#ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+    event_index_t m_index_sd;
+#endif // #ifdef CONFIG_OVMS_DEV_SDCARDSCRIPTS
+    event_index_t m_index_store;
+    uint32_t m_index_hits;          // lookups served from the index
+    uint32_t m_index_misses;        // lookups needing an index (re)build
+    uint32_t m_index_skipped;       // lookups without scripts (directory opens saved)
   };
 
 extern OvmsScripts MyScripts;
@@ -159,6 +159,8 @@ OvmsServerV2 *MyOvmsServerV2 = NULL;
 size_t MyOvmsServerV2Modifier = 0;
 size_t MyOvmsServerV2Reader = 0;
 
+static ConfigHandle<int> cfg_timeout_rx("server.v2", "timeout.rx", 960);
+
 bool OvmsServerV2ReaderCallback(OvmsNotifyType* type, OvmsNotifyEntry* entry)
   {
   if (MyOvmsServerV2)
@@ -2053,7 +2055,7 @@ void OvmsServerV2::Ticker1(std::string event, void* data)
   if (StandardMetrics.ms_s_v2_connected->AsBool())
     {
     // check for issue #241 condition:
-    if (esp_log_timestamp() - m_lastrx_time > MyConfig.GetParamValueInt("server.v2", "timeout.rx", 960) * 1000)
+    if (esp_log_timestamp() - m_lastrx_time > cfg_timeout_rx.Get() * 1000)
       {
       ESP_LOGW(TAG, "Detected stale connection (issue #241), restarting network");
       MyNetManager.RestartNetwork();
@@ -195,6 +195,7 @@ OvmsServerV3::OvmsServerV3(const char* name)
   if (MyOvmsServerV3Modifier == 0)
     {
     MyOvmsServerV3Modifier = MyMetrics.RegisterModifier();
+    MyMetrics.EnableModifiedJournal(MyOvmsServerV3Modifier);
     ESP_LOGI(TAG, "OVMS Server V3 registered metric modifier is #%d",MyOvmsServerV3Modifier);
     }
 
@@ -361,60 +362,23 @@ void OvmsServerV3::TransmitAllMetrics()
 
 void OvmsServerV3::TransmitModifiedMetrics()
   {
-  static size_t s_mod_next_index = 0;
-
   OvmsMutexLock mg(&m_mgconn_mutex);
-  if (!m_mgconn)
-    {
-    s_mod_next_index = 0;
-    return;
-    }
+  if (!m_mgconn) return;
   if (!StandardMetrics.ms_s_v3_connected->AsBool()) return;
   CountClients();
 
-  // Locate starting point:
-  OvmsMetric* m = MyMetrics.m_first;
-  size_t pos = 0;
-  while (m && pos < s_mod_next_index)
-    {
-    m = m->m_next;
-    pos++;
-    }
-
-  // List shrank? restart:
-  if (!m && s_mod_next_index != 0)
-    {
-    s_mod_next_index = 0;
-    m = MyMetrics.m_first;
-    pos = 0;
-    }
-
-  int sent = 0;
-  while (m)
-    {
-    OvmsMetric* cur = m;
-    m = m->m_next;
-    // Check & clear modification flag for our modifier slot.
-    if (cur->IsModifiedAndClear(MyOvmsServerV3Modifier))
+  // Only visit metrics journaled as modified for our modifier slot:
+  size_t sent = MyMetrics.DrainModified(MyOvmsServerV3Modifier,
+    [this](OvmsMetric* m) -> bool
       {
-      TransmitMetric(cur);
-      sent++;
-      }
-    // Advance scan position regardless of modification:
-    s_mod_next_index++;
-
-    // Dynamically recalculate m_max_per_call_modified on each iteration
-    if (sent >= m_max_per_call_modified)
-      break;
-    }
+      TransmitMetric(m);
+      return true;
+      },
+    m_max_per_call_modified);
 
-  if (!m)
-    {
-    // Completed full pass; restart next call
-    s_mod_next_index = 0;
-    }
-  else
+  if (sent >= (size_t)m_max_per_call_modified)
     {
+    // More may remain; hint for rapid continuation (limited by caller behavior)
     m_lasttx = 0;
     }
   }
@@ -1085,6 +1085,9 @@ function initSocketConnection(){
         if (loghist.length > loghist_maxsize) loghist.shift();
         $(".receiver").trigger("msg:log", msg.log);
       }
+      else {
+        $(".receiver").trigger("msg:" + msgtype, msg[msgtype]);
+      }
     }
   };
 }
@@ -266,8 +266,3 @@ ssize_t HttpCommandStream::write(const void *buf, size_t nbyte)
   return nbyte;
 }
 
-void HttpCommandStream::Log(LogBuffers* message)
-{
-  // writing could block, logging is done via the websocket stream
-  message->release();
-}
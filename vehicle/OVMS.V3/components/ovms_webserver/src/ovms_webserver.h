@@ -366,11 +366,14 @@ enum WebSocketTxJobType
   WSTX_MetricsUpdate,         // payload: -
   WSTX_Config,                // payload: config (todo)
   WSTX_Notify,                // payload: notification
-  WSTX_LogBuffers,            // payload: logbuffers
+  WSTX_Log,                   // payload: - (log ring lines)
   WSTX_UnitMetricUpdate,      // payload: -
   WSTX_UnitPrefsUpdate,       // payload: -
+  WSTX_BmsHistory,            // payload: -
 };
 
+struct BmsHistoryCursor;
+
 struct WebSocketTxJob
 {
   WebSocketTxJobType          type;
@@ -379,7 +382,6 @@ struct WebSocketTxJob
     char*                     event;
     OvmsConfigParam*          config;
     OvmsNotifyEntry*          notification;
-    LogBuffers*               logbuffers;
   };
 
   void clear(size_t client);
@@ -417,10 +419,11 @@ class WebSocketHandler : public MgHandler, public OvmsWriter
     void SubscriptionChanged();
     void UnitsCheckSubscribe();
     void UnitsCheckVehicleSubscribe();
+    void BmsHistoryCheckSubscribe();
 
   // OvmsWriter:
   public:
-    void Log(LogBuffers* message);
+    void LogNotify();
 
   public:
     size_t                    m_slot = 0;
@@ -438,6 +441,13 @@ class WebSocketHandler : public MgHandler, public OvmsWriter
     std::set<std::string>     m_subscriptions;
     bool                      m_units_subscribed;
     bool                      m_units_prefs_subscribed;
+    bool                      m_bmshist_subscribed;
+    std::atomic<bool>         m_bmshist_queued;       // WSTX_BmsHistory job pending
+    std::atomic<uint32_t>     m_bmshist_seq;          // next BMS history record to send
+    BmsHistoryCursor*         m_bmshist_cursor;
+    std::atomic<bool>         m_log_queued;           // WSTX_Log job pending
+    LogRingCursor             m_log_cursor;           // next log ring line to send
+    std::string               m_log_line;
 };
 
 struct WebSocketSlot
@@ -480,7 +490,6 @@ class HttpCommandStream : public OvmsShell, public MgHandler
     int puts(const char* s);
     int printf(const char* fmt, ...) __attribute__ ((format (printf, 2, 3)));
     ssize_t write(const void *buf, size_t nbyte);
-    void Log(LogBuffers* message);
 };
 
 
@@ -550,6 +559,7 @@ class OvmsWebServer : public ExternalRamAllocated
   public:
     static void HandleStatus(PageEntry_t& p, PageContext_t& c);
     static void HandleCommand(PageEntry_t& p, PageContext_t& c);
+    static void HandleLogQuery(PageEntry_t& p, PageContext_t& c);
     static void HandleFile(PageEntry_t& p, PageContext_t& c);
     static void HandleShell(PageEntry_t& p, PageContext_t& c);
     static void HandleDashboard(PageEntry_t& p, PageContext_t& c);
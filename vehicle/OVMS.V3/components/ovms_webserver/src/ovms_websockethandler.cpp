@@ -74,11 +74,17 @@ WebSocketHandler::WebSocketHandler(mg_connection* nc, size_t slot, size_t modifi
   m_sent = m_ack = m_last = 0;
   m_units_subscribed = false;
   m_units_prefs_subscribed = false;
+  m_bmshist_subscribed = false;
+  m_bmshist_queued = false;
+  m_bmshist_seq = 0;
+  m_bmshist_cursor = NULL;
+  m_log_queued = false;
 
   MyMetrics.InitialiseSlot(m_slot);
   MyUnitConfig.InitialiseSlot(m_slot);
   
   // Register as logging console:
+  MyCommandApp.LogAttach(m_log_cursor);
   SetMonitoring(true);
   MyCommandApp.RegisterConsole(this);
 }
@@ -91,6 +97,8 @@ WebSocketHandler::~WebSocketHandler()
       ClearTxJob(m_job);
     vQueueDelete(m_jobqueue);
   }
+  if (m_bmshist_cursor)
+    delete m_bmshist_cursor;
 }
 
 
@@ -119,7 +127,6 @@ void WebSocketHandler::ProcessTxJob()
     }
     
     case WSTX_MetricsAll:
-    case WSTX_MetricsUpdate:
     {
       // Note: this loops over the metrics by index, keeping the last checked position
       //  in m_last. It will not detect new metrics added between polls if they are
@@ -138,14 +145,13 @@ void WebSocketHandler::ProcessTxJob()
         msg = "{\"metrics\":{";
         for (i=0; m && msg.size() < XFER_CHUNK_SIZE; m=m->m_next) {
           ++m_last;
-          if (m->IsModifiedAndClear(m_modifier) || m_job.type == WSTX_MetricsAll) {
-            if (i) msg += ',';
-            msg += '\"';
-            msg += m->m_name;
-            msg += "\":";
-            msg += m->AsJSON();
-            i++;
-          }
+          m->ClearModified(m_modifier);
+          if (i) msg += ',';
+          msg += '\"';
+          msg += m->m_name;
+          msg += "\":";
+          msg += m->AsJSON();
+          i++;
         }
 
         // send msg:
@@ -167,6 +173,51 @@ void WebSocketHandler::ProcessTxJob()
       break;
     }
 
+    case WSTX_MetricsUpdate:
+    {
+      // Note: this drains the metrics modification journal for our modifier, so only
+      //  metrics changed since the last update are visited. m_last is set when the
+      //  journal has been drained completely.
+      
+      // build msg:
+      if (!m_last) {
+        int i = 0;
+        bool more = false;
+        std::string msg;
+        msg.reserve(2*XFER_CHUNK_SIZE+128);
+        msg = "{\"metrics\":{";
+        MyMetrics.DrainModified(m_modifier, [&](OvmsMetric* m) -> bool {
+          if (i) msg += ',';
+          msg += '\"';
+          msg += m->m_name;
+          msg += "\":";
+          msg += m->AsJSON();
+          i++;
+          more = (msg.size() >= XFER_CHUNK_SIZE);
+          return !more;
+        });
+        if (!more)
+          m_last = 1;
+
+        // send msg:
+        if (i) {
+          msg += "}}";
+          ESP_EARLY_LOGV(TAG, "WebSocket msg: %s", msg.c_str());
+          mg_send_websocket_frame(m_nc, WEBSOCKET_OP_TEXT, msg.data(), msg.size());
+          m_sent += i;
+        }
+      }
+
+      // done?
+      if (m_last && m_ack == m_sent) {
+        if (m_sent)
+          ESP_EARLY_LOGV(TAG, "WebSocketHandler[%p]: ProcessTxJob type=%d done, sent=%d metrics", m_nc, m_job.type, m_sent);
+        ClearTxJob(m_job);
+      }
+      
+      break;
+    }
+
     case WSTX_UnitMetricUpdate:
     {
       // Note: this loops over the metrics by index, keeping the last checked position
@@ -336,30 +387,29 @@ void WebSocketHandler::ProcessTxJob()
       break;
     }
     
-    case WSTX_LogBuffers:
+    case WSTX_Log:
     {
-      // Note: this sender loops over the buffered lines by index (kept in m_sent)
+      // Note: this sender follows the log ring at our cursor, one line per frame.
       // Single log lines may be longer than our nominal XFER_CHUNK_SIZE, but that is
       // very rarely the case, so we shouldn't need to additionally chunk them.
-      LogBuffers* lb = m_job.logbuffers;
-
-      // find next line:
-      int i;
-      LogBuffers::iterator it;
-      for (i=0, it=lb->begin(); i < m_sent && it != lb->end(); it++, i++);
-      
-      if (it != lb->end()) {
+      if (MyCommandApp.LogRead(m_log_cursor, m_log_line)) {
         // encode & send:
+        m_log_line.resize(stripesc(&m_log_line[0], m_log_line.size()));
         std::string msg;
-        msg.reserve(strlen(*it)+128);
+        msg.reserve(m_log_line.size()+128);
         msg = "{\"log\":\"";
-        msg += json_encode(stripesc(*it));
+        msg += json_encode(m_log_line);
         msg += "\"}";
         mg_send_websocket_frame(m_nc, WEBSOCKET_OP_TEXT, msg.data(), msg.size());
         m_sent++;
       }
       else if (m_ack == m_sent) {
-        // done:
+        // done, unless new lines came in after the last read:
+        m_log_queued = false;
+        if (MyCommandApp.LogPending(m_log_cursor)) {
+          m_log_queued = true;
+          break;
+        }
         if (m_sent)
           ESP_EARLY_LOGV(TAG, "WebSocketHandler[%p]: ProcessTxJob type=%d done, sent=%d lines", m_nc, m_job.type, m_sent);
         ClearTxJob(m_job);
@@ -368,6 +418,43 @@ void WebSocketHandler::ProcessTxJob()
       break;
     }
     
+    case WSTX_BmsHistory:
+    {
+      // send one history record per frame:
+      BmsHistorySample sample;
+      OvmsVehicle* vehicle = MyVehicleFactory.ActiveVehicle();
+      if (m_bmshist_cursor && vehicle && vehicle->BmsGetHistory()->Read(*m_bmshist_cursor, sample)) {
+        std::string msg;
+        char val[16];
+        msg.reserve(64 + 7 * (sample.voltages.size() + sample.temperatures.size()));
+        msg = string_format("{\"bmshistory\":{\"seq\":%" PRIu32 ",\"time\":%" PRIu32 ",\"volt\":[",
+          sample.seq, sample.time);
+        for (int i = 0; i < sample.voltages.size(); i++) {
+          snprintf(val, sizeof(val), "%s%.3f", i ? "," : "", sample.voltages[i]);
+          msg += val;
+        }
+        msg += "],\"temp\":[";
+        for (int i = 0; i < sample.temperatures.size(); i++) {
+          snprintf(val, sizeof(val), "%s%.1f", i ? "," : "", sample.temperatures[i]);
+          msg += val;
+        }
+        msg += "]}}";
+        mg_send_websocket_frame(m_nc, WEBSOCKET_OP_TEXT, msg.data(), msg.size());
+        m_bmshist_seq = m_bmshist_cursor->seq;
+        m_sent++;
+      }
+      else if (m_ack == m_sent) {
+        // done:
+        if (m_sent)
+          ESP_EARLY_LOGV(TAG, "WebSocketHandler[%p]: ProcessTxJob type=%d done, sent=%d records", m_nc, m_job.type, m_sent);
+        if (m_bmshist_cursor)
+          m_bmshist_seq = m_bmshist_cursor->seq;
+        m_bmshist_queued = false;
+        ClearTxJob(m_job);
+      }
+      break;
+    }
+    
     case WSTX_Config:
     {
       // todo: implement
@@ -398,10 +485,6 @@ void WebSocketTxJob::clear(size_t client)
         if (mt) mt->MarkRead(slot.reader, notification);
       }
       break;
-    case WSTX_LogBuffers:
-      if (logbuffers)
-        logbuffers->release();
-      break;
     default:
       break;
   }
@@ -547,13 +630,15 @@ void WebSocketHandler::HandleIncomingMsg(std::string msg)
  * OvmsWriter interface
  */
 
-void WebSocketHandler::Log(LogBuffers* message)
+void WebSocketHandler::LogNotify()
 {
+  if (m_log_queued.exchange(true))
+    return;
   WebSocketTxJob job;
-  job.type = WSTX_LogBuffers;
-  job.logbuffers = message;
+  job.type = WSTX_Log;
+  job.event = NULL;
   if (!AddTxJob(job))
-    message->release();
+    m_log_queued = false;
 }
 
 
@@ -580,6 +665,7 @@ WebSocketHandler* OvmsWebServer::CreateWebSocketHandler(mg_connection* nc)
     WebSocketSlot slot;
     slot.handler = NULL;
     slot.modifier = MyMetrics.RegisterModifier();
+    MyMetrics.EnableModifiedJournal(slot.modifier);
     slot.reader = MyNotify.RegisterReader("ovmsweb", COMMAND_RESULT_VERBOSE,
                                           std::bind(&OvmsWebServer::IncomingNotification, i, _1, _2), true,
                                           std::bind(&OvmsWebServer::NotificationFilter, i, _1, _2));
@@ -751,7 +837,8 @@ void OvmsWebServer::UpdateTicker(TimerHandle_t timer)
   unsigned long mask_all = MyMetrics.GetUnitSendAll();
   for (auto slot: MyWebServer.m_client_slots) {
     if (slot.handler) {
-      slot.handler->AddTxJob({ WSTX_MetricsUpdate, NULL });
+      if (MyMetrics.HasModified(slot.handler->m_modifier))
+        slot.handler->AddTxJob({ WSTX_MetricsUpdate, NULL });
       if (slot.handler->m_units_subscribed) {
         unsigned long bit = 1ul << slot.handler->m_modifier;
         bool addJob = (bit & mask_all) != 0;
@@ -765,6 +852,15 @@ void OvmsWebServer::UpdateTicker(TimerHandle_t timer)
         if (MyUnitConfig.HasModified(slot.handler->m_modifier))
           slot.handler->AddTxJob({ WSTX_UnitPrefsUpdate, NULL });
       }
+      if (slot.handler->m_bmshist_subscribed && !slot.handler->m_bmshist_queued) {
+        // Send new BMS history records:
+        OvmsVehicle* vehicle = MyVehicleFactory.ActiveVehicle();
+        if (vehicle && vehicle->BmsGetHistory()->GetNextSeq() != slot.handler->m_bmshist_seq
+            && !slot.handler->m_bmshist_queued.exchange(true)) {
+          if (!slot.handler->AddTxJob({ WSTX_BmsHistory, NULL }))
+            slot.handler->m_bmshist_queued = false;
+        }
+      }
     }
   }
 
@@ -815,6 +911,7 @@ void WebSocketHandler::SubscriptionChanged()
 {
   UnitsCheckSubscribe();
   UnitsCheckVehicleSubscribe();
+  BmsHistoryCheckSubscribe();
 }
 
 void WebSocketHandler::UnitsCheckSubscribe()
@@ -845,6 +942,32 @@ void WebSocketHandler::UnitsCheckVehicleSubscribe()
   }
 }
 
+/**
+ * BmsHistoryCheckSubscribe: "bms/history" streams the BMS cell history,
+ *  starting with the oldest record, then new records as they are added.
+ */
+void WebSocketHandler::BmsHistoryCheckSubscribe()
+{
+  bool newSubscribe = IsSubscribedTo("bms/history");
+  if (newSubscribe != m_bmshist_subscribed) {
+    if (newSubscribe) {
+      ESP_LOGD(TAG, "WebSocketHandler[%p/%d]: Subscribed to bms/history", m_nc, m_modifier);
+      if (!m_bmshist_cursor)
+        m_bmshist_cursor = new BmsHistoryCursor();
+      OvmsVehicle* vehicle = MyVehicleFactory.ActiveVehicle();
+      m_bmshist_seq = vehicle ? vehicle->BmsGetHistory()->GetNextSeq() - 1 : 0;
+    } else {
+      ESP_LOGD(TAG, "WebSocketHandler[%p/%d]: Unsubscribed from bms/history", m_nc, m_modifier);
+      // a pending job terminates on the missing cursor:
+      if (m_bmshist_cursor) {
+        delete m_bmshist_cursor;
+        m_bmshist_cursor = NULL;
+      }
+    }
+    m_bmshist_subscribed = newSubscribe;
+  }
+}
+
 bool WebSocketHandler::IsSubscribedTo(std::string topic)
 {
   for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); it++) {
@@ -330,6 +330,50 @@ void OvmsWebServer::HandleCommand(PageEntry_t& p, PageContext_t& c)
 }
 
 
+/**
+ * HandleLogQuery: search log file by time range, tag & level
+ *  Parameters (all optional): file, from, to, tag, level, limit
+ *  See "log show" for the value syntax.
+ */
+void OvmsWebServer::HandleLogQuery(PageEntry_t& p, PageContext_t& c)
+{
+  extram::string command = "log show";
+  std::string val = c.getvar("file");
+  if (val.find('"') != std::string::npos) {
+    c.head(400);
+    c.print("ERROR: invalid parameter");
+    c.done();
+    return;
+  }
+  if (!val.empty()) {
+    command.append(" \"");
+    command.append(val.c_str());
+    command.append("\"");
+  }
+  for (const char* opt : { "from", "to", "tag", "level", "limit" }) {
+    val = c.getvar(opt);
+    if (val.empty())
+      continue;
+    if (val.find('"') != std::string::npos) {
+      c.head(400);
+      c.print("ERROR: invalid parameter");
+      c.done();
+      return;
+    }
+    command.append(" --");
+    command.append(opt);
+    command.append(" \"");
+    command.append(val.c_str());
+    command.append("\"");
+  }
+
+  c.head(200,
+    "Content-Type: text/plain; charset=utf-8\r\n"
+    "Cache-Control: no-cache");
+  new HttpCommandStream(c.nc, command, false, COMMAND_RESULT_NORMAL);
+}
+
+
 /**
  * HandleShell: command shell
  */
@@ -534,6 +578,7 @@ void OvmsWebServer::HandleCfgPassword(PageEntry_t& p, PageContext_t& c)
       error += "<li data-input=\"newpass2\">Passwords do not match</li>";
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       if (MyConfig.GetParamValue("password", "module") == MyConfig.GetParamValue("wifi.ap", "OVMS")) {
         MyConfig.SetParamValue("wifi.ap", "OVMS", newpass1);
@@ -649,6 +694,7 @@ void OvmsWebServer::HandleCfgVehicle(PageEntry_t& p, PageContext_t& c)
     }
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       MyConfig.SetParamValue("vehicle", "id", vehicleid);
       MyConfig.SetParamValue("auto", "vehicle.type", vehicletype);
@@ -910,6 +956,7 @@ void OvmsWebServer::HandleCfgModem(PageEntry_t& p, PageContext_t& c)
       }
     else 
       {
+      OvmsConfigTransaction txn;
       MyConfig.SetParamValue("modem", "apn", apn);
       MyConfig.SetParamValue("modem", "apn.user", apn_user);
       MyConfig.SetParamValue("modem", "apn.password", apn_pass);
@@ -1549,6 +1596,7 @@ void OvmsWebServer::HandleCfgServerV2(PageEntry_t& p, PageContext_t& c)
     }
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       MyConfig.SetParamValue("server.v2", "server", server);
       MyConfig.SetParamValueBool("server.v2", "tls", tls);
@@ -1705,6 +1753,7 @@ void OvmsWebServer::HandleCfgServerV3(PageEntry_t& p, PageContext_t& c)
     }
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       MyConfig.SetParamValue("server.v3", "server", server);
       MyConfig.SetParamValueBool("server.v3", "tls", tls);
@@ -1900,6 +1949,7 @@ void OvmsWebServer::HandleCfgNotifications(PageEntry_t& p, PageContext_t& c)
     }
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       if (vehicle_minsoc == "0")
         MyConfig.DeleteInstance("vehicle", "minsoc");
@@ -2087,6 +2137,7 @@ void OvmsWebServer::HandleCfgWebServer(PageEntry_t& p, PageContext_t& c)
     }
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       if (ws_txqueuesize == "")   MyConfig.DeleteInstance("http.server", "ws.txqueuesize");
       else                        MyConfig.SetParamValue("http.server", "ws.txqueuesize", ws_txqueuesize);
@@ -2245,6 +2296,7 @@ void OvmsWebServer::HandleCfgWifi(PageEntry_t& p, PageContext_t& c)
     if (cfg_sq_bad >= cfg_sq_good) {
       error += "<li data-input=\"cfg_sq_bad\">'Bad' signal level must be lower than 'good' level.</li>";
     } else {
+      OvmsConfigTransaction txn;
       if (cfg_sq_good == -87)
         MyConfig.DeleteInstance("network", "wifi.sq.good");
       else
@@ -2665,6 +2717,7 @@ void OvmsWebServer::HandleCfgAutoInit(PageEntry_t& p, PageContext_t& c)
     }
 
     if (error == "") {
+      OvmsConfigTransaction txn;
       // success:
       MyConfig.SetParamValueBool("auto", "init", init);
       MyConfig.SetParamValueBool("auto", "dbc", dbc);
@@ -2853,6 +2906,7 @@ void OvmsWebServer::HandleCfgFirmware(PageEntry_t& p, PageContext_t& c)
       }
 
       if (!error) {
+        OvmsConfigTransaction txn;
         MyConfig.SetParamValueBool("auto", "ota", auto_enable);
         MyConfig.SetParamValueBool("ota", "auto.allow.modem", auto_allow_modem);
         MyConfig.SetParamValue("ota", "auto.hour", auto_hour);
@@ -3216,6 +3270,7 @@ void OvmsWebServer::HandleCfgLogging(PageEntry_t& p, PageContext_t& c)
       pmap["file.keepdays"] = c.getvar("file_keepdays");
     if (c.getvar("file_syncperiod") != "")
       pmap["file.syncperiod"] = c.getvar("file_syncperiod");
+    pmap["file.format"] = (c.getvar("file_format") == "binary") ? "binary" : "text";
 
     file_path = c.getvar("file_path");
     pmap["file.path"] = file_path;
@@ -3286,6 +3341,14 @@ void OvmsWebServer::HandleCfgLogging(PageEntry_t& p, PageContext_t& c)
   }
   c.input_info("Download", download.c_str());
 
+  c.input_select_start("File format", "file_format");
+  c.input_select_option("Text", "text", pmap["file.format"] != "binary");
+  c.input_select_option("Binary (indexed)", "binary", pmap["file.format"] == "binary");
+  c.input_select_end(
+    "<p>Binary log files are about half the size and can be searched quickly by time range."
+    " Use command <code>log show</code> or URL <code>/api/log?from=…&amp;to=…&amp;tag=…</code> to view them."
+    " Changing the format archives the current log file.</p>");
+
   c.input("number", "Sync period", "file_syncperiod", pmap["file.syncperiod"].c_str(), "Default: 3",
     "<p>How often to flush log buffer to SD: 0 = never/auto, &lt;0 = every n messages, &gt;0 = after n/2 seconds idle</p>",
     "min=\"-1\" step=\"1\"");
@@ -3442,6 +3505,7 @@ void OvmsWebServer::HandleCfgLocations(PageEntry_t& p, PageContext_t& c)
     valet_dist = c.getvar("valet.dist");
     valet_time = c.getvar("valet.interval");
     if (error == "") {
+      OvmsConfigTransaction txn;
       // save:
       param->m_map.clear();
       param->m_map = std::move(pmap);
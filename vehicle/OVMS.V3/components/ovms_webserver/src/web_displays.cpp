@@ -686,12 +686,13 @@ void OvmsWebServer::HandleBmsCellMonitor(PageEntry_t& p, PageContext_t& c)
   PAGE_HOOK("body.pre");
 
   c.print(
-    "<div class=\"panel panel-primary panel-single receiver\" id=\"livestatus\">\n"
+    "<div class=\"panel panel-primary panel-single receiver\" id=\"livestatus\" data-subscriptions=\"bms/history\">\n"
       "<div class=\"panel-heading\">BMS Cell Monitor</div>\n"
       "<div class=\"panel-body\">\n"
         "<div class=\"row\">\n"
           "<div id=\"voltchart\" style=\"width: 100%; max-width: 100%; height: 45vh; min-height: 280px; margin: 0 auto\"></div>\n"
           "<div id=\"tempchart\" style=\"width: 100%; max-width: 100%; height: 25vh; min-height: 160px; margin: 0 auto\"></div>\n"
+          "<div id=\"histchart\" style=\"width: 100%; max-width: 100%; height: 30vh; min-height: 200px; margin: 0 auto\"></div>\n"
         "</div>\n"
       "</div>\n"
       "<div class=\"panel-footer\">\n"
@@ -1057,6 +1058,9 @@ void OvmsWebServer::HandleBmsCellMonitor(PageEntry_t& p, PageContext_t& c)
             "}\n"
           "},\n"
         "},\n"
+        "plotOptions: {\n"
+          "series: { point: { events: { click: function () { select_hist_cell(this.x); } } } },\n"
+        "},\n"
         "series: [{\n"
           "name: 'Voltage',\n"
           "zIndex: 1,\n"
@@ -1222,6 +1226,107 @@ void OvmsWebServer::HandleBmsCellMonitor(PageEntry_t& p, PageContext_t& c)
     "}\n"
     "\n"
     "\n"
+    "/**\n"
+     "* Cell voltage history chart (websocket topic bms/history)\n"
+     "*/\n"
+    "\n"
+    "var histchart, hist = { seq: -1, recs: [], cell: -1, timer: null };\n"
+    "\n"
+    "// the page subscription outlives the page, drop it so the\n"
+    "// data-subscriptions init restarts the stream with the oldest record:\n"
+    "if (ws && ws.readyState == ws.OPEN) ws.send('unsubscribe bms/history');\n"
+    "\n"
+    "function get_hist_point(rec) {\n"
+      "var v = rec.volt, i, min = v[0], max = v[0], sum = 0;\n"
+      "for (i=0; i<v.length; i++) {\n"
+        "if (v[i] < min) min = v[i];\n"
+        "if (v[i] > max) max = v[i];\n"
+        "sum += v[i];\n"
+      "}\n"
+      "return { t: rec.time * 1000, min: min, max: max, avg: v.length ? sum / v.length : null,\n"
+        "cell: (hist.cell >= 0 && hist.cell < v.length) ? v[hist.cell] : null };\n"
+    "}\n"
+    "\n"
+    "function update_hist_chart() {\n"
+      "hist.timer = null;\n"
+      "var range = [], avg = [], cell = [], i, p;\n"
+      "for (i=0; i<hist.recs.length; i++) {\n"
+        "p = get_hist_point(hist.recs[i]);\n"
+        "range.push([p.t, p.min, p.max]);\n"
+        "avg.push([p.t, p.avg]);\n"
+        "cell.push([p.t, p.cell]);\n"
+      "}\n"
+      "histchart.series[0].setData(range, false);\n"
+      "histchart.series[1].setData(avg, false);\n"
+      "histchart.series[2].setData(cell, false);\n"
+      "histchart.series[2].update({ name: (hist.cell >= 0) ? 'Cell #' + (hist.cell+1) : 'Cell (click cell to select)' }, false);\n"
+      "histchart.redraw();\n"
+    "}\n"
+    "\n"
+    "function select_hist_cell(index) {\n"
+      "hist.cell = index;\n"
+      "update_hist_chart();\n"
+    "}\n"
+    "\n"
+    "function init_hist_chart() {\n"
+      "histchart = Highcharts.chart('histchart', {\n"
+        "chart: {\n"
+          "type: 'line',\n"
+          "zoomType: 'x',\n"
+          "panning: true,\n"
+          "panKey: 'ctrl',\n"
+          "events: {\n"
+            "load: function () {\n"
+              "$('#livestatus').on(\"msg:bmshistory\", function(e, rec){\n"
+                "// history is resent from the oldest record on reconnect:\n"
+                "if (rec.seq <= hist.seq) hist.recs = [];\n"
+                "hist.seq = rec.seq;\n"
+                "hist.recs.push(rec);\n"
+                "if (!hist.timer) hist.timer = window.setTimeout(update_hist_chart, 500);\n"
+              "});\n"
+            "}\n"
+          "},\n"
+        "},\n"
+        "title: { text: null },\n"
+        "credits: { enabled: false },\n"
+        "legend: {\n"
+          "enabled: true,\n"
+          "align: 'center',\n"
+          "verticalAlign: 'bottom',\n"
+          "margin: 2,\n"
+          "padding: 2,\n"
+        "},\n"
+        "time: { useUTC: false },\n"
+        "xAxis: { type: 'datetime' },\n"
+        "yAxis: {\n"
+          "title: { text: null },\n"
+          "labels: { format: \"{value:.2f}V\" },\n"
+          "minTickInterval: 0.01,\n"
+          "minorTickInterval: 'auto',\n"
+        "},\n"
+        "tooltip: {\n"
+          "shared: true,\n"
+          "padding: 4,\n"
+          "valueDecimals: 3,\n"
+          "valueSuffix: ' V',\n"
+        "},\n"
+        "plotOptions: { series: { animation: false, marker: { enabled: false } } },\n"
+        "series: [{\n"
+          "name: 'Min – Max',\n"
+          "type: 'arearange',\n"
+          "data: [],\n"
+        "},{\n"
+          "name: 'Average',\n"
+          "data: [],\n"
+        "},{\n"
+          "name: 'Cell (click cell to select)',\n"
+          "data: [],\n"
+        "}]\n"
+      "});\n"
+      "$('#histchart').data('chart', histchart).addClass('has-chart');"
+    "}\n"
+    "\n"
+    "\n"
     "/**\n"
      "* Chart initialization\n"
      "*/\n"
@@ -1229,6 +1334,7 @@ void OvmsWebServer::HandleBmsCellMonitor(PageEntry_t& p, PageContext_t& c)
     "function init_charts() {\n"
       "init_volt_chart();\n"
       "init_temp_chart();\n"
+      "init_hist_chart();\n"
     "}\n"
     "\n"
     "if (window.Highcharts) {\n"
@@ -37,6 +37,7 @@ static const char *TAG_DK = "duktape-poll";
 #include <ovms_command.h>
 #include <ovms_script.h>
 #include <ovms_metrics.h>
+#include <ovms_config.h>
 #include <ovms_notify.h>
 #include <metrics_standard.h>
 #ifdef CONFIG_OVMS_COMP_WEBSERVER
@@ -55,12 +56,18 @@ using namespace std::placeholders;
 
 OvmsPollers MyPollers __attribute__ ((init_priority (7000)));
 
+static ConfigHandle<bool> cfg_can_autooff("vehicle", "can.autooff", true);
+static ConfigHandle<bool> cfg_poller_timers("log", "poller.timers", false);
+static ConfigHandle<bool> cfg_poller_adaptive("vehicle", "poller.adaptive", false);
+static ConfigHandle<int> cfg_poller_adaptive_maxfactor("vehicle", "poller.adaptive.maxfactor", 8);
+static ConfigHandle<int> cfg_poller_adaptive_stable("vehicle", "poller.adaptive.stable", 3);
+
 // Runtime control for logging:
 #define IFTRACE(x) if (MyPollers.HasTrace(OvmsPollers::tracetype_t::trace_##x))
 
 OvmsPoller::OvmsPoller(canbus* can, uint8_t can_number, OvmsPollers *parent,
     const CanFrameCallback &polltxcallback)
-  : m_parent(parent)
+  : m_parent(parent), m_pipeline(&m_poll_txcallback)
   {
   m_poll.bus = can;
   m_poll.bus_no = can_number;
@@ -91,6 +98,18 @@ OvmsPoller::OvmsPoller(canbus* can, uint8_t can_number, OvmsPollers *parent,
   m_poll_repeat_count = 0;
   m_poll_sent_last = 0;
   m_poll_between_success = 0;
+  m_poll_pending = false;
+  m_poll_pending_serial = false;
+  m_pipeline_txdue = 0;
+  }
+
+/** Send pipelined consecutive frames whose separation time has passed.
+ */
+void OvmsPoller::PipelineTxTicker()
+  {
+  OvmsRecMutexLock lock(&m_poll_mutex);
+  m_pipeline.TxTicker();
+  m_pipeline_txdue = m_pipeline.TxDue();
   }
 
 /** Handle incoming frame.
@@ -99,6 +118,28 @@ OvmsPoller::OvmsPoller(canbus* can, uint8_t can_number, OvmsPollers *parent,
 bool OvmsPoller::Incoming(CAN_frame_t &frame, bool success)
   {
 
+  // Pipelined requests:
+  if (m_pipeline.Active() > 0 && frame.origin == m_poll.bus)
+    {
+    OvmsRecMutexLock lock(&m_poll_mutex);
+    uint8_t active = m_pipeline.Active();
+    if (m_pipeline.Receive(&frame))
+      {
+      // Consecutive frames waiting for the separation time are sent by the poller task:
+      m_pipeline_txdue = m_pipeline.TxDue();
+      if (m_pipeline_txdue)
+        m_parent->PipelineTxScheduled();
+      // Slot free: send deferred/next request
+      if (m_pipeline.Active() < active)
+        {
+        m_pipeline.StartDeferred(m_poll);
+        if (!m_pipeline.IsFull() && CanPoll())
+          Queue_PollerSendSuccess();
+        }
+      return true;
+      }
+    }
+
   // No multiframe request is active.
   if (m_poll.type == VEHICLE_POLL_TYPE_NONE)
     return false;
@@ -200,11 +241,16 @@ void OvmsPoller::PollSetPidList(uint8_t defaultbus, const OvmsPoller::poll_pid_t
     if (!plist) // Don't add if not necessary.
       return;
     m_poll_series = std::shared_ptr<StandardPollSeries>(new StandardVehiclePollSeries(this, signal));
+    m_poll_series->SetAdaptive(m_parent->m_poll_adaptive);
     m_polls.SetEntry("!v.standard", m_poll_series);
     }
 
   m_poll_series->PollSetPidList(defaultbus, plist);
 
+  // Drop pending responses for the previous list:
+  m_pipeline.Clear();
+  m_poll_pending = false;
+
   m_poll_run_finished = true;
   m_poll.ticker = init_ticker;
   m_poll_sequence_cnt = 0;
@@ -255,6 +301,7 @@ void OvmsPoller::PollSetResponseSeparationTime(uint8_t septime)
   {
   assert (septime <= 127 || (septime >= 241 && septime <= 249));
   m_poll_fc_septime  = septime;
+  m_pipeline.SetResponseSeparationTime(septime);
   }
 
 
@@ -282,6 +329,27 @@ void OvmsPoller::PollSetTimeBetweenSuccess(uint16_t time_between_ms)
   m_poll_between_success = pdMS_TO_TICKS(time_between_ms);
   }
 
+/**
+ * PollSetPipelineWindow: configure pipelined ISO-TP polling
+ *  With a window > 1, up to <window> requests of the PollSetPidList() list are
+ *  sent without waiting for the previous response, one per ECU (TX/RX ID pair).
+ *  Responses are reassembled per ECU and passed to IncomingPollReply() when
+ *  complete, so the frames of different ECUs don't interleave there.
+ *  Broadcasts, VWTP and all other poll series are still sent one at a time,
+ *  after all pipelined requests have finished.
+ *
+ *  Note: PollSetThrottling() limits the total number of requests per tick,
+ *  so it needs to be raised or disabled for pipelining to take effect.
+ *
+ *  @param window
+ *    Max requests in flight, 1 = no pipelining (default), max VEHICLE_POLL_PIPELINE_MAX.
+ */
+void OvmsPoller::PollSetPipelineWindow(uint8_t window)
+  {
+  OvmsRecMutexLock lock(&m_poll_mutex);
+  m_pipeline.SetWindow(window);
+  }
+
 void OvmsPoller::ResetThrottle()
   {
   // Main Timer reset throttling counter,
@@ -297,6 +365,7 @@ void OvmsPoller::ResetPollEntry(bool force)
     m_polls.RestartPoll(OvmsPoller::ResetMode::PollReset);
     m_poll.entry = {};
     m_poll_txmsgid = 0;
+    m_poll_pending = false;
     }
   }
 
@@ -309,6 +378,8 @@ bool OvmsPoller::HasPollList() const
 void OvmsPoller::ClearPollList()
   {
   OvmsRecMutexLock lock(&m_poll_mutex);
+  m_pipeline.Clear();
+  m_poll_pending = false;
   return m_polls.Clear();
   }
 
@@ -398,6 +469,12 @@ void OvmsPoller::PollerSend(poller_source_t source)
     // Timer ticker call: check response timeout
     if (m_poll_wait > 0)
       m_poll_wait--;
+    if (!m_pipeline.IsIdle())
+      {
+      OvmsRecMutexLock lock(&m_poll_mutex);
+      m_pipeline.Ticker();
+      m_pipeline.StartDeferred(m_poll);
+      }
 
     // Protocol specific ticker calls:
     PollerVWTPTicker();
@@ -408,6 +485,11 @@ void OvmsPoller::PollerSend(poller_source_t source)
     IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]PollerSend: Waiting %" PRIu8, m_poll.bus_no, m_poll_wait);
     return;
     }
+  if (m_poll_ticked && m_poll_run_finished && !m_pipeline.IsIdle())
+    {
+    IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]PollerSend: Waiting for %" PRIu8 " pipelined", m_poll.bus_no, m_pipeline.Active());
+    return;
+    }
 
   if (!curIsBlocking && m_poll_ticked)
     {
@@ -447,6 +529,13 @@ void OvmsPoller::PollerSend(poller_source_t source)
     return;
     }
 
+  // Entry waiting for the pipeline?
+  if (m_poll_pending)
+    {
+    PollerStart(fromPrimaryOrOnceOffTicker, m_poll_pending_serial);
+    return;
+    }
+
   OvmsPoller::OvmsNextPollResult res;
   {
     OvmsRecMutexLock lock(&m_poll_mutex, pdMS_TO_TICKS(50));
@@ -506,31 +595,96 @@ void OvmsPoller::PollerSend(poller_source_t source)
       break;
     case OvmsNextPollResult::FoundEntry:
       {
+      if (m_poll.entry.xargs.tag == POLL_TXBATCH)
+        {
+        // Multi DID entries need to be translated by the series (see BatchNextEntry),
+        // sent as is the tag would be taken as args.datalen:
+        ESP_LOGE(TAG, "[%" PRIu8 "]PollerSend: skipping untranslated multi DID entry (type=%02X, pid=%X)",
+                 m_poll.bus_no, m_poll.entry.type, m_poll.entry.pid);
+        break;
+        }
       IFTRACE(Poller) 
         ESP_LOGD(TAG, "[%" PRIu8 "]PollerSend(%s)[%" PRIu8 "]: entry at[type=%02X, pid=%X], ticker=%" PRIu32 ", wait=%u, cnt=%u/%u",
              m_poll.bus_no, PollerSource(source), m_poll_state, m_poll.entry.type, m_poll.entry.pid,
              m_poll.ticker, m_poll_wait, m_poll_sequence_cnt, m_poll_sequence_max);
       // We need to poll this one...
-      m_poll.protocol = m_poll.entry.protocol;
-      m_poll.type = m_poll.entry.type;
-      m_poll.pid = m_poll.entry.pid;
-
-      m_poll_sent_last = monotonictime;
-      // Dispatch transmission start to protocol handler:
-      if (m_poll.protocol == VWTP_20)
-        PollerVWTPStart(fromPrimaryOrOnceOffTicker);
-      else
-        PollerISOTPStart(fromPrimaryOrOnceOffTicker);
-
-      m_poll_sequence_cnt++;
+      // (only entries of the PollSetPidList() list may be pipelined)
+      PollerStart(fromPrimaryOrOnceOffTicker,
+        !m_pipeline.IsEnabled() || curIsBlocking || !m_poll_series
+        || m_polls.CurrentSeries() != m_poll_series.get());
       break;
       }
     }
   }
 
+/**
+ * PollerStart: internal: send m_poll.entry, or keep it pending until it can be sent
+ *  Serial requests need to wait for all pipelined requests to finish, pipelined
+ *  requests for a free slot & their ECU to be idle.
+ */
+void OvmsPoller::PollerStart(bool fromTicker, bool serial)
+  {
+  m_poll_pending = false;
+  if (serial || !ISOTPPipeline::IsEligible(m_poll.entry))
+    {
+    if (!m_pipeline.IsIdle())
+      {
+      IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]PollerStart: Serial waiting for %" PRIu8 " pipelined", m_poll.bus_no, m_pipeline.Active());
+      m_poll_pending = true;
+      m_poll_pending_serial = true;
+      return;
+      }
+
+    m_poll.protocol = m_poll.entry.protocol;
+    m_poll.type = m_poll.entry.type;
+    m_poll.pid = m_poll.entry.pid;
+
+    m_poll_sent_last = monotonictime;
+    // Dispatch transmission start to protocol handler:
+    if (m_poll.protocol == VWTP_20)
+      PollerVWTPStart(fromTicker);
+    else
+      PollerISOTPStart(fromTicker);
+
+    m_poll_sequence_cnt++;
+    return;
+    }
+
+  OvmsRecMutexLock lock(&m_poll_mutex);
+  if (m_pipeline.IsBusy(m_poll.entry) ? !m_pipeline.Defer(m_poll.entry, m_poll_series.get()) : m_pipeline.IsFull())
+    {
+    IFTRACE(Poller) ESP_LOGV(TAG, "[%" PRIu8 "]PollerStart: Waiting for pipeline slot", m_poll.bus_no);
+    m_poll_pending = true;
+    m_poll_pending_serial = false;
+    return;
+    }
+
+  // Send now unless deferred:
+  m_poll_sent_last = monotonictime;
+  if (!m_pipeline.IsBusy(m_poll.entry))
+    m_pipeline.Start(m_poll, m_poll.entry, m_poll_series.get());
+  m_poll_sequence_cnt++;
+
+  // Fill up the window:
+  if (!m_pipeline.IsFull() && CanPoll())
+    Queue_PollerSendSuccess();
+  }
+
 void OvmsPoller::Outgoing(const CAN_frame_t &frame, bool success)
   {
 
+  // Pipelined request?
+  if (m_pipeline.Active() > 0 && frame.origin == m_poll.bus)
+    {
+    OvmsRecMutexLock lock(&m_poll_mutex, pdMS_TO_TICKS(10));
+    if (lock.IsLocked() && m_pipeline.TxCallback(&frame, success))
+      {
+      if (!success)
+        m_pipeline.StartDeferred(m_poll);
+      return;
+      }
+    }
+
   // Check for a late callback:
   if (!m_poll_wait || !m_poll.entry.txmoduleid || frame.origin != m_poll.bus || frame.MsgID != m_poll_txmsgid)
     {
@@ -784,6 +938,13 @@ void OvmsPoller::PollerStatus(int verbosity, OvmsWriter* writer)
     }
   writer->printf("  Ticker: %" PRIu32 "\n", m_poll.ticker);
   writer->printf("  State:  %" PRIu8 "\n", m_poll_state);
+  if (m_pipeline.IsEnabled() || m_pipeline.m_cnt_started)
+    {
+    writer->printf("  Pipeline: window %" PRIu8 ", active %" PRIu8 ", deferred %" PRIu8 ", sent %" PRIu32
+                   ", done %" PRIu32 ", errors %" PRIu32 ", timeouts %" PRIu32 "\n",
+                   m_pipeline.GetWindow(), m_pipeline.Active(), m_pipeline.Deferred(), m_pipeline.m_cnt_started,
+                   m_pipeline.m_cnt_done, m_pipeline.m_cnt_error, m_pipeline.m_cnt_timeout);
+    }
   m_polls.Status(verbosity, writer);
   }
 /**
@@ -841,6 +1002,7 @@ const char *OvmsPoller::PollerCommand(OvmsPollCommand src, bool brief)
     case OvmsPollCommand::SuccessSep:  return brief ? "SucSp" : "SuccSep";
     case OvmsPollCommand::Shutdown:    return brief ? "Shtdn" : "Shutdown";
     case OvmsPollCommand::ResetTimer:  return brief ? "RstTm" : "ResetTimer";
+    case OvmsPollCommand::Pipeline:    return brief ? "Pipln" : "Pipeline";
     }
   return "??";
   }
@@ -851,12 +1013,15 @@ OvmsPollers::OvmsPollers()
     m_poll_fc_septime(25),
     m_poll_ch_keepalive(60),
     m_poll_between_success(0),
+    m_poll_pipeline(1),
+    m_poll_adaptive({ false, 8, 3 }),
     m_poll_last(0),
     m_pollqueue(nullptr), m_polltask(nullptr),
     m_timer_poller(nullptr),
     m_poll_subticker(0),
     m_poll_tick_ms(1000),
     m_poll_tick_secondary(0),
+    m_pipeline_txpending(false),
     m_shut_down(false),
     m_ready(false),
     m_paused(false),
@@ -904,6 +1069,13 @@ OvmsPollers::OvmsPollers()
   cmd_times->RegisterCommand("off","Turn off Poll-Time Tracing",poller_times);
   cmd_times->RegisterCommand("status","Show timing status",poller_times);
   cmd_times->RegisterCommand("reset","Reset Poll-Time Tracing",poller_times);
+  OvmsCommand* cmd_pipeline = cmd_poller->RegisterCommand("pipeline","Pipelined ISO-TP polling");
+  cmd_pipeline->RegisterCommand("window","Set max requests in flight per bus (1 = off)",poller_pipeline,"<window>",1,1);
+  cmd_pipeline->RegisterCommand("test","Benchmark pipeline on simulated ECUs",poller_pipeline_test,"[<ecus> [<pids> [<latency_ms>]]]",0,3);
+  OvmsCommand* cmd_adaptive = cmd_poller->RegisterCommand("adaptive","Adaptive poll intervals");
+  cmd_adaptive->RegisterCommand("test","Simulate adaptive polling on recorded value traces",poller_adaptive_test,"[<hours>]",0,1);
+  OvmsCommand* cmd_batch = cmd_poller->RegisterCommand("batch","Multi DID requests");
+  cmd_batch->RegisterCommand("test","Benchmark multi DID requests on simulated ECUs",poller_batch_test,"[<ecus> [<dids> [<latency_ms>]]]",0,3);
 
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   DuktapeObjectRegistration* dto = new DuktapeObjectRegistration("OvmsPoller");
@@ -946,7 +1118,10 @@ OvmsPollers::OvmsPollers()
 #endif
 
   if (MyConfig.ismounted())
+    {
     LoadPollerTimerConfig();
+    LoadAdaptiveConfig();
+    }
   }
 
 OvmsPollers::~OvmsPollers()
@@ -1000,7 +1175,7 @@ void OvmsPollers::ShuttingDown()
       m_pollers[i]->ClearPollList();
     }
 
-  bool autoOff = MyConfig.GetParamValueBool("vehicle", "can.autooff", true);
+  bool autoOff = cfg_can_autooff.Get();
   ESP_LOGV(TAG, "Poller Shutdown Powering Down Busses%s", autoOff ? "" : " (disabled)");
   for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
     {
@@ -1027,7 +1202,7 @@ void OvmsPollers::ShuttingDown()
 
 void OvmsPollers::ShuttingDownVehicle()
   {
-  bool autoOff = MyConfig.GetParamValueBool("vehicle", "can.autooff", true);
+  bool autoOff = cfg_can_autooff.Get();
   OvmsRecMutexLock lock(&m_poller_mutex);
   for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
     {
@@ -1191,16 +1366,41 @@ void OvmsPollers::ConfigChanged(std::string event, void* data)
   OvmsConfigParam* param = (OvmsConfigParam*) data;
   if (!param || param->GetName() == "log")
     LoadPollerTimerConfig();
+  if (!param || param->GetName() == "vehicle")
+    LoadAdaptiveConfig();
   }
 
 void OvmsPollers::LoadPollerTimerConfig()
   {
-  if (MyConfig.GetParamValueBool("log", "poller.timers", false))
+  if (cfg_poller_timers.Get())
     MyPollers.m_trace |= trace_Times;
   else
     MyPollers.m_trace &= ~trace_Times;
   }
 
+/**
+ * LoadAdaptiveConfig: read adaptive poll interval config & pass on to the pollers
+ */
+void OvmsPollers::LoadAdaptiveConfig()
+  {
+  OvmsPoller::poll_adaptive_t cfg;
+  cfg.enabled = cfg_poller_adaptive.Get();
+  cfg.maxfactor = LIMIT_MAX(LIMIT_MIN(cfg_poller_adaptive_maxfactor.Get(), 1), 128);
+  cfg.stable = LIMIT_MAX(LIMIT_MIN(cfg_poller_adaptive_stable.Get(), 1), 100);
+  if (cfg.enabled == m_poll_adaptive.enabled && cfg.maxfactor == m_poll_adaptive.maxfactor
+      && cfg.stable == m_poll_adaptive.stable)
+    return;
+  ESP_LOGI(TAG, "Adaptive polling %s (max factor %" PRIu8 ", stable %" PRIu8 ")",
+           cfg.enabled ? "enabled" : "disabled", cfg.maxfactor, cfg.stable);
+  m_poll_adaptive = cfg;
+  OvmsRecMutexLock lock(&m_poller_mutex);
+  for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+    {
+    if (m_pollers[i])
+      m_pollers[i]->PollSetAdaptive(m_poll_adaptive);
+    }
+  }
+
 /**
  * PollerTxCallback: internal: process poll request callbacks
  */
@@ -1430,6 +1630,37 @@ OvmsPollers::poller_key_st::poller_key_st( const OvmsPoller::poll_queue_entry_t
     }
   }
 
+/** Send due pipeline consecutive frames of all pollers.
+ * @return ticks to wait for the next due frame, portMAX_DELAY if none is scheduled.
+ */
+TickType_t OvmsPollers::PipelineTxTicker()
+  {
+  int64_t next = 0;
+  int64_t now = esp_timer_get_time();
+    {
+    OvmsRecMutexLock lock(&m_poller_mutex);
+    for (int i = 0; i < VEHICLE_MAXBUSSES; ++i)
+      {
+      OvmsPoller *poller = m_pollers[i];
+      if (!poller || !poller->m_pipeline_txdue)
+        continue;
+      if (poller->m_pipeline_txdue <= now)
+        poller->PipelineTxTicker();
+      if (poller->m_pipeline_txdue && (!next || poller->m_pipeline_txdue < next))
+        next = poller->m_pipeline_txdue;
+      }
+    }
+  if (!next)
+    {
+    m_pipeline_txpending = false;
+    return portMAX_DELAY;
+    }
+  int64_t delay = next - esp_timer_get_time();
+  if (delay <= 0)
+    return 1;
+  return (delay + portTICK_PERIOD_MS*1000 - 1) / (portTICK_PERIOD_MS*1000);
+  }
+
 void OvmsPollers::PollerTask()
   {
   OvmsPoller::poll_queue_entry_t entry;
@@ -1440,7 +1671,9 @@ void OvmsPollers::PollerTask()
       ShuttingDown();
       break;
       }
-    if (xQueueReceive(m_pollqueue, &entry, (portTickType)portMAX_DELAY)!=pdTRUE)
+    // Wake up in time for paced pipeline consecutive frames:
+    TickType_t wait = m_pipeline_txpending ? PipelineTxTicker() : portMAX_DELAY;
+    if (xQueueReceive(m_pollqueue, &entry, (portTickType)wait)!=pdTRUE)
       continue;
 
     IFTRACE(Times)
@@ -1666,6 +1899,18 @@ void OvmsPollers::PollerTask()
                 }
               }
             break;
+          case OvmsPoller::OvmsPollCommand::Pipeline:
+            if (entry.entry_Command.parameter != m_poll_pipeline)
+              {
+              m_poll_pipeline = entry.entry_Command.parameter;
+              OvmsRecMutexLock lock(&m_poller_mutex);
+              for (int i = 0 ; i < VEHICLE_MAXBUSSES; ++i)
+                {
+                if (m_pollers[i])
+                  m_pollers[i]->PollSetPipelineWindow(m_poll_pipeline);
+                }
+              }
+            break;
           case OvmsPoller::OvmsPollCommand::ResetTimer:
             break;//triggered above
           }
@@ -1744,8 +1989,9 @@ OvmsPoller *OvmsPollers::GetPoller(canbus *can, bool force)
     auto newpoller =  new OvmsPoller(can, busno, this, m_poll_txcallback);
     newpoller->m_poll_state = m_poll_state;
     newpoller->m_poll_sequence_max = m_poll_sequence_max;
-    newpoller->m_poll_fc_septime = m_poll_fc_septime;
+    newpoller->PollSetResponseSeparationTime(m_poll_fc_septime);
     newpoller->m_poll_ch_keepalive = m_poll_ch_keepalive;
+    newpoller->m_pipeline.SetWindow(m_poll_pipeline);
     m_pollers[gap] = newpoller;
     }
 
@@ -2089,6 +2335,18 @@ void OvmsPollers::vehicle_poller_trace(int verbosity, OvmsWriter* writer, OvmsCo
       );
   }
 
+void OvmsPollers::poller_pipeline(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int window = atoi(argv[0]);
+  if (window < 1 || window > VEHICLE_POLL_PIPELINE_MAX)
+    {
+    writer->printf("Error: window must be 1-%d\n", VEHICLE_POLL_PIPELINE_MAX);
+    return;
+    }
+  MyPollers.PollSetPipelineWindow(window);
+  writer->printf("Poller pipeline window set to %d\n", window);
+  }
+
 void OvmsPollers::poller_times(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   if (strcmp(cmd->GetName(), "on") == 0)
@@ -2108,6 +2366,7 @@ void OvmsPollers::poller_times(int verbosity, OvmsWriter* writer, OvmsCommand* c
     writer->printf("Poller timing is: %s\n",
       (MyPollers.m_trace & trace_Times) ? "on" : "off");
     MyPollers.PollerTimesTrace(writer);
+    MyPollers.PollerAdaptiveTrace(writer);
     }
   else if (strcmp(cmd->GetName(), "reset") == 0)
     {
@@ -2315,7 +2574,7 @@ duk_ret_t OvmsPollers::DukOvmsPollerGetTrace(duk_context *ctx)
 // OvmsPoller.Times.GetStarted
 duk_ret_t OvmsPollers::DukOvmsPollerTimesGetStarted(duk_context *ctx)
   {
-  bool enabled = MyConfig.GetParamValueBool("log", "poller.timers", false);
+  bool enabled = cfg_poller_timers.Get();
   duk_push_boolean(ctx, enabled?1:0);
   return 1;
   }
@@ -2350,7 +2609,7 @@ duk_ret_t OvmsPollers::DukOvmsPollerTimesGetStatus(duk_context *ctx)
   // The return object
   duk_push_object(ctx);
 
-  bool enabled = MyConfig.GetParamValueBool("log", "poller.timers", false);
+  bool enabled = cfg_poller_timers.Get();
   duk_push_boolean(ctx, enabled?1:0);
   duk_put_prop_string(ctx, -2, "started");
 
@@ -4034,8 +4293,11 @@ bool OvmsPoller::PollSeriesEntry::Ready() const
 
 // Standard Poll Series class
 OvmsPoller::StandardPollSeries::StandardPollSeries(OvmsPoller *poller, uint16_t stateoffset  )
-  : m_poller(poller), m_state_offset(stateoffset),  m_defaultbus(0), m_poll_plist(nullptr), m_poll_plcur(nullptr)
+  : m_poller(poller), m_state_offset(stateoffset),  m_defaultbus(0), m_poll_plist(nullptr), m_poll_plcur(nullptr),
+    m_batch_split(nullptr), m_batch_index(0),
+    m_adapt_cfg({ false, 8, 3 }), m_adapt_state(0), m_adapt_cur(-1), m_adapt_hash(0)
   {
+  AdaptiveReset(0);
   }
 void OvmsPoller::StandardPollSeries::SetParentPoller(OvmsPoller *poller)
   {
@@ -4049,6 +4311,39 @@ void OvmsPoller::StandardPollSeries::PollSetPidList(uint8_t defaultbus, const po
   m_poll_plcur = nullptr;
   m_poll_plist = plist;
   m_defaultbus = defaultbus;
+
+  // Clear learned poll intervals:
+  int len = 0;
+  for (const poll_pid_t* p = plist; p && p->txmoduleid != 0; p++)
+    len++;
+  m_adapt.assign(len, {});
+  AdaptiveReset(m_adapt_state);
+
+  // Prepare multi DID requests:
+  m_batch_split = nullptr;
+  m_batch_index = 0;
+  m_batch.clear();
+  int cnt = 0;
+  for (const poll_pid_t* p = plist; p && p->txmoduleid != 0; p++)
+    {
+    if (p->xargs.tag == POLL_TXBATCH)
+      cnt++;
+    }
+  m_batch.reserve(cnt); // keep txdata buffers in place
+  for (const poll_pid_t* p = plist; p && p->txmoduleid != 0; p++)
+    {
+    if (p->xargs.tag != POLL_TXBATCH)
+      continue;
+    const poll_did_t* dids = reinterpret_cast<const poll_did_t*>(p->xargs.data);
+    poll_batch_t batch;
+    batch.entry = p;
+    for (int i = 1; i < p->xargs.datalen; i++)
+      {
+      batch.txdata.push_back(dids[i].did >> 8);
+      batch.txdata.push_back(dids[i].did & 0xff);
+      }
+    m_batch.push_back(batch);
+    }
   }
 
 void OvmsPoller::StandardPollSeries::ResetList(OvmsPoller::ResetMode mode)
@@ -4057,6 +4352,8 @@ void OvmsPoller::StandardPollSeries::ResetList(OvmsPoller::ResetMode mode)
     {
     IFTRACE(Poller) ESP_LOGV(TAG, "Standard Poll Series: List reset");
     m_poll_plcur = NULL;
+    m_batch_split = nullptr;
+    m_batch_index = 0;
     }
   }
 
@@ -4075,6 +4372,14 @@ OvmsPoller::OvmsNextPollResult OvmsPoller::StandardPollSeries::NextPollEntry(pol
   if (pollstate >= VEHICLE_POLL_NSTATES)
     return OvmsNextPollResult::StillAtEnd;
 
+  // Multi DID entry being polled DID by DID:
+  if (m_batch_split && BatchNextEntry(entry))
+    return OvmsNextPollResult::FoundEntry;
+
+  // Learned intervals apply to the state they have been learned in:
+  if (pollstate != m_adapt_state)
+    AdaptiveReset(pollstate);
+
   // Restart poll list cursor:
   if (m_poll_plcur == NULL)
     m_poll_plcur = m_poll_plist;
@@ -4091,9 +4396,15 @@ OvmsPoller::OvmsNextPollResult OvmsPoller::StandardPollSeries::NextPollEntry(pol
     if (mybus == bus)
       {
       uint16_t polltime = m_poll_plcur->polltime[pollstate];
-      if (( polltime > 0) && ((pollticker % polltime) == 0))
+      if (( polltime > 0) && AdaptiveDue(m_poll_plcur - m_poll_plist, polltime, pollticker))
         {
         entry = *m_poll_plcur;
+        if (entry.xargs.tag == POLL_TXBATCH && !BatchNextEntry(entry))
+          {
+          ++m_poll_plcur;
+          continue;
+          }
+        AdaptiveSent(m_poll_plcur - m_poll_plist);
         IFTRACE(Poller) ESP_LOGD(TAG, "Found Poll Entry for Standard Poll");
         return OvmsNextPollResult::FoundEntry;
         }
@@ -4144,6 +4455,9 @@ OvmsPoller::StandardVehiclePollSeries::StandardVehiclePollSeries(OvmsPoller *pol
 // Process an incoming packet.
 void OvmsPoller::StandardVehiclePollSeries::IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length)
  {
+ AdaptiveIncoming(job, data, length);
+ if (BatchIncomingPacket(job, data, length))
+   return;
  if (m_signal)
    m_signal->IncomingPollReply(job, data, length);
  }
@@ -4151,6 +4465,8 @@ void OvmsPoller::StandardVehiclePollSeries::IncomingPacket(const OvmsPoller::pol
 // Process An Error.
 void OvmsPoller::StandardVehiclePollSeries::IncomingError(const OvmsPoller::poll_job_t& job, uint16_t code)
  {
+ if (BatchIncomingError(job, code))
+   return;
  if (m_signal)
    m_signal->IncomingPollError(job, code);
  }
@@ -4201,6 +4517,9 @@ void OvmsPoller::StandardPacketPollSeries::ResetList(OvmsPoller::ResetMode mode)
 // Process an incoming packet.
 void OvmsPoller::StandardPacketPollSeries::IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length)
   {
+  AdaptiveIncoming(job, data, length);
+  if (BatchIncomingPacket(job, data, length))
+    return;
   if (job.mlframe == 0)
     {
     m_format = job.format;
@@ -4234,6 +4553,8 @@ void OvmsPoller::StandardPacketPollSeries::IncomingPacket(const OvmsPoller::poll
 // Process An Error
 void OvmsPoller::StandardPacketPollSeries::IncomingError(const OvmsPoller::poll_job_t& job, uint16_t code)
   {
+  if (BatchIncomingError(job, code))
+    return;
   if (code == 0)
     {
     IFTRACE(Poller) ESP_LOGD(TAG, "Packet failed with zero error %.03" PRIx32 " TYPE:%x PID: %03x", job.moduleid_rec, job.type, job.pid);
@@ -28,6 +28,9 @@
 
 #include <cstdint>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 // PollSingleRequest specific result codes:
 #define POLLSINGLE_OK                   0
@@ -39,6 +42,9 @@
 // Number of polling states supported
 #define VEHICLE_POLL_NSTATES            4
 
+// Max number of pipelined ISO-TP requests in flight per bus
+#define VEHICLE_POLL_PIPELINE_MAX       8
+
 // A note on "PID" and their sizes here:
 //  By "PID" for the service types we mean the part of the request parameters
 //  after the service type that is reflected in _every_ valid response to the request.
@@ -75,6 +81,15 @@
 #define POLL_PID_DATA(pid, datastring) \
   {.xargs={ (pid), POLL_TXDATA, sizeof(datastring)-1, reinterpret_cast<const uint8_t*>(datastring) }}
 
+// Poll list multi DID utility: read a static array of OvmsPoller::poll_did_t
+//  with one UDS ReadDataByIdentifier request (type VEHICLE_POLL_TYPE_READDATA).
+//  The response is split up and passed on per DID as if polled one by one.
+//  The ECU needs to support the first DID. ECUs rejecting multi DID requests
+//  as not supported (NRC 0x11/0x12/0x13/0x31) are polled DID by DID from then
+//  on, other NRCs fall back to DID by DID for the current cycle only.
+#define POLL_PID_BATCH(dids) \
+  {.xargs={ (dids)[0].did, POLL_TXBATCH, sizeof(dids)/sizeof((dids)[0]), reinterpret_cast<const uint8_t*>(dids) }}
+
 
 // VWTP_20 channel states:
 typedef enum
@@ -138,6 +153,19 @@ class OvmsPoller : public InternalRamAllocated {
       uint8_t  protocol;                        // ISOTP_STD / ISOTP_EXTADR / ISOTP_EXTFRAME / VWTP_20
       } poll_pid_t;
 
+    typedef struct
+      {
+      uint16_t did;                             // UDS data identifier
+      uint16_t len;                             // response data length (bytes), 0 = rest (last DID only)
+      } poll_did_t;
+
+    typedef struct
+      {
+      bool enabled;                             // adapt poll intervals to response changes
+      uint8_t maxfactor;                        // max interval stretch factor (1…128, power of 2)
+      uint8_t stable;                           // unchanged responses before stretching the interval
+      } poll_adaptive_t;
+
     typedef struct
       {
       canbus* bus;            ///< Bus to poll on.
@@ -326,6 +354,12 @@ class OvmsPoller : public InternalRamAllocated {
          */
         bool HasRepeat() const;
 
+        /// Series of the current item.
+        PollSeriesEntry* CurrentSeries() const
+          {
+          return (m_iter != nullptr) ? m_iter->series.get() : nullptr;
+          }
+
         /** CLI Status.
          */
         void Status(int verbosity, OvmsWriter* writer);
@@ -345,6 +379,49 @@ class OvmsPoller : public InternalRamAllocated {
         const poll_pid_t* m_poll_plist; // Head of poll list
         const poll_pid_t* m_poll_plcur; // Poll list loop cursor
 
+        typedef struct
+          {
+          const poll_pid_t* entry;      // POLL_TXBATCH entry of poll list
+          std::string txdata;           // … request payload (DIDs 2…n)
+          } poll_batch_t;
+
+        std::vector<poll_batch_t> m_batch;          // Multi DID entries of poll list
+        std::set<uint32_t> m_batch_unsupported;     // ECUs (TX IDs) rejecting multi DID requests
+        const poll_batch_t* m_batch_split;          // Multi DID entry being polled DID by DID
+        uint16_t m_batch_index;                     // … next DID
+        std::string m_batch_rxbuf;                  // Multi DID response buffer
+
+        bool BatchNextEntry(poll_pid_t &entry);
+        const poll_batch_t* BatchFind(const poll_job_t& job) const;
+        bool BatchIncomingPacket(const poll_job_t& job, uint8_t* data, uint8_t length);
+        bool BatchIncomingError(const poll_job_t& job, uint16_t code);
+        void BatchDeliver(const poll_job_t& job, uint16_t did, uint8_t* data, uint16_t length);
+        void BatchError(const poll_job_t& job, uint16_t did, uint16_t code);
+
+        typedef struct
+          {
+          uint32_t hash;                // Hash of last response
+          uint8_t shift;                // Interval stretch: polltime << shift
+          uint8_t same;                 // Unchanged responses since last stretch
+          uint8_t skip;                 // Due polls left to skip
+          bool valid;                   // hash valid
+          } poll_adapt_t;
+
+        poll_adaptive_t m_adapt_cfg;                // Adaptive scheduling config
+        std::vector<poll_adapt_t> m_adapt;          // … state per poll list entry
+        uint8_t m_adapt_state;                      // … poll state learned for
+        int m_adapt_cur;                            // … list index of response being received
+        uint32_t m_adapt_hash;                      // … hash of response being received
+        int16_t m_adapt_sent[2*VEHICLE_POLL_PIPELINE_MAX]; // … list indexes of recently sent entries
+        uint8_t m_adapt_sent_next;                  // … next slot in m_adapt_sent
+
+        bool AdaptiveDue(int index, uint16_t polltime, uint32_t pollticker);
+        void AdaptiveSent(int index);
+        uint8_t AdaptiveMaxShift(uint16_t polltime) const;
+        int AdaptiveFind(const poll_job_t& job) const;
+        void AdaptiveIncoming(const poll_job_t& job, const uint8_t* data, uint8_t length);
+        void AdaptiveReset(uint8_t pollstate);
+
       public:
         StandardPollSeries(OvmsPoller *poller, uint16_t stateoffset = 0);
 
@@ -353,6 +430,10 @@ class OvmsPoller : public InternalRamAllocated {
         /// Set the PID list and default bus.
         void PollSetPidList(uint8_t defaultbus, const poll_pid_t* plist);
 
+        /// Configure adaptive poll intervals.
+        void SetAdaptive(const poll_adaptive_t& cfg);
+        int AdaptiveStatus(OvmsWriter* writer, uint8_t busno);
+
         // Move list to start.
         void ResetList(ResetMode mode) override;
 
@@ -527,6 +608,96 @@ class OvmsPoller : public InternalRamAllocated {
         void Removing() override;
       };
 
+    /** Pipelined ISO-TP requests.
+     *  Keeps up to <window> requests in flight, one per ECU (txid/rxid pair).
+     *  Each session has its own reassembly buffer & flow control. Responses are
+     *  passed to the series when complete, frame by frame in one go, so the
+     *  series sees the same packet sequence as from the serial poller.
+     *  No thread safety included, so relies on the mutex blocking calls to it.
+     */
+    class ISOTPPipeline
+      {
+      public:
+        typedef std::function<void(CAN_frame_t* frame)> writer_t;
+
+        typedef struct
+          {
+          bool active;
+          poll_job_t job;                   // Job status
+          PollSeriesEntry* series;          // Series to pass the response to
+          uint32_t txmsgid;                 // Request CAN MsgID
+          std::string txbuf;                // Request payload remaining for consecutive frames
+          uint16_t tx_offset;               // … offset of next frame
+          uint16_t tx_frame;                // … frame number
+          uint8_t tx_blockleft;             // … frames left in flow control block (0 = unlimited)
+          uint8_t tx_septime;               // … flow control separation time (STmin)
+          int64_t tx_due;                   // … esp_timer time of next frame [us], 0 = none
+          uint8_t wait;                     // Timeout ticks, see m_poll_wait
+          std::string rxbuf;                // Response reassembly buffer (ISO-TP payload)
+          uint16_t rxlen;                   // … expected length
+          uint8_t rxhdr;                    // … OBD/UDS header length (type & PID)
+          uint8_t rxfirst;                  // … payload length of first frame
+          } session_t;
+
+        typedef struct
+          {
+          poll_pid_t entry;                 // Request waiting for its ECU
+          PollSeriesEntry* series;
+          } deferred_t;
+
+      protected:
+        session_t m_session[VEHICLE_POLL_PIPELINE_MAX];
+        deferred_t m_deferred[VEHICLE_POLL_PIPELINE_MAX];
+        uint8_t m_window;
+        uint8_t m_active;
+        uint8_t m_deferred_cnt;
+        uint8_t m_fc_septime;
+        CanFrameCallback* m_txcallback;
+        writer_t m_writer;
+
+      public:
+        uint32_t m_cnt_started;             // Statistics
+        uint32_t m_cnt_done;
+        uint32_t m_cnt_error;
+        uint32_t m_cnt_timeout;
+
+      public:
+        ISOTPPipeline(CanFrameCallback* txcallback = nullptr);
+
+        void SetWindow(uint8_t window);
+        uint8_t GetWindow() const { return m_window; }
+        bool IsEnabled() const { return m_window > 1; }
+        void SetResponseSeparationTime(uint8_t septime) { m_fc_septime = septime; }
+        void SetWriter(writer_t writer) { m_writer = writer; }
+
+        uint8_t Active() const { return m_active; }
+        uint8_t Deferred() const { return m_deferred_cnt; }
+        bool IsIdle() const { return m_active == 0 && m_deferred_cnt == 0; }
+        bool IsFull() const { return m_active >= m_window; }
+        bool IsBusy(const poll_pid_t& entry) const;
+        static bool IsEligible(const poll_pid_t& entry);
+
+        bool Start(const poll_job_t& base, const poll_pid_t& entry, PollSeriesEntry* series);
+        bool Defer(const poll_pid_t& entry, PollSeriesEntry* series);
+        int StartDeferred(const poll_job_t& base);
+        bool Receive(CAN_frame_t* frame);
+        bool TxCallback(const CAN_frame_t* frame, bool success);
+        int64_t TxDue() const;
+        void TxTicker();
+        void Ticker();
+        void Clear();
+
+      protected:
+        bool IsActive(const poll_pid_t& entry) const;
+        session_t* Find(CAN_frame_t* frame, uint32_t& msgid);
+        bool ReceiveFlowControl(session_t* s, CAN_frame_t* frame, uint8_t* fr_data);
+        void SendConsecutive(session_t* s);
+        void Deliver(session_t* s);
+        void Error(session_t* s, uint16_t code);
+        void Finish(session_t* s);
+        void Write(CAN_frame_t* frame);
+      };
+
   protected:
     OvmsPollers*      m_parent;
 
@@ -577,6 +748,13 @@ class OvmsPoller : public InternalRamAllocated {
   protected:
     vwtp_channel_t    m_poll_vwtp;            // VWTP channel state
 
+  private:
+    ISOTPPipeline     m_pipeline;             // Pipelined ISO-TP requests
+    bool              m_poll_pending;         // m_poll.entry waiting for a pipeline slot
+    bool              m_poll_pending_serial;  // … needs to be sent by the serial poller
+    int64_t           m_pipeline_txdue;       // Next paced consecutive frame due [us], 0 = none
+    void PipelineTxTicker();
+
   protected:
 
     // Signals for vehicle
@@ -594,6 +772,11 @@ class OvmsPoller : public InternalRamAllocated {
 
     void PollerISOTPStart(bool fromTicker);
     bool PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid);
+    void PollerStart(bool fromTicker, bool serial);
+
+    static uint16_t ISOTPRequestFrame(CAN_frame_t& txframe, const poll_pid_t& entry, uint32_t txid,
+                                      const uint8_t* tx_data, uint16_t tx_datalen);
+    static void ISOTPFlowControlFrame(CAN_frame_t& txframe, uint8_t protocol, uint32_t txid, uint8_t septime);
 
     void PollerVWTPStart(bool fromTicker);
     bool PollerVWTPReceive(CAN_frame_t* frame, uint32_t msgid);
@@ -639,7 +822,8 @@ class OvmsPoller : public InternalRamAllocated {
       Keepalive,
       SuccessSep,
       Shutdown,
-      ResetTimer
+      ResetTimer,
+      Pipeline
       };
     typedef struct {
         CAN_frame_t frame;
@@ -693,6 +877,9 @@ class OvmsPoller : public InternalRamAllocated {
     void PollSetResponseSeparationTime(uint8_t septime);
     void PollSetChannelKeepalive(uint16_t keepalive_seconds);
     void PollSetTimeBetweenSuccess(uint16_t time_between_ms);
+    void PollSetPipelineWindow(uint8_t window);
+    void PollSetAdaptive(const poll_adaptive_t& cfg);
+    int PollerAdaptiveStatus(OvmsWriter* writer);
 
     // TODO - Work out how to make sure these are protected. Reduce/eliminate mutex time.
     void PollSetPidList(uint8_t defaultbus, const poll_pid_t* plist, VehicleSignal *signal);
@@ -737,6 +924,8 @@ class OvmsPollers : public InternalRamAllocated {
     uint8_t           m_poll_fc_septime;      // Flow control separation time for multi frame responses
     uint16_t          m_poll_ch_keepalive;    // Seconds to keep an inactive channel (e.g. VWTP) alive (default: 60)
     uint16_t          m_poll_between_success;
+    uint8_t           m_poll_pipeline;        // Pipelined ISO-TP requests per bus, default 1 = off
+    OvmsPoller::poll_adaptive_t m_poll_adaptive; // Adaptive poll interval config
     uint32_t          m_poll_last;
 
     _Alignas(32 / CHAR_BIT)
@@ -749,6 +938,8 @@ class OvmsPollers : public InternalRamAllocated {
     uint16_t          m_poll_tick_ms;         // Tick length in ms.
     uint8_t           m_poll_tick_secondary;  // Number of secondary poll subticks per primary / zero
 
+    bool              m_pipeline_txpending;   // A poller has paced consecutive frames scheduled
+
     bool              m_shut_down;
     bool              m_ready;
     bool              m_paused;
@@ -775,6 +966,10 @@ class OvmsPollers : public InternalRamAllocated {
     static void vehicle_pause_off(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void vehicle_poller_trace(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void poller_times(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_pipeline(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_pipeline_test(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_batch_test(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void poller_adaptive_test(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
 
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
     // OvmsPoller Object
@@ -847,6 +1042,7 @@ class OvmsPollers : public InternalRamAllocated {
     bool LoadTimesTrace( metric_unit_t ratio_unit, times_trace_t &trace);
   public:
     bool PollerTimesTrace( OvmsWriter* writer);
+    void PollerAdaptiveTrace( OvmsWriter* writer);
     bool IsTracingTimes() const { return (m_trace & trace_Times) != 0; }
     typedef std::function<void(canbus*, void *)> PollCallback;
     typedef std::function<void(const CAN_frame_t &)> FrameCallback;
@@ -951,6 +1147,7 @@ class OvmsPollers : public InternalRamAllocated {
     void EventSystemShuttingDown(std::string event, void* data);
     void ConfigChanged(std::string event, void* data);
     void LoadPollerTimerConfig();
+    void LoadAdaptiveConfig();
 
     void VehicleOn(std::string event, void* data);
     void VehicleChargeStart(std::string event, void* data);
@@ -958,8 +1155,11 @@ class OvmsPollers : public InternalRamAllocated {
     void VehicleChargeStop(std::string event, void* data);
 
     void NotifyPollerTrace();
+    TickType_t PipelineTxTicker();
 
   public:
+    /** PipelineTxScheduled: a pipeline has consecutive frames waiting for their separation time */
+    void PipelineTxScheduled() { m_pipeline_txpending = true; }
     OvmsPollers();
     ~OvmsPollers();
 
@@ -999,6 +1199,10 @@ class OvmsPollers : public InternalRamAllocated {
       {
       Queue_Command(OvmsPoller::OvmsPollCommand::SuccessSep, time_between_ms);
       }
+    void PollSetPipelineWindow(uint8_t window)
+      {
+      Queue_Command(OvmsPoller::OvmsPollCommand::Pipeline, window);
+      }
     // signal poller
     void PollerResetThrottle();
 
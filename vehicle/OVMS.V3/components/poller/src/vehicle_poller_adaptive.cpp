@@ -0,0 +1,432 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "vehicle-poll-adapt";
+
+#include <stdio.h>
+#include <algorithm>
+#include <ovms_command.h>
+#include "vehicle.h"
+
+// FNV-1a 32 bit hash:
+#define ADAPT_HASH_INIT         0x811c9dc5
+#define ADAPT_HASH_PRIME        0x01000193
+
+
+/**
+ * SetAdaptive: configure adaptive poll intervals
+ *  With adaptive polling enabled, read requests (OBD modes 01/09, UDS 0x21/0x22)
+ *  that return the same response <stable> times in a row are polled at twice
+ *  the interval, up to <maxfactor> times the list interval. Any change in a
+ *  response reverts the entry to the list interval.
+ *  Stretched intervals stay below SM_STALE_MID (the autostale time of most
+ *  polled metrics), entries polled at SM_STALE_MID/2 or slower are not
+ *  stretched.
+ *  Learned intervals are reset on poll state and list changes.
+ */
+void OvmsPoller::StandardPollSeries::SetAdaptive(const poll_adaptive_t& cfg)
+  {
+  m_adapt_cfg = cfg;
+  AdaptiveReset(m_adapt_state);
+  }
+
+/**
+ * AdaptiveReset: forget learned intervals, start over in a poll state
+ */
+void OvmsPoller::StandardPollSeries::AdaptiveReset(uint8_t pollstate)
+  {
+  m_adapt_state = pollstate;
+  std::fill(m_adapt.begin(), m_adapt.end(), poll_adapt_t());
+  m_adapt_cur = -1;
+  std::fill(std::begin(m_adapt_sent), std::end(m_adapt_sent), -1);
+  m_adapt_sent_next = 0;
+  }
+
+/**
+ * AdaptiveSent: remember the list index of a polled entry for AdaptiveFind()
+ */
+void OvmsPoller::StandardPollSeries::AdaptiveSent(int index)
+  {
+  if (!m_adapt_cfg.enabled)
+    return;
+  m_adapt_sent[m_adapt_sent_next] = index;
+  m_adapt_sent_next = (m_adapt_sent_next + 1) % (sizeof(m_adapt_sent) / sizeof(m_adapt_sent[0]));
+  }
+
+/**
+ * AdaptiveMaxShift: get the max interval stretch for a list interval
+ *  The metrics set from a response must not become stale, so the stretched
+ *  interval needs to stay below SM_STALE_MID.
+ */
+uint8_t OvmsPoller::StandardPollSeries::AdaptiveMaxShift(uint16_t polltime) const
+  {
+  if (polltime == 0)
+    return 0;
+  uint8_t shift = 0;
+  while ((2 << shift) <= m_adapt_cfg.maxfactor
+         && ((uint32_t)polltime << (shift + 1)) < SM_STALE_MID)
+    shift++;
+  return shift;
+  }
+
+/**
+ * AdaptiveDue: check if a poll list entry is due in this tick
+ */
+bool OvmsPoller::StandardPollSeries::AdaptiveDue(int index, uint16_t polltime, uint32_t pollticker)
+  {
+  if ((pollticker % polltime) != 0)
+    return false;
+  if (!m_adapt_cfg.enabled || index >= (int)m_adapt.size())
+    return true;
+  poll_adapt_t& adapt = m_adapt[index];
+  if (adapt.skip > 0)
+    {
+    adapt.skip--;
+    return false;
+    }
+  adapt.skip = (1 << adapt.shift) - 1;
+  return true;
+  }
+
+/**
+ * AdaptiveFind: find the poll list index of a response
+ *  @return     index or -1 if the job isn't an adaptive read request from the list
+ */
+int OvmsPoller::StandardPollSeries::AdaptiveFind(const poll_job_t& job) const
+  {
+  if (!m_poll_plist || job.entry.rxmoduleid == 0)
+    return -1;
+  switch (job.entry.type)
+    {
+    case VEHICLE_POLL_TYPE_OBDIICURRENT:
+    case VEHICLE_POLL_TYPE_OBDIIVEHICLE:
+    case VEHICLE_POLL_TYPE_OBDIIGROUP:
+    case VEHICLE_POLL_TYPE_READDATA:
+      break;
+    default:
+      return -1;
+    }
+
+  const poll_batch_t* batch = BatchFind(job);
+  if (batch)
+    return batch->entry - m_poll_plist;
+
+  // Check the recently sent entries, newest first:
+  const poll_pid_t& e = job.entry;
+  const int cnt = sizeof(m_adapt_sent) / sizeof(m_adapt_sent[0]);
+  for (int i = 1; i <= cnt; i++)
+    {
+    int index = m_adapt_sent[(m_adapt_sent_next + cnt - i) % cnt];
+    if (index < 0 || index >= (int)m_adapt.size())
+      continue;
+    const poll_pid_t* p = &m_poll_plist[index];
+    if (p->txmoduleid == e.txmoduleid && p->rxmoduleid == e.rxmoduleid && p->type == e.type
+        && p->xargs.pid == e.xargs.pid && p->xargs.tag == e.xargs.tag && p->protocol == e.protocol
+        && (p->xargs.tag != POLL_TXDATA || p->xargs.data == e.xargs.data))
+      return index;
+    }
+  return -1;
+  }
+
+/**
+ * AdaptiveIncoming: hash response, stretch or reset the entry interval when complete
+ */
+void OvmsPoller::StandardPollSeries::AdaptiveIncoming(const poll_job_t& job, const uint8_t* data, uint8_t length)
+  {
+  if (!m_adapt_cfg.enabled)
+    return;
+  if (job.mlframe == 0)
+    {
+    m_adapt_cur = AdaptiveFind(job);
+    m_adapt_hash = ADAPT_HASH_INIT;
+    }
+  if (m_adapt_cur < 0 || m_adapt_cur >= (int)m_adapt.size())
+    return;
+
+  for (int i = 0; i < length; i++)
+    m_adapt_hash = (m_adapt_hash ^ data[i]) * ADAPT_HASH_PRIME;
+  if (job.mlremain > 0)
+    return;
+
+  poll_adapt_t& adapt = m_adapt[m_adapt_cur];
+  uint16_t polltime = (m_adapt_state < VEHICLE_POLL_NSTATES) ? m_poll_plist[m_adapt_cur].polltime[m_adapt_state] : 0;
+  m_adapt_cur = -1;
+  if (adapt.valid && adapt.hash == m_adapt_hash)
+    {
+    if (++adapt.same >= m_adapt_cfg.stable && adapt.shift < AdaptiveMaxShift(polltime))
+      {
+      adapt.shift++;
+      adapt.same = 0;
+      ESP_LOGD(TAG, "Entry %d unchanged, interval factor now %d", (int)(&adapt - m_adapt.data()), 1 << adapt.shift);
+      }
+    else if (adapt.same > m_adapt_cfg.stable)
+      adapt.same = m_adapt_cfg.stable;
+    }
+  else
+    {
+    if (adapt.shift > 0)
+      ESP_LOGD(TAG, "Entry %d changed, interval reset", (int)(&adapt - m_adapt.data()));
+    adapt.hash = m_adapt_hash;
+    adapt.valid = true;
+    adapt.shift = 0;
+    adapt.same = 0;
+    adapt.skip = 0;
+    }
+  }
+
+/**
+ * AdaptiveStatus: list entries with stretched intervals
+ *  @return     number of stretched entries
+ */
+int OvmsPoller::StandardPollSeries::AdaptiveStatus(OvmsWriter* writer, uint8_t busno)
+  {
+  int stretched = 0, total = 0;
+  for (int i = 0; i < (int)m_adapt.size(); i++)
+    {
+    const poll_pid_t& p = m_poll_plist[i];
+    if ((p.pollbus ? p.pollbus : m_defaultbus) != busno || m_adapt_state >= VEHICLE_POLL_NSTATES
+        || p.polltime[m_adapt_state] == 0)
+      continue;
+    total++;
+    if (m_adapt[i].shift == 0)
+      continue;
+    stretched++;
+    writer->printf("    %03" PRIx32 " %02" PRIx16 ":%04" PRIx16 "  %5" PRIu16 "s -> %5u s\n",
+                   p.txmoduleid, p.type, p.xargs.pid, p.polltime[m_adapt_state],
+                   (unsigned)p.polltime[m_adapt_state] << m_adapt[i].shift);
+    }
+  writer->printf("  Adaptive: %d of %d entries stretched in state %" PRIu8 "\n",
+                 stretched, total, m_adapt_state);
+  return stretched;
+  }
+
+void OvmsPoller::PollSetAdaptive(const poll_adaptive_t& cfg)
+  {
+  OvmsRecMutexLock lock(&m_poll_mutex);
+  if (m_poll_series)
+    m_poll_series->SetAdaptive(cfg);
+  }
+
+int OvmsPoller::PollerAdaptiveStatus(OvmsWriter* writer)
+  {
+  OvmsRecMutexLock lock(&m_poll_mutex, pdMS_TO_TICKS(3000));
+  if (!lock.IsLocked())
+    {
+    writer->puts("Failed to lock Poller for status");
+    return 0;
+    }
+  if (!m_poll_series)
+    return 0;
+  return m_poll_series->AdaptiveStatus(writer, m_poll.bus_no);
+  }
+
+void OvmsPollers::PollerAdaptiveTrace(OvmsWriter* writer)
+  {
+  if (!m_poll_adaptive.enabled)
+    {
+    writer->puts("Adaptive polling is: off");
+    return;
+    }
+  writer->printf("Adaptive polling is: on (max factor %" PRIu8 ", stable %" PRIu8 ")\n",
+                 m_poll_adaptive.maxfactor, m_poll_adaptive.stable);
+  for (uint8_t busno = 1; busno <= VEHICLE_MAXBUSSES; ++busno)
+    {
+    auto bus = GetBus(busno);
+    if (!bus)
+      continue;
+    OvmsPoller *poller = GetPoller(bus, false);
+    if (!poller)
+      continue;
+    writer->printf("Poller on Can%" PRIu8 "\n", busno);
+    poller->PollerAdaptiveStatus(writer);
+    }
+  }
+
+
+/**
+ * Adaptive polling simulation: replays value traces through a standard poll series
+ *  The traces model typical vehicle data: static (VIN), slow (SOH, capacity),
+ *  medium (SOC, temperatures), fast (current) and bursty (charge state).
+ *  Each tick the series is asked for the due entries like PollerSend() does,
+ *  polled entries get the current trace value as their response.
+ *  Staleness is the delay from a value change until it's polled.
+ */
+
+typedef struct
+  {
+  const char* name;
+  uint16_t polltime;                  // List interval [s]
+  uint32_t period;                    // Value change interval [s], 0 = static
+  bool bursty;                        // … only during charge windows
+  } adaptive_trace_t;
+
+static const adaptive_trace_t adaptive_traces[] =
+  {
+  { "VIN",          10,    0, false },
+  { "SOH",          10, 3600, false },
+  { "Capacity",     30, 1800, false },
+  { "SOC",          10,   60, false },
+  { "Current",       1,    1, false },
+  { "Temperature",  10,  300, false },
+  { "Charge state",  5,    5, true  },
+  };
+#define ADAPTIVE_TRACES (sizeof(adaptive_traces) / sizeof(adaptive_traces[0]))
+
+static uint32_t AdaptiveTraceValue(const adaptive_trace_t& trace, uint32_t t)
+  {
+  if (trace.period == 0)
+    return 0;
+  if (trace.bursty)
+    {
+    // 20 minutes of charge state changes every two hours:
+    if ((t % 7200) < 1200)
+      return 0x10000000 + t / trace.period;
+    return t / 7200;
+    }
+  return t / trace.period;
+  }
+
+class AdaptiveTestSignal : public OvmsPoller::VehicleSignal
+  {
+  public:
+    void IncomingPollReply(const OvmsPoller::poll_job_t &job, uint8_t* data, uint8_t length) override {}
+    void IncomingPollError(const OvmsPoller::poll_job_t &job, uint16_t code) override {}
+    void IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success) override {}
+    bool Ready() const override { return true; }
+  };
+
+typedef struct
+  {
+  uint32_t requests;
+  uint32_t changes;                   // Changes seen by a poll
+  uint64_t stale_sum;                 // [s]
+  uint32_t stale_max;                 // [s]
+  } adaptive_result_t;
+
+static void AdaptiveTestRun(const OvmsPoller::poll_pid_t* plist, const OvmsPoller::poll_adaptive_t& cfg,
+                            uint32_t duration, adaptive_result_t* result)
+  {
+  AdaptiveTestSignal signal;
+  OvmsPoller::StandardVehiclePollSeries series(nullptr, &signal);
+  series.PollSetPidList(1, plist);
+  series.SetAdaptive(cfg);
+
+  uint32_t last[ADAPTIVE_TRACES], changed[ADAPTIVE_TRACES];
+  bool pending[ADAPTIVE_TRACES] = {};
+  for (int i = 0; i < (int)ADAPTIVE_TRACES; i++)
+    {
+    last[i] = AdaptiveTraceValue(adaptive_traces[i], 0);
+    changed[i] = 0;
+    result[i] = {};
+    }
+
+  OvmsPoller::poll_pid_t entry;
+  for (uint32_t t = 0; t < duration; t++)
+    {
+    for (int i = 0; i < (int)ADAPTIVE_TRACES; i++)
+      {
+      uint32_t value = AdaptiveTraceValue(adaptive_traces[i], t);
+      if (value != last[i] && !pending[i])
+        {
+        pending[i] = true;
+        changed[i] = t;
+        }
+      last[i] = value;
+      }
+
+    series.ResetList(OvmsPoller::ResetMode::PollReset);
+    while (series.NextPollEntry(entry, 1, t % 3600, 0) == OvmsPoller::OvmsNextPollResult::FoundEntry)
+      {
+      int i = entry.pid & 0xff;
+      adaptive_result_t& res = result[i];
+      res.requests++;
+      if (pending[i])
+        {
+        uint32_t stale = t - changed[i];
+        res.changes++;
+        res.stale_sum += stale;
+        res.stale_max = std::max(res.stale_max, stale);
+        pending[i] = false;
+        }
+
+      uint8_t data[4] = { (uint8_t)(last[i] >> 24), (uint8_t)(last[i] >> 16), (uint8_t)(last[i] >> 8), (uint8_t)last[i] };
+      OvmsPoller::poll_job_t job = {};
+      job.bus_no = 1;
+      job.protocol = entry.protocol;
+      job.type = entry.type;
+      job.pid = entry.pid;
+      job.moduleid_sent = entry.txmoduleid;
+      job.moduleid_rec = entry.rxmoduleid;
+      job.entry = entry;
+      job.ticker = t;
+      job.raw_data = data;
+      job.raw_data_len = sizeof(data);
+      series.IncomingPacket(job, data, sizeof(data));
+      }
+    }
+  }
+
+void OvmsPollers::poller_adaptive_test(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int hours = (argc > 0) ? atoi(argv[0]) : 24;
+  if (hours < 1 || hours > 168)
+    {
+    writer->puts("ERROR: hours 1-168");
+    return;
+    }
+
+  OvmsPoller::poll_pid_t plist[ADAPTIVE_TRACES + 1];
+  for (int i = 0; i < (int)ADAPTIVE_TRACES; i++)
+    {
+    uint16_t t = adaptive_traces[i].polltime;
+    plist[i] = { 0x7e4, 0x7ec, VEHICLE_POLL_TYPE_READDATA, { (uint16_t)(0xf400 + i) }, { t, t, t, t }, 0, ISOTP_STD };
+    }
+  plist[ADAPTIVE_TRACES] = POLL_LIST_END;
+
+  OvmsPoller::poll_adaptive_t cfg = MyPollers.m_poll_adaptive;
+  cfg.enabled = false;
+  adaptive_result_t fixed[ADAPTIVE_TRACES], adaptive[ADAPTIVE_TRACES];
+  AdaptiveTestRun(plist, cfg, hours * 3600, fixed);
+  cfg.enabled = true;
+  AdaptiveTestRun(plist, cfg, hours * 3600, adaptive);
+
+  writer->printf("Simulated time: %d h, max factor: %" PRIu8 ", stable: %" PRIu8 "\n",
+                 hours, cfg.maxfactor, cfg.stable);
+  writer->puts("Trace         Interval  Requests fixed/adaptive  Staleness avg/max [s] fixed | adaptive");
+  uint32_t fixed_total = 0, adaptive_total = 0;
+  for (int i = 0; i < (int)ADAPTIVE_TRACES; i++)
+    {
+    const adaptive_result_t& f = fixed[i];
+    const adaptive_result_t& a = adaptive[i];
+    writer->printf("%-12s  %7" PRIu16 "s  %8" PRIu32 " / %8" PRIu32 "    %6.1f / %4" PRIu32 " | %6.1f / %4" PRIu32 "\n",
+                   adaptive_traces[i].name, adaptive_traces[i].polltime, f.requests, a.requests,
+                   f.changes ? (double)f.stale_sum / f.changes : 0.0, f.stale_max,
+                   a.changes ? (double)a.stale_sum / a.changes : 0.0, a.stale_max);
+    fixed_total += f.requests;
+    adaptive_total += a.requests;
+    }
+  writer->printf("Total requests: %" PRIu32 " fixed, %" PRIu32 " adaptive, saving %.1f%%\n",
+                 fixed_total, adaptive_total,
+                 fixed_total ? 100.0 * (fixed_total - adaptive_total) / fixed_total : 0.0);
+  }
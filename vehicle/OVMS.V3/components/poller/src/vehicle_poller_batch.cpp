@@ -0,0 +1,402 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "vehicle-poll-batch";
+
+#include <stdio.h>
+#include <ovms_command.h>
+#include "vehicle.h"
+#include "vehicle_poller_sim.h"
+
+// UDS NRC codes used for multi DID responses:
+#define UDS_RESP_NRC_SNS                0x11  // … serviceNotSupported
+#define UDS_RESP_NRC_SFNS               0x12  // … subFunctionNotSupported
+#define UDS_RESP_NRC_IMLOIF             0x13  // … incorrectMessageLengthOrInvalidFormat
+#define UDS_RESP_NRC_ROOR               0x31  // … requestOutOfRange (DID not supported)
+
+
+/**
+ * BatchNextEntry: translate multi DID poll list entry into the request to send
+ *  Called with a POLL_TXBATCH entry found in the poll list, or with
+ *  m_batch_split set to get the next single DID request.
+ *  @return     false if there is nothing (more) to send for the entry
+ */
+bool OvmsPoller::StandardPollSeries::BatchNextEntry(poll_pid_t &entry)
+  {
+  const poll_batch_t* batch = m_batch_split;
+  if (!batch)
+    {
+    for (auto &b : m_batch)
+      {
+      if (b.entry == m_poll_plcur)
+        {
+        batch = &b;
+        break;
+        }
+      }
+    if (!batch || batch->entry->xargs.datalen == 0)
+      return false;
+    if (batch->entry->xargs.datalen > 1 && m_batch_unsupported.count(batch->entry->txmoduleid) == 0)
+      {
+      // Multi DID request:
+      entry = *batch->entry;
+      entry.xargs.tag = POLL_TXDATA;
+      entry.xargs.datalen = batch->txdata.size();
+      entry.xargs.data = reinterpret_cast<const uint8_t*>(batch->txdata.data());
+      return true;
+      }
+    // Poll DID by DID:
+    m_batch_split = batch;
+    m_batch_index = 0;
+    }
+
+  if (m_batch_index >= batch->entry->xargs.datalen)
+    {
+    m_batch_split = nullptr;
+    return false;
+    }
+  const poll_did_t* dids = reinterpret_cast<const poll_did_t*>(batch->entry->xargs.data);
+  entry = *batch->entry;
+  entry.xargs = {};
+  entry.pid = dids[m_batch_index++].did;
+  return true;
+  }
+
+/**
+ * BatchFind: find multi DID entry a job belongs to
+ */
+const OvmsPoller::StandardPollSeries::poll_batch_t* OvmsPoller::StandardPollSeries::BatchFind(const poll_job_t& job) const
+  {
+  if (job.entry.xargs.tag != POLL_TXDATA || job.type != VEHICLE_POLL_TYPE_READDATA)
+    return nullptr;
+  for (auto &b : m_batch)
+    {
+    if (job.entry.xargs.data == reinterpret_cast<const uint8_t*>(b.txdata.data())
+        && job.entry.txmoduleid == b.entry->txmoduleid)
+      return &b;
+    }
+  return nullptr;
+  }
+
+/**
+ * BatchIncomingPacket: collect multi DID response, pass on per DID when complete
+ *  The response is a sequence of DID + data, with the first DID already
+ *  stripped by the poller. DIDs not supported by the ECU may be missing.
+ *  @return     false if the job isn't a multi DID request
+ */
+bool OvmsPoller::StandardPollSeries::BatchIncomingPacket(const poll_job_t& job, uint8_t* data, uint8_t length)
+  {
+  const poll_batch_t* batch = BatchFind(job);
+  if (!batch)
+    return false;
+
+  if (job.mlframe == 0)
+    {
+    m_batch_rxbuf.clear();
+    m_batch_rxbuf.reserve(length + job.mlremain);
+    }
+  m_batch_rxbuf.append((const char*)data, length);
+  if (job.mlremain > 0)
+    return true;
+
+  const poll_did_t* dids = reinterpret_cast<const poll_did_t*>(batch->entry->xargs.data);
+  int cnt = batch->entry->xargs.datalen;
+  uint8_t* buf = (uint8_t*) m_batch_rxbuf.data();
+  uint16_t size = m_batch_rxbuf.size();
+  uint16_t pos = 0;
+  int i = 0;
+  while (i < cnt)
+    {
+    if (i > 0)
+      {
+      // Find next DID echoed, skip unsupported DIDs:
+      if (pos + 2 > size)
+        break;
+      uint16_t did = buf[pos] << 8 | buf[pos+1];
+      int j;
+      for (j = i; j < cnt && dids[j].did != did; j++);
+      if (j == cnt)
+        break;
+      for (; i < j; i++)
+        BatchError(job, dids[i].did, UDS_RESP_NRC_ROOR);
+      pos += 2;
+      }
+    uint16_t len = dids[i].len ? dids[i].len : size - pos;
+    if (pos + len > size)
+      break;
+    BatchDeliver(job, dids[i].did, buf + pos, len);
+    pos += len;
+    i++;
+    }
+
+  if (i < cnt || pos < size)
+    {
+    ESP_LOGW(TAG, "Multi DID response from %03" PRIx32 " doesn't match DID list at %" PRIu16 "/%" PRIu16
+             " (DID %d/%d), check lengths", job.moduleid_rec, pos, size, i+1, cnt);
+    for (; i < cnt; i++)
+      BatchError(job, dids[i].did, UDS_RESP_NRC_ROOR);
+    }
+
+  m_batch_rxbuf.clear();
+  return true;
+  }
+
+/**
+ * BatchIncomingError: handle error response to a multi DID request
+ *  NRCs 0x11, 0x12, 0x13 and 0x31 mean the ECU doesn't support multi DID
+ *  requests (or the first DID), so the entry is polled DID by DID from now
+ *  on, starting right away. Other NRCs (busy, conditions not correct, …)
+ *  are transient: the entry is polled DID by DID in this cycle only, the
+ *  next cycle tries the multi DID request again. Other errors are passed on
+ *  for all DIDs.
+ *  @return     false if the job isn't a multi DID request
+ */
+bool OvmsPoller::StandardPollSeries::BatchIncomingError(const poll_job_t& job, uint16_t code)
+  {
+  const poll_batch_t* batch = BatchFind(job);
+  if (!batch)
+    return false;
+
+  if (code == UDS_RESP_NRC_SNS || code == UDS_RESP_NRC_SFNS
+      || code == UDS_RESP_NRC_IMLOIF || code == UDS_RESP_NRC_ROOR)
+    {
+    ESP_LOGI(TAG, "ECU %03" PRIx32 " rejected multi DID request (NRC %02X), polling DIDs one by one",
+             job.moduleid_sent, code);
+    m_batch_unsupported.insert(job.moduleid_sent);
+    m_batch_split = batch;
+    m_batch_index = 0;
+    }
+  else if (code > 0 && code <= 0xff)
+    {
+    ESP_LOGD(TAG, "ECU %03" PRIx32 " multi DID request failed (NRC %02X), polling DIDs one by one this cycle",
+             job.moduleid_sent, code);
+    m_batch_split = batch;
+    m_batch_index = 0;
+    }
+  else
+    {
+    const poll_did_t* dids = reinterpret_cast<const poll_did_t*>(batch->entry->xargs.data);
+    for (int i = 0; i < batch->entry->xargs.datalen; i++)
+      BatchError(job, dids[i].did, code);
+    }
+  return true;
+  }
+
+/**
+ * BatchDeliver: pass on the data of one DID
+ *  The data is split into frame sized packets, so the application sees the
+ *  same packet sequence as for a single DID request.
+ */
+void OvmsPoller::StandardPollSeries::BatchDeliver(const poll_job_t& job, uint16_t did, uint8_t* data, uint16_t length)
+  {
+  poll_job_t single = job;
+  single.pid = did;
+  single.entry.xargs = {};
+  single.entry.pid = did;
+
+  uint8_t fr_maxlen = (job.protocol == ISOTP_EXTADR) ? 7 : 8;
+  uint16_t len = (length + 3 <= fr_maxlen - 1) ? length : fr_maxlen - 2 - 3;
+  uint16_t offset = 0;
+  single.mlframe = 0;
+  single.mloffset = 0;
+  single.mlremain = length - len;
+  single.raw_data = data;
+  single.raw_data_len = len;
+  IncomingPacket(single, data, len);
+
+  for (offset = len; offset < length; offset += len)
+    {
+    len = LIMIT_MAX((uint16_t)(length - offset), (uint16_t)(fr_maxlen - 1));
+    single.mlframe++;
+    single.mloffset = offset;
+    single.mlremain = length - offset - len;
+    single.raw_data = data + offset;
+    single.raw_data_len = len;
+    IncomingPacket(single, data + offset, len);
+    }
+  }
+
+void OvmsPoller::StandardPollSeries::BatchError(const poll_job_t& job, uint16_t did, uint16_t code)
+  {
+  poll_job_t single = job;
+  single.pid = did;
+  single.entry.xargs = {};
+  single.entry.pid = did;
+  single.mlframe = 0;
+  single.mloffset = 0;
+  single.mlremain = 0;
+  single.raw_data = nullptr;
+  single.raw_data_len = 0;
+  IncomingError(single, code);
+  }
+
+
+/**
+ * Multi DID benchmark: polls simulated ECUs with & without multi DID requests
+ *  Uses a StandardVehiclePollSeries on the ISO-TP pipeline engine with window 1,
+ *  which sends the same frames as the serial poller. Time is simulated.
+ */
+
+#define BATCHTEST_MAXDIDS       8         // DIDs per multi DID entry
+
+class BatchTestSignal : public OvmsPoller::VehicleSignal
+  {
+  public:
+    std::string m_rxbuf;
+    uint32_t m_ok = 0;
+    uint32_t m_bad = 0;
+
+  public:
+    void IncomingPollReply(const OvmsPoller::poll_job_t &job, uint8_t* data, uint8_t length) override
+      {
+      // Single buffer assembly like most vehicles do:
+      if (job.mlframe == 0)
+        m_rxbuf.clear();
+      if (job.mloffset != m_rxbuf.size())
+        {
+        m_bad++;
+        return;
+        }
+      m_rxbuf.append((const char*)data, length);
+      if (job.mlremain == 0)
+        {
+        if (m_rxbuf == PollerSimBus::Data(job.moduleid_sent, job.pid))
+          m_ok++;
+        else
+          m_bad++;
+        }
+      }
+    void IncomingPollError(const OvmsPoller::poll_job_t &job, uint16_t code) override { m_bad++; }
+    void IncomingPollTxCallback(const OvmsPoller::poll_job_t &job, bool success) override {}
+    bool Ready() const override { return true; }
+  };
+
+static uint64_t BatchTestRun(OvmsPoller::PollSeriesEntry& series, PollerSimBus& bus)
+  {
+  OvmsPoller::ISOTPPipeline pipeline;
+  OvmsPoller::poll_job_t base = {};
+  OvmsPoller::poll_pid_t entry;
+  pipeline.SetResponseSeparationTime(0);
+  pipeline.SetWriter([&bus](CAN_frame_t* frame) { bus.Transmit(frame); });
+
+  bus.m_now = 0;
+  bus.m_txframes = 0;
+  bus.m_rxframes = 0;
+  series.ResetList(OvmsPoller::ResetMode::PollReset);
+
+  uint64_t next_tick = POLLSIM_TICKTIME;
+  while (true)
+    {
+    // Send next request when the previous one is done, like PollerSend() does:
+    if (pipeline.IsIdle())
+      {
+      if (series.NextPollEntry(entry, 1, 0, 0) != OvmsPoller::OvmsNextPollResult::FoundEntry)
+        break;
+      pipeline.Start(base, entry, &series);
+      }
+
+    // Next event: frame reception or poll tick
+    auto it = bus.m_queue.begin();
+    if (it != bus.m_queue.end() && it->first < next_tick)
+      {
+      CAN_frame_t frame = it->second;
+      bus.m_now = it->first;
+      bus.m_queue.erase(it);
+      pipeline.Receive(&frame);
+      }
+    else
+      {
+      bus.m_now = next_tick;
+      next_tick += POLLSIM_TICKTIME;
+      pipeline.Ticker();
+      }
+    }
+  return bus.m_now;
+  }
+
+void OvmsPollers::poller_batch_test(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int ecus = (argc > 0) ? atoi(argv[0]) : 4;
+  int dids = (argc > 1) ? atoi(argv[1]) : 16;
+  int latency = (argc > 2) ? atoi(argv[2]) : 20;
+  if (ecus < 1 || ecus > 16 || dids < 1 || dids > 64 || latency < 0 || latency > 500)
+    {
+    writer->puts("ERROR: ecus 1-16, dids 1-64, latency 0-500 ms");
+    return;
+    }
+
+  // Poll lists: DID by DID and in multi DID entries of up to BATCHTEST_MAXDIDS
+  std::vector<OvmsPoller::poll_did_t> didlist;
+  std::vector<OvmsPoller::poll_pid_t> single, batch;
+  didlist.reserve(ecus * dids);
+  for (int e = 0; e < ecus; e++)
+    {
+    uint32_t txid = 0x700 + (e << 4);
+    for (int d = 0; d < dids; d++)
+      {
+      uint16_t did = 0xf400 + d;
+      OvmsPoller::poll_pid_t poll = { txid, txid + 8, VEHICLE_POLL_TYPE_READDATA, { did }, { 1, 1, 1, 1 }, 0, ISOTP_STD };
+      single.push_back(poll);
+      didlist.push_back({ did, PollerSimBus::Length(did) });
+      }
+    for (int d = 0; d < dids; d += BATCHTEST_MAXDIDS)
+      {
+      OvmsPoller::poll_pid_t poll = { txid, txid + 8, VEHICLE_POLL_TYPE_READDATA, {}, { 1, 1, 1, 1 }, 0, ISOTP_STD };
+      const OvmsPoller::poll_did_t* first = &didlist[e * dids + d];
+      poll.xargs.pid = first->did;
+      poll.xargs.tag = POLL_TXBATCH;
+      poll.xargs.datalen = std::min(dids - d, BATCHTEST_MAXDIDS);
+      poll.xargs.data = reinterpret_cast<const uint8_t*>(first);
+      batch.push_back(poll);
+      }
+    }
+  single.push_back(POLL_LIST_END);
+  batch.push_back(POLL_LIST_END);
+
+  writer->printf("Simulated ECUs: %d, DIDs/ECU: %d, latency: %d ms, max DIDs/request: %d\n",
+                 ecus, dids, latency, BATCHTEST_MAXDIDS);
+  writer->puts("Mode              Cycle[ms]  TX frames  RX frames  Errors");
+
+  static const char* const modes[] = { "single DID", "multi DID", "fallback 1st run", "fallback 2nd run" };
+  BatchTestSignal signal;
+  std::unique_ptr<OvmsPoller::StandardVehiclePollSeries> series;
+  PollerSimBus bus;
+  bus.m_latency = latency * 1000;
+  for (int mode = 0; mode < 4; mode++)
+    {
+    if (mode != 3)
+      {
+      series.reset(new OvmsPoller::StandardVehiclePollSeries(nullptr, &signal));
+      series->PollSetPidList(1, (mode == 0) ? single.data() : batch.data());
+      }
+    bus.m_multidid = (mode < 2);
+    signal.m_ok = signal.m_bad = 0;
+    uint64_t cycle = BatchTestRun(*series, bus);
+    uint32_t errors = signal.m_bad + (ecus * dids - signal.m_ok);
+    writer->printf("%-16s  %9.1f  %9" PRIu32 "  %9" PRIu32 "  %6" PRIu32 "\n",
+                   modes[mode], cycle / 1000.0, bus.m_txframes, bus.m_rxframes, errors);
+    if (errors)
+      writer->printf("ERROR: %" PRIu32 " responses lost or corrupted in mode '%s'\n", errors, modes[mode]);
+    }
+  }
@@ -38,84 +38,52 @@ static const char *TAG = "vehicle-isotp";
 
 
 /**
- * PollerISOTPStart: start ISO-TP request
+ * ISOTPRequestFrame: assemble ISO-TP single/first frame for a poll request
+ *
+ *  @param txframe      Frame to fill in (origin & callback need to be set by the caller)
+ *  @param entry        Poll entry (protocol, type & PID)
+ *  @param txid         Module ID to send to
+ *  @param tx_data      Payload data
+ *  @param tx_datalen   Payload data length
+ *
+ *  @return             Payload data length sent with this frame
  */
-void OvmsPoller::PollerISOTPStart(bool fromTicker)
+uint16_t OvmsPoller::ISOTPRequestFrame(CAN_frame_t& txframe, const poll_pid_t& entry, uint32_t txid,
+                                       const uint8_t* tx_data, uint16_t tx_datalen)
   {
-  if (m_poll.entry.rxmoduleid != 0)
-    {
-    // send to <moduleid>, listen to response from <rmoduleid>:
-    m_poll.moduleid_sent = m_poll.entry.txmoduleid;
-    m_poll.moduleid_low = m_poll.entry.rxmoduleid;
-    m_poll.moduleid_high = m_poll.entry.rxmoduleid;
-    }
-  else
-    {
-    // broadcast: send to 0x7df, listen to all responses:
-    m_poll.moduleid_sent = 0x7df;
-    m_poll.moduleid_low = 0x7e8;
-    m_poll.moduleid_high = 0x7ef;
-    }
-
-  ESP_LOGD(TAG, "[%" PRIu8 "]PollerISOTPStart(%s): send [bus=%" PRIu8 ", type=%02" PRIX16 ", pid=%X], expecting %03" PRIx32 "/%03" PRIx32 "-%03" PRIx32 "",
-           m_poll.bus_no, fromTicker ? "Yes" : "No",
-           m_poll.entry.pollbus, m_poll.type, m_poll.pid, m_poll.moduleid_sent,
-           m_poll.moduleid_low, m_poll.moduleid_high);
-
-  //
-  // Assemble ISO-TP single/first frame
-  //
-
   uint8_t* fr_data;               // Frame data address
   uint8_t  fr_maxlen;             // Frame data max length
   uint16_t tp_len;                // TP payload length including this frame (0…4095)
   uint8_t* tp_data;               // TP frame data section address
   uint8_t  tp_datalen;            // TP frame data section length (0…7)
-
-  const uint8_t* tx_data;         // Payload data
-  uint16_t tx_datalen;            // Payload data length
   uint16_t tx_datasent;           // Payload data length sent with this frame
 
-  if (m_poll.entry.xargs.tag == POLL_TXDATA)
-    {
-    tx_data = m_poll.entry.xargs.data;
-    tx_datalen = m_poll.entry.xargs.datalen;
-    }
-  else
-    {
-    tx_data = m_poll.entry.args.data;
-    tx_datalen = m_poll.entry.args.datalen;
-    }
-
-  CAN_frame_t txframe = {};
-  txframe.origin = m_poll.bus;
-  txframe.callback = &m_poll_txcallback;
   txframe.FIR.B.DLC = 8;
   std::fill_n(txframe.data.u8, sizeof_array(txframe.data.u8), 0x55);
 
-  if (m_poll.protocol == ISOTP_EXTFRAME)
+  if (entry.protocol == ISOTP_EXTFRAME)
     txframe.FIR.B.FF = CAN_frame_ext;
   else
     txframe.FIR.B.FF = CAN_frame_std;
 
-  if (m_poll.protocol == ISOTP_EXTADR)
+  if (entry.protocol == ISOTP_EXTADR)
     {
-    txframe.MsgID = m_poll.moduleid_sent >> 8;
-    txframe.data.u8[0] = m_poll.moduleid_sent & 0xff;
+    txframe.MsgID = txid >> 8;
+    txframe.data.u8[0] = txid & 0xff;
     fr_data = &txframe.data.u8[1];
     fr_maxlen = 7;
     }
   else
     {
-    txframe.MsgID = m_poll.moduleid_sent;
+    txframe.MsgID = txid;
     fr_data = &txframe.data.u8[0];
     fr_maxlen = 8;
     }
 
   // Do we need to split this request into multiple frames?
-  if (POLL_TYPE_HAS_16BIT_PID(m_poll.entry.type))
+  if (POLL_TYPE_HAS_16BIT_PID(entry.type))
     tp_len = 3 + tx_datalen;
-  else if (POLL_TYPE_HAS_8BIT_PID(m_poll.entry.type))
+  else if (POLL_TYPE_HAS_8BIT_PID(entry.type))
     tp_len = 2 + tx_datalen;
   else
     tp_len = 1 + tx_datalen;
@@ -135,28 +103,110 @@ void OvmsPoller::PollerISOTPStart(bool fromTicker)
     }
 
   // Add TP data:
-  if (POLL_TYPE_HAS_16BIT_PID(m_poll.entry.type))
+  if (POLL_TYPE_HAS_16BIT_PID(entry.type))
     {
-    tp_data[0] = m_poll.type;
-    tp_data[1] = m_poll.pid >> 8;
-    tp_data[2] = m_poll.pid & 0xff;
+    tp_data[0] = entry.type;
+    tp_data[1] = entry.pid >> 8;
+    tp_data[2] = entry.pid & 0xff;
     tx_datasent = LIMIT_MAX(tx_datalen, tp_datalen - 3);
     memcpy(&tp_data[3], tx_data, tx_datasent);
     }
-  else if (POLL_TYPE_HAS_8BIT_PID(m_poll.entry.type))
+  else if (POLL_TYPE_HAS_8BIT_PID(entry.type))
     {
-    tp_data[0] = m_poll.type;
-    tp_data[1] = m_poll.pid;
+    tp_data[0] = entry.type;
+    tp_data[1] = entry.pid;
     tx_datasent = LIMIT_MAX(tx_datalen, tp_datalen - 2);
     memcpy(&tp_data[2], tx_data, tx_datasent);
     }
   else
     {
-    tp_data[0] = m_poll.type;
+    tp_data[0] = entry.type;
     tx_datasent = LIMIT_MAX(tx_datalen, tp_datalen - 1);
     memcpy(&tp_data[1], tx_data, tx_datasent);
     }
 
+  return tx_datasent;
+  }
+
+/**
+ * ISOTPFlowControlFrame: assemble ISO-TP flow control frame requesting all frames
+ */
+void OvmsPoller::ISOTPFlowControlFrame(CAN_frame_t& txframe, uint8_t protocol, uint32_t txid, uint8_t septime)
+  {
+  uint8_t* txdata;
+  txframe.FIR.B.DLC = 8;
+
+  if (protocol == ISOTP_EXTFRAME)
+    txframe.FIR.B.FF = CAN_frame_ext;
+  else
+    txframe.FIR.B.FF = CAN_frame_std;
+
+  if (protocol == ISOTP_EXTADR)
+    {
+    txframe.MsgID = txid >> 8;
+    txframe.data.u8[0] = txid & 0xff;
+    txdata = &txframe.data.u8[1];
+    }
+  else
+    {
+    txframe.MsgID = txid;
+    txdata = &txframe.data.u8[0];
+    }
+
+  txdata[0] = 0x30;                // flow control frame type
+  txdata[1] = 0x00;                // request all frames available
+  txdata[2] = septime;             // with configured separation timing (default 25 ms)
+  }
+
+/**
+ * PollerISOTPStart: start ISO-TP request
+ */
+void OvmsPoller::PollerISOTPStart(bool fromTicker)
+  {
+  if (m_poll.entry.rxmoduleid != 0)
+    {
+    // send to <moduleid>, listen to response from <rmoduleid>:
+    m_poll.moduleid_sent = m_poll.entry.txmoduleid;
+    m_poll.moduleid_low = m_poll.entry.rxmoduleid;
+    m_poll.moduleid_high = m_poll.entry.rxmoduleid;
+    }
+  else
+    {
+    // broadcast: send to 0x7df, listen to all responses:
+    m_poll.moduleid_sent = 0x7df;
+    m_poll.moduleid_low = 0x7e8;
+    m_poll.moduleid_high = 0x7ef;
+    }
+
+  ESP_LOGD(TAG, "[%" PRIu8 "]PollerISOTPStart(%s): send [bus=%" PRIu8 ", type=%02" PRIX16 ", pid=%X], expecting %03" PRIx32 "/%03" PRIx32 "-%03" PRIx32 "",
+           m_poll.bus_no, fromTicker ? "Yes" : "No",
+           m_poll.entry.pollbus, m_poll.type, m_poll.pid, m_poll.moduleid_sent,
+           m_poll.moduleid_low, m_poll.moduleid_high);
+
+  //
+  // Assemble ISO-TP single/first frame
+  //
+
+  const uint8_t* tx_data;         // Payload data
+  uint16_t tx_datalen;            // Payload data length
+  uint16_t tx_datasent;           // Payload data length sent with this frame
+
+  if (m_poll.entry.xargs.tag == POLL_TXDATA)
+    {
+    tx_data = m_poll.entry.xargs.data;
+    tx_datalen = m_poll.entry.xargs.datalen;
+    }
+  else
+    {
+    tx_data = m_poll.entry.args.data;
+    tx_datalen = m_poll.entry.args.datalen;
+    }
+
+  CAN_frame_t txframe = {};
+  txframe.origin = m_poll.bus;
+  txframe.callback = &m_poll_txcallback;
+  tx_datasent = ISOTPRequestFrame(txframe, m_poll.entry, m_poll.moduleid_sent, tx_data, tx_datalen);
+
   m_poll_txmsgid = txframe.MsgID;
   m_poll_tx_frame = 0;
   m_poll_tx_data = tx_data;
@@ -498,16 +548,9 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
       {
       // First frame; send flow control frame:
       CAN_frame_t txframe;
-      uint8_t* txdata;
       uint32_t txid;
       memset(&txframe,0,sizeof(txframe));
       txframe.origin = frame->origin;
-      txframe.FIR.B.DLC = 8;
-
-      if (m_poll.protocol == ISOTP_EXTFRAME)
-        txframe.FIR.B.FF = CAN_frame_ext;
-      else
-        txframe.FIR.B.FF = CAN_frame_std;
 
       if (m_poll.moduleid_sent == 0x7df)
         {
@@ -521,21 +564,7 @@ bool OvmsPoller::PollerISOTPReceive(CAN_frame_t* frame, uint32_t msgid)
         txid = m_poll.moduleid_sent;
         }
 
-      if (m_poll.protocol == ISOTP_EXTADR)
-        {
-        txframe.MsgID = txid >> 8;
-        txframe.data.u8[0] = txid & 0xff;
-        txdata = &txframe.data.u8[1];
-        }
-      else
-        {
-        txframe.MsgID = txid;
-        txdata = &txframe.data.u8[0];
-        }
-
-      txdata[0] = 0x30;                // flow control frame type
-      txdata[1] = 0x00;                // request all frames available
-      txdata[2] = m_poll_fc_septime;   // with configured separation timing (default 25 ms)
+      ISOTPFlowControlFrame(txframe, m_poll.protocol, txid, m_poll_fc_septime);
       txframe.Write();
       m_poll.mlframe = 1;
       }
@@ -0,0 +1,823 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "vehicle-pipeline";
+
+#include <stdio.h>
+#include <algorithm>
+#include <esp_timer.h>
+#include <ovms_command.h>
+#include "vehicle.h"
+#include "vehicle_poller_sim.h"
+
+
+OvmsPoller::ISOTPPipeline::ISOTPPipeline(CanFrameCallback* txcallback)
+  : m_txcallback(txcallback)
+  {
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    m_session[i].active = false;
+  m_window = 1;
+  m_active = 0;
+  m_deferred_cnt = 0;
+  m_fc_septime = 25;
+  m_cnt_started = 0;
+  m_cnt_done = 0;
+  m_cnt_error = 0;
+  m_cnt_timeout = 0;
+  }
+
+/**
+ * SetWindow: set max number of requests in flight, 1 = pipelining disabled
+ *  Reducing the window doesn't abort running requests.
+ */
+void OvmsPoller::ISOTPPipeline::SetWindow(uint8_t window)
+  {
+  m_window = LIMIT_MAX(LIMIT_MIN(window, 1), VEHICLE_POLL_PIPELINE_MAX);
+  }
+
+/**
+ * IsEligible: check if a poll entry can be sent pipelined
+ *  Broadcasts, responses without a specific RX ID and VWTP requests are
+ *  left to the serial poller.
+ */
+bool OvmsPoller::ISOTPPipeline::IsEligible(const poll_pid_t& entry)
+  {
+  return (entry.protocol == ISOTP_STD || entry.protocol == ISOTP_EXTADR || entry.protocol == ISOTP_EXTFRAME)
+      && entry.rxmoduleid != 0
+      && entry.txmoduleid != 0x7df;
+  }
+
+/**
+ * IsActive: check if the ECU addressed by the entry has a request in flight
+ */
+bool OvmsPoller::ISOTPPipeline::IsActive(const poll_pid_t& entry) const
+  {
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    const session_t* s = &m_session[i];
+    if (s->active && (s->job.moduleid_sent == entry.txmoduleid || s->job.moduleid_low == entry.rxmoduleid))
+      return true;
+    }
+  return false;
+  }
+
+/**
+ * IsBusy: check if the ECU addressed by the entry has a request in flight or deferred
+ *  Requests to a busy ECU need to be deferred to keep the order per ECU.
+ */
+bool OvmsPoller::ISOTPPipeline::IsBusy(const poll_pid_t& entry) const
+  {
+  for (int i = 0; i < m_deferred_cnt; i++)
+    {
+    const poll_pid_t& d = m_deferred[i].entry;
+    if (d.txmoduleid == entry.txmoduleid || d.rxmoduleid == entry.rxmoduleid)
+      return true;
+    }
+  return IsActive(entry);
+  }
+
+/**
+ * Defer: queue request until its ECU is done with the previous one
+ *  Poll lists are normally sorted by ECU, so without this the pipeline would
+ *  stall on the second request to the same ECU. The queue size is limited to
+ *  the window size.
+ *  @return         false if the queue is full
+ */
+bool OvmsPoller::ISOTPPipeline::Defer(const poll_pid_t& entry, PollSeriesEntry* series)
+  {
+  if (m_deferred_cnt >= m_window)
+    return false;
+  m_deferred[m_deferred_cnt].entry = entry;
+  m_deferred[m_deferred_cnt].series = series;
+  m_deferred_cnt++;
+  return true;
+  }
+
+/**
+ * StartDeferred: send deferred requests whose ECU has become idle
+ *  Call after requests have finished.
+ *  @return         number of requests sent
+ */
+int OvmsPoller::ISOTPPipeline::StartDeferred(const poll_job_t& base)
+  {
+  int started = 0;
+  for (int i = 0; i < m_deferred_cnt && !IsFull(); )
+    {
+    if (IsActive(m_deferred[i].entry) || !Start(base, m_deferred[i].entry, m_deferred[i].series))
+      {
+      i++;
+      continue;
+      }
+    started++;
+    m_deferred_cnt--;
+    for (int j = i; j < m_deferred_cnt; j++)
+      m_deferred[j] = m_deferred[j+1];
+    }
+  return started;
+  }
+
+/**
+ * Start: send request
+ *  @param base     Poller job status to inherit (bus, ticker)
+ *  @param entry    Poll entry to send
+ *  @param series   Series to pass the response to
+ *  @return         false if the window is full or the ECU is busy
+ */
+bool OvmsPoller::ISOTPPipeline::Start(const poll_job_t& base, const poll_pid_t& entry, PollSeriesEntry* series)
+  {
+  if (IsFull() || !IsEligible(entry) || IsActive(entry))
+    return false;
+
+  session_t* s = NULL;
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX && !s; i++)
+    {
+    if (!m_session[i].active)
+      s = &m_session[i];
+    }
+  if (!s)
+    return false;
+
+  s->job = base;
+  s->job.entry = entry;
+  s->job.protocol = entry.protocol;
+  s->job.type = entry.type;
+  s->job.pid = entry.pid;
+  s->job.moduleid_sent = entry.txmoduleid;
+  s->job.moduleid_low = entry.rxmoduleid;
+  s->job.moduleid_high = entry.rxmoduleid;
+  s->job.moduleid_rec = 0;
+  s->job.mlframe = 0;
+  s->job.mloffset = 0;
+  s->job.mlremain = 0;
+  s->job.raw_data = nullptr;
+  s->job.raw_data_len = 0;
+  s->series = series;
+
+  const uint8_t* tx_data;
+  uint16_t tx_datalen, tx_datasent;
+  if (entry.xargs.tag == POLL_TXDATA)
+    {
+    tx_data = entry.xargs.data;
+    tx_datalen = entry.xargs.datalen;
+    }
+  else
+    {
+    tx_data = entry.args.data;
+    tx_datalen = entry.args.datalen;
+    }
+
+  CAN_frame_t txframe = {};
+  txframe.origin = base.bus;
+  txframe.callback = m_txcallback;
+  tx_datasent = ISOTPRequestFrame(txframe, entry, entry.txmoduleid, tx_data, tx_datalen);
+
+  // The payload may be gone when the flow control arrives, keep a copy:
+  s->txmsgid = txframe.MsgID;
+  s->txbuf.assign((const char*)tx_data + tx_datasent, tx_datalen - tx_datasent);
+  s->tx_offset = 0;
+  s->tx_frame = 0;
+  s->tx_blockleft = 0;
+  s->tx_septime = 0;
+  s->tx_due = 0;
+  s->rxbuf.clear();
+  s->rxlen = 0;
+  s->rxhdr = 0;
+  s->rxfirst = 0;
+  s->wait = 2;
+  s->active = true;
+  m_active++;
+  m_cnt_started++;
+
+  ESP_LOGD(TAG, "[%" PRIu8 "]Start: send [type=%02" PRIX16 ", pid=%X] to %03" PRIx32 ", expecting %03" PRIx32 ", active=%u/%u",
+           base.bus_no, s->job.type, s->job.pid, s->job.moduleid_sent, s->job.moduleid_low, m_active, m_window);
+
+  Write(&txframe);
+  return true;
+  }
+
+/**
+ * Find: get the session a frame belongs to
+ */
+OvmsPoller::ISOTPPipeline::session_t* OvmsPoller::ISOTPPipeline::Find(CAN_frame_t* frame, uint32_t& msgid)
+  {
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    session_t* s = &m_session[i];
+    if (!s->active || s->job.bus != frame->origin)
+      continue;
+    if (s->job.protocol == ISOTP_EXTADR)
+      msgid = frame->MsgID << 8 | frame->data.u8[0];
+    else
+      msgid = frame->MsgID;
+    if (msgid == s->job.moduleid_low)
+      return s;
+    }
+  return NULL;
+  }
+
+/**
+ * Receive: process ISO-TP response frame
+ *  @return   true if the frame belongs to a running request
+ */
+bool OvmsPoller::ISOTPPipeline::Receive(CAN_frame_t* frame)
+  {
+  char *hexdump = NULL;
+  uint32_t msgid;
+  session_t* s = Find(frame, msgid);
+  if (!s)
+    return false;
+
+  uint8_t* fr_data;               // Frame data address
+  uint8_t  fr_maxlen;             // Frame data max length
+  if (s->job.protocol == ISOTP_EXTADR)
+    {
+    fr_data = &frame->data.u8[1];
+    fr_maxlen = 7;
+    }
+  else
+    {
+    fr_data = &frame->data.u8[0];
+    fr_maxlen = 8;
+    }
+
+  s->job.format = frame->FIR.B.FF;
+  uint8_t tp_frametype = fr_data[0] >> 4;
+
+  if (tp_frametype == ISOTP_FT_FLOWCTRL)
+    return ReceiveFlowControl(s, frame, fr_data);
+
+  if (tp_frametype == ISOTP_FT_CONSECUTIVE)
+    {
+    // Note: we tolerate an index less than the expected one, as some devices
+    //  begin counting at the first consecutive frame
+    uint8_t tp_frameindex = fr_data[0] & 0x0f;
+    if (s->rxlen == 0 || s->rxbuf.size() >= s->rxlen || tp_frameindex > (s->job.mlframe & 0x0f))
+      {
+      FormatHexDump(&hexdump, (const char*)frame->data.u8, 8, 8);
+      ESP_LOGW(TAG, "Receive[%03" PRIX32 "]: unexpected/out of sequence ISO TP frame (%d vs %d), aborting poll %02X(%X): %s",
+               msgid, tp_frameindex, s->job.mlframe & 0x0f, s->job.type, s->job.pid, hexdump ? hexdump : "-");
+      if (hexdump) free(hexdump);
+      m_cnt_error++;
+      Finish(s);
+      return true;
+      }
+    uint16_t tp_datalen = LIMIT_MAX((uint16_t)(s->rxlen - s->rxbuf.size()), (uint16_t)(fr_maxlen - 1));
+    s->rxbuf.append((const char*)&fr_data[1], tp_datalen);
+    s->job.mlframe++;
+    s->wait = 2;
+    if (s->rxbuf.size() >= s->rxlen)
+      Deliver(s);
+    return true;
+    }
+
+  if (tp_frametype != ISOTP_FT_SINGLE && tp_frametype != ISOTP_FT_FIRST)
+    {
+    FormatHexDump(&hexdump, (const char*)frame->data.u8, 8, 8);
+    ESP_LOGW(TAG, "Receive[%03" PRIX32 "]: ignoring unknown/invalid ISO TP frame: %s",
+             msgid, hexdump ? hexdump : "-");
+    if (hexdump) free(hexdump);
+    return false;
+    }
+
+  uint16_t tp_len;                // TP payload length (0…4095)
+  uint8_t* tp_data;               // TP frame data section address
+  uint8_t  tp_datalen;            // TP frame data section length (0…7)
+  if (tp_frametype == ISOTP_FT_SINGLE)
+    {
+    tp_datalen = LIMIT_MAX(fr_data[0] & 0x0f, fr_maxlen - 1);
+    tp_len = tp_datalen;
+    tp_data = &fr_data[1];
+    }
+  else
+    {
+    tp_len = (fr_data[0] & 0x0f) << 8 | fr_data[1];
+    tp_data = &fr_data[2];
+    tp_datalen = LIMIT_MAX(tp_len, fr_maxlen - 2);
+    }
+
+  // Negative Response Code:
+  uint8_t response_type = (tp_datalen > 0) ? tp_data[0] : 0;
+  if (response_type == UDS_RESP_TYPE_NRC && tp_datalen >= 3 && tp_data[1] == s->job.type)
+    {
+    uint8_t error_code = tp_data[2];
+    if (error_code == UDS_RESP_NRC_RCRRP)
+      {
+      ESP_LOGD(TAG, "[%" PRIu8 "]Receive[%03" PRIX32 "]: got OBD/UDS info %02X(%X) code=%02X (pending)",
+               s->job.bus_no, msgid, s->job.type, s->job.pid, error_code);
+      s->wait++;
+      }
+    else
+      {
+      ESP_LOGD(TAG, "[%" PRIu8 "]Receive[%03" PRIX32 "]: process OBD/UDS error %02X(%X) code=%02X",
+               s->job.bus_no, msgid, s->job.type, s->job.pid, error_code);
+      s->job.moduleid_rec = msgid;
+      Error(s, error_code);
+      }
+    return true;
+    }
+
+  // Validate response type & PID:
+  uint8_t  response_hdr;
+  uint16_t response_pid;
+  if (POLL_TYPE_HAS_16BIT_PID(s->job.type))
+    {
+    response_hdr = 3;
+    response_pid = (tp_datalen >= 3) ? (tp_data[1] << 8 | tp_data[2]) : 0;
+    }
+  else if (POLL_TYPE_HAS_8BIT_PID(s->job.type))
+    {
+    response_hdr = 2;
+    response_pid = (tp_datalen >= 2) ? tp_data[1] : 0;
+    }
+  else
+    {
+    response_hdr = 1;
+    response_pid = s->job.pid;
+    }
+  if (response_type != 0x40+s->job.type || response_pid != s->job.pid || tp_datalen < response_hdr)
+    {
+    // This is most likely a late response to a previous poll, log & skip:
+    FormatHexDump(&hexdump, (const char*)frame->data.u8, 8, 8);
+    ESP_LOGW(TAG, "Receive[%03" PRIX32 "]: OBD/UDS response type/PID mismatch, got %02X(%X) vs %02X(%X) => ignoring: %s",
+             msgid, response_type, response_pid, 0x40+s->job.type, s->job.pid, hexdump ? hexdump : "-");
+    if (hexdump) free(hexdump);
+    return false;
+    }
+
+  s->job.moduleid_rec = msgid;
+  s->rxbuf.assign((const char*)tp_data, tp_datalen);
+  s->rxlen = tp_len;
+  s->rxhdr = response_hdr;
+  s->rxfirst = tp_datalen;
+
+  if (tp_len > tp_datalen)
+    {
+    // First frame; send flow control frame:
+    CAN_frame_t txframe = {};
+    txframe.origin = frame->origin;
+    ISOTPFlowControlFrame(txframe, s->job.protocol, s->job.moduleid_sent, m_fc_septime);
+    Write(&txframe);
+    s->rxbuf.reserve(tp_len);
+    s->job.mlframe = 1;
+    s->wait = 2;
+    }
+  else
+    {
+    Deliver(s);
+    }
+  return true;
+  }
+
+/**
+ * ReceiveFlowControl: send consecutive frames of a multi frame request
+ */
+bool OvmsPoller::ISOTPPipeline::ReceiveFlowControl(session_t* s, CAN_frame_t* frame, uint8_t* fr_data)
+  {
+  uint8_t tp_fc_command  = fr_data[0] & 0x0f;   // 0 = continue, 1 = wait, 2 = abort
+  uint8_t tp_fc_framecnt = fr_data[1];          // max frame count (0 = unlimited)
+  uint8_t tp_fc_septime  = fr_data[2];          // frame separation time
+  uint16_t tx_remain = s->txbuf.size() - s->tx_offset;
+
+  if (tp_fc_command > 2 || tx_remain == 0)
+    {
+    char *hexdump = NULL;
+    FormatHexDump(&hexdump, (const char*)frame->data.u8, 8, 8);
+    ESP_LOGW(TAG, "Receive[%03" PRIX32 "]: ignoring unexpected/invalid ISO TP flow control frame: %s",
+             s->job.moduleid_low, hexdump ? hexdump : "-");
+    if (hexdump) free(hexdump);
+    return false;
+    }
+
+  if (tp_fc_command == 1)
+    {
+    // add some wait time:
+    s->wait++;
+    return true;
+    }
+  else if (tp_fc_command == 2)
+    {
+    // abort TX (but still wait for response):
+    s->tx_offset = s->txbuf.size();
+    s->tx_due = 0;
+    return true;
+    }
+
+  // continue TX: send the first frame of the block now, the
+  // remaining ones are paced by TxTicker() (see TxDue()):
+  s->tx_blockleft = tp_fc_framecnt;
+  s->tx_septime = tp_fc_septime;
+  SendConsecutive(s);
+  return true;
+  }
+
+/**
+ * SendConsecutive: send consecutive frames of a multi frame request
+ *  Sends frames up to the end of the flow control block, or until the
+ *  separation time requires a pause. In that case the next frame is
+ *  scheduled by tx_due, so we never sleep with the poll mutex held.
+ */
+void OvmsPoller::ISOTPPipeline::SendConsecutive(session_t* s)
+  {
+  uint16_t tx_remain = s->txbuf.size() - s->tx_offset;
+  CAN_frame_t tx_frame = {};
+  uint8_t* tx_data;
+  uint8_t tx_datalen;
+  uint8_t tx_datasent;
+  uint32_t txid = s->job.moduleid_sent;
+  tx_frame.origin = s->job.bus;
+  tx_frame.FIR.B.DLC = 8;
+  tx_frame.FIR.B.FF = (s->job.protocol == ISOTP_EXTFRAME) ? CAN_frame_ext : CAN_frame_std;
+  if (s->job.protocol == ISOTP_EXTADR)
+    {
+    tx_frame.MsgID = txid >> 8;
+    tx_frame.data.u8[0] = txid & 0xff;
+    tx_data = &tx_frame.data.u8[1];
+    tx_datalen = 6;
+    }
+  else
+    {
+    tx_frame.MsgID = txid;
+    tx_data = &tx_frame.data.u8[0];
+    tx_datalen = 7;
+    }
+
+  s->tx_due = 0;
+  while (tx_remain > 0)
+    {
+    ++s->tx_frame;
+    tx_data[0] = (ISOTP_FT_CONSECUTIVE << 4) + (s->tx_frame & 0x0f);
+    tx_datasent = LIMIT_MAX(tx_remain, tx_datalen);
+    memcpy(&tx_data[1], s->txbuf.data() + s->tx_offset, tx_datasent);
+    if (tx_datasent < tx_datalen)
+      memset(&tx_data[1+tx_datasent], 0x55, tx_datalen-tx_datasent);
+    Write(&tx_frame);
+    s->tx_offset += tx_datasent;
+    tx_remain -= tx_datasent;
+
+    if (tx_remain == 0)
+      break;
+    if (s->tx_blockleft > 0 && --s->tx_blockleft == 0)
+      break;    // wait for next flow control frame
+
+    int64_t septime = 0;
+    if (s->tx_septime <= 127)
+      septime = s->tx_septime * 1000;
+    else if (s->tx_septime > 240 && s->tx_septime <= 249)
+      septime = (s->tx_septime - 240) * 100;
+    if (septime > 0)
+      {
+      s->tx_due = esp_timer_get_time() + septime;
+      break;
+      }
+    }
+
+  s->wait = 2;
+  }
+
+/**
+ * TxDue: get time of the next paced consecutive frame
+ *  @return   esp_timer time [us], 0 = none scheduled
+ */
+int64_t OvmsPoller::ISOTPPipeline::TxDue() const
+  {
+  int64_t due = 0;
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    const session_t* s = &m_session[i];
+    if (s->active && s->tx_due && (due == 0 || s->tx_due < due))
+      due = s->tx_due;
+    }
+  return due;
+  }
+
+/**
+ * TxTicker: send consecutive frames that are due
+ */
+void OvmsPoller::ISOTPPipeline::TxTicker()
+  {
+  int64_t now = esp_timer_get_time();
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    session_t* s = &m_session[i];
+    if (s->active && s->tx_due && now >= s->tx_due)
+      SendConsecutive(s);
+    }
+  }
+
+/**
+ * Deliver: pass complete response to the series
+ *  The response is split up as received, so the series gets the same
+ *  mlframe / mloffset / mlremain sequence as from the serial poller.
+ */
+void OvmsPoller::ISOTPPipeline::Deliver(session_t* s)
+  {
+  poll_job_t& job = s->job;
+  uint8_t* buf = (uint8_t*) &s->rxbuf[0];
+  uint16_t total = s->rxbuf.size();
+  uint8_t cf_maxlen = (job.protocol == ISOTP_EXTADR) ? 6 : 7;
+  uint16_t pos, len;
+
+  ESP_LOGD(TAG, "[%" PRIu8 "]Deliver[%03" PRIX32 "]: process OBD/UDS response %02" PRIX16 "(%" PRIX16 ") len=%u",
+           job.bus_no, job.moduleid_rec, job.type, job.pid, total - s->rxhdr);
+
+  job.mlframe = 0;
+  job.mloffset = 0;
+  job.mlremain = total - s->rxfirst;
+  job.raw_data = buf;
+  job.raw_data_len = s->rxfirst;
+  if (s->series)
+    s->series->IncomingPacket(job, buf + s->rxhdr, s->rxfirst - s->rxhdr);
+  job.mloffset = s->rxfirst - s->rxhdr;
+
+  for (pos = s->rxfirst; pos < total; pos += len)
+    {
+    len = LIMIT_MAX((uint16_t)(total - pos), (uint16_t)cf_maxlen);
+    job.mlframe++;
+    job.mlremain = total - pos - len;
+    job.raw_data = buf + pos;
+    job.raw_data_len = len;
+    if (s->series)
+      s->series->IncomingPacket(job, buf + pos, len);
+    job.mloffset += len;
+    }
+
+  job.raw_data = nullptr;
+  job.raw_data_len = 0;
+  m_cnt_done++;
+  Finish(s);
+  }
+
+/**
+ * Error: pass error code to the series & close the session
+ */
+void OvmsPoller::ISOTPPipeline::Error(session_t* s, uint16_t code)
+  {
+  s->job.mlframe = 0;
+  s->job.mloffset = 0;
+  s->job.mlremain = 0;
+  if (s->series)
+    s->series->IncomingError(s->job, code);
+  m_cnt_error++;
+  Finish(s);
+  }
+
+void OvmsPoller::ISOTPPipeline::Finish(session_t* s)
+  {
+  // Keep the buffer capacities for the next request:
+  s->txbuf.clear();
+  s->rxbuf.clear();
+  s->active = false;
+  m_active--;
+  }
+
+/**
+ * TxCallback: process request frame transmission result
+ *  @return   true if the frame belongs to a running request
+ */
+bool OvmsPoller::ISOTPPipeline::TxCallback(const CAN_frame_t* frame, bool success)
+  {
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    session_t* s = &m_session[i];
+    if (!s->active || s->job.bus != frame->origin || s->txmsgid != frame->MsgID)
+      continue;
+    if (s->job.protocol == ISOTP_EXTADR && frame->data.u8[0] != (s->job.moduleid_sent & 0xff))
+      continue;
+
+    s->job.moduleid_rec = 0; // Not yet received
+    if (!success)
+      {
+      if (s->series)
+        s->series->IncomingError(s->job, POLLSINGLE_TXFAILURE);
+      m_cnt_error++;
+      }
+    if (s->series)
+      s->series->IncomingTxReply(s->job, success);
+    if (!success)
+      Finish(s);
+    return true;
+    }
+  return false;
+  }
+
+/**
+ * Ticker: response timeout handling, call once per poll tick
+ */
+void OvmsPoller::ISOTPPipeline::Ticker()
+  {
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    session_t* s = &m_session[i];
+    if (!s->active)
+      continue;
+    if (s->wait > 0)
+      s->wait--;
+    if (s->wait == 0)
+      {
+      ESP_LOGD(TAG, "[%" PRIu8 "]Ticker: timeout on %02X(%X) from %03" PRIx32,
+               s->job.bus_no, s->job.type, s->job.pid, s->job.moduleid_low);
+      m_cnt_timeout++;
+      Finish(s);
+      }
+    }
+  }
+
+void OvmsPoller::ISOTPPipeline::Clear()
+  {
+  for (int i = 0; i < VEHICLE_POLL_PIPELINE_MAX; i++)
+    {
+    if (m_session[i].active)
+      Finish(&m_session[i]);
+    }
+  m_deferred_cnt = 0;
+  }
+
+void OvmsPoller::ISOTPPipeline::Write(CAN_frame_t* frame)
+  {
+  if (m_writer)
+    m_writer(frame);
+  else
+    frame->origin->Write(frame);
+  }
+
+
+/**
+ * Pipeline benchmark: runs the ISO-TP pipeline against simulated ECUs
+ *  The ECUs answer canned UDS responses after a fixed latency, multi frame
+ *  responses follow the flow control separation time. Time is simulated, so
+ *  the test runs in a fraction of the cycle time and is reproducible.
+ */
+
+class PipelineTestSeries : public OvmsPoller::PollSeriesEntry
+  {
+  public:
+    std::vector<OvmsPoller::poll_pid_t> m_list;
+    size_t m_next = 0;
+    std::string m_rxbuf;
+    uint32_t m_ok = 0;
+    uint32_t m_bad = 0;
+
+  public:
+    void SetParentPoller(OvmsPoller *poller) override {}
+    void ResetList(OvmsPoller::ResetMode mode) override { m_next = 0; }
+    OvmsPoller::OvmsNextPollResult NextPollEntry(OvmsPoller::poll_pid_t &entry, uint8_t mybus, uint32_t pollticker, uint8_t pollstate) override
+      {
+      if (m_next >= m_list.size())
+        return OvmsPoller::OvmsNextPollResult::ReachedEnd;
+      entry = m_list[m_next++];
+      return OvmsPoller::OvmsNextPollResult::FoundEntry;
+      }
+    void IncomingPacket(const OvmsPoller::poll_job_t& job, uint8_t* data, uint8_t length) override
+      {
+      // Single buffer assembly like most vehicles do; breaks on interleaved responses:
+      if (job.mlframe == 0)
+        m_rxbuf.clear();
+      if (job.mloffset != m_rxbuf.size())
+        {
+        m_bad++;
+        return;
+        }
+      m_rxbuf.append((const char*)data, length);
+      if (job.mlremain == 0)
+        {
+        if (m_rxbuf == PollerSimBus::Data(job.moduleid_sent, job.pid))
+          m_ok++;
+        else
+          m_bad++;
+        }
+      }
+    void IncomingError(const OvmsPoller::poll_job_t& job, uint16_t code) override { m_bad++; }
+    OvmsPoller::SeriesStatus FinishRun() override { return OvmsPoller::SeriesStatus::Next; }
+    void Removing() override {}
+    bool HasPollList() const override { return !m_list.empty(); }
+    bool HasRepeat() const override { return false; }
+  };
+
+static uint64_t PipelineTestRun(uint8_t window, int ecus, int pids,
+                                uint32_t latency, uint8_t septime, uint32_t& frames, uint32_t& errors)
+  {
+  PipelineTestSeries series;
+  PollerSimBus bus;
+  OvmsPoller::ISOTPPipeline pipeline;
+  OvmsPoller::poll_job_t base = {};
+  OvmsPoller::poll_pid_t entry = {};
+  bool pending = false;
+
+  // Poll list as vehicles usually order it: ECU by ECU
+  for (int e = 0; e < ecus; e++)
+    {
+    for (int p = 0; p < pids; p++)
+      {
+      OvmsPoller::poll_pid_t poll = { (uint32_t)(0x700 + (e << 4)), (uint32_t)(0x708 + (e << 4)),
+        VEHICLE_POLL_TYPE_READDATA, { (uint16_t)(0xf400 + p) }, { 1, 1, 1, 1 }, 0, ISOTP_STD };
+      series.m_list.push_back(poll);
+      }
+    }
+
+  bus.m_latency = latency;
+  pipeline.SetWindow(window);
+  pipeline.SetResponseSeparationTime(septime);
+  pipeline.SetWriter([&bus](CAN_frame_t* frame) { bus.Transmit(frame); });
+
+  uint64_t next_tick = POLLSIM_TICKTIME;
+  while (true)
+    {
+    // Fill the window, like PollerSend() does:
+    pipeline.StartDeferred(base);
+    while (true)
+      {
+      if (!pending)
+        {
+        if (series.NextPollEntry(entry, 1, 0, 0) != OvmsPoller::OvmsNextPollResult::FoundEntry)
+          break;
+        pending = true;
+        }
+      if (pipeline.IsBusy(entry))
+        {
+        if (!pipeline.Defer(entry, &series))
+          break;
+        }
+      else if (pipeline.IsFull())
+        break;
+      else
+        pipeline.Start(base, entry, &series);
+      pending = false;
+      }
+
+    if (bus.m_queue.empty() && pipeline.IsIdle() && !pending)
+      break;
+
+    // Next event: frame reception or poll tick
+    auto it = bus.m_queue.begin();
+    if (it != bus.m_queue.end() && it->first < next_tick)
+      {
+      CAN_frame_t frame = it->second;
+      bus.m_now = it->first;
+      bus.m_queue.erase(it);
+      if (!pipeline.Receive(&frame))
+        series.m_bad++;
+      }
+    else
+      {
+      bus.m_now = next_tick;
+      next_tick += POLLSIM_TICKTIME;
+      pipeline.Ticker();
+      }
+    }
+
+  frames = bus.m_txframes;
+  errors = series.m_bad + pipeline.m_cnt_error + pipeline.m_cnt_timeout
+         + (ecus * pids - series.m_ok);
+  return bus.m_now;
+  }
+
+void OvmsPollers::poller_pipeline_test(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int ecus = (argc > 0) ? atoi(argv[0]) : 8;
+  int pids = (argc > 1) ? atoi(argv[1]) : 4;
+  int latency = (argc > 2) ? atoi(argv[2]) : 20;
+  if (ecus < 1 || ecus > 16 || pids < 1 || pids > 64 || latency < 0 || latency > 500)
+    {
+    writer->puts("ERROR: ecus 1-16, pids 1-64, latency 0-500 ms");
+    return;
+    }
+  uint8_t septime = MyPollers.m_poll_fc_septime;
+
+  writer->printf("Simulated ECUs: %d, PIDs/ECU: %d, latency: %d ms, septime: %u\n",
+                 ecus, pids, latency, septime);
+  writer->puts("Window  Cycle[ms]  Speedup  TX frames  Errors");
+
+  uint64_t serial = 0;
+  for (uint8_t window = 1; window <= VEHICLE_POLL_PIPELINE_MAX; window <<= 1)
+    {
+    uint32_t frames, errors;
+    uint64_t cycle = PipelineTestRun(window, ecus, pids, latency * 1000, septime, frames, errors);
+    if (window == 1)
+      serial = cycle;
+    writer->printf("%6u  %9.1f  %7.2f  %9" PRIu32 "  %6" PRIu32 "\n",
+                   window, cycle / 1000.0, cycle ? (float)serial / cycle : 0.0f, frames, errors);
+    if (errors)
+      writer->printf("ERROR: %" PRIu32 " responses lost or corrupted with window %u\n", errors, window);
+    }
+  }
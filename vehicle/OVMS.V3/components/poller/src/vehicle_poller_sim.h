@@ -0,0 +1,188 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __VEHICLE_POLLER_SIM_H__
+#define __VEHICLE_POLLER_SIM_H__
+
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include "can.h"
+#include "ovms_utils.h"
+#include "vehicle_common.h"
+
+#define POLLSIM_FRAMETIME       250       // CAN frame time [us] (500 kbit/s, 8 bytes)
+#define POLLSIM_TICKTIME        1000000   // Poll tick [us]
+
+/**
+ * PollerSimBus: simulated UDS ECUs for the poller benchmark commands
+ *  ECUs listen on 0x7n0 and respond on 0x7n8 (ISOTP_STD) after a fixed
+ *  latency. ReadDataByIdentifier (0x22) requests are answered by canned
+ *  data, multi DID requests only if m_multidid is set (else NRC 0x13).
+ *  Time is simulated: frames are queued with their reception time, the
+ *  test driver advances m_now by taking frames from the queue.
+ */
+class PollerSimBus
+  {
+  public:
+    typedef struct
+      {
+      std::string request;              // ISO-TP request received
+      uint16_t reqlen;                  // … expected length
+      std::string response;             // ISO-TP payload to send
+      uint16_t offset;                  // … sent so far
+      uint8_t frame;                    // … CF index
+      } ecu_t;
+
+    uint64_t m_now = 0;                 // Simulated time [us]
+    uint32_t m_latency = 0;             // ECU response latency [us]
+    bool m_multidid = true;             // ECUs support multi DID requests
+    uint32_t m_txframes = 0;            // Frames sent by the tester
+    uint32_t m_rxframes = 0;            // Frames sent by the ECUs
+    std::map<uint32_t, ecu_t> m_ecu;
+    std::multimap<uint64_t, CAN_frame_t> m_queue;
+
+  public:
+    /** Length: canned response data length for a DID */
+    static uint16_t Length(uint16_t did)
+      {
+      static const uint16_t sizes[] = { 4, 12, 30, 62 };
+      return sizes[did & 3];
+      }
+
+    /** Data: canned response data for a DID */
+    static std::string Data(uint32_t txid, uint16_t did)
+      {
+      std::string data;
+      int len = Length(did);
+      for (int i = 0; i < len; i++)
+        data.push_back((char)((txid >> 4) * 31 + did * 7 + i));
+      return data;
+      }
+
+    void Schedule(uint64_t time, uint32_t rxid, const uint8_t* data)
+      {
+      CAN_frame_t frame = {};
+      frame.FIR.B.DLC = 8;
+      frame.FIR.B.FF = CAN_frame_std;
+      frame.MsgID = rxid;
+      memcpy(frame.data.u8, data, 8);
+      m_queue.insert(std::make_pair(time, frame));
+      m_rxframes++;
+      }
+
+    void Transmit(CAN_frame_t* frame)
+      {
+      m_txframes++;
+      uint32_t txid = frame->MsgID;
+      uint32_t rxid = txid + 8;
+      ecu_t& ecu = m_ecu[txid];
+      uint8_t* d = frame->data.u8;
+      uint8_t out[8];
+
+      switch (d[0] >> 4)
+        {
+        case ISOTP_FT_SINGLE:
+          ecu.request.assign((const char*)&d[1], LIMIT_MAX(d[0] & 0x0f, 7));
+          Process(txid, ecu);
+          break;
+        case ISOTP_FT_FIRST:
+          ecu.reqlen = (d[0] & 0x0f) << 8 | d[1];
+          ecu.request.assign((const char*)&d[2], 6);
+          std::fill_n(out, 8, 0x55);
+          out[0] = ISOTP_FT_FLOWCTRL << 4;
+          out[1] = 0;
+          out[2] = 0;
+          Schedule(m_now + POLLSIM_FRAMETIME, rxid, out);
+          break;
+        case ISOTP_FT_CONSECUTIVE:
+          ecu.request.append((const char*)&d[1], LIMIT_MAX((int)(ecu.reqlen - ecu.request.size()), 7));
+          if (ecu.request.size() >= ecu.reqlen)
+            Process(txid, ecu);
+          break;
+        case ISOTP_FT_FLOWCTRL:
+          {
+          // Send all consecutive frames with the requested separation time:
+          uint32_t septime = (d[2] <= 127) ? d[2] * 1000 : (d[2] - 240) * 100;
+          uint64_t time = m_now + POLLSIM_FRAMETIME;
+          while (ecu.offset < ecu.response.size())
+            {
+            uint16_t len = LIMIT_MAX((uint16_t)(ecu.response.size() - ecu.offset), (uint16_t)7);
+            std::fill_n(out, 8, 0x55);
+            out[0] = (ISOTP_FT_CONSECUTIVE << 4) | (ecu.frame++ & 0x0f);
+            memcpy(&out[1], ecu.response.data() + ecu.offset, len);
+            ecu.offset += len;
+            Schedule(time, rxid, out);
+            time += std::max(septime, (uint32_t)POLLSIM_FRAMETIME);
+            }
+          break;
+          }
+        }
+      }
+
+  protected:
+    void Process(uint32_t txid, ecu_t& ecu)
+      {
+      const std::string& req = ecu.request;
+      int cnt = (req.size() - 1) / 2;
+      if (req.size() < 3 || req[0] != VEHICLE_POLL_TYPE_READDATA)
+        ecu.response = std::string("\x7f", 1) + req[0] + '\x11';
+      else if (cnt > 1 && !m_multidid)
+        ecu.response = std::string("\x7f\x22\x13", 3);
+      else
+        {
+        ecu.response = "\x62";
+        for (int i = 0; i < cnt; i++)
+          {
+          uint16_t did = (uint8_t)req[1+i*2] << 8 | (uint8_t)req[2+i*2];
+          ecu.response += req.substr(1+i*2, 2) + Data(txid, did);
+          }
+        }
+      Respond(txid + 8, ecu);
+      }
+
+    void Respond(uint32_t rxid, ecu_t& ecu)
+      {
+      uint8_t out[8];
+      std::fill_n(out, 8, 0x55);
+      uint16_t len = ecu.response.size();
+      if (len <= 7)
+        {
+        out[0] = len;
+        memcpy(&out[1], ecu.response.data(), len);
+        ecu.offset = len;
+        }
+      else
+        {
+        out[0] = (ISOTP_FT_FIRST << 4) | (len >> 8);
+        out[1] = len & 0xff;
+        memcpy(&out[2], ecu.response.data(), 6);
+        ecu.offset = 6;
+        ecu.frame = 1;
+        }
+      Schedule(m_now + m_latency, rxid, out);
+      }
+  };
+
+#endif //#ifndef __VEHICLE_POLLER_SIM_H__
@@ -32,6 +32,7 @@
 static const char *TAG = "re";
 
 #include <string.h>
+#include <algorithm>
 #include "retools.h"
 #include "dbc_app.h"
 #include "ovms.h"
@@ -39,6 +40,7 @@ static const char *TAG = "re";
 #include "ovms_events.h"
 #include "ovms_utils.h"
 #include "ovms_notify.h"
+#include "esp_timer.h"
 
 void re_stream_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
 
@@ -114,7 +116,7 @@ void re::Task()
 
   while(1)
     {
-    if (xQueueReceive(m_rxqueue, &message.frame, (portTickType)portMAX_DELAY)==pdTRUE)
+    if (m_rxreader->Read(&message.frame))
       {
       if (MyRE != NULL) // Protect against MyRE not set (during init)
         {
@@ -138,40 +140,146 @@ void re::Task()
     }
   }
 
+/**
+ * re_record_table
+ */
+
+static inline size_t re_hash(uint64_t key)
+  {
+  // 64 bit finalizer (MurmurHash3):
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return (size_t)key;
+  }
+
+re_record_table::re_record_table()
+  {
+  m_slots = NULL;
+  m_capacity = 0;
+  m_count = 0;
+  }
+
+re_record_table::~re_record_table()
+  {
+  Clear();
+  }
+
+re_record_t* re_record_table::Find(uint64_t key)
+  {
+  if (m_count == 0) return NULL;
+  size_t mask = m_capacity - 1;
+  for (size_t i = re_hash(key) & mask; m_slots[i].record != NULL; i = (i+1) & mask)
+    {
+    if (m_slots[i].key == key)
+      return m_slots[i].record;
+    }
+  return NULL;
+  }
+
+/**
+ * Insert: add a new zeroed record for key (key must not exist yet)
+ *  Returns NULL if out of memory.
+ */
+re_record_t* re_record_table::Insert(uint64_t key)
+  {
+  // keep load factor below 3/4:
+  if ((m_count+1) * 4 > m_capacity * 3)
+    {
+    if (!Resize(m_capacity ? m_capacity * 2 : RE_TABLE_MINSIZE))
+      return NULL;
+    }
+
+  // get record from pool:
+  size_t block = m_count / RE_POOL_BLOCKSIZE;
+  if (block == m_blocks.size())
+    {
+    re_record_t* b = (re_record_t*)ExternalRamCalloc(RE_POOL_BLOCKSIZE, sizeof(re_record_t));
+    if (!b) return NULL;
+    m_blocks.push_back(b);
+    }
+  re_record_t* r = at(m_count++);
+  memset(r, 0, sizeof(re_record_t));
+  r->key = key;
+
+  size_t mask = m_capacity - 1;
+  size_t i = re_hash(key) & mask;
+  while (m_slots[i].record != NULL)
+    i = (i+1) & mask;
+  m_slots[i].key = key;
+  m_slots[i].record = r;
+  return r;
+  }
+
+bool re_record_table::Resize(size_t capacity)
+  {
+  re_record_slot_t* slots = (re_record_slot_t*)ExternalRamCalloc(capacity, sizeof(re_record_slot_t));
+  if (!slots) return false;
+  size_t mask = capacity - 1;
+  for (size_t k = 0; k < m_count; k++)
+    {
+    re_record_t* r = at(k);
+    size_t i = re_hash(r->key) & mask;
+    while (slots[i].record != NULL)
+      i = (i+1) & mask;
+    slots[i].key = r->key;
+    slots[i].record = r;
+    }
+  if (m_slots) free(m_slots);
+  m_slots = slots;
+  m_capacity = capacity;
+  return true;
+  }
+
+void re_record_table::Clear()
+  {
+  for (re_record_t* b : m_blocks)
+    free(b);
+  m_blocks.clear();
+  if (m_slots) free(m_slots);
+  m_slots = NULL;
+  m_capacity = 0;
+  m_count = 0;
+  }
+
+
 void re::DoAnalyse(CAN_frame_t* frame)
   {
   char vbuf[256];
 
   OvmsRecMutexLock lock(&m_mutex);
-  std::string key = GetKey(frame);
-  auto k = m_rmap.find(key);
-  re_record_t* r;
+  uint64_t key = GetKey(frame);
+  re_record_t* r = m_rmap.Find(key);
   if (m_rmap.size() == 0) m_started = monotonictime;
-  if (k == m_rmap.end())
+  if (r == NULL)
     {
-    r = k->second;
-    r = new re_record_t;
-    memset(r,0,sizeof(re_record_t));
+    r = m_rmap.Insert(key);
+    if (r == NULL)
+      {
+      ESP_LOGE(TAG, "Out of memory, frame dropped");
+      return;
+      }
     r->attr.b.Changed = 1; // Mark the whole ID as changed
     r->attr.dc = 0xff;
-    switch (MyRE->m_mode)
+    switch (m_mode)
       {
       case Analyse:
         break;
       case Discover:
         r->attr.b.Discovered = 1;
         r->attr.dd = 0xff;
+        memcpy(&r->last,frame,sizeof(CAN_frame_t));
         HighlightDump(vbuf, (const char*)frame->data.u8, frame->FIR.B.DLC, r->attr.dc, r->attr.dd);
         ESP_LOGV(TAG, "Discovered new %s%s%s %s",
-          re_green[0][0], key.c_str(), re_green[0][1], vbuf);
+          re_green[0][0], GetKeyName(r).c_str(), re_green[0][1], vbuf);
         break;
       }
-    m_rmap[key] = r;
     }
   else
     {
-    r = k->second;
-    switch (MyRE->m_mode)
+    switch (m_mode)
       {
       case Analyse:
         for (int k=0;k<r->last.FIR.B.DLC;k++)
@@ -197,7 +305,7 @@ void re::DoAnalyse(CAN_frame_t* frame)
         if (found)
           {
           HighlightDump(vbuf, (const char*)frame->data.u8, frame->FIR.B.DLC, r->attr.dc, r->attr.dd);
-          ESP_LOGV(TAG, "Discovered change %s %s", k->first.c_str(), vbuf);
+          ESP_LOGV(TAG, "Discovered change %s %s", GetKeyName(r).c_str(), vbuf);
           }
         break;
         }
@@ -207,21 +315,10 @@ void re::DoAnalyse(CAN_frame_t* frame)
   r->rxcount++;
   }
 
-std::string re::GetKey(CAN_frame_t* frame)
+uint64_t re::GetKey(CAN_frame_t* frame)
   {
-  std::string key;
-  if (frame->origin != NULL)
-    key = std::string(frame->origin->GetName());
-  else
-    key = std::string("can?");
-  key.append("/");
-
-  char id[9];
-  if (frame->FIR.B.FF == CAN_frame_std)
-    sprintf(id,"%03" PRIx32,frame->MsgID);
-  else
-    sprintf(id,"%08" PRIx32,frame->MsgID);
-  key.append(id);
+  uint32_t bus = (frame->origin != NULL) ? ((frame->origin->m_busnumber + 1) & 0x0f) : 0;
+  bool ext = (frame->FIR.B.FF != CAN_frame_std);
 
   if (((m_obdii_std_min>0) &&
        (frame->FIR.B.FF == CAN_frame_std) &&
@@ -237,28 +334,16 @@ std::string re::GetKey(CAN_frame_t* frame)
     if (frame->data.u8[0] > 8)
       {
       // Probably just a continuation frame. Ignore it.
-      return key;
+      return RE_KEY(bus, RE_KEY_ID, ext, frame->MsgID, 0);
       }
     uint8_t mode = frame->data.u8[1];
-    char req[16];
-    if (mode > 0x4a)
-      {
-      sprintf(req,":O2Pm%d:%d",mode-0x40,((int)frame->data.u8[2]<<8)+frame->data.u8[3]);
-      }
-    else if (mode > 0x40)
-      {
-      sprintf(req,":O2Pm%d:%d",mode-0x40,(int)frame->data.u8[2]);
-      }
-    else if (mode > 0x0a)
-      {
-      sprintf(req,":O2Qm%d:%d",mode,((int)frame->data.u8[2]<<8)+frame->data.u8[3]);
-      }
+    uint32_t pid;
+    if (mode > 0x4a || (mode > 0x0a && mode <= 0x40))
+      pid = ((uint32_t)frame->data.u8[2]<<8) + frame->data.u8[3];
     else
-      {
-      sprintf(req,":O2Qm%d:%d",mode,(int)frame->data.u8[2]);
-      }
-    key.append(req);
-    return key;
+      pid = frame->data.u8[2];
+    return RE_KEY(bus, (mode > 0x40) ? RE_KEY_OBDII_RESPONSE : RE_KEY_OBDII_REQUEST,
+                  ext, frame->MsgID, ((uint32_t)mode << 16) | pid);
     }
 
   // Check for, and process, multiplexed signal
@@ -274,14 +359,66 @@ std::string re::GetKey(CAN_frame_t* frame)
         dbcSignal* s = m->GetMultiplexorSignal();
         dbcNumber muxn = s->Decode(frame->data.u8, 8);
         uint32_t mux = muxn.GetUnsignedInteger();
-        char b[8];
-        sprintf(b,":%04" PRIx32,mux);
-        key.append(b);
+        return RE_KEY(bus, RE_KEY_MUX, ext, frame->MsgID, mux);
         }
       }
     }
 
-  return key;
+  return RE_KEY(bus, RE_KEY_ID, ext, frame->MsgID, 0);
+  }
+
+/**
+ * GetKeyName: format record key for display, i.e. "can1/7e8:O2Pm1:12"
+ */
+std::string re::GetKeyName(re_record_t* r)
+  {
+  char buf[48];
+  const char* bus = (r->last.origin != NULL) ? r->last.origin->GetName() : "can?";
+  int len;
+  if (r->last.FIR.B.FF == CAN_frame_std)
+    len = snprintf(buf, sizeof(buf), "%s/%03" PRIx32, bus, r->last.MsgID);
+  else
+    len = snprintf(buf, sizeof(buf), "%s/%08" PRIx32, bus, r->last.MsgID);
+
+  uint32_t sub = RE_KEY_SUB(r->key);
+  uint32_t mode = sub >> 16, pid = sub & 0xffff;
+  switch (RE_KEY_TYPE(r->key))
+    {
+    case RE_KEY_OBDII_RESPONSE:
+      snprintf(buf+len, sizeof(buf)-len, ":O2Pm%d:%d", (int)mode-0x40, (int)pid);
+      break;
+    case RE_KEY_OBDII_REQUEST:
+      snprintf(buf+len, sizeof(buf)-len, ":O2Qm%d:%d", (int)mode, (int)pid);
+      break;
+    case RE_KEY_MUX:
+      snprintf(buf+len, sizeof(buf)-len, ":%04" PRIx32, sub);
+      break;
+    default:
+      break;
+    }
+  return std::string(buf);
+  }
+
+/**
+ * GetList: get records sorted by key name, optionally filtered by key name
+ *  substring and change/discover state. Key names are only generated here.
+ *  Note: caller needs to hold m_mutex while using the list.
+ */
+void re::GetList(re_record_list_t& list, const char* filter, re_list_select_t select)
+  {
+  list.clear();
+  for (size_t k = 0; k < m_rmap.size(); k++)
+    {
+    re_record_t* r = m_rmap.at(k);
+    if (select == RE_LIST_CHANGED && !r->attr.b.Changed && !r->attr.dc)
+      continue;
+    if (select == RE_LIST_DISCOVERED && !r->attr.b.Discovered && !r->attr.dd)
+      continue;
+    std::string name = GetKeyName(r);
+    if (filter == NULL || strstr(name.c_str(), filter) != NULL)
+      list.push_back(std::make_pair(name, r));
+    }
+  std::sort(list.begin(), list.end());
   }
 
 re::re(const char* name, canfilter* filter)
@@ -295,19 +432,17 @@ re::re(const char* name, canfilter* filter)
   m_started = monotonictime;
   m_finished = monotonictime;
   m_mode = Analyse;
-  m_rxqueue = xQueueCreate(20,sizeof(CAN_frame_t));
+  m_rxreader = new CanRingReader("re", true);
   xTaskCreatePinnedToCore(RE_task, "OVMS RE", 4096, (void*)this, 5, &m_task, CORE(1));
-  MyCan.RegisterListener(m_rxqueue, true);
   }
 
 re::~re()
   {
   OvmsRecMutexLock lock(&m_mutex);
-  MyCan.DeregisterListener(m_rxqueue);
+  vTaskDelete(m_task);
+  delete m_rxreader;
 
   Clear();
-  vQueueDelete(m_rxqueue);
-  vTaskDelete(m_task);
   if (m_filter)
     {
     delete m_filter;
@@ -335,11 +470,7 @@ void re::SetPowerMode(PowerMode powermode)
 
 void re::Clear()
   {
-  for (re_record_map_t::iterator it=m_rmap.begin(); it!=m_rmap.end(); ++it)
-    {
-    delete it->second;
-    }
-  m_rmap.clear();
+  m_rmap.Clear();
   m_started = monotonictime;
   m_finished = monotonictime;
   }
@@ -421,17 +552,16 @@ void re_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, cons
   if (tdiff == 0) tdiff = 1000;
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
+  re_record_list_t list;
+  MyRE->GetList(list, (argc>0) ? argv[0] : NULL);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
-    if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
-      {
-      char vbuf[48];
-      char *s = vbuf;
-      FormatHexDump(&s, (const char*)it->second->last.data.u8, it->second->last.FIR.B.DLC, 8);
-      writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
-        it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
-      }
+    char vbuf[48];
+    char *s = vbuf;
+    FormatHexDump(&s, (const char*)it->second->last.data.u8, it->second->last.FIR.B.DLC, 8);
+    writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
+      it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
     }
   }
 
@@ -448,22 +578,21 @@ void re_stream_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
   if (tdiff == 0) tdiff = 1000;
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
+  re_record_list_t list;
+  MyRE->GetList(list, (argc>0) ? argv[0] : NULL);
   writer->printf("[");
   int cnt = 0;
   char *ascii = NULL;
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
-    if (argc == 0 || strstr(it->first.c_str(),argv[0]) != NULL)
-      {
-      HighlightDump(vbuf, (const char*)it->second->last.data.u8,
-        it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd, 1, &ascii);
-      writer->printf("%s[\"%s\",%" PRId32 ",%" PRId32 ",\"%s\",\"%s\"]\n",
-        cnt ? "," : "",
-        json_encode(it->first).c_str(), it->second->rxcount, (tdiff/it->second->rxcount),
-        json_encode(std::string(vbuf)).c_str(),
-        json_encode(std::string(ascii)).c_str());
-      cnt++;
-      }
+    HighlightDump(vbuf, (const char*)it->second->last.data.u8,
+      it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd, 1, &ascii);
+    writer->printf("%s[\"%s\",%" PRId32 ",%" PRId32 ",\"%s\",\"%s\"]\n",
+      cnt ? "," : "",
+      json_encode(it->first).c_str(), it->second->rxcount, (tdiff/it->second->rxcount),
+      json_encode(std::string(vbuf)).c_str(),
+      json_encode(std::string(ascii)).c_str());
+    cnt++;
     }
   writer->puts("]");
   }
@@ -480,28 +609,27 @@ void re_dbc_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
   if (tdiff == 0) tdiff = 1000;
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
+  re_record_list_t list;
+  MyRE->GetList(list, (argc>0) ? argv[0] : NULL);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
-    if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
+    char vbuf[48];
+    char *s = vbuf;
+    FormatHexDump(&s, (const char*)it->second->last.data.u8, it->second->last.FIR.B.DLC, 8);
+    writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
+      it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
+    re_record_t *re_record = it->second;
+    if (re_record->last.origin)
       {
-      char vbuf[48];
-      char *s = vbuf;
-      FormatHexDump(&s, (const char*)it->second->last.data.u8, it->second->last.FIR.B.DLC, 8);
-      writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
-        it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
-      re_record_t *re_record = it->second;
-      if (re_record->last.origin)
+      dbcfile* dbc = re_record->last.origin->GetDBC();
+      if (dbc)
         {
-        dbcfile* dbc = re_record->last.origin->GetDBC();
-        if (dbc)
-          {
-          // We have a DBC attached.
-          dbc->DecodeSignal(
-              re_record->last.FIR.B.FF, re_record->last.MsgID,
-              re_record->last.data.u8, 8,
-              writer);
-          }
+        // We have a DBC attached.
+        dbc->DecodeSignal(
+            re_record->last.FIR.B.FF, re_record->last.MsgID,
+            re_record->last.data.u8, 8,
+            writer);
         }
       }
     }
@@ -539,9 +667,9 @@ void re_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, co
     int bchanged = 0;
     int ndiscovered = 0;
     int bdiscovered = 0;
-    for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+    for (size_t k=0; k<MyRE->m_rmap.size(); k++)
       {
-      re_record_t *r = it->second;
+      re_record_t *r = MyRE->m_rmap.at(k);
       if (r->attr.b.Ignore) nignored++;
       if (r->attr.b.Changed) nchanged++;
       if (r->attr.b.Discovered) ndiscovered++;
@@ -610,10 +738,11 @@ void re_mode_discover(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (size_t k=0; k<MyRE->m_rmap.size(); k++)
     {
-    it->second->attr.b.Discovered = 0;
-    it->second->attr.dd = 0;
+    re_record_t *r = MyRE->m_rmap.at(k);
+    r->attr.b.Discovered = 0;
+    r->attr.dd = 0;
     }
 
   MyRE->m_mode = Discover;
@@ -630,10 +759,11 @@ void re_clear_changed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int a
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (size_t k=0; k<MyRE->m_rmap.size(); k++)
     {
-    it->second->attr.b.Changed = 0;
-    it->second->attr.dc = 0;
+    re_record_t *r = MyRE->m_rmap.at(k);
+    r->attr.b.Changed = 0;
+    r->attr.dc = 0;
     }
 
   if (MyNotify.HasReader("stream", "retools.list"))
@@ -656,10 +786,11 @@ void re_clear_discovered(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, in
     }
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (size_t k=0; k<MyRE->m_rmap.size(); k++)
     {
-    it->second->attr.b.Discovered = 0;
-    it->second->attr.dd = 0;
+    re_record_t *r = MyRE->m_rmap.at(k);
+    r->attr.b.Discovered = 0;
+    r->attr.dd = 0;
     }
 
   if (MyNotify.HasReader("stream", "retools.list"))
@@ -686,19 +817,15 @@ void re_list_changed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int ar
   if (tdiff == 0) tdiff = 1000;
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
+  re_record_list_t list;
+  MyRE->GetList(list, (argc>0) ? argv[0] : NULL, RE_LIST_CHANGED);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
-    if ((it->second->attr.b.Changed)||(it->second->attr.dc))
-      {
-      HighlightDump(vbuf, (const char*)it->second->last.data.u8,
-        it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd);
-      if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
-        {
-        writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
-          it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
-        }
-      }
+    HighlightDump(vbuf, (const char*)it->second->last.data.u8,
+      it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd);
+    writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
+      it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
     }
   }
 
@@ -715,23 +842,21 @@ void re_stream_changed(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int
   if (tdiff == 0) tdiff = 1000;
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
+  re_record_list_t list;
+  MyRE->GetList(list, (argc>0) ? argv[0] : NULL, RE_LIST_CHANGED);
   writer->printf("[");
   int cnt = 0;
   char *ascii = NULL;
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
     {
-    if ((it->second->attr.b.Changed || it->second->attr.dc) &&
-        (argc == 0 || strstr(it->first.c_str(),argv[0]) != NULL))
-      {
-      HighlightDump(vbuf, (const char*)it->second->last.data.u8,
-        it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd, 1, &ascii);
-      writer->printf("%s[\"%s\",%" PRId32 ",%" PRId32 ",\"%s\",\"%s\"]\n",
-        cnt ? "," : "",
-        json_encode(it->first).c_str(), it->second->rxcount, (tdiff/it->second->rxcount),
-        json_encode(std::string(vbuf)).c_str(),
-        json_encode(std::string(ascii)).c_str());
-      cnt++;
-      }
+    HighlightDump(vbuf, (const char*)it->second->last.data.u8,
+      it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd, 1, &ascii);
+    writer->printf("%s[\"%s\",%" PRId32 ",%" PRId32 ",\"%s\",\"%s\"]\n",
+      cnt ? "," : "",
+      json_encode(it->first).c_str(), it->second->rxcount, (tdiff/it->second->rxcount),
+      json_encode(std::string(vbuf)).c_str(),
+      json_encode(std::string(ascii)).c_str());
+    cnt++;
     }
   writer->puts("]");
   }
@@ -749,20 +874,89 @@ void re_list_discovered(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int
   if (tdiff == 0) tdiff = 1000;
 
   OvmsRecMutexLock lock(&MyRE->m_mutex);
+  re_record_list_t list;
+  MyRE->GetList(list, (argc>0) ? argv[0] : NULL, RE_LIST_DISCOVERED);
   writer->printf("%-20.20s %10s %6s %s\n","key","records","ms","last");
-  for (re_record_map_t::iterator it=MyRE->m_rmap.begin(); it!=MyRE->m_rmap.end(); ++it)
+  for (re_record_list_t::iterator it=list.begin(); it!=list.end(); ++it)
+    {
+    HighlightDump(vbuf, (const char*)it->second->last.data.u8,
+      it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd);
+    writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
+      it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
+    }
+  }
+
+/**
+ * re_benchmark: replay synthetic frames through re::DoAnalyse
+ *  Runs on a private RE instance (RE tools must not be running), live
+ *  frames are discarded by the RE task meanwhile.
+ */
+void re_benchmark(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyRE)
     {
-    if ((it->second->attr.b.Discovered)||(it->second->attr.dd))
+    writer->puts("Error: RE tools running, stop them first");
+    return;
+    }
+  int frames = (argc > 0) ? atoi(argv[0]) : 100000;
+  int ids = (argc > 1) ? atoi(argv[1]) : 200;
+  if (frames < 1) frames = 1;
+  if (ids < 1) ids = 1;
+
+  // Frame set: standard & extended IDs, plus OBDII responses with 32 PIDs:
+  canbus* bus = (canbus*)MyPcpApp.FindDeviceByName("can1");
+  int nframes = ids + 32;
+  CAN_frame_t* set = new CAN_frame_t[nframes];
+  memset(set, 0, sizeof(CAN_frame_t) * nframes);
+  for (int i = 0; i < nframes; i++)
+    {
+    CAN_frame_t& f = set[i];
+    f.origin = bus;
+    f.FIR.B.DLC = 8;
+    if (i < ids)
       {
-      HighlightDump(vbuf, (const char*)it->second->last.data.u8,
-        it->second->last.FIR.B.DLC, it->second->attr.dc, it->second->attr.dd);
-      if ((argc==0)||(strstr(it->first.c_str(),argv[0])))
-        {
-        writer->printf("%-20s %10" PRId32 " %6" PRId32 " %s\n",
-          it->first.c_str(),it->second->rxcount,(tdiff/it->second->rxcount),vbuf);
-        }
+      f.FIR.B.FF = (i % 4 == 3) ? CAN_frame_ext : CAN_frame_std;
+      f.MsgID = (f.FIR.B.FF == CAN_frame_ext) ? 0x18daf100 + i : 0x100 + i;
+      }
+    else
+      {
+      f.FIR.B.FF = CAN_frame_std;
+      f.MsgID = 0x7e8;
+      f.data.u8[0] = 0x05;
+      f.data.u8[1] = 0x62;
+      f.data.u8[2] = 0xf4;
+      f.data.u8[3] = i - ids;
       }
     }
+
+  re* bench = new re("re");
+  bench->m_obdii_std_min = 0x7e0;
+  bench->m_obdii_std_max = 0x7ef;
+
+  int64_t started = esp_timer_get_time();
+  for (int n = 0; n < frames; n++)
+    {
+    CAN_frame_t& f = set[n % nframes];
+    f.data.u8[7] = n >> 8;   // some changing payload
+    bench->DoAnalyse(&f);
+    }
+  int64_t elapsed = esp_timer_get_time() - started;
+
+  re_record_list_t list;
+  started = esp_timer_get_time();
+  bench->GetList(list);
+  int64_t elapsed_list = esp_timer_get_time() - started;
+  size_t keys = bench->m_rmap.size();
+
+  delete bench;
+  delete [] set;
+
+  if (elapsed < 1) elapsed = 1;
+  writer->printf("Analysed %d frames on %u keys in %lld us: %lld frames/s\n",
+    frames, (unsigned)keys, elapsed, (int64_t)frames * 1000000 / elapsed);
+  writer->printf("Listing %u keys took %lld us\n", (unsigned)list.size(), elapsed_list);
+  if (keys != nframes)
+    writer->printf("ERROR: expected %d keys\n", nframes);
   }
 
 class REInit
@@ -803,6 +997,7 @@ REInit::REInit()
   cmd_re->RegisterCommand("clear","Clear RE records",re_clear);
   cmd_re->RegisterCommand("list","List RE records",re_list, "", 0, 1);
   cmd_re->RegisterCommand("status","Show RE status",re_status);
+  cmd_re->RegisterCommand("benchmark","Benchmark RE frame analysis",re_benchmark, "[<frames>] [<ids>]", 0, 2);
 
   OvmsCommand* cmd_dbc = cmd_re->RegisterCommand("dbc","RE DBC framework");
   cmd_dbc->RegisterCommand("list","List RE DBC records",re_dbc_list, "", 0, 1);
@@ -35,8 +35,9 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include <string>
-#include <map>
+#include <vector>
 #include "can.h"
+#include "can_ring.h"
 #include "canformat.h"
 #include "dbc.h"
 #include "pcp.h"
@@ -46,6 +47,7 @@
 
 typedef struct
   {
+  uint64_t key;
   CAN_frame_t last;
   uint32_t rxcount;
   struct __attribute__((__packed__))
@@ -66,7 +68,65 @@ typedef struct
     } attr;
   } re_record_t;
 
-typedef std::map<std::string, re_record_t*> re_record_map_t;
+/**
+ * RE record keys are packed into 64 bits:
+ *  63-60   bus number + 1 (0 = no origin)
+ *  59-58   key type (re_key_type_t)
+ *  57      extended ID
+ *  56-28   CAN ID
+ *  27-0    OBDII request: mode << 16 | PID, multiplexed: multiplexor value
+ */
+enum re_key_type_t { RE_KEY_ID = 0, RE_KEY_OBDII_RESPONSE, RE_KEY_OBDII_REQUEST, RE_KEY_MUX };
+
+#define RE_KEY(bus,type,ext,id,sub)     (((uint64_t)(bus) << 60) | ((uint64_t)(type) << 58) | \
+                                         ((uint64_t)(ext) << 57) | ((uint64_t)((id) & 0x1fffffff) << 28) | \
+                                         ((sub) & 0x0fffffff))
+#define RE_KEY_TYPE(key)                ((re_key_type_t)(((key) >> 58) & 3))
+#define RE_KEY_SUB(key)                 ((uint32_t)((key) & 0x0fffffff))
+
+#define RE_POOL_BLOCKSIZE               64        // Records per pool block
+#define RE_TABLE_MINSIZE                256       // Initial hash table size (power of 2)
+
+typedef struct
+  {
+  uint64_t key;
+  re_record_t* record;                          // NULL = free slot
+  } re_record_slot_t;
+
+/**
+ * re_record_table: open addressing hash table of RE records
+ *  Records are allocated from a pool of blocks and stay in place until
+ *  Clear(), so record pointers are stable and the records can be
+ *  iterated in insertion order by index.
+ */
+class re_record_table
+  {
+  public:
+    re_record_table();
+    ~re_record_table();
+
+  public:
+    re_record_t* Find(uint64_t key);
+    re_record_t* Insert(uint64_t key);
+    void Clear();
+    size_t size() { return m_count; }
+    re_record_t* at(size_t index)
+      {
+      return &m_blocks[index / RE_POOL_BLOCKSIZE][index % RE_POOL_BLOCKSIZE];
+      }
+
+  protected:
+    bool Resize(size_t capacity);
+
+  protected:
+    re_record_slot_t* m_slots;                  // Hash slots, linear probing
+    size_t m_capacity;                          // Slot count (power of 2)
+    size_t m_count;                             // Records in use
+    std::vector<re_record_t*> m_blocks;         // Record pool
+  };
+
+typedef std::vector< std::pair<std::string, re_record_t*> > re_record_list_t;
+enum re_list_select_t { RE_LIST_ALL, RE_LIST_CHANGED, RE_LIST_DISCOVERED };
 
 enum REMode { Analyse, Discover };
 
@@ -82,20 +142,20 @@ class re : public pcp, public ExternalRamAllocated
   public:
     void Task();
     void Clear();
-    std::string GetKey(CAN_frame_t* frame);
-
-  protected:
+    uint64_t GetKey(CAN_frame_t* frame);
+    std::string GetKeyName(re_record_t* r);
+    void GetList(re_record_list_t& list, const char* filter = NULL, re_list_select_t select = RE_LIST_ALL);
     void DoAnalyse(CAN_frame_t* frame);
 
   protected:
     TaskHandle_t m_task;
-    QueueHandle_t m_rxqueue;
+    CanRingReader* m_rxreader;
 
   public:
     OvmsRecMutex m_mutex;
     canfilter* m_filter;
     REMode m_mode;
-    re_record_map_t m_rmap;
+    re_record_table m_rmap;
     uint32_t m_obdii_std_min;
     uint32_t m_obdii_std_max;
     uint32_t m_obdii_ext_min;
@@ -303,15 +303,14 @@ OvmsReToolsPidScanner::OvmsReToolsPidScanner(
     m_lastResponseTime(0u),
     m_mfRemain(0u),
     m_task(nullptr),
-    m_rxqueue(nullptr),
+    m_rxreader(nullptr),
     m_found(),
     m_foundMutex()
 {
-    m_rxqueue = xQueueCreate(20,sizeof(CAN_frame_t));
+    m_rxreader = new CanRingReader("re-pidscan", true);
     xTaskCreatePinnedToCore(
         &OvmsReToolsPidScanner::Task, "OVMS RE PID", 4096, this, 5, &m_task, CORE(1)
     );
-    MyCan.RegisterListener(m_rxqueue, true);
     m_currentPid = m_startPid - m_pidStep;
     MyEvents.RegisterEvent(
         TAG, "ticker.1",
@@ -327,12 +326,11 @@ OvmsReToolsPidScanner::OvmsReToolsPidScanner(
 
 OvmsReToolsPidScanner::~OvmsReToolsPidScanner()
 {
-    if (m_rxqueue)
+    if (m_rxreader)
     {
         MyEvents.DeregisterEvent(TAG);
-        MyCan.DeregisterListener(m_rxqueue);
-        vQueueDelete(m_rxqueue);
         vTaskDelete(m_task);
+        delete m_rxreader;
         MyEvents.SignalEvent("retools.pidscan.stop", NULL);
     }
 }
@@ -381,9 +379,7 @@ void OvmsReToolsPidScanner::Task()
     CAN_frame_t frame;
     while (1)
     {
-        if (xQueueReceive(
-                    m_rxqueue, &frame, static_cast<portTickType>(portMAX_DELAY)
-                ) == pdTRUE)
+        if (m_rxreader->Read(&frame))
         {
             if (frame.origin == m_bus)
             {
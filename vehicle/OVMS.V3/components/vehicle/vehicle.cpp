@@ -50,6 +50,7 @@ static const char *CHECK_SHUTDOWN_TAG = "vehicle-shutdown";
 #include <ovms_boot.h>
 #include <string_writer.h>
 #include "vehicle.h"
+#include "can_ring.h"
 
 #ifdef bind
 #undef bind
@@ -110,6 +111,10 @@ OvmsVehicleFactory::OvmsVehicleFactory()
   cmd_bms->RegisterCommand("volt","Show BMS voltage status",bms_status);
   cmd_bms->RegisterCommand("reset","Reset BMS statistics",bms_reset);
   cmd_bms->RegisterCommand("alerts","Show BMS alerts",bms_alerts);
+  OvmsCommand* cmd_bmshist = cmd_bms->RegisterCommand("history","BMS cell history",bms_history_status, "", 0, 0, false);
+  cmd_bmshist->RegisterCommand("status","Show BMS history status",bms_history_status);
+  cmd_bmshist->RegisterCommand("export","Export BMS history to file",bms_history_export, "<path>", 1, 1);
+  cmd_bmshist->RegisterCommand("clear","Clear BMS history",bms_history_clear);
 
   OvmsCommand* cmd_obdii = MyCommandApp.RegisterCommand("obdii", "OBDII framework");
   for (int k=1; k <= 4; k++)
@@ -321,6 +326,16 @@ const char* OvmsVehicleFactory::ActiveVehicleShortName()
   }
 
 OvmsVehicle::OvmsVehicle()
+  : m_bms_cfg_vmaxgrad("vehicle", "bms.dev.voltage.maxgrad", BMS_DEFTHR_VMAXGRAD),
+    m_bms_cfg_vmaxsddev("vehicle", "bms.dev.voltage.maxsddev", BMS_DEFTHR_VMAXSDDEV),
+    m_bms_cfg_vwarn("vehicle", "bms.dev.voltage.warn", BMS_DEFTHR_VWARN),
+    m_bms_cfg_valert("vehicle", "bms.dev.voltage.alert", BMS_DEFTHR_VALERT),
+    m_bms_cfg_twarn("vehicle", "bms.dev.temp.warn", BMS_DEFTHR_TWARN),
+    m_bms_cfg_talert("vehicle", "bms.dev.temp.alert", BMS_DEFTHR_TALERT),
+    m_bms_cfg_vlog_interval("vehicle", "bms.log.voltage.interval", 0),
+    m_bms_cfg_tlog_interval("vehicle", "bms.log.temp.interval", 0),
+    m_bms_cfg_hist_interval("vehicle", "bms.history.interval", 0),
+    m_bms_cfg_hist_size("vehicle", "bms.history.size", 128)
   {
 
   m_is_shutdown = false;
@@ -368,6 +383,8 @@ OvmsVehicle::OvmsVehicle()
   PollSetResponseSeparationTime(25);
   // channel keepalive default: 60 seconds
   PollSetChannelKeepalive(60);
+  // no pipelining
+  PollSetPipelineWindow(1);
 #endif
 
   m_bms_voltages = NULL;
@@ -411,6 +428,7 @@ OvmsVehicle::OvmsVehicle()
 
   m_bms_vlog_last = 0;
   m_bms_tlog_last = 0;
+  m_bms_hist_last = 0;
 
   m_minsoc = 0;
   m_minsoc_triggered = 0;
@@ -452,10 +470,9 @@ OvmsVehicle::OvmsVehicle()
   MyPollers.RegisterFrameRx(TAG, std::bind(&OvmsVehicle::IncomingRxFrame, this, _1));
 #else
 
-  m_vqueue = xQueueCreate(CONFIG_OVMS_VEHICLE_CAN_RX_QUEUE_SIZE,sizeof(CAN_frame_t));
+  m_vreader = new CanRingReader("vehicle");
   xTaskCreatePinnedToCore(OvmsVehicleTask, "OVMS Vehicle Poll",
       CONFIG_OVMS_VEHICLE_RXTASK_STACK, (void*)this, 10, &m_vtask, CORE(1));
-  MyCan.RegisterListener(m_vqueue);
   for (int idx = 0; idx < VEHICLE_MAXBUSSES; ++idx)
     m_autopoweroff[idx] = false;
 #endif
@@ -468,8 +485,8 @@ OvmsVehicle::~OvmsVehicle()
   if (vtask)
     vTaskDelete(vtask);
 
-  vQueueDelete(m_vqueue);
-  m_vqueue = nullptr;
+  delete m_vreader;
+  m_vreader = nullptr;
 #endif
 
   if (m_bms_voltages != NULL)
@@ -548,12 +565,7 @@ void OvmsVehicle::ShuttingDown()
   if (m_pollsignal)
     delete m_pollsignal;
 #else
-  MyCan.DeregisterListener(m_vqueue);
-  CAN_frame_t entry;
-  entry.origin = nullptr;
-  entry.callback = nullptr;
-  entry.MsgID = 0;
-  xQueueSendToFront(m_vqueue, &entry, 0);
+  m_vreader->Wakeup();
 
   if (MyConfig.GetParamValueBool("vehicle", "can.autooff", true))
     {
@@ -572,7 +584,7 @@ bool OvmsVehicle::IsShutdown()
   if (!m_is_shutdown)
     return false;
 #ifndef CONFIG_OVMS_COMP_POLLER
-  if (Atomic_Get(m_vqueue) != nullptr) {
+  if (Atomic_Get(m_vreader) != nullptr) {
     return false;
   }
 #endif
@@ -2632,6 +2644,10 @@ void OvmsVehicle::PollSetTimeBetweenSuccess(uint16_t time_between_ms)
   {
   MyPollers.PollSetTimeBetweenSuccess(time_between_ms);
   }
+void OvmsVehicle::PollSetPipelineWindow(uint8_t window)
+  {
+  MyPollers.PollSetPipelineWindow(window);
+  }
 
 /**
  * IncomingPollReply: poll response handler (stub, override with vehicle implementation)
@@ -2702,9 +2718,7 @@ void OvmsVehicle::VehicleTask()
   CAN_frame_t entry;
   while (!m_is_shutdown)
     {
-    if (xQueueReceive(m_vqueue, &entry, (portTickType)portMAX_DELAY)!=pdTRUE)
-      continue;
-    if (entry.origin != nullptr )
+    if (m_vreader->Read(&entry))
       SendIncomingFrame(&entry);
     }
   auto vtask = Atomic_GetAndNull(m_vtask);
@@ -2720,6 +2734,7 @@ void OvmsVehicle::SendIncomingFrame(const CAN_frame_t *frame)
     return;
 
   auto bus = frame->origin;
+  bus->m_latency_vehicle.Add(frame);
 
   // Pass frame to standard handlers:
   CAN_frame_t tmp_frame = *frame;
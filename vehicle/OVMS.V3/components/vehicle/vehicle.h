@@ -44,12 +44,15 @@
 #include "ovms_mutex.h"
 #include "ovms_semaphore.h"
 #include "vehicle_common.h"
+#include "vehicle_bmsstats.h"
+#include "vehicle_bmshistory.h"
 #ifdef CONFIG_OVMS_COMP_POLLER
 #include "vehicle_poller.h"
 #endif
 
 using namespace std;
 struct DashboardConfig;
+class CanRingReader;
 
 
 // OBD2/UDS Polling types supported:
@@ -293,6 +296,7 @@ class OvmsVehicle : public InternalRamAllocated
     void PollSetResponseSeparationTime(uint8_t septime);
     void PollSetChannelKeepalive(uint16_t keepalive_seconds);
     void PollSetTimeBetweenSuccess(uint16_t tick_between_ms);
+    void PollSetPipelineWindow(uint8_t window);
 #endif
 
     uint8_t GetBusNo(canbus* bus);
@@ -583,7 +587,7 @@ class OvmsVehicle : public InternalRamAllocated
     // These are required in lieu of using the OvmsPoller queue.
     static void OvmsVehicleTask(void *pvParameters);
     void VehicleTask();
-    QueueHandle_t m_vqueue;
+    CanRingReader* m_vreader;
     TaskHandle_t  m_vtask;
 
     bool m_autopoweroff[VEHICLE_MAXBUSSES];
@@ -601,6 +605,7 @@ class OvmsVehicle : public InternalRamAllocated
     int m_bms_vstddev_cnt;                    // BMS internal stddev counter
     float m_bms_vstddev_avg;                  // BMS internal stddev average
     bool m_bms_has_voltages;                  // True if BMS has a complete set of voltage values
+    BmsCellStats m_bms_vstats;                // BMS voltage series statistics
     float* m_bms_temperatures;                // BMS temperatures (celcius current value)
     float* m_bms_tmins;                       // BMS minimum temperatures seen (since reset)
     float* m_bms_tmaxs;                       // BMS maximum temperatures seen (since reset)
@@ -608,6 +613,7 @@ class OvmsVehicle : public InternalRamAllocated
     OvmsStatus* m_bms_talerts;                // BMS temperature deviation alerts (since reset)
     int m_bms_talerts_new;                    // BMS new temperature alerts since last notification
     bool m_bms_has_temperatures;              // True if BMS has a complete set of temperature values
+    BmsCellStats m_bms_tstats;                // BMS temperature series statistics
     std::vector<bool> m_bms_bitset_v;         // BMS tracking: true if corresponding voltage set
     std::vector<bool> m_bms_bitset_t;         // BMS tracking: true if corresponding temperature set
     int m_bms_bitset_cv;                      // BMS tracking: count of unique voltage values set
@@ -626,8 +632,20 @@ class OvmsVehicle : public InternalRamAllocated
     float m_bms_defthr_valert;                // Default voltage deviation alert threshold [V]
     float m_bms_defthr_twarn;                 // Default temperature deviation warn threshold [°C]
     float m_bms_defthr_talert;                // Default temperature deviation alert threshold [°C]
+    ConfigHandle<float> m_bms_cfg_vmaxgrad;   // Config: voltage deviation max valid gradient [V]
+    ConfigHandle<float> m_bms_cfg_vmaxsddev;  // Config: voltage deviation max valid stddev deviation [V]
+    ConfigHandle<float> m_bms_cfg_vwarn;      // Config: voltage deviation warn threshold [V]
+    ConfigHandle<float> m_bms_cfg_valert;     // Config: voltage deviation alert threshold [V]
+    ConfigHandle<float> m_bms_cfg_twarn;      // Config: temperature deviation warn threshold [°C]
+    ConfigHandle<float> m_bms_cfg_talert;     // Config: temperature deviation alert threshold [°C]
+    ConfigHandle<int> m_bms_cfg_vlog_interval; // Config: voltage log interval [s]
+    ConfigHandle<int> m_bms_cfg_tlog_interval; // Config: temperature log interval [s]
     uint32_t m_bms_vlog_last;                 // Last log time for voltages
     uint32_t m_bms_tlog_last;                 // Last log time for temperatures
+    BmsHistory m_bms_history;                 // BMS cell snapshot history (PSRAM)
+    ConfigHandle<int> m_bms_cfg_hist_interval; // Config: history record interval [s]
+    ConfigHandle<int> m_bms_cfg_hist_size;    // Config: history buffer size [kB]
+    uint32_t m_bms_hist_last;                 // Last history record time
 
   protected:
     void BmsSetCellArrangementVoltage(int readings, int readingspermodule);
@@ -651,6 +669,7 @@ class OvmsVehicle : public InternalRamAllocated
     void BmsGetCellDefaultThresholdsVoltage(float* warn, float* alert, float* maxgrad=NULL, float* maxsddev=NULL);
     void BmsGetCellDefaultThresholdsTemperature(float* warn, float* alert);
     void BmsResetCellStats();
+    BmsHistory* BmsGetHistory() { return &m_bms_history; }
     virtual void BmsStatus(int verbosity, OvmsWriter* writer, vehicle_bms_status_t statusmode);
     virtual bool FormatBmsAlerts(int verbosity, OvmsWriter* writer, bool show_warnings);
     bool BmsCheckChangeCellArrangementVoltage(int readings, int readingspermodule = 0);
@@ -746,6 +765,9 @@ class OvmsVehicleFactory
     static void bms_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void bms_reset(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void bms_alerts(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void bms_history_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void bms_history_export(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
+    static void bms_history_clear(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
     static void obdii_request(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv);
 
     void EventSystemShuttingDown(std::string event, void* data);
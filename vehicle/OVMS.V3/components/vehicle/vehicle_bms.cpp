@@ -32,6 +32,7 @@
 static const char *TAG = "vehicle";
 
 #include <stdio.h>
+#include <time.h>
 #include <algorithm>
 #include <ovms_command.h>
 #include <ovms_script.h>
@@ -48,6 +49,12 @@ static const char *TAG = "vehicle";
 // Voltage stddev running average sample count:
 #define VSTDDEV_SMOOTHCNT         5
 
+// Round to 5 (voltages) / 2 (temperatures) decimals in float:
+static inline float roundprec_f(float value, float scale)
+  {
+  return roundf(value * scale) / scale;
+  }
+
 
 void OvmsVehicle::BmsSetCellArrangementVoltage(int readings, int readingspermodule)
   {
@@ -68,6 +75,7 @@ void OvmsVehicle::BmsSetCellArrangementVoltage(int readings, int readingspermodu
 
   m_bms_readings_v = readings;
   m_bms_readingspermodule_v = readingspermodule;
+  m_bms_vstats.SetCount(readings);
 
   BmsResetCellVoltages(true);
   }
@@ -214,6 +222,7 @@ void OvmsVehicle::BmsSetCellArrangementTemperature(int readings, int readingsper
 
   m_bms_readings_t = readings;
   m_bms_readingspermodule_t = readingspermodule;
+  m_bms_tstats.SetCount(readings);
 
   BmsResetCellTemperatures(true);
   }
@@ -239,6 +248,10 @@ void OvmsVehicle::BmsSetCellDefaultThresholdsVoltage(float warn, float alert,
   m_bms_defthr_valert = alert;
   m_bms_defthr_vmaxgrad = (maxgrad < 0) ? BMS_DEFTHR_VMAXGRAD : maxgrad;
   m_bms_defthr_vmaxsddev = (maxsddev < 0) ? BMS_DEFTHR_VMAXSDDEV : maxsddev;
+  m_bms_cfg_vwarn.SetDefault(m_bms_defthr_vwarn);
+  m_bms_cfg_valert.SetDefault(m_bms_defthr_valert);
+  m_bms_cfg_vmaxgrad.SetDefault(m_bms_defthr_vmaxgrad);
+  m_bms_cfg_vmaxsddev.SetDefault(m_bms_defthr_vmaxsddev);
   }
 
 void OvmsVehicle::BmsGetCellDefaultThresholdsVoltage(float* warn, float* alert,
@@ -254,6 +267,8 @@ void OvmsVehicle::BmsSetCellDefaultThresholdsTemperature(float warn, float alert
   {
   m_bms_defthr_twarn = warn;
   m_bms_defthr_talert = alert;
+  m_bms_cfg_twarn.SetDefault(warn);
+  m_bms_cfg_talert.SetDefault(alert);
   }
 
 void OvmsVehicle::BmsGetCellDefaultThresholdsTemperature(float* warn, float* alert)
@@ -291,38 +306,33 @@ void OvmsVehicle::BmsSetCellVoltage(int index, float value)
   else if (m_bms_vmaxs[index] < value)
     m_bms_vmaxs[index] = value;
 
-  if (m_bms_bitset_v[index] == false) m_bms_bitset_cv++;
+  // Update the series statistics incrementally; a repeated reading within
+  // the series invalidates them, a full pass is done on completion then:
+  if (m_bms_bitset_v[index] == false)
+    {
+    m_bms_bitset_cv++;
+    m_bms_vstats.Add(index, value);
+    }
+  else
+    {
+    m_bms_vstats.Invalidate();
+    }
   if (m_bms_bitset_cv == m_bms_readings_v)
     {
     // Series complete, all cell voltages acquired
-    float thr_maxgrad  = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.maxgrad",  m_bms_defthr_vmaxgrad);
-    float thr_maxsddev = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.maxsddev", m_bms_defthr_vmaxsddev);
-    float thr_warn     = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.warn",     m_bms_defthr_vwarn);
-    float thr_alert    = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.alert",    m_bms_defthr_valert);
-
-    // Get min, max, avg & standard deviation:
-    double sum=0, sqrsum=0, avg, stddev=0;
-    float min=0, max=0;
-    for (int i=0; i<m_bms_readings_v; i++)
-      {
-      sum += m_bms_voltages[i];
-      sqrsum += SQR(m_bms_voltages[i]);
-      if (min==0 || m_bms_voltages[i]<min)
-        min = m_bms_voltages[i];
-      if (max==0 || m_bms_voltages[i]>max)
-        max = m_bms_voltages[i];
-      }
-    avg = sum / m_bms_readings_v;
-    stddev = sqrt(LIMIT_MIN((sqrsum / m_bms_readings_v) - SQR(avg), 0));
-
-    // Get gradient:
-    double sumn = 0, sumd = 0;
-    for (int i=0; i<m_bms_readings_v; i++)
-      {
-      sumn += (i - (m_bms_readings_v / 2 - 0.5)) * (m_bms_voltages[i] - avg);
-      sumd += SQR(i - (m_bms_readings_v / 2 - 0.5));
-      }
-    float grad = (sumn / sumd) * m_bms_readings_v;
+    float thr_maxgrad  = m_bms_cfg_vmaxgrad.Get();
+    float thr_maxsddev = m_bms_cfg_vmaxsddev.Get();
+    float thr_warn     = m_bms_cfg_vwarn.Get();
+    float thr_alert    = m_bms_cfg_valert.Get();
+
+    // Get min, max, avg, standard deviation & gradient:
+    if (!m_bms_vstats.IsComplete())
+      m_bms_vstats.Compute(m_bms_voltages);
+    float min = m_bms_vstats.Min();
+    float max = m_bms_vstats.Max();
+    float avg = m_bms_vstats.Mean();
+    float stddev = m_bms_vstats.StdDev();
+    float grad = m_bms_vstats.Gradient();
 
     // …publish to metrics:
     StandardMetrics.ms_v_bat_pack_vmin->SetValue(min);
@@ -362,18 +372,19 @@ void OvmsVehicle::BmsSetCellVoltage(int index, float value)
     // Check cell deviations only if the series appears to be consistent:
     if (series_valid)
       {
-      float dev;
+      float lim_warn = stddev + thr_warn, lim_alert = stddev + thr_alert;
       for (int i=0; i<m_bms_readings_v; i++)
         {
-        dev = ROUNDPREC(m_bms_voltages[i] - avg, 5);
-        if (ABS(dev) > ABS(m_bms_vdevmaxs[i]))
+        float dev = roundprec_f(m_bms_voltages[i] - avg, 1e5f);
+        float absdev = fabsf(dev);
+        if (absdev > fabsf(m_bms_vdevmaxs[i]))
           m_bms_vdevmaxs[i] = dev;
-        if (ABS(dev) >= stddev + thr_alert && m_bms_valerts[i] <= OvmsStatus::Warn)
+        if (absdev >= lim_alert && m_bms_valerts[i] <= OvmsStatus::Warn)
           {
           m_bms_valerts[i] = OvmsStatus::Alert;
           m_bms_valerts_new++; // trigger notification
           }
-        else if (ABS(dev) >= stddev + thr_warn && m_bms_valerts[i] < OvmsStatus::Warn)
+        else if (absdev >= lim_warn && m_bms_valerts[i] < OvmsStatus::Warn)
           m_bms_valerts[i] = OvmsStatus::Warn;
         }
 
@@ -389,6 +400,7 @@ void OvmsVehicle::BmsSetCellVoltage(int index, float value)
     m_bms_bitset_v.clear();
     m_bms_bitset_v.resize(m_bms_readings_v);
     m_bms_bitset_cv = 0;
+    m_bms_vstats.Reset();
     }
   else
     {
@@ -413,47 +425,49 @@ void OvmsVehicle::BmsSetCellTemperature(int index, float value)
   else if (m_bms_tmaxs[index] < value)
     m_bms_tmaxs[index] = value;
 
-  if (m_bms_bitset_t[index] == false) m_bms_bitset_ct++;
+  if (m_bms_bitset_t[index] == false)
+    {
+    m_bms_bitset_ct++;
+    m_bms_tstats.Add(index, value);
+    }
+  else
+    {
+    m_bms_tstats.Invalidate();
+    }
   if (m_bms_bitset_ct == m_bms_readings_t)
     {
     // Series complete, all cell temperatures acquired
-    float thr_warn  = MyConfig.GetParamValueFloat("vehicle", "bms.dev.temp.warn", m_bms_defthr_twarn);
-    float thr_alert = MyConfig.GetParamValueFloat("vehicle", "bms.dev.temp.alert", m_bms_defthr_talert);
+    float thr_warn  = m_bms_cfg_twarn.Get();
+    float thr_alert = m_bms_cfg_talert.Get();
 
     // get min, max, avg & standard deviation:
-    double sum=0, sqrsum=0, avg, stddev=0;
-    float min=0, max=0;
-    for (int i=0; i<m_bms_readings_t; i++)
-      {
-      sum += m_bms_temperatures[i];
-      sqrsum += SQR(m_bms_temperatures[i]);
-      if (min==0 || m_bms_temperatures[i]<min)
-        min = m_bms_temperatures[i];
-      if (max==0 || m_bms_temperatures[i]>max)
-        max = m_bms_temperatures[i];
-      }
-    avg = sum / m_bms_readings_t;
-    stddev = sqrt(LIMIT_MIN((sqrsum / m_bms_readings_t) - SQR(avg), 0));
+    if (!m_bms_tstats.IsComplete())
+      m_bms_tstats.Compute(m_bms_temperatures);
+    float min = m_bms_tstats.Min();
+    float max = m_bms_tstats.Max();
+    float avg = m_bms_tstats.Mean();
+    float stddev = m_bms_tstats.StdDev();
 
     // check cell deviations:
-    float dev;
+    float lim_warn = stddev + thr_warn, lim_alert = stddev + thr_alert;
     for (int i=0; i<m_bms_readings_t; i++)
       {
-      dev = ROUNDPREC(m_bms_temperatures[i] - avg, 2);
-      if (ABS(dev) > ABS(m_bms_tdevmaxs[i]))
+      float dev = roundprec_f(m_bms_temperatures[i] - avg, 1e2f);
+      float absdev = fabsf(dev);
+      if (absdev > fabsf(m_bms_tdevmaxs[i]))
         m_bms_tdevmaxs[i] = dev;
-      if (ABS(dev) >= stddev + thr_alert && m_bms_talerts[i] < OvmsStatus::Alert)
+      if (absdev >= lim_alert && m_bms_talerts[i] < OvmsStatus::Alert)
         {
         m_bms_talerts[i] = OvmsStatus::Alert;
         m_bms_talerts_new++; // trigger notification
         }
-      else if (ABS(dev) >= stddev + thr_warn && m_bms_valerts[i] < OvmsStatus::Warn)
+      else if (absdev >= lim_warn && m_bms_talerts[i] < OvmsStatus::Warn)
         m_bms_talerts[i] = OvmsStatus::Warn;
       }
 
     // publish to metrics:
-    avg = ROUNDPREC(avg, 2);
-    stddev = ROUNDPREC(stddev, 2);
+    avg = roundprec_f(avg, 1e2f);
+    stddev = roundprec_f(stddev, 1e2f);
     StandardMetrics.ms_v_bat_pack_tmin->SetValue(min);
     StandardMetrics.ms_v_bat_pack_tmax->SetValue(max);
     StandardMetrics.ms_v_bat_pack_tavg->SetValue(avg);
@@ -471,6 +485,7 @@ void OvmsVehicle::BmsSetCellTemperature(int index, float value)
     m_bms_bitset_t.clear();
     m_bms_bitset_t.resize(m_bms_readings_t);
     m_bms_bitset_ct = 0;
+    m_bms_tstats.Reset();
     }
   else
     {
@@ -483,6 +498,7 @@ void OvmsVehicle::BmsRestartCellVoltages()
   m_bms_bitset_v.clear();
   m_bms_bitset_v.resize(m_bms_readings_v);
   m_bms_bitset_cv = 0;
+  m_bms_vstats.Reset();
   }
 
 void OvmsVehicle::BmsRestartCellTemperatures()
@@ -490,6 +506,7 @@ void OvmsVehicle::BmsRestartCellTemperatures()
   m_bms_bitset_t.clear();
   m_bms_bitset_t.resize(m_bms_readings_t);
   m_bms_bitset_ct = 0;
+  m_bms_tstats.Reset();
   }
 
 void OvmsVehicle::BmsResetCellVoltages(bool full /*=false*/)
@@ -499,6 +516,7 @@ void OvmsVehicle::BmsResetCellVoltages(bool full /*=false*/)
     m_bms_bitset_v.clear();
     m_bms_bitset_v.resize(m_bms_readings_v);
     m_bms_bitset_cv = 0;
+    m_bms_vstats.Reset();
     m_bms_has_voltages = false;
     for (int k=0; k<m_bms_readings_v; k++)
       {
@@ -526,6 +544,7 @@ void OvmsVehicle::BmsResetCellTemperatures(bool full /*=false*/)
     m_bms_bitset_t.clear();
     m_bms_bitset_t.resize(m_bms_readings_t);
     m_bms_bitset_ct = 0;
+    m_bms_tstats.Reset();
     m_bms_has_temperatures = false;
     for (int k=0; k<m_bms_readings_t; k++)
       {
@@ -853,7 +872,7 @@ void OvmsVehicle::BmsTicker()
     }
 
   // Log cell voltages:
-  int vlog_interval = MyConfig.GetParamValueInt("vehicle", "bms.log.voltage.interval", 0);
+  int vlog_interval = m_bms_cfg_vlog_interval.Get();
   if (vlog_interval > 0 && m_bms_vlog_last + vlog_interval < monotonictime &&
       StdMetrics.ms_v_bat_cell_voltage->LastModified() > m_bms_vlog_last)
     {
@@ -870,7 +889,7 @@ void OvmsVehicle::BmsTicker()
     }
 
   // Log cell temperatures:
-  int tlog_interval = MyConfig.GetParamValueInt("vehicle", "bms.log.temp.interval", 0);
+  int tlog_interval = m_bms_cfg_tlog_interval.Get();
   if (tlog_interval > 0 && m_bms_tlog_last + tlog_interval < monotonictime &&
       StdMetrics.ms_v_bat_cell_temp->LastModified() > m_bms_tlog_last)
     {
@@ -883,4 +902,23 @@ void OvmsVehicle::BmsTicker()
       StdMetrics.ms_v_bat_pack_tstddev_max->AsFloat(),
       StdMetrics.ms_v_bat_cell_temp->AsString("", Native, 1).c_str());
     }
+
+  // Record cell history:
+  int hist_interval = m_bms_cfg_hist_interval.Get();
+  if (hist_interval > 0 && m_bms_has_voltages && m_bms_hist_last + hist_interval < monotonictime &&
+      StdMetrics.ms_v_bat_cell_voltage->LastModified() > m_bms_hist_last)
+    {
+    m_bms_hist_last = monotonictime;
+    size_t hist_size = (size_t) m_bms_cfg_hist_size.Get() * 1024;
+    if (m_bms_history.GetCapacity() != hist_size)
+      m_bms_history.SetCapacity(hist_size);
+    m_bms_history.Add(time(NULL),
+      m_bms_readings_v, m_bms_voltages,
+      m_bms_has_temperatures ? m_bms_readings_t : 0, m_bms_temperatures);
+    }
+  else if (hist_interval <= 0 && m_bms_history.IsAllocated())
+    {
+    // History disabled, release the buffer:
+    m_bms_history.SetCapacity(0);
+    }
   }
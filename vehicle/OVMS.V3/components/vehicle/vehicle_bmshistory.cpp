@@ -0,0 +1,477 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "bms-history";
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include "esp_heap_caps.h"
+#include "vehicle_bmshistory.h"
+
+static inline uint16_t get_u16(const uint8_t* p)
+  {
+  return p[0] | (p[1] << 8);
+  }
+
+static inline uint32_t get_u32(const uint8_t* p)
+  {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+static inline void put_u16(uint8_t* p, uint16_t v)
+  {
+  p[0] = v; p[1] = v >> 8;
+  }
+
+static inline void put_u32(uint8_t* p, uint32_t v)
+  {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+  }
+
+static inline uint8_t* put_varint(uint8_t* p, uint32_t v)
+  {
+  while (v >= 0x80)
+    {
+    *p++ = (v & 0x7f) | 0x80;
+    v >>= 7;
+    }
+  *p++ = v;
+  return p;
+  }
+
+static inline const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint32_t* v)
+  {
+  uint32_t res = 0;
+  for (int shift = 0; p < end && shift < 32; shift += 7)
+    {
+    uint8_t b = *p++;
+    res |= (uint32_t)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+      {
+      *v = res;
+      return p;
+      }
+    }
+  return NULL;
+  }
+
+static inline int16_t quantize(float value, float scale)
+  {
+  long v = lroundf(value * scale);
+  if (v < INT16_MIN) return INT16_MIN;
+  if (v > INT16_MAX) return INT16_MAX;
+  return v;
+  }
+
+
+BmsHistory::BmsHistory()
+  {
+  m_buf = NULL;
+  m_capacity = 0;
+  m_size = 0;
+  m_seq_first = m_seq_next = 0;
+  m_total_records = 0;
+  m_total_bytes = 0;
+  Clear();
+  }
+
+BmsHistory::~BmsHistory()
+  {
+  if (m_buf)
+    heap_caps_free(m_buf);
+  }
+
+/**
+ * SetCapacity: (re)allocate the ring buffer in PSRAM, discards the history
+ *  size 0 frees the buffer. Returns false if the allocation failed.
+ */
+bool BmsHistory::SetCapacity(size_t size)
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  m_capacity = size;
+  if (size > 0 && size < 256)
+    size = 256;
+  if (m_buf && size == m_size)
+    return true;
+  if (m_buf)
+    {
+    heap_caps_free(m_buf);
+    m_buf = NULL;
+    }
+  m_size = 0;
+  if (size > 0)
+    {
+    // PSRAM only, the history must not compete for internal RAM:
+    m_buf = (uint8_t*) heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (!m_buf)
+      {
+      ESP_LOGE(TAG, "SetCapacity: can't allocate %u bytes", (unsigned) size);
+      Clear();
+      return false;
+      }
+    m_size = size;
+    }
+  Clear();
+  return true;
+  }
+
+void BmsHistory::Clear()
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  m_first = m_next = 0;
+  // keep sequence numbers unique, so cursors restart:
+  m_seq_first = m_seq_next;
+  m_last_time = 0;
+  m_since_key = 0;
+  m_prev_volt.clear();
+  m_prev_temp.clear();
+  }
+
+size_t BmsHistory::GetUsed()
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  if (m_seq_first == m_seq_next)
+    return 0;
+  else if (m_first < m_next)
+    return m_next - m_first;
+  else
+    return (m_size - m_first) + m_next;
+  }
+
+uint32_t BmsHistory::GetFirstTime()
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  if (m_seq_first == m_seq_next)
+    return 0;
+  return get_u32(m_buf + m_first + 7);
+  }
+
+/**
+ * EncodeValues: encode value differences to tokens
+ *  prev = NULL: key frame, predict each value by its predecessor
+ *  Returns encoded size or 0 if the buffer is too small (needs 3 bytes/value).
+ */
+size_t BmsHistory::EncodeValues(uint8_t* buf, size_t size, const int16_t* cur, const int16_t* prev, int cnt)
+  {
+  if (size < (size_t)cnt * 3)
+    return 0;
+  uint8_t* p = buf;
+  uint32_t run = 0;
+  for (int i = 0; i < cnt; i++)
+    {
+    int32_t pred = prev ? prev[i] : (i > 0 ? cur[i-1] : 0);
+    int32_t diff = cur[i] - pred;
+    if (diff == 0)
+      {
+      run++;
+      continue;
+      }
+    if (run)
+      {
+      p = put_varint(p, (run << 1) | 1);
+      run = 0;
+      }
+    uint32_t zz = ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+    p = put_varint(p, zz << 1);
+    }
+  if (run)
+    p = put_varint(p, (run << 1) | 1);
+  return p - buf;
+  }
+
+/**
+ * DecodeValues: decode tokens, cur may be the same array as prev
+ *  Returns pointer behind the tokens or NULL on error.
+ */
+const uint8_t* BmsHistory::DecodeValues(const uint8_t* p, const uint8_t* end, int16_t* cur, const int16_t* prev, int cnt)
+  {
+  uint32_t token, run = 0;
+  int i = 0;
+  while (i < cnt)
+    {
+    int32_t diff = 0;
+    if (run)
+      {
+      run--;
+      }
+    else
+      {
+      if ((p = get_varint(p, end, &token)) == NULL)
+        return NULL;
+      if (token & 1)
+        {
+        run = (token >> 1);
+        if (run == 0)
+          return NULL;
+        run--;
+        }
+      else
+        {
+        uint32_t zz = token >> 1;
+        diff = (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+        }
+      }
+    int32_t pred = prev ? prev[i] : (i > 0 ? cur[i-1] : 0);
+    cur[i++] = pred + diff;
+    }
+  return (run == 0) ? p : NULL;
+  }
+
+size_t BmsHistory::Encode(uint32_t time, bool key)
+  {
+  int vcnt = m_volt.size(), tcnt = m_temp.size();
+  m_encbuf.resize(BMSHIST_HEADERSIZE + 10 + 3 * (vcnt + tcnt));
+  uint8_t* rec = m_encbuf.data();
+  uint8_t* end = rec + m_encbuf.size();
+  rec[2] = key ? BMSHIST_KEYFRAME : 0;
+  put_u32(rec + 3, m_seq_next);
+  put_u32(rec + 7, time);
+  uint8_t* p = rec + BMSHIST_HEADERSIZE;
+  p = put_varint(p, vcnt);
+  p = put_varint(p, tcnt);
+  p += EncodeValues(p, end - p, m_volt.data(), key ? NULL : m_prev_volt.data(), vcnt);
+  p += EncodeValues(p, end - p, m_temp.data(), key ? NULL : m_prev_temp.data(), tcnt);
+  size_t len = p - rec;
+  if (len > UINT16_MAX)
+    return 0;
+  put_u16(rec, len);
+  return len;
+  }
+
+/**
+ * Add: record a snapshot
+ */
+bool BmsHistory::Add(uint32_t time, int vcnt, const float* volt, int tcnt, const float* temp)
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  if (!m_buf)
+    return false;
+
+  m_volt.resize(vcnt);
+  for (int i = 0; i < vcnt; i++)
+    m_volt[i] = quantize(volt[i], 1000);
+  m_temp.resize(tcnt);
+  for (int i = 0; i < tcnt; i++)
+    m_temp[i] = quantize(temp[i], 10);
+
+  bool key = (m_seq_first == m_seq_next || m_since_key >= BMSHIST_KEYINTERVAL ||
+              m_prev_volt.size() != m_volt.size() || m_prev_temp.size() != m_temp.size());
+  size_t len = Encode(time, key);
+  if (len == 0 || len > m_size)
+    {
+    ESP_LOGW(TAG, "Add: record size %u exceeds capacity", (unsigned) len);
+    return false;
+    }
+
+  // Make room:
+  for (;;)
+    {
+    if (m_seq_first == m_seq_next)
+      {
+      m_first = m_next = 0;
+      break;
+      }
+    if (m_first < m_next)
+      {
+      if (m_size - m_next >= len)
+        break;
+      // wrap around:
+      if (m_size - m_next >= 2)
+        put_u16(m_buf + m_next, 0);
+      m_next = 0;
+      }
+    else
+      {
+      if (m_first - m_next >= len)
+        break;
+      Evict();
+      }
+    }
+
+  memcpy(m_buf + m_next, m_encbuf.data(), len);
+  m_next += len;
+  m_seq_next++;
+  m_last_time = time;
+  m_since_key = key ? 1 : m_since_key + 1;
+  m_prev_volt.swap(m_volt);
+  m_prev_temp.swap(m_temp);
+  m_total_records++;
+  m_total_bytes += len;
+  return true;
+  }
+
+void BmsHistory::Evict()
+  {
+  uint32_t pos = m_first + get_u16(m_buf + m_first);
+  m_seq_first++;
+  if (m_seq_first == m_seq_next)
+    {
+    m_first = m_next = 0;
+    return;
+    }
+  if (m_size - pos < 2 || get_u16(m_buf + pos) == 0)
+    pos = 0; // wrap marker
+  m_first = pos;
+  }
+
+/**
+ * Locate: find record seq at pos or, if wrapped, at the buffer start
+ */
+bool BmsHistory::Locate(uint32_t& pos, uint32_t seq)
+  {
+  if (seq - m_seq_first >= m_seq_next - m_seq_first)
+    return false;
+  if (pos <= m_size - BMSHIST_HEADERSIZE && get_u16(m_buf + pos) >= BMSHIST_HEADERSIZE &&
+      get_u32(m_buf + pos + 3) == seq)
+    return true;
+  if (get_u16(m_buf) >= BMSHIST_HEADERSIZE && get_u32(m_buf + 3) == seq)
+    {
+    pos = 0;
+    return true;
+    }
+  return false;
+  }
+
+/**
+ * Seek: position cursor on its next record
+ *  A new cursor starts at the oldest key frame. If Add has wrapped over the
+ *  cursor (detected by the sequence number), it skips to the oldest valid
+ *  record behind the gap, i.e. the next key frame; a cursor never moves back.
+ *  Returns false if no record is available.
+ */
+bool BmsHistory::Seek(BmsHistoryCursor& cursor)
+  {
+  if (!m_buf)
+    return false;
+  if (cursor.valid && cursor.seq == m_seq_next)
+    return false;
+  if (cursor.valid && Locate(cursor.pos, cursor.seq))
+    return true;
+
+  bool gap = (!cursor.valid || cursor.seq - m_seq_first >= m_seq_next - m_seq_first);
+  if (cursor.valid && gap)
+    {
+    ESP_LOGW(TAG, "Seek: cursor overtaken, %" PRIu32 " records lost", m_seq_first - cursor.seq);
+    }
+  uint32_t pos = m_first, seq = m_seq_first;
+  while (Locate(pos, seq))
+    {
+    if (gap ? (m_buf[pos + 2] & BMSHIST_KEYFRAME) : (seq == cursor.seq))
+      {
+      if (gap)
+        {
+        cursor.volt.clear();
+        cursor.temp.clear();
+        }
+      cursor.valid = true;
+      cursor.seq = seq;
+      cursor.pos = pos;
+      return true;
+      }
+    pos += get_u16(m_buf + pos);
+    seq++;
+    }
+
+  // no key frame yet, wait for the next one:
+  cursor.valid = false;
+  cursor.seq = m_seq_next;
+  cursor.pos = m_next;
+  cursor.volt.clear();
+  cursor.temp.clear();
+  return false;
+  }
+
+bool BmsHistory::Decode(const uint8_t* rec, BmsHistoryCursor& cursor)
+  {
+  const uint8_t* p = rec + BMSHIST_HEADERSIZE;
+  const uint8_t* end = rec + get_u16(rec);
+  bool key = (rec[2] & BMSHIST_KEYFRAME);
+  uint32_t vcnt, tcnt;
+  if ((p = get_varint(p, end, &vcnt)) == NULL || (p = get_varint(p, end, &tcnt)) == NULL)
+    return false;
+  if (key)
+    {
+    cursor.volt.resize(vcnt);
+    cursor.temp.resize(tcnt);
+    }
+  else if (cursor.volt.size() != vcnt || cursor.temp.size() != tcnt)
+    {
+    return false;
+    }
+  p = DecodeValues(p, end, cursor.volt.data(), key ? NULL : cursor.volt.data(), vcnt);
+  if (p) p = DecodeValues(p, end, cursor.temp.data(), key ? NULL : cursor.temp.data(), tcnt);
+  return (p != NULL);
+  }
+
+/**
+ * Read: decode next record
+ *  Returns false if no record is available.
+ */
+bool BmsHistory::Read(BmsHistoryCursor& cursor, BmsHistorySample& sample)
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  while (Seek(cursor))
+    {
+    const uint8_t* rec = m_buf + cursor.pos;
+    bool ok = Decode(rec, cursor);
+    sample.seq = cursor.seq;
+    sample.time = get_u32(rec + 7);
+    cursor.pos += get_u16(rec);
+    cursor.seq++;
+    if (!ok)
+      {
+      ESP_LOGW(TAG, "Read: record %" PRIu32 " invalid, skipped", sample.seq);
+      cursor.volt.clear();
+      cursor.temp.clear();
+      continue;
+      }
+    sample.voltages.resize(cursor.volt.size());
+    for (int i = 0; i < cursor.volt.size(); i++)
+      sample.voltages[i] = cursor.volt[i] / 1000.0f;
+    sample.temperatures.resize(cursor.temp.size());
+    for (int i = 0; i < cursor.temp.size(); i++)
+      sample.temperatures[i] = cursor.temp[i] / 10.0f;
+    return true;
+    }
+  return false;
+  }
+
+/**
+ * ReadRaw: copy next encoded record (for exports)
+ *  Returns false if no record is available.
+ */
+bool BmsHistory::ReadRaw(BmsHistoryCursor& cursor, std::vector<uint8_t>& record)
+  {
+  OvmsRecMutexLock lock(&m_mutex);
+  if (!Seek(cursor))
+    return false;
+  const uint8_t* rec = m_buf + cursor.pos;
+  uint16_t len = get_u16(rec);
+  record.assign(rec, rec + len);
+  cursor.pos += len;
+  cursor.seq++;
+  return true;
+  }
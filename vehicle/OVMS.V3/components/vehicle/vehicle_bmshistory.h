@@ -0,0 +1,134 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __VEHICLE_BMSHISTORY_H__
+#define __VEHICLE_BMSHISTORY_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "ovms_mutex.h"
+
+#define BMSHIST_KEYINTERVAL     32        // Key frame interval [records]
+#define BMSHIST_FILEMAGIC       "OVMSBMSH"
+#define BMSHIST_FILEVERSION     1
+
+/**
+ * BmsHistory: fixed size ring buffer of cell voltage & temperature snapshots
+ *
+ *  Record layout (little endian):
+ *    u16     record length including this header (0 = wrap marker)
+ *    u8      flags (BMSHIST_KEYFRAME)
+ *    u32     sequence number
+ *    u32     timestamp (UTC)
+ *    varint  voltage count, varint temperature count
+ *    tokens  voltages [mV] followed by temperatures [0.1 °C]
+ *
+ *  Values are stored as differences to a prediction: in key frames the
+ *  previous cell of the same record, else the same cell of the previous
+ *  record. Tokens are varints: (zigzag(diff) << 1) or (zero run length << 1 | 1).
+ *  Records don't wrap around the buffer end. When space runs out, the oldest
+ *  records are dropped. Reading starts at the first key frame that is still
+ *  in the buffer.
+ *
+ *  The export file format is BMSHIST_FILEMAGIC, u8 BMSHIST_FILEVERSION,
+ *  followed by the records, starting with a key frame.
+ */
+
+#define BMSHIST_KEYFRAME        0x01
+#define BMSHIST_HEADERSIZE      11
+
+struct BmsHistorySample
+  {
+  uint32_t seq;                             // Record sequence number
+  uint32_t time;                            // Timestamp
+  std::vector<float> voltages;              // Cell voltages [V]
+  std::vector<float> temperatures;          // Cell temperatures [°C]
+  };
+
+struct BmsHistoryCursor
+  {
+  uint32_t seq = 0;                         // Sequence number of next record
+  uint32_t pos = 0;                         // Buffer offset of next record
+  bool valid = false;                       // false = start at oldest key frame
+  std::vector<int16_t> volt;                // Decoder state
+  std::vector<int16_t> temp;
+  };
+
+class BmsHistory
+  {
+  public:
+    BmsHistory();
+    ~BmsHistory();
+
+  public:
+    bool SetCapacity(size_t size);
+    size_t GetCapacity() { return m_capacity; }
+    bool IsAllocated() { return m_buf != NULL; }
+    void Clear();
+    bool Add(uint32_t time, int vcnt, const float* volt, int tcnt, const float* temp);
+    bool Read(BmsHistoryCursor& cursor, BmsHistorySample& sample);
+    bool ReadRaw(BmsHistoryCursor& cursor, std::vector<uint8_t>& record);
+    uint32_t GetNextSeq() { return m_seq_next; }
+
+  public:
+    uint32_t GetCount() { return m_seq_next - m_seq_first; }
+    size_t GetUsed();
+    uint32_t GetFirstTime();
+    uint32_t GetLastTime() { return m_last_time; }
+    uint32_t GetTotalRecords() { return m_total_records; }
+    uint32_t GetTotalBytes() { return m_total_bytes; }
+
+  public:
+    // Codec, public for tests:
+    static size_t EncodeValues(uint8_t* buf, size_t size, const int16_t* cur, const int16_t* prev, int cnt);
+    static const uint8_t* DecodeValues(const uint8_t* p, const uint8_t* end, int16_t* cur, const int16_t* prev, int cnt);
+
+  protected:
+    size_t Encode(uint32_t time, bool key);
+    bool Decode(const uint8_t* rec, BmsHistoryCursor& cursor);
+    bool Locate(uint32_t& pos, uint32_t seq);
+    void Evict();
+    bool Seek(BmsHistoryCursor& cursor);
+
+  protected:
+    OvmsRecMutex m_mutex;
+    uint8_t* m_buf;                         // Ring buffer (PSRAM)
+    size_t m_capacity;                      // Requested ring buffer size
+    size_t m_size;                          // Allocated ring buffer size
+    uint32_t m_first;                       // Offset of oldest record
+    uint32_t m_next;                        // Offset of next record
+    uint32_t m_seq_first;                   // Sequence number of oldest record
+    uint32_t m_seq_next;                    // Sequence number of next record
+    uint32_t m_last_time;                   // Timestamp of last record
+    uint32_t m_total_records;               // Records added since boot
+    uint32_t m_total_bytes;                 // Bytes added since boot
+    int m_since_key;                        // Records since last key frame
+    std::vector<int16_t> m_volt;            // Values to record
+    std::vector<int16_t> m_temp;
+    std::vector<int16_t> m_prev_volt;       // Values of last record
+    std::vector<int16_t> m_prev_temp;
+    std::vector<uint8_t> m_encbuf;          // Record encoding buffer
+  };
+
+#endif //#ifndef __VEHICLE_BMSHISTORY_H__
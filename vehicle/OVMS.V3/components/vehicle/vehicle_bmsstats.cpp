@@ -0,0 +1,116 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "vehicle_bmsstats.h"
+
+BmsCellStats::BmsCellStats()
+  {
+  m_count = 0;
+  m_centre = 0;
+  m_sumd = 0;
+  Reset();
+  }
+
+/**
+ * SetCount: set the number of cells per series
+ *  The gradient is the linear regression slope of the values over the cell
+ *  index, scaled to the pack: Σ(k·x) / Σ(k²) · count, k = index - centre.
+ *  As Σk = 0, Σ(k·x) needs no mean correction and can be summed up
+ *  incrementally.
+ */
+void BmsCellStats::SetCount(int count)
+  {
+  m_count = count;
+  m_centre = (count - 1) / 2.0f;
+  m_sumd = 0;
+  for (int i = 0; i < count; i++)
+    m_sumd += (i - m_centre) * (i - m_centre);
+  Reset();
+  }
+
+void BmsCellStats::Reset()
+  {
+  m_valid = true;
+  m_n = 0;
+  m_min = 0;
+  m_max = 0;
+  m_mean = 0;
+  m_m2 = 0;
+  m_sumkx = 0;
+  }
+
+void BmsCellStats::Add(int index, float value)
+  {
+  m_n++;
+  if (m_n == 1)
+    {
+    m_min = m_max = value;
+    }
+  else
+    {
+    if (value < m_min) m_min = value;
+    if (value > m_max) m_max = value;
+    }
+  float delta = value - m_mean;
+  m_mean += delta / m_n;
+  m_m2 += delta * (value - m_mean);
+  m_sumkx += (index - m_centre) * value;
+  }
+
+/**
+ * Compute: single pass over the complete series
+ */
+void BmsCellStats::Compute(const float* values)
+  {
+  Reset();
+  if (m_count <= 0)
+    return;
+
+  float min = values[0], max = values[0];
+  float mean = 0, m2 = 0, sumkx = 0;
+  float k = -m_centre;
+  for (int i = 0; i < m_count; i++, k += 1)
+    {
+    float value = values[i];
+    if (value < min) min = value;
+    if (value > max) max = value;
+    float delta = value - mean;
+    mean += delta / (i + 1);
+    m2 += delta * (value - mean);
+    sumkx += k * value;
+    }
+
+  m_n = m_count;
+  m_min = min;
+  m_max = max;
+  m_mean = mean;
+  m_m2 = m2;
+  m_sumkx = sumkx;
+  }
+
+float BmsCellStats::Gradient() const
+  {
+  if (m_sumd <= 0)
+    return 0;
+  return m_sumkx / m_sumd * m_count;
+  }
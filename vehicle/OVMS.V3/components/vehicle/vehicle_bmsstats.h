@@ -0,0 +1,75 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __VEHICLE_BMSSTATS_H__
+#define __VEHICLE_BMSSTATS_H__
+
+#include <math.h>
+
+/**
+ * BmsCellStats: statistics over a BMS cell series (voltages / temperatures)
+ *
+ *  Mean & variance are computed by Welford's method, all arithmetic is done
+ *  in float (the ESP32 FPU has no double support). The cell values stay in
+ *  the caller's arrays (one array per cell attribute).
+ *
+ *  Add() updates the aggregates as each cell arrives, so the series result
+ *  is available without another pass when the last cell is set. If a cell
+ *  is read twice within a series, the incremental result is invalidated and
+ *  Compute() needs to do a single pass over the final values.
+ */
+class BmsCellStats
+  {
+  public:
+    BmsCellStats();
+
+  public:
+    void SetCount(int count);
+    void Reset();
+    void Add(int index, float value);
+    void Invalidate() { m_valid = false; }
+    bool IsComplete() const { return m_valid && m_n == m_count; }
+    void Compute(const float* values);
+
+  public:
+    int Count() const { return m_n; }
+    float Min() const { return m_min; }
+    float Max() const { return m_max; }
+    float Mean() const { return m_mean; }
+    float StdDev() const { return (m_n > 0) ? sqrtf(m_m2 / m_n) : 0; }
+    float Gradient() const;
+
+  protected:
+    int m_count;                        // Cells per series
+    float m_centre;                     // Gradient: cell index centre
+    float m_sumd;                       // Gradient: sum of squared index offsets
+    bool m_valid;                       // Incremental aggregates valid
+    int m_n;                            // Cells added
+    float m_min;
+    float m_max;
+    float m_mean;
+    float m_m2;                         // Sum of squared differences from the mean
+    float m_sumkx;                      // Gradient: sum of index offset * value
+  };
+
+#endif //#ifndef __VEHICLE_BMSSTATS_H__
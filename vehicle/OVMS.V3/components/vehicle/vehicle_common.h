@@ -44,6 +44,7 @@
 
 // Argument tag:
 #define POLL_TXDATA                     0xff  // poll_pid_t using xargs for external payload up to 4095 bytes
+#define POLL_TXBATCH                    0xfe  // poll_pid_t using xargs for a UDS multi DID request (see POLL_PID_BATCH)
 
 // OBD (ISO 15031) service identifiers supported:
 #define VEHICLE_POLL_TYPE_OBDIICURRENT    0x01 // Mode 01 "current data" (8 bit PID)
@@ -32,6 +32,7 @@
 // static const char *TAG = "vehicle";
 
 #include <stdio.h>
+#include <time.h>
 #include <algorithm>
 #include <ovms_command.h>
 #include <ovms_script.h>
@@ -463,6 +464,99 @@ void OvmsVehicleFactory::bms_reset(int verbosity, OvmsWriter* writer, OvmsComman
     }
   }
 
+void OvmsVehicleFactory::bms_history_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyVehicleFactory.m_currentvehicle == NULL)
+    {
+    writer->puts("No vehicle module selected");
+    return;
+    }
+  BmsHistory* hist = MyVehicleFactory.m_currentvehicle->BmsGetHistory();
+  if (!hist->IsAllocated())
+    {
+    if (hist->GetCapacity() > 0)
+      writer->printf("BMS history: buffer allocation failed (%u bytes, PSRAM required)\n", (unsigned) hist->GetCapacity());
+    else
+      writer->puts("BMS history: not active");
+    return;
+    }
+
+  uint32_t count = hist->GetCount();
+  size_t used = hist->GetUsed();
+  writer->printf("Records:  %" PRIu32 "\n", count);
+  writer->printf("Memory:   %u of %u bytes used\n", (unsigned) used, (unsigned) hist->GetCapacity());
+  if (count > 0)
+    {
+    char tb[32];
+    time_t t;
+    struct tm tmu;
+    writer->printf("Size:     %.1f bytes/record\n", (float) used / count);
+    t = hist->GetFirstTime();
+    strftime(tb, sizeof(tb), "%Y-%m-%d %H:%M:%S", localtime_r(&t, &tmu));
+    writer->printf("First:    %s\n", tb);
+    t = hist->GetLastTime();
+    strftime(tb, sizeof(tb), "%Y-%m-%d %H:%M:%S", localtime_r(&t, &tmu));
+    writer->printf("Last:     %s\n", tb);
+    }
+  writer->printf("Recorded: %" PRIu32 " records, %" PRIu32 " bytes since boot\n",
+    hist->GetTotalRecords(), hist->GetTotalBytes());
+  }
+
+void OvmsVehicleFactory::bms_history_export(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyVehicleFactory.m_currentvehicle == NULL)
+    {
+    writer->puts("No vehicle module selected");
+    return;
+    }
+  if (MyConfig.ProtectedPath(argv[0]))
+    {
+    writer->puts("Error: protected path");
+    return;
+    }
+  BmsHistory* hist = MyVehicleFactory.m_currentvehicle->BmsGetHistory();
+  FILE* fp = fopen(argv[0], "w");
+  if (!fp)
+    {
+    writer->printf("Error: cannot open '%s'\n", argv[0]);
+    return;
+    }
+
+  uint8_t version = BMSHIST_FILEVERSION;
+  bool ok = (fwrite(BMSHIST_FILEMAGIC, strlen(BMSHIST_FILEMAGIC), 1, fp) == 1 &&
+             fwrite(&version, 1, 1, fp) == 1);
+  BmsHistoryCursor cursor;
+  std::vector<uint8_t> record;
+  uint32_t cnt = 0;
+  size_t size = 0;
+  while (ok && hist->ReadRaw(cursor, record))
+    {
+    ok = (fwrite(record.data(), record.size(), 1, fp) == 1);
+    cnt++;
+    size += record.size();
+    }
+  if (fclose(fp) != 0)
+    ok = false;
+
+  if (ok)
+    writer->printf("Exported %" PRIu32 " records (%u bytes) to '%s'\n", cnt, (unsigned) size, argv[0]);
+  else
+    writer->printf("Error: write to '%s' failed\n", argv[0]);
+  }
+
+void OvmsVehicleFactory::bms_history_clear(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyVehicleFactory.m_currentvehicle != NULL)
+    {
+    MyVehicleFactory.m_currentvehicle->BmsGetHistory()->Clear();
+    writer->puts("BMS history has been cleared.");
+    }
+  else
+    {
+    writer->puts("No vehicle module selected");
+    }
+  }
+
 void OvmsVehicleFactory::vehicle_aux(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   writer->printf("AUX BATTERY\n");
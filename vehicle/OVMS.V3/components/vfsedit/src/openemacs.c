@@ -884,6 +884,7 @@ int editor_save(struct editor_state* E)
   free(buf);
   E->dirty = false;
   editor_set_status_message(E, "Wrote %s (%d bytes)", E->filename, len);
+  if (E->saved) { E->saved(E); }
   return 0;
   write_error:
   free(buf);
@@ -1454,6 +1455,7 @@ void editor_init(struct editor_state* E, size_t (*write) (struct editor_state* E
   E->status_message = NULL;
   E->syntax_highlight_mode = NULL;
   E->write = write;
+  E->saved = NULL;
   E->editor_userdata = userdata;
   editor_request_window_size(E);
   console_buffer_open(E);
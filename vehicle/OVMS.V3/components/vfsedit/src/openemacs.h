@@ -23,6 +23,7 @@ struct editor_state
   bool editor_completed;                  // TRUE if editor has completed
   void* editor_userdata;                  // General user data
   size_t (*write) (struct editor_state* E, const char *buf, size_t nbyte);
+  void (*saved) (struct editor_state* E); // Called after the file has been written (optional)
   struct editor_row *row;                 // Rows
   bool dirty;                             // File modified but not saved.
   char *filename;                         // Currently open filename
@@ -30,6 +30,7 @@
 
 #include "vfsedit.h"
 #include "openemacs.h"
+#include "ovms_events.h"
 
 size_t vfs_edit_write(struct editor_state* E, const char *buf, size_t nbyte)
   {
@@ -38,6 +39,12 @@ size_t vfs_edit_write(struct editor_state* E, const char *buf, size_t nbyte)
   return writer->write(buf,nbyte);
   }
 
+void vfs_edit_saved(struct editor_state* E)
+  {
+  // Let listeners (e.g. the event script index) know about the change:
+  MyEvents.SignalEvent("system.vfs.file.changed", (void*)E->filename, strlen(E->filename)+1);
+  }
+
 bool vfs_edit_insert(OvmsWriter* writer, void* ctx, char ch)
   {
   struct editor_state* ed = (struct editor_state*)ctx;
@@ -65,6 +72,7 @@ void vfs_edit(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, con
 
   struct editor_state* ed = (struct editor_state*)ExternalRamMalloc(sizeof(struct editor_state));
   editor_init(ed,vfs_edit_write,(void*)writer);
+  ed->saved = vfs_edit_saved;
   editor_open(ed,argv[0]);
 
   writer->RegisterInsertCallback(vfs_edit_insert, ed);
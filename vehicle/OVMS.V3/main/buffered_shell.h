@@ -49,7 +49,6 @@ class BufferedShell : public OvmsShell
     int puts(const char* s);
     int printf(const char* fmt, ...) __attribute__ ((format (printf, 2, 3)));
     ssize_t write(const void *buf, size_t nbyte);
-    void Log(LogBuffers* message);
     virtual bool IsInteractive() { return false; }
     void Output(OvmsWriter*);
     void Dump(std::string&);
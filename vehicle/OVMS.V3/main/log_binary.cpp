@@ -0,0 +1,803 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+#include "ovms_malloc.h"
+#include "ovms_command.h"
+#include "glob_match.h"
+#include "log_binary.h"
+
+static const char log_levels[] = "?EWIDV";
+
+static inline int log_level_num(char level)
+  {
+  const char* p = level ? strchr(log_levels+1, level) : NULL;
+  return p ? (p - log_levels) : 0;
+  }
+
+static inline void put_u32(uint8_t* p, uint32_t v)
+  {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+  }
+
+static inline uint32_t get_u32(const uint8_t* p)
+  {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+static inline uint8_t* put_varint(uint8_t* p, uint64_t v)
+  {
+  while (v >= 0x80)
+    {
+    *p++ = (v & 0x7f) | 0x80;
+    v >>= 7;
+    }
+  *p++ = v;
+  return p;
+  }
+
+static inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+  {
+  v = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+    uint8_t b = *p++;
+    v |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return true;
+    }
+  return false;
+  }
+
+
+/**
+ * LogParseLine: split a log line "L (stamp) tag: message\n"
+ *  Returns false for lines not in this format, these are passed in rec.msg
+ *  as a whole (without line end), level, tag & stamp are left unset.
+ */
+bool LogParseLine(const char* line, size_t len, LogRecord& rec)
+  {
+  rec.lineend = (len > 0 && line[len-1] == '\n');
+  if (rec.lineend)
+    len--;
+  rec.level = 0;
+  rec.tag = NULL;
+  rec.taglen = 0;
+  rec.msg = line;
+  rec.msglen = len;
+
+  const char* end = line + len;
+  if (len < 8 || !log_level_num(line[0]) || line[1] != ' ' || line[2] != '(')
+    return false;
+  const char* p = line + 3;
+  uint32_t stamp = 0;
+  if (*p < '0' || *p > '9')
+    return false;
+  while (p < end && *p >= '0' && *p <= '9')
+    stamp = stamp * 10 + (*p++ - '0');
+  if (end - p < 2 || p[0] != ')' || p[1] != ' ')
+    return false;
+  p += 2;
+  const char* tag = p;
+  while (p + 1 < end && !(p[0] == ':' && p[1] == ' '))
+    p++;
+  if (p + 1 >= end || p == tag || p - tag > 255)
+    return false;
+
+  rec.level = line[0];
+  rec.stamp = stamp;
+  rec.tag = tag;
+  rec.taglen = p - tag;
+  rec.msg = p + 2;
+  rec.msglen = end - rec.msg;
+  return true;
+  }
+
+/**
+ * LogParseTextLine: parse a line from a text log file
+ *  Lines written by the file logger are prefixed by the wall time
+ *  ("YYYY-mm-dd HH:MM:SS.mmm TZ ") if they are in log format. Unformatted
+ *  lines don't carry a time, rec.time is left unchanged for these.
+ *  The cache speeds up converting the date to epoch time.
+ */
+bool LogParseTextLine(const char* line, size_t len, LogRecord& rec, LogTimeCache& cache)
+  {
+  // "YYYY-mm-dd HH:MM:SS.mmm TZ ":
+  static const char pattern[] = "dddd-dd-dd dd:dd:dd.ddd ";
+  const size_t plen = sizeof(pattern) - 1;
+  size_t i;
+  for (i = 0; i < plen && i < len; i++)
+    {
+    if (pattern[i] == 'd' ? (line[i] < '0' || line[i] > '9') : (line[i] != pattern[i]))
+      break;
+    }
+  const char* p = line + plen;
+  const char* end = line + len;
+  while (i == plen && p < end && *p != ' ' && *p != '\n')
+    p++;
+  LogRecord lr;
+  if (i < plen || p >= end || *p != ' ' || !LogParseLine(p + 1, end - p - 1, lr))
+    {
+    LogParseLine(line, len, rec);
+    return false;
+    }
+  lr.time = rec.time;
+  rec = lr;
+
+  #define DIGITS2(s) (((s)[0]-'0')*10 + ((s)[1]-'0'))
+  int year = DIGITS2(line) * 100 + DIGITS2(line+2);
+  int mon = DIGITS2(line+5), day = DIGITS2(line+8), hour = DIGITS2(line+11);
+  int min = DIGITS2(line+14), sec = DIGITS2(line+17);
+  int ms = DIGITS2(line+20) * 10 + (line[22] - '0');
+  #undef DIGITS2
+  int32_t key = (((year * 12 + mon) * 31 + day) * 24) + hour;
+  if (key != cache.key)
+    {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = year - 1900;
+    tm.tm_mon = mon - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_isdst = -1;
+    cache.key = key;
+    cache.base = (int64_t) mktime(&tm) * 1000;
+    }
+  rec.time = cache.base + (min * 60 + sec) * 1000 + ms;
+  return true;
+  }
+
+/**
+ * LogFormatTime: format wall time like the text file logger
+ */
+size_t LogFormatTime(char* buf, size_t size, int64_t time)
+  {
+  time_t sec = time / 1000;
+  int ms = time % 1000;
+  struct tm tmu;
+  localtime_r(&sec, &tmu);
+  size_t len = strftime(buf, size, "%Y-%m-%d %H:%M:%S", &tmu);
+  len += snprintf(buf+len, size-len, ".%03d ", ms);
+  len += strftime(buf+len, size-len, "%Z ", &tmu);
+  return len;
+  }
+
+/**
+ * LogFormatLine: reconstruct the text log line of a record
+ */
+void LogFormatLine(std::string& out, const LogRecord& rec, bool withtime /*=true*/)
+  {
+  char buf[64];
+  out.clear();
+  if (rec.level)
+    {
+    if (withtime)
+      out.append(buf, LogFormatTime(buf, sizeof(buf), rec.time));
+    out.append(buf, snprintf(buf, sizeof(buf), "%c (%" PRIu32 ") ", rec.level, rec.stamp));
+    out.append(rec.tag, rec.taglen);
+    out.append(": ");
+    }
+  out.append(rec.msg, rec.msglen);
+  if (rec.lineend)
+    out.push_back('\n');
+  }
+
+/**
+ * LogParseTime: parse a time specification for log queries
+ *  Supported: "YYYY-MM-DD[(T| |_)HH:MM[:SS]]", "HH:MM[:SS]" (today),
+ *  "-<n>[s|m|h|d]" (relative to now), "<n>" (Unix epoch seconds)
+ */
+bool LogParseTime(const char* str, int64_t& time)
+  {
+  time_t now = ::time(NULL);
+  int n = 0, len = strlen(str);
+  if (len == 0)
+    return false;
+
+  if (str[0] == '-')
+    {
+    char* end;
+    long val = strtol(str+1, &end, 10);
+    int mult = 1;
+    switch (*end)
+      {
+      case 0: case 's': break;
+      case 'm': mult = 60; break;
+      case 'h': mult = 3600; break;
+      case 'd': mult = 86400; break;
+      default: return false;
+      }
+    if (end == str+1 || (*end && end[1]))
+      return false;
+    time = ((int64_t)now - (int64_t)val * mult) * 1000;
+    return true;
+    }
+
+  if (strspn(str, "0123456789") == (size_t)len && len > 6)
+    {
+    time = (int64_t) atoll(str) * 1000;
+    return true;
+    }
+
+  struct tm tm;
+  localtime_r(&now, &tm);
+  int year, mon, day, hour = 0, min = 0, sec = 0;
+  char sep;
+  if (sscanf(str, "%4d-%2d-%2d%n", &year, &mon, &day, &n) == 3)
+    {
+    tm.tm_year = year - 1900;
+    tm.tm_mon = mon - 1;
+    tm.tm_mday = day;
+    str += n;
+    if (*str)
+      {
+      n = 0;
+      if (sscanf(str, "%c%2d:%2d%n:%2d%n", &sep, &hour, &min, &n, &sec, &n) < 3
+          || (sep != 'T' && sep != ' ' && sep != '_'))
+        return false;
+      str += n;
+      }
+    }
+  else if (sscanf(str, "%2d:%2d%n:%2d%n", &hour, &min, &n, &sec, &n) >= 2)
+    {
+    str += n;
+    }
+  else
+    return false;
+  if (*str)
+    return false;
+
+  tm.tm_hour = hour;
+  tm.tm_min = min;
+  tm.tm_sec = sec;
+  tm.tm_isdst = -1;
+  time = (int64_t) mktime(&tm) * 1000;
+  return true;
+  }
+
+
+/**
+ * LogBinaryWriter: append log records to a binary log file
+ */
+
+#define LOGBIN_ENCODESIZE       (LOGBIN_MAXMSG + 300)
+
+LogBinaryWriter::LogBinaryWriter()
+  {
+  m_file = NULL;
+  m_buf = NULL;
+  m_used = 0;
+  m_time = 0;
+  m_stamp = 0;
+  m_tagcnt = 0;
+  }
+
+LogBinaryWriter::~LogBinaryWriter()
+  {
+  if (m_buf)
+    free(m_buf);
+  }
+
+static size_t log_pad(FILE* file, size_t len)
+  {
+  static const uint8_t zero[128] = { 0 };
+  size_t written = 0;
+  while (len > 0)
+    {
+    size_t n = (len > sizeof(zero)) ? sizeof(zero) : len;
+    if (fwrite(zero, 1, n, file) != n)
+      break;
+    written += n;
+    len -= n;
+    }
+  return written;
+  }
+
+/**
+ * Open: attach to file opened for appending
+ *  @param size     current file size
+ *  @return         bytes written (padding to the next block boundary)
+ */
+size_t LogBinaryWriter::Open(FILE* file, size_t size)
+  {
+  m_file = file;
+  m_used = 0;
+  m_tagcnt = 0;
+  if (!m_buf)
+    m_buf = (uint8_t*) ExternalRamMalloc(LOGBIN_ENCODESIZE);
+  if (!m_buf)
+    {
+    m_file = NULL;
+    return 0;
+    }
+  return log_pad(m_file, (LOGBIN_BLOCKSIZE - size % LOGBIN_BLOCKSIZE) % LOGBIN_BLOCKSIZE);
+  }
+
+void LogBinaryWriter::Close()
+  {
+  m_file = NULL;
+  m_used = 0;
+  }
+
+size_t LogBinaryWriter::StartBlock(const LogRecord& rec)
+  {
+  size_t written = 0;
+  if (m_used)
+    written += log_pad(m_file, LOGBIN_BLOCKSIZE - m_used);
+
+  uint8_t hdr[LOGBIN_HEADERSIZE];
+  memset(hdr, 0, sizeof(hdr));
+  memcpy(hdr, LOGBIN_MAGIC, 4);
+  hdr[4] = LOGBIN_VERSION;
+  if (m_used && rec.time < m_time)
+    hdr[5] |= LOGBIN_FLAG_BACKSTEP;
+  put_u32(hdr+8, (uint64_t)rec.time & 0xffffffff);
+  put_u32(hdr+12, (uint64_t)rec.time >> 32);
+  put_u32(hdr+16, rec.stamp);
+  written += fwrite(hdr, 1, sizeof(hdr), m_file);
+
+  m_used = LOGBIN_HEADERSIZE;
+  m_time = rec.time;
+  m_stamp = rec.stamp;
+  m_tagcnt = 0;
+  return written;
+  }
+
+size_t LogBinaryWriter::Encode(const LogRecord& rec, int tagid)
+  {
+  uint8_t* p = m_buf;
+  int level = log_level_num(rec.level);
+  bool newtag = (level && tagid == m_tagcnt);
+  *p++ = 0x80 | level | (newtag ? 0x40 : 0) | (rec.lineend ? 0 : 0x20);
+  p = put_varint(p, rec.time - m_time);
+  p = put_varint(p, rec.stamp - m_stamp);
+  if (level)
+    {
+    p = put_varint(p, tagid);
+    if (newtag)
+      {
+      *p++ = rec.taglen;
+      memcpy(p, rec.tag, rec.taglen);
+      p += rec.taglen;
+      }
+    }
+  size_t msglen = (rec.msglen > LOGBIN_MAXMSG) ? LOGBIN_MAXMSG : rec.msglen;
+  p = put_varint(p, msglen);
+  memcpy(p, rec.msg, msglen);
+  p += msglen;
+  return p - m_buf;
+  }
+
+/**
+ * Write: append a record
+ *  Starts a new block if the record doesn't fit, or if the time or stamp
+ *  run backwards (e.g. clock adjusted).
+ *  @return         bytes written
+ */
+size_t LogBinaryWriter::Write(const LogRecord& rec)
+  {
+  if (!m_file)
+    return 0;
+  size_t written = 0;
+  int level = log_level_num(rec.level);
+
+  bool fresh = (m_used == 0 || rec.time < m_time || rec.stamp < m_stamp);
+  int tagid = 0;
+  if (!fresh && level)
+    {
+    for (tagid = 0; tagid < m_tagcnt; tagid++)
+      {
+      if (m_tags[tagid].size() == rec.taglen && memcmp(m_tags[tagid].data(), rec.tag, rec.taglen) == 0)
+        break;
+      }
+    if (tagid == LOGBIN_MAXTAGS)
+      fresh = true;
+    }
+  if (fresh)
+    {
+    written += StartBlock(rec);
+    tagid = 0;
+    }
+
+  size_t len = Encode(rec, tagid);
+  if (m_used + len > LOGBIN_BLOCKSIZE)
+    {
+    written += StartBlock(rec);
+    tagid = 0;
+    len = Encode(rec, tagid);
+    }
+  if (level && tagid == m_tagcnt)
+    m_tags[m_tagcnt++].assign(rec.tag, rec.taglen);
+
+  written += fwrite(m_buf, 1, len, m_file);
+  m_used += len;
+  m_time = rec.time;
+  m_stamp = rec.stamp;
+  return written;
+  }
+
+
+/**
+ * LogBinaryReader: sequential & time indexed reading of binary log files
+ */
+
+LogBinaryReader::LogBinaryReader()
+  {
+  m_file = NULL;
+  m_block = NULL;
+  m_blocks = 0;
+  m_index = 0;
+  m_len = 0;
+  m_pos = 0;
+  m_loaded = 0;
+  m_time = 0;
+  m_stamp = 0;
+  m_tagcnt = 0;
+  m_run = 0;
+  m_seeking = false;
+  }
+
+LogBinaryReader::~LogBinaryReader()
+  {
+  Close();
+  }
+
+bool LogBinaryReader::IsBinary(const char* path)
+  {
+  FILE* file = fopen(path, "r");
+  if (!file)
+    return false;
+  char magic[4];
+  bool binary = (fread(magic, 1, 4, file) == 4 && memcmp(magic, LOGBIN_MAGIC, 4) == 0);
+  fclose(file);
+  return binary;
+  }
+
+bool LogBinaryReader::Open(const char* path)
+  {
+  Close();
+  m_file = fopen(path, "r");
+  if (!m_file)
+    return false;
+  m_block = (uint8_t*) ExternalRamMalloc(LOGBIN_BLOCKSIZE);
+  int64_t time;
+  if (!m_block || fseek(m_file, 0, SEEK_END) != 0)
+    {
+    Close();
+    return false;
+    }
+  m_blocks = (ftell(m_file) + LOGBIN_BLOCKSIZE - 1) / LOGBIN_BLOCKSIZE;
+  if (!ReadHeader(0, time))
+    {
+    Close();
+    return false;
+    }
+  m_index = 0;
+  m_pos = m_len = 0;
+  m_loaded = 0;
+  return true;
+  }
+
+void LogBinaryReader::Close()
+  {
+  if (m_file)
+    fclose(m_file);
+  m_file = NULL;
+  if (m_block)
+    free(m_block);
+  m_block = NULL;
+  m_blocks = 0;
+  m_btime.clear();
+  m_runstart.clear();
+  m_seekblock.clear();
+  m_seeking = false;
+  }
+
+bool LogBinaryReader::ReadHeader(uint32_t index, int64_t& time, uint8_t* flags /*=NULL*/)
+  {
+  uint8_t hdr[LOGBIN_HEADERSIZE];
+  if (fseek(m_file, (long)index * LOGBIN_BLOCKSIZE, SEEK_SET) != 0
+      || fread(hdr, 1, sizeof(hdr), m_file) != sizeof(hdr)
+      || memcmp(hdr, LOGBIN_MAGIC, 4) != 0 || hdr[4] != LOGBIN_VERSION)
+    return false;
+  time = (int64_t)((uint64_t)get_u32(hdr+12) << 32 | get_u32(hdr+8));
+  if (flags)
+    *flags = hdr[5];
+  return true;
+  }
+
+bool LogBinaryReader::LoadBlock(uint32_t index)
+  {
+  m_pos = m_len = 0;
+  m_tagcnt = 0;
+  if (fseek(m_file, (long)index * LOGBIN_BLOCKSIZE, SEEK_SET) != 0)
+    return false;
+  size_t len = fread(m_block, 1, LOGBIN_BLOCKSIZE, m_file);
+  m_loaded++;
+  if (len < LOGBIN_HEADERSIZE || memcmp(m_block, LOGBIN_MAGIC, 4) != 0 || m_block[4] != LOGBIN_VERSION)
+    return false;
+  m_time = (int64_t)((uint64_t)get_u32(m_block+12) << 32 | get_u32(m_block+8));
+  m_stamp = get_u32(m_block+16);
+  m_pos = LOGBIN_HEADERSIZE;
+  m_len = len;
+  return true;
+  }
+
+/**
+ * ScanRuns: read all block headers, split the file into ascending runs
+ *  A run ends where the block time decreases or the writer flagged a
+ *  backwards time step (reboot, clock adjusted). Unreadable blocks
+ *  inherit the previous time, Read() skips them.
+ */
+void LogBinaryReader::ScanRuns()
+  {
+  m_btime.resize(m_blocks);
+  m_runstart.clear();
+  int64_t last = INT64_MIN;
+  for (uint32_t index = 0; index < m_blocks; index++)
+    {
+    int64_t btime;
+    uint8_t flags = 0;
+    if (!ReadHeader(index, btime, &flags))
+      btime = last;
+    if (index == 0 || btime < last || (flags & LOGBIN_FLAG_BACKSTEP))
+      m_runstart.push_back(index);
+    m_btime[index] = last = btime;
+    }
+  }
+
+/**
+ * Seek: position before the first record at or after time
+ *  Binary search over the block headers of each ascending run, the reader
+ *  needs to skip records before the time in the block found. Read()
+ *  continues with the next run at its seek position when a run ends,
+ *  NextRun() skips the rest of the current run.
+ */
+bool LogBinaryReader::Seek(int64_t time)
+  {
+  if (!m_file || m_blocks == 0)
+    return false;
+  if (m_btime.size() != m_blocks)
+    ScanRuns();
+
+  m_seekblock.resize(m_runstart.size());
+  for (size_t run = 0; run < m_runstart.size(); run++)
+    {
+    uint32_t first = m_runstart[run];
+    uint32_t lo = first, found = first;
+    uint32_t hi = (run+1 < m_runstart.size()) ? m_runstart[run+1] : m_blocks;
+    while (lo < hi)
+      {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (m_btime[mid] > time)
+        hi = mid;
+      else
+        {
+        found = mid;
+        lo = mid + 1;
+        }
+      }
+    // the block found may start exactly at the time, with more records of
+    // the same time in the previous block:
+    while (found > first && m_btime[found] == time)
+      found--;
+    m_seekblock[run] = found;
+    }
+
+  m_run = 0;
+  m_seeking = true;
+  m_index = m_seekblock[0];
+  m_pos = m_len = 0;
+  return true;
+  }
+
+/**
+ * NextRun: continue reading at the seek position of the next run
+ *  @return     false if there is no next run (or no Seek() done)
+ */
+bool LogBinaryReader::NextRun()
+  {
+  if (!m_seeking || m_run+1 >= m_runstart.size())
+    return false;
+  m_run++;
+  m_index = m_seekblock[m_run];
+  m_pos = m_len = 0;
+  return true;
+  }
+
+/**
+ * Read: get next record
+ *  Tag & message pointers are valid until the next Read()
+ */
+bool LogBinaryReader::Read(LogRecord& rec)
+  {
+  if (!m_file)
+    return false;
+  for (;;)
+    {
+    if (m_pos >= m_len || m_block[m_pos] == 0)
+      {
+      // load next block:
+      if (m_len)
+        m_index++;
+      while (m_index < m_blocks)
+        {
+        if (m_seeking && m_run+1 < m_runstart.size() && m_index == m_runstart[m_run+1])
+          {
+          // end of run, continue at the seek position of the next:
+          m_run++;
+          m_index = m_seekblock[m_run];
+          }
+        if (LoadBlock(m_index))
+          break;
+        m_index++;
+        }
+      if (m_index >= m_blocks)
+        return false;
+      continue;
+      }
+
+    const uint8_t* p = m_block + m_pos;
+    const uint8_t* end = m_block + m_len;
+    uint8_t head = *p++;
+    int level = head & 0x07;
+    uint64_t dt, ds, id, len;
+    bool valid = (head & 0x80) && level <= 5 && get_varint(p, end, dt) && get_varint(p, end, ds);
+    rec.tag = NULL;
+    rec.taglen = 0;
+    if (valid && level)
+      {
+      valid = get_varint(p, end, id);
+      if (valid && (head & 0x40))
+        {
+        valid = (p < end && id == (uint64_t)m_tagcnt && m_tagcnt < LOGBIN_MAXTAGS && p + 1 + *p <= end);
+        if (valid)
+          {
+          m_taglen[m_tagcnt] = *p++;
+          m_tag[m_tagcnt++] = (const char*) p;
+          p += m_taglen[id];
+          }
+        }
+      if (valid && id < (uint64_t)m_tagcnt)
+        {
+        rec.tag = m_tag[id];
+        rec.taglen = m_taglen[id];
+        }
+      else
+        valid = false;
+      }
+    valid = valid && get_varint(p, end, len) && len <= (uint64_t)(end - p);
+    if (!valid)
+      {
+      // corrupted or truncated, skip rest of block:
+      m_pos = m_len;
+      continue;
+      }
+
+    m_time += dt;
+    m_stamp += ds;
+    rec.time = m_time;
+    rec.stamp = m_stamp;
+    rec.level = level ? log_levels[level] : 0;
+    rec.lineend = !(head & 0x20);
+    rec.msg = (const char*) p;
+    rec.msglen = len;
+    m_pos = (p + len) - m_block;
+    return true;
+    }
+  }
+
+
+/**
+ * LogSearch: output log lines matching the query
+ *  Binary files are searched using the block index, text files are scanned
+ *  completely.
+ */
+static bool log_match(const LogRecord& rec, const LogQuery& query)
+  {
+  if (rec.level && log_level_num(rec.level) > query.level)
+    return false;
+  if (!query.tag.empty())
+    {
+    if (!rec.level)
+      return false;
+    char tag[256];
+    memcpy(tag, rec.tag, rec.taglen);
+    tag[rec.taglen] = 0;
+    if (!glob_match(query.tag.c_str(), tag))
+      return false;
+    }
+  return true;
+  }
+
+bool LogSearch(OvmsWriter* writer, const char* path, LogQuery& query)
+  {
+  LogRecord rec;
+  query.lines = query.scanned = 0;
+  query.binary = LogBinaryReader::IsBinary(path);
+
+  if (query.binary)
+    {
+    LogBinaryReader reader;
+    if (!reader.Open(path))
+      return false;
+    reader.Seek(query.from);
+    std::string line;
+    line.reserve(256);
+    while (reader.Read(rec))
+      {
+      query.scanned++;
+      if (rec.time < query.from)
+        continue;
+      if (rec.time > query.to)
+        {
+        // done with this run, there may be more in later runs:
+        if (reader.NextRun())
+          continue;
+        break;
+        }
+      if (!log_match(rec, query))
+        continue;
+      LogFormatLine(line, rec);
+      writer->write(line.data(), line.size());
+      if (++query.lines == query.limit)
+        break;
+      }
+    return true;
+    }
+
+  FILE* file = fopen(path, "r");
+  if (!file)
+    return false;
+  const size_t size = LOGBIN_MAXMSG + 128;
+  char* buf = (char*) ExternalRamMalloc(size);
+  if (!buf)
+    {
+    fclose(file);
+    return false;
+    }
+  LogTimeCache cache;
+  rec.time = INT64_MIN;
+  while (fgets(buf, size, file))
+    {
+    size_t len = strlen(buf);
+    LogParseTextLine(buf, len, rec, cache);
+    query.scanned++;
+    // Text logs have no run index, times may jump back after a reboot
+    //  or clock adjustment, so scan to the end:
+    if (rec.time < query.from || rec.time > query.to)
+      continue;
+    if (!log_match(rec, query))
+      continue;
+    writer->write(buf, len);
+    if (++query.lines == query.limit)
+      break;
+    }
+  free(buf);
+  fclose(file);
+  return true;
+  }
@@ -0,0 +1,186 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __LOG_BINARY_H__
+#define __LOG_BINARY_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#define LOGBIN_MAGIC            "OVLB"
+#define LOGBIN_VERSION          1
+#define LOGBIN_BLOCKSIZE        4096      // Block size [bytes]
+#define LOGBIN_HEADERSIZE       24        // Block header size [bytes]
+#define LOGBIN_MAXTAGS          64        // Max tags defined per block
+#define LOGBIN_MAXMSG           2048      // Max message length [bytes], longer messages are truncated
+
+/**
+ * Binary log file format
+ *
+ *  The file is a sequence of fixed size blocks, each block can be decoded on
+ *  its own. This makes the block index implicit: block n starts at file
+ *  offset n * LOGBIN_BLOCKSIZE, its header holds the time of the first
+ *  record. A time range query does a binary search on the block headers,
+ *  then scans the records from the block found.
+ *
+ *  Block header (LOGBIN_HEADERSIZE bytes, little endian):
+ *    magic "OVLB", version u8, flags u8 (LOGBIN_FLAG_*), reserved u16,
+ *    time i64 (wall time of first record [ms since epoch]),
+ *    stamp u32 (log timestamp of first record [ms since boot]), reserved u32
+ *
+ *  Records follow the header and never cross a block boundary:
+ *    head u8:    0x80 | level (0=unformatted, 1=E … 5=V)
+ *                | 0x40 if a new tag follows | 0x20 if the line had no line end
+ *    varint:     time delta to previous record [ms]
+ *    varint:     stamp delta to previous record [ms]
+ *    varint:     tag id (formatted lines only), for a new tag followed by
+ *                u8 length + tag text (ids are assigned in block order)
+ *    varint:     message length, followed by the message text
+ *  A zero head byte or the block end terminates the block.
+ *
+ *  Writing always starts a new block when a file is opened for appending, so
+ *  a partially written record (e.g. power loss) only affects its own block.
+ *
+ *  Block times normally ascend through the file, but a reboot (time starts
+ *  at 1970 until the clock is set) or a clock set backwards starts a new
+ *  ascending run of blocks. The reader scans the block headers once to find
+ *  these runs, a time range query does a binary search in each run.
+ */
+
+#define LOGBIN_FLAG_BACKSTEP    0x01      // Block started because the time ran backwards
+
+struct LogRecord
+  {
+  int64_t time = 0;               // Wall time [ms since epoch]
+  uint32_t stamp = 0;             // Log timestamp [ms since boot]
+  char level = 0;                 // 'E','W','I','D','V' or 0 = unformatted line
+  bool lineend = true;            // Line terminated by '\n'
+  const char* tag = NULL;         // Tag (not terminated, valid until next read)
+  size_t taglen = 0;
+  const char* msg = NULL;         // Message (not terminated, valid until next read)
+  size_t msglen = 0;
+  };
+
+struct LogTimeCache
+  {
+  int32_t key = -1;               // Date & hour of base
+  int64_t base = 0;               // Wall time of hour start [ms since epoch]
+  };
+
+// Text log line handling:
+bool LogParseLine(const char* line, size_t len, LogRecord& rec);
+bool LogParseTextLine(const char* line, size_t len, LogRecord& rec, LogTimeCache& cache);
+size_t LogFormatTime(char* buf, size_t size, int64_t time);
+void LogFormatLine(std::string& out, const LogRecord& rec, bool withtime=true);
+bool LogParseTime(const char* str, int64_t& time);
+
+class LogBinaryWriter
+  {
+  public:
+    LogBinaryWriter();
+    ~LogBinaryWriter();
+
+  public:
+    size_t Open(FILE* file, size_t size);
+    size_t Write(const LogRecord& rec);
+    void Close();
+
+  protected:
+    size_t StartBlock(const LogRecord& rec);
+    size_t Encode(const LogRecord& rec, int tagid);
+
+  protected:
+    FILE* m_file;
+    uint8_t* m_buf;                         // Record encoding buffer
+    uint32_t m_used;                        // Bytes used in current block, 0 = none
+    int64_t m_time;                         // Time & stamp of previous record
+    uint32_t m_stamp;
+    int m_tagcnt;                           // Tags defined in current block
+    std::string m_tags[LOGBIN_MAXTAGS];
+  };
+
+class LogBinaryReader
+  {
+  public:
+    LogBinaryReader();
+    ~LogBinaryReader();
+
+  public:
+    static bool IsBinary(const char* path);
+    bool Open(const char* path);
+    void Close();
+    bool Seek(int64_t time);
+    bool NextRun();
+    bool Read(LogRecord& rec);
+    uint32_t GetBlockCount() { return m_blocks; }
+    uint32_t GetBlocksLoaded() { return m_loaded; }
+
+  protected:
+    bool ReadHeader(uint32_t index, int64_t& time, uint8_t* flags = NULL);
+    bool LoadBlock(uint32_t index);
+    void ScanRuns();
+
+  protected:
+    FILE* m_file;
+    uint8_t* m_block;                       // Current block data
+    uint32_t m_blocks;                      // Block count
+    uint32_t m_index;                       // Current block index
+    uint32_t m_len;                         // Bytes valid in current block
+    uint32_t m_pos;                         // Read position in current block
+    uint32_t m_loaded;                      // Statistics: blocks loaded
+    std::vector<int64_t> m_btime;           // Block header times (after ScanRuns)
+    std::vector<uint32_t> m_runstart;       // First block of each ascending run
+    std::vector<uint32_t> m_seekblock;      // Seek() result per run
+    uint32_t m_run;                         // Current run (after Seek)
+    bool m_seeking;
+    int64_t m_time;
+    uint32_t m_stamp;
+    int m_tagcnt;
+    const char* m_tag[LOGBIN_MAXTAGS];
+    uint8_t m_taglen[LOGBIN_MAXTAGS];
+  };
+
+/**
+ * LogQuery: search a log file (binary or text) by time range, tag & level
+ */
+class OvmsWriter;
+struct LogQuery
+  {
+  int64_t from = INT64_MIN;               // Time range [ms since epoch]
+  int64_t to = INT64_MAX;
+  std::string tag;                        // Tag pattern (glob), empty = all
+  int level = 5;                          // Max level (1=E … 5=V)
+  uint32_t limit = 0;                     // Max lines, 0 = unlimited
+
+  // Results:
+  uint32_t lines = 0;                     // Lines output
+  uint32_t scanned = 0;                   // Records / lines examined
+  bool binary = false;                    // File format
+  };
+
+bool LogSearch(OvmsWriter* writer, const char* path, LogQuery& query);
+
+#endif //#ifndef __LOG_BINARY_H__
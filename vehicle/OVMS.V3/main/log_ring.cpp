@@ -0,0 +1,234 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include "ovms_malloc.h"
+#include "log_ring.h"
+
+// Slot sequence marker while a line is being written:
+#define LOGRING_BUSY            0x80000000
+
+
+LogRing::LogRing()
+  : m_data(NULL), m_slot(NULL), m_size(0), m_lines(0),
+    m_head(0), m_seq(0), m_total_bytes(0), m_truncated(0)
+  {
+  }
+
+LogRing::~LogRing()
+  {
+  if (m_data)
+    free(m_data);
+  if (m_slot)
+    free(m_slot);
+  }
+
+/**
+ * Init: allocate the ring
+ *  Sizes are rounded up to the next power of 2. Must be called before the
+ *  first Write(), the ring can't be resized while in use.
+ */
+bool LogRing::Init(size_t size, size_t lines)
+  {
+  if (m_data)
+    return true;
+  uint32_t sz = 4096, ln = 64;
+  while (sz < size) sz <<= 1;
+  while (ln < lines) ln <<= 1;
+  uint8_t* data = (uint8_t*) ExternalRamMalloc(sz);
+  slot_t* slot = (slot_t*) ExternalRamMalloc(ln * sizeof(slot_t));
+  if (!data || !slot)
+    {
+    if (data) free(data);
+    if (slot) free(slot);
+    return false;
+    }
+  for (uint32_t i = 0; i < ln; i++)
+    {
+    new (&slot[i].seq) std::atomic<uint32_t>(LOGRING_BUSY);
+    new (&slot[i].pos) std::atomic<uint32_t>(0);
+    new (&slot[i].len) std::atomic<uint32_t>(0);
+    new (&slot[i].stamp) std::atomic<uint32_t>(0);
+    }
+  m_size = sz;
+  m_lines = ln;
+  m_slot = slot;
+  m_data = data;
+  return true;
+  }
+
+/**
+ * Write: format a log line into the ring
+ *  The prefix (may be NULL) is prepended to the formatted text.
+ *  CR/LF except at the end are replaced by '|' (an escape sequence to change
+ *  the color may follow the final line end).
+ *  @return     length of the line, -1 if not allocated
+ */
+int LogRing::Write(uint32_t stamp, const char* prefix, const char* fmt, va_list args)
+  {
+  if (!m_data)
+    return -1;
+
+  va_list args2;
+  va_copy(args2, args);
+  int plen = prefix ? strlen(prefix) : 0;
+  int flen = vsnprintf(NULL, 0, fmt, args2);
+  va_end(args2);
+  if (flen < 0)
+    return flen;
+  int len = plen + flen;
+  if (len > LOGRING_MAXLINE - 1)
+    {
+    len = LOGRING_MAXLINE - 1;
+    m_truncated++;
+    }
+
+  // Reserve data space, skip the rest of the area if the line doesn't fit:
+  uint32_t need = (len + 1 + 3) & ~3;
+  uint32_t head = m_head.load(std::memory_order_relaxed);
+  uint32_t pos;
+  do
+    {
+    pos = head;
+    uint32_t off = pos & (m_size - 1);
+    if (off + need > m_size)
+      pos += m_size - off;
+    } while (!m_head.compare_exchange_weak(head, pos + need,
+               std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  // Take the slot from readers:
+  uint32_t seq = m_seq.fetch_add(1, std::memory_order_acq_rel);
+  slot_t& slot = m_slot[seq & (m_lines - 1)];
+  slot.seq.store(seq ^ LOGRING_BUSY, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  char* buffer = (char*) m_data + (pos & (m_size - 1));
+  if (plen > len)
+    plen = len;
+  if (plen)
+    memcpy(buffer, prefix, plen);
+  int n = vsnprintf(buffer + plen, len - plen + 1, fmt, args);
+  if (n >= 0 && n < len - plen)
+    len = plen + n;
+
+  // Replace CR/LF except last by "|", but don't leave '|' at the end.
+  // An ESC sequence to change color may be appended after the log text.
+  // Note: scan is bounded by our reservation, a writer lapping us while
+  //  we're preempted may overwrite the terminator (readers drop the line).
+  char* end = buffer + len;
+  for (char* s = buffer; s < end; s++)
+    {
+    if (*s=='\r' || *s=='\n')
+      {
+      char *t = s;
+      if (s+1 < end && *(s+1) == '\033')
+        ++s;
+      else if (s+1 < end)
+        {
+        *s = '|';
+        continue;
+        }
+      while (t > buffer && *(t-1) == '|')
+        --t;
+      memmove(t, s, end - s);
+      len -= s - t;
+      break;
+      }
+    }
+  buffer[len] = '\0';
+
+  // Commit:
+  slot.pos.store(pos, std::memory_order_relaxed);
+  slot.len.store(len, std::memory_order_relaxed);
+  slot.stamp.store(stamp, std::memory_order_relaxed);
+  slot.seq.store(seq, std::memory_order_release);
+  m_total_bytes += len;
+  return len;
+  }
+
+/**
+ * Attach: set cursor to the next line written
+ */
+void LogRing::Attach(LogRingCursor& cursor)
+  {
+  cursor.seq = GetNextSeq();
+  cursor.lost = 0;
+  }
+
+/**
+ * Read: copy the next line at the cursor
+ *  Returns false if no line is available (yet).
+ */
+bool LogRing::Read(LogRingCursor& cursor, std::string& line, uint32_t* stamp /*=NULL*/)
+  {
+  if (!m_data)
+    return false;
+  for (;;)
+    {
+    uint32_t next = GetNextSeq();
+    if (cursor.seq == next)
+      return false;
+    if (next - cursor.seq > m_lines)
+      {
+      // Overrun: skip to the oldest line likely to still be there
+      uint32_t skip = next - cursor.seq - m_lines + m_lines / 8;
+      cursor.lost += skip;
+      cursor.seq += skip;
+      }
+
+    slot_t& slot = m_slot[cursor.seq & (m_lines - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != cursor.seq)
+      {
+      // Line still being written, or slot already reused:
+      if (GetNextSeq() - cursor.seq > m_lines)
+        continue;
+      return false;
+      }
+
+    uint32_t pos = slot.pos.load(std::memory_order_relaxed);
+    uint32_t len = slot.len.load(std::memory_order_relaxed);
+    uint32_t st = slot.stamp.load(std::memory_order_relaxed);
+    uint32_t off = pos & (m_size - 1);
+    bool valid = (len < LOGRING_MAXLINE && off + len <= m_size);
+    if (valid)
+      line.assign((const char*) m_data + off, len);
+
+    // Check the slot & data haven't been reused while copying:
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || slot.seq.load(std::memory_order_relaxed) != cursor.seq
+        || m_head.load(std::memory_order_relaxed) - pos > m_size)
+      {
+      cursor.lost++;
+      cursor.seq++;
+      continue;
+      }
+
+    if (stamp)
+      *stamp = st;
+    cursor.seq++;
+    return true;
+    }
+  }
@@ -0,0 +1,102 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Date:          18th October 2026
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __LOG_RING_H__
+#define __LOG_RING_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <atomic>
+#include <string>
+
+#define LOGRING_MAXLINE         1024      // Max line length [bytes], longer lines are truncated
+
+/**
+ * LogRing: fixed size multi producer / multi reader ring of log lines
+ *
+ *  Lines are formatted once, directly into the ring. Each reader follows
+ *  the lines at its own cursor (sequence number), so there is no per line
+ *  allocation or reference counting for the consoles & file logger.
+ *
+ *  The ring consists of a data area (text, 4 byte aligned, not wrapping
+ *  around the end) and a slot table indexed by sequence number. Writers
+ *  reserve data space & a sequence number by atomic operations on the
+ *  head counters, which need to be in internal RAM. Data & slots only need
+ *  plain loads & stores, so they can be in PSRAM.
+ *
+ *  A slot is committed by storing its sequence number last. Readers copy
+ *  the line, then check the slot & data haven't been reused meanwhile.
+ *  Writers never wait for readers: readers falling behind by more than
+ *  the ring capacity lose the oldest lines, the loss is counted in the
+ *  cursor. Readers wait for a line still being written (lines are passed
+ *  on in sequence order).
+ */
+
+struct LogRingCursor
+  {
+  uint32_t seq = 0;                         // Sequence number of next line
+  uint32_t lost = 0;                        // Lines lost by overruns (reset by reader)
+  };
+
+class LogRing
+  {
+  public:
+    LogRing();
+    ~LogRing();
+
+  public:
+    bool Init(size_t size, size_t lines);
+    bool IsAllocated() { return m_data != NULL; }
+    int Write(uint32_t stamp, const char* prefix, const char* fmt, va_list args) __attribute__ ((format (printf, 4, 0)));
+    bool Read(LogRingCursor& cursor, std::string& line, uint32_t* stamp = NULL);
+    void Attach(LogRingCursor& cursor);
+    uint32_t GetNextSeq() { return m_seq.load(std::memory_order_acquire); }
+
+  public:
+    size_t GetSize() { return m_size; }
+    size_t GetLines() { return m_lines; }
+    uint32_t GetTotalBytes() { return m_total_bytes; }
+    uint32_t GetTruncated() { return m_truncated; }
+
+  protected:
+    struct slot_t
+      {
+      std::atomic<uint32_t> seq;            // Sequence number of line (committed)
+      std::atomic<uint32_t> pos;            // Data position (head counter value)
+      std::atomic<uint32_t> len;            // Text length
+      std::atomic<uint32_t> stamp;          // Log timestamp [ms]
+      };
+
+  protected:
+    uint8_t* m_data;                        // Line data (PSRAM)
+    slot_t* m_slot;                         // Line slots (PSRAM)
+    uint32_t m_size;                        // Data size [bytes], power of 2
+    uint32_t m_lines;                       // Slot count, power of 2
+    std::atomic<uint32_t> m_head;           // Data position of next line
+    std::atomic<uint32_t> m_seq;            // Sequence number of next line
+    uint32_t m_total_bytes;                 // Statistics (not synchronized)
+    uint32_t m_truncated;
+  };
+
+#endif //#ifndef __LOG_RING_H__
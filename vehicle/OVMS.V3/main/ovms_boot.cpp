@@ -543,6 +543,7 @@ void Boot::Restart(bool hard)
 
   if (hard)
     {
+    MyConfig.Flush();
     esp_restart();
     return;
     }
@@ -656,6 +656,83 @@ void log_expire(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
   MyCommandApp.ExpireLogFiles(verbosity, writer, keepdays);
   }
 
+void log_show(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  std::string path = MyCommandApp.GetLogfile();
+  LogQuery query;
+  for (int i = 0; i < argc; i++)
+    {
+    if (strncmp(argv[i], "--", 2) != 0)
+      {
+      path = argv[i];
+      continue;
+      }
+    // option value: "--opt=val" or "--opt val"
+    std::string opt = argv[i] + 2;
+    std::string val;
+    size_t eq = opt.find('=');
+    if (eq != std::string::npos)
+      {
+      val = opt.substr(eq+1);
+      opt.resize(eq);
+      }
+    else if (i+1 < argc)
+      val = argv[++i];
+    else
+      {
+      cmd->PutUsage(writer);
+      return;
+      }
+    bool valid = true;
+    if (opt == "from")
+      valid = LogParseTime(val.c_str(), query.from);
+    else if (opt == "to")
+      valid = LogParseTime(val.c_str(), query.to);
+    else if (opt == "tag")
+      query.tag = val;
+    else if (opt == "limit")
+      query.limit = atol(val.c_str());
+    else if (opt == "level")
+      {
+      static const char* const levels[] = { "none", "error", "warn", "info", "debug", "verbose" };
+      query.level = -1;
+      for (int l = 0; l <= 5; l++)
+        {
+        if (strncasecmp(levels[l], val.c_str(), val.size()) == 0)
+          query.level = l;
+        }
+      valid = (query.level >= 0 && !val.empty());
+      }
+    else
+      valid = false;
+    if (!valid)
+      {
+      writer->printf("Error: invalid option/value '%s'\n", argv[i]);
+      return;
+      }
+    }
+
+  if (path.empty())
+    {
+    writer->puts("Error: no log file path has been set");
+    return;
+    }
+  if (MyConfig.ProtectedPath(path))
+    {
+    writer->puts("Error: protected path");
+    return;
+    }
+  uint32_t started = esp_log_timestamp();
+  if (!LogSearch(writer, path.c_str(), query))
+    {
+    writer->printf("Error: cannot read '%s'\n", path.c_str());
+    return;
+    }
+  if (verbosity >= COMMAND_RESULT_VERBOSE)
+    writer->printf("# %" PRIu32 " lines shown, %" PRIu32 " %s scanned in %" PRIu32 " ms\n",
+      query.lines, query.scanned, query.binary ? "records" : "lines", esp_log_timestamp() - started);
+  }
+
 static OvmsCommand* monitor;
 static OvmsCommand* monitor_yes;
 
@@ -828,12 +905,17 @@ OvmsCommandApp::OvmsCommandApp()
   m_logfile_path = "";
   m_logfile_size = 0;
   m_logfile_maxsize = 0;
+  m_logfile_binary = false;
   m_logtask = NULL;
   m_logtask_queue = NULL;
+  m_logtask_pending = false;
   m_logtask_dropcnt = 0;
   m_logfile_cyclecnt = 0;
   m_expiretask = 0;
 
+  if (!m_logring.Init(CONFIG_OVMS_LOGRING_SIZE * 1024, CONFIG_OVMS_LOGRING_LINES))
+    ESP_LOGE(TAG, "Unable to allocate log ring (%d kB)", CONFIG_OVMS_LOGRING_SIZE);
+
   m_root.RegisterCommand("help", "Ask for help", help, "", 0, 0, false);
   m_root.RegisterCommand("exit", "End console session", cmd_exit, "", 0, 0, false);
   OvmsCommand* cmd_log = MyCommandApp.RegisterCommand("log","LOG framework", log_status, "", 0, 0, false);
@@ -842,6 +924,12 @@ OvmsCommandApp::OvmsCommandApp()
   cmd_log->RegisterCommand("close", "Stop file logging", log_close);
   cmd_log->RegisterCommand("status", "Show logging status", log_status);
   cmd_log->RegisterCommand("expire", "Expire old log files", log_expire, "[<keepdays>]", 0, 1);
+  cmd_log->RegisterCommand("show", "Show log file lines by time, tag & level", log_show,
+    "[<vfspath>] [--from <time>] [--to <time>] [--tag <tag>] [--level <level>] [--limit <n>]\n"
+    "Default path: current log file, binary log files are searched using their block index.\n"
+    "<time>: YYYY-MM-DD[_HH:MM[:SS]], HH:MM[:SS] (today), -<n>[s|m|h|d] (ago) or epoch seconds\n"
+    "<tag>: tag or pattern, e.g. \"v-*\"\n"
+    "<level>: error|warn|info|debug|verbose (show this level and below)", 0, 11);
   OvmsCommand* level_cmd = cmd_log->RegisterCommand("level", "Set logging level", NULL, "$C [<tag>]", 0, 0, false);
   level_cmd->RegisterCommand("verbose", "Log at the VERBOSE level (5)", log_level , "[<tag>]", 0, 1);
   level_cmd->RegisterCommand("debug", "Log at the DEBUG level (4)", log_level , "[<tag>]", 0, 1);
@@ -980,21 +1068,24 @@ int OvmsCommandApp::Log(const char* fmt, ...)
 
 int OvmsCommandApp::Log(const char* fmt, va_list args)
   {
-  LogBuffers* lb;
+  int ret;
   TaskHandle_t task = xTaskGetCurrentTaskHandle();
   PartialLogs::iterator it = m_partials.find(task);
   if (it == m_partials.end())
-    lb = new LogBuffers();
+    ret = m_logring.Write(esp_log_timestamp(), NULL, fmt, args);
   else
     {
-    lb = it->second;
+    LogBuffers* lb = it->second;
     m_partials.erase(task);
+    std::string prefix;
+    for (LogBuffers::iterator i = lb->begin(); i != lb->end(); ++i)
+      prefix.append(*i);
+    delete lb;
+    ret = m_logring.Write(esp_log_timestamp(), prefix.c_str(), fmt, args);
     }
-  int ret = LogBuffer(lb, fmt, args);
-  lb->set(m_consoles.size());
   for (ConsoleSet::iterator it = m_consoles.begin(); it != m_consoles.end(); ++it)
     {
-    (*it)->Log(lb);
+    (*it)->LogNotify();
     }
   return ret;
   }
@@ -1015,45 +1106,15 @@ int OvmsCommandApp::LogPartial(const char* fmt, ...)
     }
   va_list args;
   va_start(args, fmt);
-  int ret = LogBuffer(lb, fmt, args);
+  int ret = lb->append(fmt, args);
   va_end(args);
   return ret;
   }
 
-int OvmsCommandApp::LogBuffer(LogBuffers* lb, const char* fmt, va_list args)
-  {
-  char *buffer;
-  int ret = vasprintf(&buffer, fmt, args);
-  if (ret < 0) return ret;
-
-  // Replace CR/LF except last by "|", but don't leave '|' at the end.
-  // An ESC sequence to change color may be appended after the log text.
-  char* s;
-  for (s=buffer; *s; s++)
-    {
-    if (*s=='\r' || *s=='\n')
-      {
-      char *t = s;
-      if (*(s+1) == '\033')
-        ++s;
-      else if (*(s+1) != '\0')
-        {
-        *s = '|';
-        continue;
-        }
-      while (t > buffer && *(t-1) == '|')
-        --t;
-      while ((*t++ = *s++)) ;
-      break;
-      }
-    }
-
-  lb->append(buffer);
-  return ret;
-  }
-
 int OvmsCommandApp::HexDump(const char* tag, const char* prefix, const char* data, size_t length, size_t colsize /*=16*/)
   {
+#if LOG_LOCAL_LEVEL >= ESP_LOG_VERBOSE
+  // Only format if the output isn't compiled out (used in data paths, e.g. PPP)
   char* buffer = NULL;
   int rlength = (int)length;
 
@@ -1066,6 +1127,7 @@ int OvmsCommandApp::HexDump(const char* tag, const char* prefix, const char* dat
 
   if (buffer)
     free(buffer);
+#endif
   return length;
   }
 
@@ -1096,12 +1158,11 @@ struct LogTaskCmd
   {
   enum
     {
-    LTC_Log,          // write data.logbuffers to file
+    LTC_Log,          // write new log ring lines to file
     LTC_Exit,         // close file, give data.cmdack, exit
     } type;
   union
     {
-    LogBuffers*       logbuffers;
     OvmsSemaphore*    cmdack;
     } data;
   };
@@ -1134,46 +1195,56 @@ void OvmsCommandApp::LogTask()
       // cmd received:
       if (cmd.type == LogTaskCmd::LTC_Log)
         {
-        // write logbuffers messages:
-        for (auto it = cmd.data.logbuffers->begin(); it != cmd.data.logbuffers->end(); it++)
+        // write new log ring lines:
+        m_logtask_pending = false;
+        std::string& le = m_logtask_line;
+        uint32_t ringstamp;
+        while (LogRead(m_logtask_cursor, le, &ringstamp))
           {
-          std::string le = stripesc(*it);
-          if (*(le.data() + 1) == ' ' && *(le.data() + 2) == '(')
+          le.resize(stripesc(&le[0], le.size()));
+          LogRecord rec;
+          rec.stamp = ringstamp;
+          bool formatted = LogParseLine(le.data(), le.size(), rec);
+          struct timeval stamp;
+          stamp.tv_sec = rec.stamp / 1000;
+          stamp.tv_usec = (rec.stamp % 1000) * 1000;
+          // If 10 seconds have elapsed since the previous log message or if a
+          // real base time hasn't been set yet, recalculate the correspondence
+          // of real time to system time.
+          if (formatted &&
+              (stamp.tv_sec - m_logtask_laststamp > 10 || m_logtask_basetime.tv_sec < 1609459200))
             {
-            struct timeval stamp;
-            stamp.tv_sec = atoi(le.data() + 3);
-            stamp.tv_usec = (stamp.tv_sec % 1000) * 1000;
-            stamp.tv_sec /= 1000;
-            // If 10 seconds have elapsed since the previous log message or if a
-            // real base time hasn't been set yet, recalculate the correspondence
-            // of real time to system time.
-            if (stamp.tv_sec - m_logtask_laststamp > 10 || m_logtask_basetime.tv_sec < 1609459200)
-              {
-              struct timeval daytime, uptime;
-              gettimeofday(&daytime, NULL);
-              uptime.tv_sec = xTaskGetTickCount();
-              uptime.tv_usec = (uptime.tv_sec % 100) * 10000;
-              uptime.tv_sec /= 100;
-              daytime.tv_usec -= daytime.tv_usec % 10000;       // Always show 0 for ms units
-              timersub(&daytime, &uptime, &m_logtask_basetime);
-              }
+            struct timeval daytime, uptime;
+            gettimeofday(&daytime, NULL);
+            uptime.tv_sec = xTaskGetTickCount();
+            uptime.tv_usec = (uptime.tv_sec % 100) * 10000;
+            uptime.tv_sec /= 100;
+            daytime.tv_usec -= daytime.tv_usec % 10000;       // Always show 0 for ms units
+            timersub(&daytime, &uptime, &m_logtask_basetime);
+            }
+          if (formatted)
             m_logtask_laststamp = stamp.tv_sec;
-            // write timestamp:
-            timeradd(&m_logtask_basetime, &stamp, &stamp);
-            struct tm tmu;
-            localtime_r(&stamp.tv_sec, &tmu);
-            strftime(tb, sizeof(tb), "%Y-%m-%d %H:%M:%S", &tmu);
-            m_logfile_size += fwrite(tb, 1, strlen(tb), m_logfile);
-            snprintf(tb, sizeof(tb), ".%03lu ", stamp.tv_usec / 1000);
-            int len = strlen(tb);
-            strftime(tb+len, sizeof(tb)-len, "%Z ", &tmu);
-            m_logfile_size += fwrite(tb, 1, strlen(tb), m_logfile);
+          timeradd(&m_logtask_basetime, &stamp, &stamp);
+          rec.time = (int64_t)stamp.tv_sec * 1000 + stamp.tv_usec / 1000;
+
+          if (m_logfile_binary)
+            {
+            m_logfile_size += m_logfile_writer.Write(rec);
+            }
+          else
+            {
+            // write timestamp & log entry:
+            if (formatted)
+              m_logfile_size += fwrite(tb, 1, LogFormatTime(tb, sizeof(tb), rec.time), m_logfile);
+            m_logfile_size += fwrite(le.data(), 1, le.size(), m_logfile);
             }
-          // write log entry:
-          m_logfile_size += fwrite(le.data(), 1, le.size(), m_logfile);
           m_logtask_linecnt++;
           }
-        cmd.data.logbuffers->release();
+        if (m_logtask_cursor.lost)
+          {
+          m_logtask_dropcnt += m_logtask_cursor.lost;
+          m_logtask_cursor.lost = 0;
+          }
 
         // check file size:
         if (m_logfile_maxsize && m_logfile_size > (m_logfile_maxsize*1024))
@@ -1217,16 +1288,13 @@ void OvmsCommandApp::LogTask()
     }
 
   // cleanup & terminate:
+  m_logfile_writer.Close();
   if (m_logfile)
     fclose(m_logfile);
   LogTaskCmd drop;
   while (xQueueReceive(m_logtask_queue, (void*)&drop, 0) == pdTRUE)
     {
-    if (drop.type == LogTaskCmd::LTC_Log)
-      {
-      drop.data.logbuffers->release();
-      }
-    else if (drop.type == LogTaskCmd::LTC_Exit)
+    if (drop.type == LogTaskCmd::LTC_Exit)
       {
       if (drop.data.cmdack)
         drop.data.cmdack->Give();
@@ -1266,6 +1334,8 @@ bool OvmsCommandApp::StartLogTask(FILE* file)
     return false;
     }
   // register as logging console:
+  m_logtask_pending = false;
+  LogAttach(m_logtask_cursor);
   SetMonitoring(true);
   MyCommandApp.RegisterConsole(this);
   return true;
@@ -1327,6 +1397,15 @@ bool OvmsCommandApp::OpenLogfile()
   else
     m_logfile_size = 0;
 
+  // archive existing file on format change:
+  m_logfile_binary = (MyConfig.GetParamValue("log", "file.format") == "binary");
+  if (m_logfile_size > 0 && LogBinaryReader::IsBinary(m_logfile_path.c_str()) != m_logfile_binary)
+    {
+    ESP_LOGI(TAG, "OpenLogfile: log format changed to %s", m_logfile_binary ? "binary" : "text");
+    if (ArchiveLogfile())
+      m_logfile_size = 0;
+    }
+
   // open file, start task:
   FILE* file = fopen(m_logfile_path.c_str(), "a+");
   if (file == NULL)
@@ -1334,6 +1413,8 @@ bool OvmsCommandApp::OpenLogfile()
     ESP_LOGE(TAG, "OpenLogfile: cannot open '%s'", m_logfile_path.c_str());
     return false;
     }
+  if (m_logfile_binary)
+    m_logfile_size += m_logfile_writer.Open(file, m_logfile_size);
   if (!StartLogTask(file))
     {
     ESP_LOGE(TAG, "OpenLogfile: cannot start log task on '%s'", m_logfile_path.c_str());
@@ -1372,13 +1453,8 @@ bool OvmsCommandApp::SetLogfile(std::string path)
   return true;
   }
 
-bool OvmsCommandApp::CycleLogfile()
+bool OvmsCommandApp::ArchiveLogfile()
   {
-  if (!m_logfile || m_logfile_path.empty())
-    return false;
-  fclose(m_logfile);
-  m_logfile = NULL;
-
   char ts[20];
   time_t tm = time(NULL);
   struct tm timeinfo;
@@ -1387,33 +1463,40 @@ bool OvmsCommandApp::CycleLogfile()
   archpath.append(ts);
   if (rename(m_logfile_path.c_str(), archpath.c_str()) == 0)
     {
-    ESP_LOGI(TAG, "CycleLogfile: log file '%s' archived as '%s'", m_logfile_path.c_str(), archpath.c_str());
-    m_logfile_cyclecnt++;
+    ESP_LOGI(TAG, "ArchiveLogfile: log file '%s' archived as '%s'", m_logfile_path.c_str(), archpath.c_str());
+    return true;
     }
   else
     {
-    ESP_LOGE(TAG, "CycleLogfile: rename log file '%s' to '%s' failed", m_logfile_path.c_str(), archpath.c_str());
+    ESP_LOGE(TAG, "ArchiveLogfile: rename log file '%s' to '%s' failed", m_logfile_path.c_str(), archpath.c_str());
+    return false;
     }
+  }
+
+bool OvmsCommandApp::CycleLogfile()
+  {
+  if (!m_logfile || m_logfile_path.empty())
+    return false;
+  m_logfile_writer.Close();
+  fclose(m_logfile);
+  m_logfile = NULL;
+
+  if (ArchiveLogfile())
+    m_logfile_cyclecnt++;
 
   return OpenLogfile();
   }
 
-void OvmsCommandApp::Log(LogBuffers* msg)
+void OvmsCommandApp::LogNotify()
   {
-  if (!m_logtask || !m_logtask_queue)
-    {
-    msg->release();
+  if (!m_logtask || !m_logtask_queue || m_logtask_pending.exchange(true))
     return;
-    }
-  // send to LogTask:
+  // wake up LogTask:
   LogTaskCmd cmd;
   cmd.type = LogTaskCmd::LTC_Log;
-  cmd.data.logbuffers = msg;
+  cmd.data.cmdack = NULL;
   if (xQueueSend(m_logtask_queue, &cmd, 0) != pdTRUE)
-    {
-    m_logtask_dropcnt++;
-    msg->release();
-    }
+    m_logtask_pending = false;
   }
 
 void OvmsCommandApp::SetLoglevel(std::string tag, std::string level)
@@ -1536,21 +1619,26 @@ void OvmsCommandApp::ShowLogStatus(int verbosity, OvmsWriter* writer)
     "Log listeners      : %u\n"
     "File logging status: %s\n"
     "  Log file path    : %s\n"
+    "  Log file format  : %s\n"
     "  Current size     : %.1f kB\n"
     "  Cycle size       : %u kB\n"
     "  Cycle count      : %" PRIu32 "\n"
     "  Dropped messages : %" PRIu32 "\n"
     "  Messages logged  : %" PRIu32 "\n"
     "  Total fsync time : %.1f s\n"
+    "Log ring           : %u kB, %u lines, %" PRIu32 " lines written, %" PRIu32 " truncated\n"
     , m_consoles.size()
     , m_logfile ? "active" : "inactive"
     , m_logfile_path.empty() ? "-" : m_logfile_path.c_str()
+    , m_logfile_binary ? "binary" : "text"
     , (float) m_logfile_size / 1024.0f
     , m_logfile_maxsize
     , m_logfile_cyclecnt
     , m_logtask_dropcnt
     , m_logtask_linecnt
-    , m_logtask_fsynctime / 1e6);
+    , m_logtask_fsynctime / 1e6
+    , m_logring.GetSize() / 1024, m_logring.GetLines()
+    , m_logring.GetNextSeq(), m_logring.GetTruncated());
   }
 
 void OvmsCommandApp::EventHandler(std::string event, void* data)
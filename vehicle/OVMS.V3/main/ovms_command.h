@@ -37,10 +37,13 @@
 #include <set>
 #include <list>
 #include <functional>
+#include <atomic>
 #include <limits.h>
 #include "ovms.h"
 #include "ovms_utils.h"
 #include "ovms_mutex.h"
+#include "log_ring.h"
+#include "log_binary.h"
 #include "task_base.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -72,7 +75,7 @@ class OvmsWriter
     virtual char** GetCompletions(int &common_len, bool &finished ) { return NULL; }
     virtual void SetArgv(const char* const* argv) { return; }
     virtual const char* const* GetArgv() { return NULL; }
-    virtual void Log(LogBuffers* message) {};
+    virtual void LogNotify() {}
     virtual void Exit();
     virtual bool IsInteractive() { return true; }
     void RegisterInsertCallback(InsertCallback cb, void* ctx);
@@ -370,6 +373,7 @@ class OvmsCommandApp : public OvmsWriter
     bool CloseLogfile();
     bool SetLogfile(std::string path);
     std::string GetLogfile() { return m_logfile_path; }
+    bool IsLogfileBinary() { return m_logfile_binary; }
     void SetLoglevel(std::string tag, std::string level);
     void ExpireLogFiles(int verbosity, OvmsWriter* writer, int keepdays);
     void ShowLogStatus(int verbosity, OvmsWriter* writer);
@@ -377,28 +381,36 @@ class OvmsCommandApp : public OvmsWriter
     void EventHandler(std::string event, void* data);
 
   private:
+    bool ArchiveLogfile();
     bool CycleLogfile();
     void ReadConfig();
 
     OvmsCommand* CheckCreateUsr(OvmsCommand *, bool allow_create_user);
-  private:
-    int LogBuffer(LogBuffers* lb, const char* fmt, va_list args) __attribute__ ((format (printf, 3, 0)));
-
   public:
-    void Log(LogBuffers* message);
+    void LogNotify();
+    void LogAttach(LogRingCursor& cursor) { m_logring.Attach(cursor); }
+    bool LogRead(LogRingCursor& cursor, std::string& line, uint32_t* stamp = NULL)
+      { return m_logring.Read(cursor, line, stamp); }
+    bool LogPending(const LogRingCursor& cursor) { return cursor.seq != m_logring.GetNextSeq(); }
 
   private:
     OvmsCommand m_root;
     typedef std::set<OvmsWriter*> ConsoleSet;
     ConsoleSet m_consoles;
     PartialLogs m_partials;
+    LogRing m_logring;
     FILE* m_logfile;
     std::string m_logfile_path;
     size_t m_logfile_size;
     size_t m_logfile_maxsize;
+    bool m_logfile_binary;
+    LogBinaryWriter m_logfile_writer;
     TaskHandle_t m_logtask;
     OvmsMutex m_logtask_mutex;
     QueueHandle_t m_logtask_queue;
+    std::atomic<bool> m_logtask_pending;
+    LogRingCursor m_logtask_cursor;
+    std::string m_logtask_line;
     uint32_t m_logtask_dropcnt;
     uint32_t m_logfile_cyclecnt;
     uint32_t m_logtask_linecnt;
@@ -46,6 +46,7 @@ static const char *TAG = "config";
 #include "ovms_boot.h"
 #include "ovms_semaphore.h"
 #include "ovms_vfs.h"
+#include "ovms.h"
 
 #ifdef CONFIG_OVMS_SC_ZIP
 #include "zip_archive.h"
@@ -53,6 +54,7 @@ static const char *TAG = "config";
 
 #define OVMS_CONFIGPATH "/store/ovms_config"
 #define OVMS_MAXVALSIZE 2500
+#define OVMS_WRITEDELAY 2         // Default write coalescing delay [s]
 //#define OVMS_PERSIST_METADATA
 
 
@@ -226,6 +228,17 @@ void config_restore(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
   }
 #endif // CONFIG_OVMS_SC_ZIP
 
+void config_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  MyConfig.Status(writer);
+  }
+
+void config_flush(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  MyConfig.Flush();
+  writer->puts("Config written.");
+  }
+
 #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
 
 static duk_ret_t DukOvmsConfigParams(duk_context *ctx)
@@ -394,6 +407,14 @@ OvmsConfig::OvmsConfig()
   ESP_LOGI(TAG, "Initialising CONFIG (1400)");
 
   m_mounted = false;
+  m_generation = 1;
+  m_transaction_owner = NULL;
+  m_transaction_depth = 0;
+  m_flush_due = 0;
+  m_stat_changes = 0;
+  m_stat_events = 0;
+  m_stat_writes = 0;
+  m_stat_bytes = 0;
 
   OvmsCommand* cmd_store = MyCommandApp.RegisterCommand("store","STORE framework");
   cmd_store->RegisterCommand("mount","Mount STORE",store_mount);
@@ -403,6 +424,8 @@ OvmsConfig::OvmsConfig()
   cmd_config->RegisterCommand("list","Show configuration parameters/instances",config_list,"[<param>]",0,1, true, config_validate);
   cmd_config->RegisterCommand("set","Set parameter:instance=value",config_set,"<param> <instance> <value>",3,3, true, config_validate);
   cmd_config->RegisterCommand("rm","Remove parameter:instance",config_rm,"<param> {<instance> | *}",2,2, true, config_validate);
+  cmd_config->RegisterCommand("status","Show config store write statistics",config_status);
+  cmd_config->RegisterCommand("flush","Write pending config changes now",config_flush);
 
 #ifdef CONFIG_OVMS_SC_ZIP
   cmd_config->RegisterCommand("backup", "Backup to file", config_backup,
@@ -425,6 +448,13 @@ OvmsConfig::OvmsConfig()
   RegisterParam("module", "Module configuration", true, true);
   RegisterParam("usr", "Custom plugin configuration", true, true);
 
+  #undef bind  // Kludgy, but works
+  using std::placeholders::_1;
+  using std::placeholders::_2;
+  MyEvents.RegisterEvent(TAG, "ticker.1", std::bind(&OvmsConfig::EventListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "system.shuttingdown", std::bind(&OvmsConfig::EventListener, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "system.shutdown", std::bind(&OvmsConfig::EventListener, this, _1, _2));
+
   #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   DuktapeObjectRegistration* dto = new DuktapeObjectRegistration("OvmsConfig");
   dto->RegisterDuktapeFunction(DukOvmsConfigParams, 0, "Params");
@@ -478,14 +508,41 @@ esp_err_t OvmsConfig::mount()
     ESP_LOGE(TAG, "Error: Cannot open config store directory");
     return ESP_ERR_NOT_FOUND;
     }
+  std::vector<std::string> tmpfiles;
   while ((dp = readdir(dir)) != NULL)
     {
+    // Collect leftovers of interrupted writes for recovery:
+    if (endsWith(std::string(dp->d_name), ".tmp"))
+      {
+      tmpfiles.push_back(dp->d_name);
+      continue;
+      }
     // Register the param in case this was not already done
     if (CachedParam(dp->d_name) == NULL)
       RegisterParam(dp->d_name, "", true, false);
     }
   closedir(dir);
 
+  // Recover interrupted writes: the temp file is complete if the
+  // original has already been removed, else the original is valid:
+  for (auto& tmpname : tmpfiles)
+    {
+    std::string tmppath = std::string(OVMS_CONFIGPATH "/") + tmpname;
+    std::string name = tmpname.substr(0, tmpname.size()-4);
+    std::string path = std::string(OVMS_CONFIGPATH "/") + name;
+    if (!path_exists(path) && rename(tmppath.c_str(), path.c_str()) == 0)
+      {
+      ESP_LOGW(TAG, "Recovered interrupted write of '%s'", name.c_str());
+      if (CachedParam(name) == NULL)
+        RegisterParam(name, "", true, false);
+      }
+    else
+      {
+      ESP_LOGW(TAG, "Discarding incomplete write of '%s'", name.c_str());
+      unlink(tmppath.c_str());
+      }
+    }
+
   // load & upgrade params:
   for (ConfigMap::iterator it=MyConfig.m_map.begin(); it!=MyConfig.m_map.end(); ++it)
     {
@@ -493,6 +550,7 @@ esp_err_t OvmsConfig::mount()
     }
   upgrade();
 
+  Invalidate();
   MyEvents.SignalEvent("config.mounted", NULL);
   return ESP_OK;
   }
@@ -504,12 +562,14 @@ esp_err_t OvmsConfig::unmount()
 
   if (m_mounted)
     {
+    Flush();
 #if ESP_IDF_VERSION_MAJOR >= 5
     esp_vfs_fat_spiflash_unmount_rw_wl("/store", m_store_wlh);
 #else
     esp_vfs_fat_spiflash_unmount("/store", m_store_wlh);
 #endif
     m_mounted = false;
+    Invalidate();
     MyEvents.SignalEvent("config.unmounted", NULL);
     }
 
@@ -521,6 +581,171 @@ bool OvmsConfig::ismounted()
   return m_mounted;
   }
 
+/**
+ * Write coalescing & transactions:
+ *  ParamChanged() marks a param for rewrite and schedules the write
+ *  module/config.writedelay seconds later (0 = write immediately). Within a
+ *  transaction, writes and config.changed events are deferred until the
+ *  outermost Commit(), so each changed param is written and signalled once.
+ *  A transaction belongs to the task that opened it: changes done by other
+ *  tasks are written & signalled as usual, and other tasks beginning a
+ *  transaction block until the owner commits.
+ */
+void OvmsConfig::BeginTransaction()
+  {
+  m_transaction_lock.Lock();
+  OvmsMutexLock lock(&m_pending_lock);
+  m_transaction_owner = xTaskGetCurrentTaskHandle();
+  m_transaction_depth++;
+  }
+
+void OvmsConfig::Commit()
+  {
+  std::vector<OvmsConfigParam*> signal;
+    {
+    OvmsMutexLock lock(&m_pending_lock);
+    if (m_transaction_depth == 0 || m_transaction_owner != xTaskGetCurrentTaskHandle())
+      {
+      ESP_LOGE(TAG, "Commit: no transaction open by this task");
+      return;
+      }
+    if (--m_transaction_depth > 0)
+      {
+      m_transaction_lock.Unlock();
+      return;
+      }
+    m_transaction_owner = NULL;
+    for (auto& it : m_map)
+      {
+      if (it.second->m_event_pending)
+        {
+        it.second->m_event_pending = false;
+        signal.push_back(it.second);
+        }
+      }
+    }
+
+  Flush();
+  m_transaction_lock.Unlock();
+
+  for (OvmsConfigParam* param : signal)
+    {
+    m_stat_events++;
+    MyEvents.SignalEvent("config.changed", param);
+    }
+  }
+
+void OvmsConfig::ParamChanged(OvmsConfigParam* param, bool write /*=true*/)
+  {
+  Invalidate();
+
+  bool signal;
+  bool flush = false;
+    {
+    OvmsMutexLock lock(&m_pending_lock);
+    bool deferred = (m_transaction_depth > 0 &&
+                     m_transaction_owner == xTaskGetCurrentTaskHandle());
+    m_stat_changes++;
+    if (write)
+      {
+      param->m_dirty = true;
+      if (!deferred)
+        {
+        int delay = GetParamValueInt("module", "config.writedelay", OVMS_WRITEDELAY);
+        if (delay <= 0 || !m_mounted)
+          flush = true;
+        else if (m_flush_due == 0)
+          m_flush_due = monotonictime + delay;
+        }
+      }
+    signal = !deferred;
+    if (!signal)
+      param->m_event_pending = true;
+    }
+
+  if (flush)
+    Flush();
+  if (signal)
+    {
+    m_stat_events++;
+    MyEvents.SignalEvent("config.changed", param);
+    }
+  }
+
+void OvmsConfig::Flush()
+  {
+  std::vector<OvmsConfigParam*> dirty;
+    {
+    OvmsMutexLock lock(&m_pending_lock);
+    m_flush_due = 0;
+    for (auto& it : m_map)
+      {
+      if (it.second->m_dirty)
+        {
+        it.second->m_dirty = false;
+        dirty.push_back(it.second);
+        }
+      }
+    }
+
+  for (OvmsConfigParam* param : dirty)
+    param->RewriteConfig();
+  }
+
+void OvmsConfig::DiscardPending()
+  {
+  OvmsMutexLock lock(&m_pending_lock);
+  m_flush_due = 0;
+  for (auto& it : m_map)
+    it.second->m_dirty = false;
+  }
+
+void OvmsConfig::EventListener(std::string event, void* data)
+  {
+  if (event == "ticker.1")
+    {
+    if (m_flush_due && monotonictime >= m_flush_due)
+      Flush();
+    }
+  else
+    {
+    // system.shuttingdown / system.shutdown:
+    Flush();
+    }
+  }
+
+void OvmsConfig::Status(OvmsWriter* writer)
+  {
+  OvmsMutexLock lock(&m_pending_lock);
+  writer->printf("Config store: %s\n", m_mounted ? "mounted" : "not mounted");
+  writer->printf("  Write delay:   %d sec\n",
+    GetParamValueInt("module", "config.writedelay", OVMS_WRITEDELAY));
+  if (m_transaction_owner)
+    writer->printf("  Transactions:  %d open by task %s\n", m_transaction_depth,
+      pcTaskGetTaskName(m_transaction_owner));
+  else
+    writer->printf("  Transactions:  none open\n");
+  writer->printf("  Changes:       %" PRIu32 "\n", m_stat_changes);
+  writer->printf("  Events:        %" PRIu32 "\n", m_stat_events);
+  writer->printf("  File writes:   %" PRIu32 "\n", m_stat_writes);
+  writer->printf("  Bytes written: %" PRIu32 "\n", m_stat_bytes);
+  int pending = 0;
+  for (auto& it : m_map)
+    {
+    if (it.second->m_dirty)
+      {
+      if (pending++ == 0)
+        writer->printf("  Pending:      ");
+      writer->printf(" %s", it.first.c_str());
+      }
+    }
+  if (pending)
+    writer->printf(" (write in %d sec)\n",
+      m_flush_due ? (int)(m_flush_due - monotonictime) : 0);
+  else
+    writer->puts("  Pending:       none");
+  }
+
 void OvmsConfig::upgrade()
   {
   // Migrate password/changed → module/init:
@@ -609,6 +834,7 @@ void OvmsConfig::RegisterParam(std::string name, std::string title, bool writabl
     {
     OvmsConfigParam* p = new OvmsConfigParam(name, title, writable, readable);
     m_map[name] = p;
+    Invalidate();
     }
   else
     {
@@ -832,6 +1058,7 @@ bool OvmsConfig::Backup(std::string path, std::string password, OvmsWriter* writ
   else
     ESP_LOGD(TAG, "Backup: creating '%s'...", path.c_str());
 
+  Flush();
   OvmsMutexLock store_lock(&m_store_lock);
   bool ok = true;
 
@@ -900,6 +1127,7 @@ bool OvmsConfig::Restore(std::string path, std::string password, OvmsWriter* wri
     ESP_LOGD(TAG, "Restore: reading '%s'...", path.c_str());
 
   // Lock config store:
+  Flush();
   if (!m_store_lock.Lock(pdMS_TO_TICKS(5000)))
     {
     if (writer)
@@ -1003,6 +1231,9 @@ bool OvmsConfig::Restore(std::string path, std::string password, OvmsWriter* wri
     return false;
     }
 
+  // don't overwrite the restored config by pending changes:
+  DiscardPending();
+
   if (writer)
     writer->puts("Done, rebooting now...");
   else
@@ -1041,6 +1272,8 @@ OvmsConfigParam::OvmsConfigParam(std::string name, std::string title, bool writa
   m_writable = writable;
   m_readable = readable;
   m_loaded = false;
+  m_dirty = false;
+  m_event_pending = false;
 
   if (MyConfig.ismounted())
     {
@@ -1108,21 +1341,25 @@ void OvmsConfigParam::SetValue(std::string instance, std::string value)
   if (m_map.find(instance) == m_map.end() || m_map[instance] != value)
     {
     m_map[instance] = value;
-    RewriteConfig();
-    MyEvents.SignalEvent("config.changed", this);
+    MyConfig.ParamChanged(this);
     }
   }
 
 void OvmsConfigParam::DeleteParam()
   {
-  OvmsMutexLock store_lock(&MyConfig.m_store_lock);
-
-  std::string path(OVMS_CONFIGPATH);
-  path.append("/");
-  path.append(m_name);
-  unlink(path.c_str());
-  m_map.clear();
-  MyEvents.SignalEvent("config.changed", this);
+    {
+    OvmsMutexLock store_lock(&MyConfig.m_store_lock);
+    std::string path(OVMS_CONFIGPATH);
+    path.append("/");
+    path.append(m_name);
+    unlink(path.c_str());
+    m_map.clear();
+    }
+    {
+    OvmsMutexLock lock(&MyConfig.m_pending_lock);
+    m_dirty = false;
+    }
+  MyConfig.ParamChanged(this, false);
   }
 
 bool OvmsConfigParam::DeleteInstance(std::string instance)
@@ -1132,10 +1369,13 @@ bool OvmsConfigParam::DeleteInstance(std::string instance)
   if (k != m_map.end())
     {
     m_map.erase(k);
-    RewriteConfig();
+    MyConfig.ParamChanged(this);
     ret = true;
     }
-  MyEvents.SignalEvent("config.changed", this);
+  else
+    {
+    MyEvents.SignalEvent("config.changed", this);
+    }
   return ret;
   }
 
@@ -1184,12 +1424,16 @@ void OvmsConfigParam::RewriteConfig()
   {
   OvmsMutexLock store_lock(&MyConfig.m_store_lock);
 
+  // Write to a temp file and replace the original when complete; an
+  // interrupted write is recovered on the next mount (see mount()).
+  // Note: FAT does not support renaming onto an existing file.
   std::string path(OVMS_CONFIGPATH);
   path.append("/");
   path.append(m_name);
-  FILE* f = fopen(path.c_str(), "w");
+  std::string tmppath = path + ".tmp";
+  FILE* f = fopen(tmppath.c_str(), "w");
   if (!f)
-    ESP_LOGE(TAG, "RewriteConfig: can't open '%s': %s", path.c_str(), strerror(errno));
+    ESP_LOGE(TAG, "RewriteConfig: can't open '%s': %s", tmppath.c_str(), strerror(errno));
   else
     {
 #ifdef OVMS_PERSIST_METADATA
@@ -1202,8 +1446,21 @@ void OvmsConfigParam::RewriteConfig()
       {
       fprintf(f,"%s\t%s\n",it->first.c_str(),it->second.c_str());
       }
-    if (fclose(f))
-      ESP_LOGE(TAG, "RewriteConfig: error writing '%s': %s", path.c_str(), strerror(errno));
+    long size = ftell(f);
+    if (fclose(f) != 0 || size < 0)
+      {
+      ESP_LOGE(TAG, "RewriteConfig: error writing '%s': %s", tmppath.c_str(), strerror(errno));
+      unlink(tmppath.c_str());
+      }
+    else if ((unlink(path.c_str()) != 0 && errno != ENOENT) || rename(tmppath.c_str(), path.c_str()) != 0)
+      {
+      ESP_LOGE(TAG, "RewriteConfig: can't replace '%s': %s", path.c_str(), strerror(errno));
+      }
+    else
+      {
+      MyConfig.m_stat_writes++;
+      MyConfig.m_stat_bytes += size;
+      }
     }
   }
 
@@ -1216,8 +1473,7 @@ void OvmsConfigParam::Save()
   {
   if (m_name != "")
     {
-    RewriteConfig();
-    MyEvents.SignalEvent("config.changed", this);
+    MyConfig.ParamChanged(this);
     }
   }
 
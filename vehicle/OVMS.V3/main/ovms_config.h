@@ -33,6 +33,7 @@
 
 #include "string"
 #include "map"
+#include <atomic>
 #include "esp_err.h"
 #include "esp_vfs_fat.h"
 #include "wear_levelling.h"
@@ -74,6 +75,10 @@ class OvmsConfigParam
     bool m_writable;
     bool m_readable;
     bool m_loaded;
+    bool m_dirty;                       // File rewrite pending (guarded by MyConfig.m_pending_lock)
+    bool m_event_pending;               // config.changed pending until transaction commit
+
+  friend class OvmsConfig;
 
   public:
     ConfigParamMap m_map;
@@ -129,6 +134,25 @@ class OvmsConfig
   public:
     void SupportSummary(OvmsWriter* writer);
 
+  public:
+    // Config generation: changes on every param change (see ConfigHandle)
+    uint32_t GetGeneration() { return m_generation.load(std::memory_order_acquire); }
+    void Invalidate() { m_generation.fetch_add(1, std::memory_order_acq_rel); }
+
+  public:
+    // Write coalescing: changes are written after module/config.writedelay
+    // seconds; changes done by a task within its transaction are written &
+    // signalled once on commit. Transactions of different tasks are serialized.
+    void BeginTransaction();
+    void Commit();
+    void Flush();
+    void ParamChanged(OvmsConfigParam* param, bool write=true);
+    void Status(OvmsWriter* writer);
+
+  protected:
+    void DiscardPending();
+    void EventListener(std::string event, void* data);
+
   protected:
     void upgrade();
 
@@ -140,8 +164,100 @@ class OvmsConfig
   public:
     ConfigMap m_map;
     OvmsMutex m_store_lock;
+    OvmsMutex m_pending_lock;
+
+  protected:
+    std::atomic<uint32_t> m_generation;
+    OvmsRecMutex m_transaction_lock;    // Held by the transaction owner
+    TaskHandle_t m_transaction_owner;   // guarded by m_pending_lock
+    int m_transaction_depth;            // guarded by m_pending_lock
+    uint32_t m_flush_due;               // monotonictime of next write, 0 = none
+
+  public:
+    uint32_t m_stat_changes;            // Param changes
+    uint32_t m_stat_events;             // config.changed events signalled
+    uint32_t m_stat_writes;             // Files written
+    uint32_t m_stat_bytes;              // Bytes written
   };
 
 extern OvmsConfig MyConfig;
 
+/**
+ * OvmsConfigTransaction: scoped config transaction
+ */
+class OvmsConfigTransaction
+  {
+  public:
+    OvmsConfigTransaction() { MyConfig.BeginTransaction(); }
+    ~OvmsConfigTransaction() { MyConfig.Commit(); }
+  };
+
+/**
+ * ConfigHandle: cached typed access to a config instance for hot code paths
+ *
+ *  The value is parsed on first use and kept until the next config change,
+ *  so a read normally only compares the config generation. Example:
+ *
+ *    static ConfigHandle<float> cfg_maxgrad("vehicle", "bms.dev.voltage.maxgrad", 0.010);
+ *    float maxgrad = cfg_maxgrad.Get();
+ *
+ *  Param & instance need to be static strings. Supported types: int, float, bool.
+ */
+template <typename T> class ConfigHandle
+  {
+  public:
+    ConfigHandle(const char* param, const char* instance, T defvalue = T())
+      : m_param(param), m_instance(instance), m_defvalue(defvalue),
+        m_value(defvalue), m_generation(0)
+      {
+      }
+
+  public:
+    T Get()
+      {
+      if (m_generation.load(std::memory_order_acquire) != MyConfig.GetGeneration())
+        Reload();
+      return m_value.load(std::memory_order_relaxed);
+      }
+    operator T() { return Get(); }
+    void SetDefault(T defvalue)
+      {
+      m_defvalue = defvalue;
+      m_generation.store(0, std::memory_order_release);
+      }
+    const char* GetParam() { return m_param; }
+    const char* GetInstance() { return m_instance; }
+
+  protected:
+    void Reload()
+      {
+      uint32_t generation = MyConfig.GetGeneration();
+      m_value.store(Load(), std::memory_order_relaxed);
+      m_generation.store(generation, std::memory_order_release);
+      }
+    T Load();
+
+  protected:
+    const char*           m_param;
+    const char*           m_instance;
+    T                     m_defvalue;
+    std::atomic<T>        m_value;
+    std::atomic<uint32_t> m_generation;
+  };
+
+template<> inline int ConfigHandle<int>::Load()
+  {
+  return MyConfig.GetParamValueInt(m_param, m_instance, m_defvalue);
+  }
+
+template<> inline float ConfigHandle<float>::Load()
+  {
+  return MyConfig.GetParamValueFloat(m_param, m_instance, m_defvalue);
+  }
+
+template<> inline bool ConfigHandle<bool>::Load()
+  {
+  return MyConfig.GetParamValueBool(m_param, m_instance, m_defvalue);
+  }
+
 #endif //#ifndef __CONFIG_H__
@@ -34,7 +34,6 @@
 #include "ovms_log.h"
 #include "ovms_console.h"
 #include "ovms_version.h"
-#include "log_buffers.h"
 
 //static const char *TAG = "Console";
 static char CRbuf[4] = { '\r', '\033', '[', 'K' };
@@ -57,6 +56,8 @@ OvmsConsole::OvmsConsole()
   m_discarded = 0;
   m_state = AT_PROMPT;
   m_lost = m_acked = 0;
+  m_logpending = false;
+  m_logdeferred = false;
   }
 
 OvmsConsole::~OvmsConsole()
@@ -74,6 +75,7 @@ void OvmsConsole::Initialize(const char* console)
     printf("\nWelcome to the Open Vehicle Monitoring System (OVMS) - %s Console\n", console);
     printf("Firmware: %s\nHardware: %s\n",GetOVMSVersion().c_str(),GetOVMSHardware().c_str());
     ProcessChar('\n');
+    MyCommandApp.LogAttach(m_logcursor);
     MyCommandApp.RegisterConsole(this);
     }
   m_ready = true;
@@ -126,21 +128,62 @@ char** OvmsConsole::GetCompletions(int &common_len, bool &finished )
   return m_completions;
   }
 
-void OvmsConsole::Log(LogBuffers* message)
+void OvmsConsole::LogNotify()
   {
-  if (!m_ready)
-    {
-    message->release();
+  if (!m_ready || m_logpending.exchange(true))
     return;
-    }
   Event event;
-  event.type = ALERT_MULTI;
-  event.multi = message;
+  event.type = ALERT_LOG;
+  event.buffer = NULL;
   BaseType_t ret = xQueueSendToBack(m_queue, (void * )&event, 0);
   if (ret != pdPASS)
+    m_logpending = false;   // lines stay in the log ring until the next notification
+  }
+
+/**
+ * LogDisplay: output new lines from the log ring
+ */
+void OvmsConsole::LogDisplay()
+  {
+  if (!m_monitoring)
     {
-    message->release();
-    ++m_lost;
+    MyCommandApp.LogAttach(m_logcursor);
+    return;
+    }
+  while (MyCommandApp.LogRead(m_logcursor, m_logline))
+    Display(&m_logline[0], m_logline.size());
+  m_lost += m_logcursor.lost;
+  m_logcursor.lost = 0;
+  }
+
+/**
+ * Display: output a log message
+ *  We remove the newline from the end of a log message so that we can later
+ *  output a newline as part of restoring the command prompt and its line
+ *  without leaving a blank line above it.  So before we display a new log
+ *  message we need to output a newline if the last action was displaying a
+ *  log message, or output a carriage return to back over the prompt.
+ */
+void OvmsConsole::Display(const char* buffer, size_t len)
+  {
+  if (len == 0)
+    return;
+  if (m_state == AWAITING_NL)
+    write(NLbuf, 2);
+  else if (m_state == AT_PROMPT)
+    write(CRbuf, 4);
+  if (buffer[len-1] == '\n')
+    {
+    --len;
+    if (len && buffer[len-1] == '\r')  // Omit CR, too, in case of \r\n
+      --len;
+    m_state = AWAITING_NL;
+    write(buffer, len);
+    }
+  else
+    {
+    m_state = NO_NL;
+    write(buffer, len);
     }
   }
 
@@ -173,6 +216,18 @@ void OvmsConsole::Poll(portTickType ticks, QueueHandle_t queue)
         HandleDeviceEvent(&event);
         continue;
         }
+      // Log lines stay in the log ring while a command that takes input is
+      // executing, they are displayed when the command finishes.
+      if (event.type == ALERT_LOG)
+        {
+        m_logpending = false;
+        if (m_insert)
+          m_logdeferred = true;
+        else
+          LogDisplay();
+        ticks = 200 / portTICK_PERIOD_MS;
+        continue;
+        }
       // While a command that takes input is executing, put alert events into a
       // separate "deferred" queue.  If that queue fills, keep only the last N
       // events and count those discarded.
@@ -185,66 +240,14 @@ void OvmsConsole::Poll(portTickType ticks, QueueHandle_t queue)
           Event discard;
           xQueueReceive(m_deferred, (void*)&discard, 0);
           xQueueSendToBack(m_deferred, (void *)&event, 0);
-          if (discard.type == ALERT_MULTI)
-            discard.multi->release();
-          else
-            free(discard.buffer);
+          free(discard.buffer);
           ++m_discarded;
           }
         continue;
         }
-      // We remove the newline from the end of a log message so that we can later
-      // output a newline as part of restoring the command prompt and its line
-      // without leaving a blank line above it.  So before we display a new log
-      // message we need to output a newline if the last action was displaying a
-      // log message, or output a carriage return to back over the prompt.
-      if (m_monitoring &&
-        (event.type != ALERT_MULTI || event.multi->begin() != event.multi->end()))
-        {
-        if (m_state == AWAITING_NL)
-          write(NLbuf, 2);
-        else if (m_state == AT_PROMPT)
-          write(CRbuf, 4);
-        char* buffer;
-        size_t len;
-        if (event.type == ALERT_MULTI)
-          {
-          LogBuffers::iterator before = event.multi->begin(), after;
-          while (true)
-            {
-            buffer = *before;
-            len = strlen(buffer);
-            after = before;
-            ++after;
-            if (after == event.multi->end())
-              break;
-            write(buffer, len);
-            before = after;
-            }
-          }
-        else
-          {
-          buffer = event.buffer;
-          len = strlen(buffer);
-          }
-        if (buffer[len-1] == '\n')
-          {
-          --len;
-          if (buffer[len-1] == '\r')  // Omit CR, too, in case of \r\n
-            --len;
-          m_state = AWAITING_NL;
-          write(buffer, len);
-          }
-        else
-          {
-          m_state = NO_NL;
-          write(buffer, len);
-          }
-        }
-      if (event.type == ALERT_MULTI)
-        event.multi->release();
-      else
-        free(event.buffer);
+      if (m_monitoring)
+        Display(event.buffer, strlen(event.buffer));
+      free(event.buffer);
       ticks = 200 / portTICK_PERIOD_MS;
       }
     else
@@ -284,4 +287,9 @@ void OvmsConsole::finalise()
     vQueueDelete(m_deferred);
     m_deferred = NULL;
     }
+  if (m_logdeferred)
+    {
+    m_logdeferred = false;
+    LogDisplay();
+    }
   }
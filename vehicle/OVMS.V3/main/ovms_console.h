@@ -32,14 +32,16 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include <atomic>
+#include <string>
 #include "ovms_shell.h"
+#include "log_ring.h"
 
 #define TOKEN_MAX_LENGTH 32
 #define COMPLETION_MAX_TOKENS 20
 
 class OvmsCommandMap;
 class Parent;
-class LogBuffers;
 struct mbuf;
 
 class OvmsConsole : public OvmsShell
@@ -57,7 +59,7 @@ class OvmsConsole : public OvmsShell
       {
       RECV = 0x10000,
       ALERT,
-      ALERT_MULTI
+      ALERT_LOG
       } event_type_t;
 
     typedef struct
@@ -66,7 +68,6 @@ class OvmsConsole : public OvmsShell
       union
         {
         char* buffer;       // Pointer to ALERT buffer
-        LogBuffers* multi;  // Pointer to ALERT_MULTI message
         ssize_t size;       // Buffer size for RECV
         struct mbuf* mbuf;  // Buffer pointer for RECV with Mongoose
         };
@@ -83,12 +84,14 @@ class OvmsConsole : public OvmsShell
     void Initialize(const char* console);
     char** SetCompletion(int index, const char* token, bool isfinal) override;
     char** GetCompletions(int &common_len, bool &finished ) override;
-    void Log(LogBuffers* message);
+    void LogNotify() override;
     void Poll(portTickType ticks, QueueHandle_t queue = NULL);
 
   protected:
     void Service();
     void finalise();
+    void LogDisplay();
+    void Display(const char* buffer, size_t len);
 
   protected:
     virtual void HandleDeviceEvent(void* event) = 0;
@@ -105,6 +108,10 @@ class OvmsConsole : public OvmsShell
     DisplayState m_state;
     unsigned int m_lost;        // Log messages lost due to full queue
     unsigned int m_acked;       // Log messages acknowledged as lost
+    LogRingCursor m_logcursor;  // Next log ring line to display
+    std::string m_logline;      // Log ring line buffer
+    std::atomic<bool> m_logpending;   // ALERT_LOG event queued
+    bool m_logdeferred;         // Log lines held back during command input
   };
 
 #endif //#ifndef __CONSOLE_H__
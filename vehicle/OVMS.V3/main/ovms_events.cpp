@@ -34,6 +34,7 @@ static const char *TAG = "events";
 #include <string.h>
 #include <stdio.h>
 #include <esp_task_wdt.h>
+#include <esp_timer.h>
 #include "ovms_module.h"
 #include "ovms_events.h"
 #include "ovms_command.h"
@@ -58,7 +59,7 @@ static const char *TAG = "events";
 OvmsEvents MyEvents __attribute__ ((init_priority (1200)));
 
 typedef void (*event_signal_done_fn)(const char* event, void* data);
-static void CheckQueueOverflow(const char* from, char* event);
+static void CheckQueueOverflow(const char* from, const char* event);
 
 bool EventMap::GetCompletion(OvmsWriter* writer, const char* token) const
   {
@@ -106,10 +107,12 @@ void event_trace(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
 
 void event_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
-  writer->printf("Event map has %d listeners, and queue has %d/%d entries\n",
+  writer->printf("Event map has %d listeners, and queue has %d/%d entries (max %d)\n",
     MyEvents.Map().size(),
     uxQueueMessagesWaiting(MyEvents.m_taskqueue),
-    CONFIG_OVMS_HW_EVENT_QUEUE_SIZE);
+    CONFIG_OVMS_HW_EVENT_QUEUE_SIZE,
+    MyEvents.m_queue_hwm);
+  writer->printf("Event names interned: %d/%d\n", MyEvents.GetEventCount(), EVENT_ID_MAX);
 
   EventCallbackEntry* cbe = MyEvents.m_current_callback;
   if (cbe != NULL)
@@ -143,6 +146,23 @@ void event_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
   writer->printf("%s", event.c_str());
   }
 
+void event_stats(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  writer->printf("%-35s %8s %10s %10s %10s\n", "Event", "Count", "Avg[us]", "Max[us]", "MaxQ[us]");
+  for (event_id_t id = 0; id < MyEvents.GetEventCount(); id++)
+    {
+    const event_info_t* info = MyEvents.GetEventInfo(id);
+    if (!info || info->count == 0)
+      continue;
+    if (argc > 0 && strstr(info->name, argv[0]) == NULL)
+      continue;
+    writer->printf("%-35s %8" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+      info->name, info->count,
+      (uint32_t)(info->run_us_total / info->count),
+      info->run_us_max, info->queue_us_max);
+    }
+  }
+
 int event_validate(OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv, bool complete)
   {
   int argpos = 0;
@@ -206,6 +226,11 @@ OvmsEvents::OvmsEvents()
   ESP_LOGI(TAG, "Initialising EVENTS (1200)");
 
   m_current_callback = NULL;
+  m_events = (event_info_t**) ExternalRamCalloc(EVENT_ID_MAX, sizeof(event_info_t*));
+  m_events_count = 0;
+  m_events_fallback_logged = false;
+  m_wildcard = NULL;
+  m_queue_hwm = 0;
 
 #ifdef CONFIG_OVMS_DEV_DEBUGEVENTS
   m_trace = true;
@@ -224,6 +249,7 @@ OvmsEvents::OvmsEvents()
   OvmsCommand* cmd_event = MyCommandApp.RegisterCommand("event","EVENT framework", event_status, "", 0, 0, false);
   cmd_event->RegisterCommand("status","Show status of event system",event_status);
   cmd_event->RegisterCommand("list","List registered events",event_list,"[<key>]", 0, 1);
+  cmd_event->RegisterCommand("stats","Show event dispatch statistics",event_stats,"[<key>]", 0, 1);
   cmd_event->RegisterCommand("raise","Raise a textual event",event_raise,"[-d<delay_ms>] <event>", 1, 2, true, event_validate);
   OvmsCommand* cmd_eventtrace = cmd_event->RegisterCommand("trace","EVENT trace framework");
   cmd_eventtrace->RegisterCommand("on","Turn event tracing ON",event_trace);
@@ -297,6 +323,22 @@ void OvmsEvents::EventTask()
     }
   }
 
+void OvmsEvents::DispatchCallbacks(EventCallbackList* el, event_queue_t* msg)
+  {
+  if (!el)
+    return;
+  for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
+    {
+    m_current_started = monotonictime;
+    m_current_callback = *itc;
+    if (m_current_callback->m_callback)
+      {
+      m_current_callback->m_callback(m_current_event, msg->body.signal.data);
+      }
+    m_current_callback = NULL;
+    }
+  }
+
 void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
   {
   // Log everything but the ticker & clock signals
@@ -308,53 +350,46 @@ void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
       ESP_LOGD(TAG, "Signal(%s)",m_current_event.c_str());
     }
 
+  event_info_t* info = (event_info_t*) GetEventInfo(msg->body.signal.id);
+  uint32_t started = (uint32_t) esp_timer_get_time();
+
   // Run callbacks:
     {
     OvmsRecMutexLock lock(&m_map_mutex);
 
-    auto k = m_map.find(m_current_event);
-    if (k != m_map.end())
+    if (info)
       {
-      EventCallbackList* el = k->second;
-      if (el)
-        {
-        for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
-          {
-          m_current_started = monotonictime;
-          m_current_callback = *itc;
-          if (m_current_callback->m_callback)
-            {
-            m_current_callback->m_callback(m_current_event, msg->body.signal.data);
-            }
-          m_current_callback = NULL;
-          }
-        }
+      // Interned event: handlers have been resolved on registration
+      DispatchCallbacks(info->handlers, msg);
       }
-
-    k = m_map.find("*");
-    if (k != m_map.end())
+    else
       {
-      EventCallbackList* el = k->second;
-      if (el)
-        {
-        for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
-          {
-          m_current_started = monotonictime;
-          m_current_callback = *itc;
-          if (m_current_callback->m_callback)
-            {
-            m_current_callback->m_callback(m_current_event, msg->body.signal.data);
-            }
-          m_current_callback = NULL;
-          }
-        }
+      auto k = m_map.find(m_current_event);
+      if (k != m_map.end())
+        DispatchCallbacks(k->second, msg);
       }
+
+    DispatchCallbacks(m_wildcard, msg);
     }
 
   // Run scripts:
   m_current_started = monotonictime;
   MyScripts.EventScript(m_current_event, msg->body.signal.data);
 
+  // Update statistics:
+  if (info)
+    {
+    uint32_t finished = (uint32_t) esp_timer_get_time();
+    uint32_t queue_us = started - msg->body.signal.queued;
+    uint32_t run_us = finished - started;
+    info->count++;
+    info->run_us_total += run_us;
+    if (run_us > info->run_us_max)
+      info->run_us_max = run_us;
+    if (queue_us > info->queue_us_max)
+      info->queue_us_max = queue_us;
+    }
+
   FreeQueueSignalEvent(msg);
   }
 
@@ -364,9 +399,69 @@ void OvmsEvents::FreeQueueSignalEvent(event_queue_t* msg)
     {
     msg->body.signal.donefn(msg->body.signal.event, msg->body.signal.data);
     }
-  free(msg->body.signal.event);
+  if (msg->body.signal.id == EVENT_ID_NONE)
+    free((void*)msg->body.signal.event);
+  }
+
+/**
+ * InternEvent: get the ID for an event name, allocate a new ID if necessary
+ *  IDs are never released, so this should only be used for static event names.
+ *  Returns EVENT_ID_NONE if the intern table is full.
+ */
+event_id_t OvmsEvents::InternEvent(const std::string& event)
+  {
+  OvmsMutexLock lock(&m_events_mutex);
+  auto k = m_event_ids.find(event);
+  if (k != m_event_ids.end())
+    return k->second;
+  if (!m_events || m_events_count >= EVENT_ID_MAX)
+    {
+    ESP_LOGW(TAG, "InternEvent: table full, '%s' will use the string path", event.c_str());
+    return EVENT_ID_NONE;
+    }
+  event_info_t* info = (event_info_t*) ExternalRamCalloc(1, sizeof(event_info_t));
+  if (!info)
+    return EVENT_ID_NONE;
+  info->name = ExternalRamAllocated::strdup(event.c_str());
+  // Note: handlers are attached by ResolveHandlers(), as event names
+  //  get interned on handler registration
+  info->handlers = NULL;
+  event_id_t id = m_events_count.load(std::memory_order_relaxed);
+  m_events[id] = info;
+  m_event_ids[event] = id;
+  m_events_count.store(id+1, std::memory_order_release);  // publish the entry
+  return id;
   }
 
+event_id_t OvmsEvents::FindEvent(const std::string& event)
+  {
+  OvmsMutexLock lock(&m_events_mutex);
+  auto k = m_event_ids.find(event);
+  return (k != m_event_ids.end()) ? k->second : EVENT_ID_NONE;
+  }
+
+const char* OvmsEvents::GetEventName(event_id_t id)
+  {
+  return (id < GetEventCount()) ? m_events[id]->name : NULL;
+  }
+
+const event_info_t* OvmsEvents::GetEventInfo(event_id_t id)
+  {
+  return (id < GetEventCount()) ? m_events[id] : NULL;
+  }
+
+void OvmsEvents::ResolveHandlers(const std::string& event, EventCallbackList* el)
+  {
+  // Note: called with m_map_mutex locked
+  if (event == "*")
+    {
+    m_wildcard = el;
+    return;
+    }
+  event_id_t id = FindEvent(event);
+  if (id != EVENT_ID_NONE)
+    m_events[id]->handlers = el;
+  }
 
 void OvmsEvents::RegisterEvent(std::string caller, std::string event, EventCallback callback)
   {
@@ -399,6 +494,12 @@ void OvmsEvents::HandleQueueAddHandler(event_queue_t* msg)
     {
     m_map[event] = new EventCallbackList();
     k = m_map.find(event);
+    if (k != m_map.end())
+      {
+      if (event != "*")
+        InternEvent(event);
+      ResolveHandlers(event, k->second);
+      }
     }
   if (k == m_map.end())
     {
@@ -482,6 +583,7 @@ void OvmsEvents::HandleQueueRemoveHandlers(event_queue_t* msg)
       }
     if (el->empty())
       {
+      ResolveHandlers(itm->first, NULL);
       itm = m_map.erase(itm);
       delete el;
       }
@@ -494,7 +596,7 @@ void OvmsEvents::HandleQueueRemoveHandlers(event_queue_t* msg)
   free(msg->body.removehandlers.caller);
   }
 
-static void CheckQueueOverflow(const char* from, char* event)
+static void CheckQueueOverflow(const char* from, const char* event)
   {
   EventCallbackEntry* cbe = MyEvents.m_current_callback;
   if (cbe != NULL)
@@ -542,11 +644,16 @@ void OvmsEvents::SignalScheduledEvent(TimerHandle_t timer)
     }
 
   // … and pass on to event task:
+  msg->body.signal.queued = (uint32_t) esp_timer_get_time();
   if (xQueueSend(MyEvents.m_taskqueue, msg, 0) != pdTRUE)
     {
     CheckQueueOverflow("SignalScheduledEvent", msg->body.signal.event);
     MyEvents.FreeQueueSignalEvent(msg);
     }
+  else
+    {
+    MyEvents.UpdateQueueStats();
+    }
 
   delete msg;
   MyEvents.m_timer_active[timer] = false;
@@ -608,36 +715,62 @@ bool OvmsEvents::ScheduleEvent(event_queue_t* msg, uint32_t delay_ms)
   return true;
   }
 
-void OvmsEvents::SignalEvent(std::string event, void* data, event_signal_done_fn callback /*=NULL*/,
-                             uint32_t delay_ms /*=0*/)
+void OvmsEvents::UpdateQueueStats()
   {
-  event_queue_t msg;
-  memset(&msg, 0, sizeof(msg));
-
-  msg.type = EVENT_signal;
-  msg.body.signal.event = (char*)ExternalRamMalloc(event.size()+1);
-  strcpy(msg.body.signal.event, event.c_str());
-  msg.body.signal.data = data;
-  msg.body.signal.donefn = callback;
+  UBaseType_t depth = uxQueueMessagesWaiting(m_taskqueue);
+  if (depth > m_queue_hwm)
+    m_queue_hwm = depth;
+  }
 
+void OvmsEvents::PostSignalEvent(event_queue_t* msg, uint32_t delay_ms)
+  {
   if (delay_ms == 0)
     {
-    if (xQueueSend(m_taskqueue, &msg, 0) != pdTRUE)
+    msg->body.signal.queued = (uint32_t) esp_timer_get_time();
+    if (xQueueSend(m_taskqueue, msg, 0) != pdTRUE)
       {
-      CheckQueueOverflow("SignalEvent", msg.body.signal.event);
-      FreeQueueSignalEvent(&msg);
+      CheckQueueOverflow("SignalEvent", msg->body.signal.event);
+      FreeQueueSignalEvent(msg);
+      }
+    else
+      {
+      UpdateQueueStats();
       }
     }
   else
     {
-    if (ScheduleEvent(&msg, delay_ms) != true)
+    if (ScheduleEvent(msg, delay_ms) != true)
       {
-      ESP_LOGE(TAG, "SignalEvent: no timer available, event '%s' dropped", msg.body.signal.event);
-      FreeQueueSignalEvent(&msg);
+      ESP_LOGE(TAG, "SignalEvent: no timer available, event '%s' dropped", msg->body.signal.event);
+      FreeQueueSignalEvent(msg);
       }
     }
   }
 
+void OvmsEvents::SignalEvent(std::string event, void* data, event_signal_done_fn callback /*=NULL*/,
+                             uint32_t delay_ms /*=0*/)
+  {
+  event_queue_t msg;
+  memset(&msg, 0, sizeof(msg));
+
+  msg.type = EVENT_signal;
+  msg.body.signal.id = FindEvent(event);
+  if (msg.body.signal.id != EVENT_ID_NONE)
+    {
+    msg.body.signal.event = m_events[msg.body.signal.id]->name;
+    }
+  else
+    {
+    char* name = (char*)ExternalRamMalloc(event.size()+1);
+    strcpy(name, event.c_str());
+    msg.body.signal.event = name;
+    }
+  msg.body.signal.data = data;
+  msg.body.signal.donefn = callback;
+
+  PostSignalEvent(&msg, delay_ms);
+  }
+
 void OvmsEvents::SignalEvent(std::string event, void* data, size_t length,
                              uint32_t delay_ms /*=0*/)
   {
@@ -645,8 +778,17 @@ void OvmsEvents::SignalEvent(std::string event, void* data, size_t length,
   memset(&msg, 0, sizeof(msg));
 
   msg.type = EVENT_signal;
-  msg.body.signal.event = (char*)ExternalRamMalloc(event.size()+1);
-  strcpy(msg.body.signal.event, event.c_str());
+  msg.body.signal.id = FindEvent(event);
+  if (msg.body.signal.id != EVENT_ID_NONE)
+    {
+    msg.body.signal.event = m_events[msg.body.signal.id]->name;
+    }
+  else
+    {
+    char* name = (char*)ExternalRamMalloc(event.size()+1);
+    strcpy(name, event.c_str());
+    msg.body.signal.event = name;
+    }
   if (data != NULL)
     {
     msg.body.signal.data = ExternalRamMalloc(length);
@@ -659,22 +801,44 @@ void OvmsEvents::SignalEvent(std::string event, void* data, size_t length,
     msg.body.signal.donefn = NULL;
     }
 
-  if (delay_ms == 0)
+  PostSignalEvent(&msg, delay_ms);
+  }
+
+/**
+ * SignalEvent: fast path for interned events
+ *  Only the event ID is posted, no string copy or allocation is necessary.
+ *  The event name is used if the ID is invalid, i.e. if the name could not
+ *  be interned (table full).
+ */
+void OvmsEvents::SignalEvent(event_id_t id, const char* event, void* data,
+                             event_signal_done_fn callback /*=NULL*/, uint32_t delay_ms /*=0*/)
+  {
+  if (id >= GetEventCount())
     {
-    if (xQueueSend(m_taskqueue, &msg, 0) != pdTRUE)
+    if (!event)
       {
-      CheckQueueOverflow("SignalEvent", msg.body.signal.event);
-      FreeQueueSignalEvent(&msg);
+      ESP_LOGE(TAG, "SignalEvent: invalid event id %u", id);
+      return;
       }
-    }
-  else
-    {
-    if (ScheduleEvent(&msg, delay_ms) != true)
+    if (!m_events_fallback_logged)
       {
-      ESP_LOGE(TAG, "SignalEvent: no timer available, event '%s' dropped", msg.body.signal.event);
-      FreeQueueSignalEvent(&msg);
+      m_events_fallback_logged = true;
+      ESP_LOGW(TAG, "SignalEvent: event '%s' not interned, using the string path", event);
       }
+    SignalEvent(std::string(event), data, callback, delay_ms);
+    return;
     }
+
+  event_queue_t msg;
+  memset(&msg, 0, sizeof(msg));
+
+  msg.type = EVENT_signal;
+  msg.body.signal.id = id;
+  msg.body.signal.event = m_events[id]->name;
+  msg.body.signal.data = data;
+  msg.body.signal.donefn = callback;
+
+  PostSignalEvent(&msg, delay_ms);
   }
 
 #if ESP_IDF_VERSION_MAJOR >= 4
@@ -35,6 +35,7 @@
 #include <functional>
 #include <map>
 #include <list>
+#include <atomic>
 #include "esp_idf_version.h"
 #if ESP_IDF_VERSION_MAJOR >= 4
 #include <esp_event.h>
@@ -73,6 +74,21 @@ typedef void (*event_signal_done_fn)(const char* event, void* data);
 
 extern void EventStdFree(const char* event, void* data);
 
+// Interned event IDs:
+typedef uint16_t event_id_t;
+#define EVENT_ID_NONE ((event_id_t)0xffff)
+#define EVENT_ID_MAX  1024                // max number of interned event names
+
+typedef struct
+  {
+  const char* name;                       // interned name (never freed)
+  EventCallbackList* handlers;            // pre-resolved m_map entry
+  uint32_t count;                         // dispatch count
+  uint32_t queue_us_max;                  // max time from signal to dispatch
+  uint32_t run_us_max;                    // max dispatch run time
+  uint64_t run_us_total;                  // total dispatch run time
+  } event_info_t;
+
 typedef enum
   {
   EVENT_none = 0,             // Do nothing
@@ -96,9 +112,11 @@ typedef struct
       } removehandlers;
     struct
       {
-      char* event;
+      const char* event;                  // interned name or malloc'ed copy (id == EVENT_ID_NONE)
       void* data;
       event_signal_done_fn donefn;
+      event_id_t id;
+      uint32_t queued;                    // esp_timer time (us) of enqueueing
       } signal;
     } body;
   event_msg_t type;
@@ -118,6 +136,14 @@ class OvmsEvents
     void DeregisterEvent(std::string caller);
     void SignalEvent(std::string event, void* data, event_signal_done_fn callback = NULL, uint32_t delay_ms = 0);
     void SignalEvent(std::string event, void* data, size_t length, uint32_t delay_ms = 0);
+    void SignalEvent(event_id_t id, const char* event, void* data, event_signal_done_fn callback = NULL, uint32_t delay_ms = 0);
+
+  public:
+    event_id_t InternEvent(const std::string& event);
+    event_id_t FindEvent(const std::string& event);
+    const char* GetEventName(event_id_t id);
+    const event_info_t* GetEventInfo(event_id_t id);
+    event_id_t GetEventCount() { return m_events_count.load(std::memory_order_acquire); }
 
   public:
     void EventTask();
@@ -131,6 +157,10 @@ class OvmsEvents
     const EventMap& Map() { return m_map; }
 
   protected:
+    void PostSignalEvent(event_queue_t* msg, uint32_t delay_ms);
+    void UpdateQueueStats();
+    void DispatchCallbacks(EventCallbackList* el, event_queue_t* msg);
+    void ResolveHandlers(const std::string& event, EventCallbackList* el);
     void HandleQueueSignalEvent(event_queue_t* msg);
     void HandleQueueAddHandler(event_queue_t* msg);
     void HandleQueueRemoveHandlers(event_queue_t* msg);
@@ -145,6 +175,12 @@ class OvmsEvents
     TimerList m_timers;
     TimerStatusMap m_timer_active;
     OvmsMutex m_timers_mutex;
+    std::map<std::string, event_id_t> m_event_ids;
+    event_info_t** m_events;
+    std::atomic<event_id_t> m_events_count;   // written under m_events_mutex
+    bool m_events_fallback_logged;
+    OvmsMutex m_events_mutex;
+    EventCallbackList* m_wildcard;
 #if ESP_IDF_VERSION_MAJOR >= 4
     esp_event_handler_instance_t event_handler_instance;
 #endif
@@ -153,6 +189,7 @@ class OvmsEvents
     bool m_trace;
     TaskHandle_t m_taskid;
     QueueHandle_t m_taskqueue;
+    UBaseType_t m_queue_hwm;
 
   public:
     EventCallbackEntry* m_current_callback;
@@ -111,25 +111,34 @@ void HousekeepingTicker1( TimerHandle_t timer )
   StandardMetrics.ms_m_timeutc->SetValue(time(NULL));
 
   HousekeepingUpdate12V();
-  MyEvents.SignalEvent("ticker.1", NULL);
+
+  // Use interned event IDs for the ticker events:
+  static event_id_t ev_ticker1 = MyEvents.InternEvent("ticker.1");
+  static event_id_t ev_ticker10 = MyEvents.InternEvent("ticker.10");
+  static event_id_t ev_ticker60 = MyEvents.InternEvent("ticker.60");
+  static event_id_t ev_ticker300 = MyEvents.InternEvent("ticker.300");
+  static event_id_t ev_ticker600 = MyEvents.InternEvent("ticker.600");
+  static event_id_t ev_ticker3600 = MyEvents.InternEvent("ticker.3600");
+
+  MyEvents.SignalEvent(ev_ticker1, "ticker.1", NULL);
 
   tick++;
   if ((tick % 10)==0)
     {
-    MyEvents.SignalEvent("ticker.10", NULL);
+    MyEvents.SignalEvent(ev_ticker10, "ticker.10", NULL);
     if ((tick % 60)==0)
       {
-      MyEvents.SignalEvent("ticker.60", NULL);
+      MyEvents.SignalEvent(ev_ticker60, "ticker.60", NULL);
       if ((tick % 300)==0)
         {
-        MyEvents.SignalEvent("ticker.300", NULL);
+        MyEvents.SignalEvent(ev_ticker300, "ticker.300", NULL);
         if ((tick % 600)==0)
           {
-          MyEvents.SignalEvent("ticker.600", NULL);
+          MyEvents.SignalEvent(ev_ticker600, "ticker.600", NULL);
           if ((tick % 3600)==0)
             {
             tick = 0;
-            MyEvents.SignalEvent("ticker.3600", NULL);
+            MyEvents.SignalEvent(ev_ticker3600, "ticker.3600", NULL);
             }
           }
         }
@@ -1082,6 +1082,21 @@ OvmsMetrics::OvmsMetrics()
 
   m_nextmodifier = 1;
   m_first = NULL;
+  m_index = NULL;
+  m_index_count = 0;
+  m_index_size = 0;
+  m_index_valid = true;
+  m_count = 0;
+  m_listeners_all = NULL;
+  m_jslots = NULL;
+  m_jslots_used = 0;
+  m_jslots_overflow = false;
+  for (int i = 0; i < METRICS_MAX_MODIFIERS; i++)
+    {
+    m_journal[i] = NULL;
+    m_journal_pos[i] = 0;
+    }
+  m_journal_mask = 0;
   m_trace = false;
 
   // Register our commands
@@ -1146,60 +1161,147 @@ OvmsMetrics::~OvmsMetrics()
     m = m->m_next;
     delete c;
     }
+  if (m_index)
+    free(m_index);
   }
 
-void OvmsMetrics::RegisterMetric(OvmsMetric* metric)
+size_t OvmsMetrics::IndexLowerBound(const char* name) const
   {
-  // Quick simple check for if we are the first metric.
-  if (m_first == NULL)
+  // Binary search for the first index entry not less than name:
+  size_t lo = 0, hi = m_index_count;
+  while (lo < hi)
     {
-    m_first = metric;
-    return;
+    size_t mid = lo + (hi - lo) / 2;
+    if (strcmp(m_index[mid]->m_name, name) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
     }
+  return lo;
+  }
 
-  // Now, check if we are before the first
-  if (strcmp(m_first->m_name,metric->m_name)>=0)
+/**
+ * LowerBound: first metric in list order with a name not less than name
+ */
+OvmsMetric* OvmsMetrics::LowerBound(const char* name) const
+  {
+  if (m_index_valid)
     {
-    metric->m_next = m_first;
-    m_first = metric;
-    return;
+    size_t pos = IndexLowerBound(name);
+    return (pos < m_index_count) ? m_index[pos] : NULL;
     }
+  OvmsMetric* m = m_first;
+  while (m && strcmp(m->m_name, name) < 0)
+    m = m->m_next;
+  return m;
+  }
 
-  // Search for the correct place to insert
-  for (OvmsMetric*m = m_first; m!=NULL; m=m->m_next)
+void OvmsMetrics::RegisterMetric(OvmsMetric* metric)
+  {
+  // Grow the name index if necessary:
+  if (m_index_valid && m_index_count == m_index_size)
     {
-    if (m->m_next == NULL)
+    size_t newsize = m_index_size ? m_index_size * 2 : METRICS_INDEX_INITSIZE;
+    OvmsMetric** newindex = (OvmsMetric**) ExternalRamMalloc(newsize * sizeof(OvmsMetric*));
+    if (!newindex)
       {
-      m->m_next = metric;
-      return;
+      ESP_LOGE(TAG, "RegisterMetric: out of memory extending index for %s, using linear lookup", metric->m_name);
+      free(m_index);
+      m_index = NULL;
+      m_index_count = 0;
+      m_index_size = 0;
+      m_index_valid = false;
       }
-    if (strcmp(m->m_next->m_name,metric->m_name)>=0)
+    else
       {
-      metric->m_next = m->m_next;
-      m->m_next = metric;
-      return;
+      if (m_index)
+        memcpy(newindex, m_index, m_index_count * sizeof(OvmsMetric*));
+      OvmsMetric** oldindex = m_index;
+      m_index = newindex;
+      m_index_size = newsize;
+      if (oldindex)
+        free(oldindex);
+      }
+    }
+
+  if (m_index_valid)
+    {
+    // The index and the list share the same order, so the index position
+    // also gives us the list predecessor:
+    size_t pos = IndexLowerBound(metric->m_name);
+    if (pos == 0)
+      {
+      metric->m_next = m_first;
+      m_first = metric;
       }
+    else
+      {
+      OvmsMetric* prev = m_index[pos-1];
+      metric->m_next = prev->m_next;
+      prev->m_next = metric;
+      }
+
+    memmove(&m_index[pos+1], &m_index[pos], (m_index_count - pos) * sizeof(OvmsMetric*));
+    m_index[pos] = metric;
+    m_index_count++;
+    }
+  else
+    {
+    // No index, insert into the sorted list:
+    OvmsMetric** link = &m_first;
+    while (*link && strcmp((*link)->m_name, metric->m_name) < 0)
+      link = &(*link)->m_next;
+    metric->m_next = *link;
+    *link = metric;
+    }
+  m_count++;
+
+  // Attach listeners registered before the metric:
+  if (!m_listeners.empty())
+    {
+    auto k = m_listeners.find(metric->m_name);
+    if (k != m_listeners.end())
+      metric->m_listeners = k->second;
     }
+
+  AssignJournalSlot(metric);
   }
 
 void OvmsMetrics::DeregisterMetric(OvmsMetric* metric)
   {
-  if (m_first == metric)
+  if (!m_index_valid)
     {
-    m_first = metric->m_next;
+    OvmsMetric** link = &m_first;
+    while (*link && *link != metric)
+      link = &(*link)->m_next;
+    if (!*link)
+      return;
+    *link = metric->m_next;
+    m_count--;
+    ReleaseJournalSlot(metric);
     delete metric;
     return;
     }
 
-  for (OvmsMetric* m=m_first;m!=NULL;m=m->m_next)
-    {
-    if (m->m_next == metric)
-      {
-      m->m_next = metric->m_next;
-      delete metric;
-      return;
-      }
-    }
+  // Locate the exact entry (names may not be unique):
+  size_t pos = IndexLowerBound(metric->m_name);
+  while (pos < m_index_count && m_index[pos] != metric
+    && strcmp(m_index[pos]->m_name, metric->m_name) == 0)
+    pos++;
+  if (pos >= m_index_count || m_index[pos] != metric)
+    return;
+
+  if (pos == 0)
+    m_first = metric->m_next;
+  else
+    m_index[pos-1]->m_next = metric->m_next;
+
+  m_index_count--;
+  memmove(&m_index[pos], &m_index[pos+1], (m_index_count - pos) * sizeof(OvmsMetric*));
+  m_count--;
+
+  ReleaseJournalSlot(metric);
+  delete metric;
   }
 
 std::string OvmsMetrics::GetUnitStr(const char* metric, const char *unit)
@@ -1263,31 +1365,27 @@ bool OvmsMetrics::SetFloat(const char* metric, float value)
 
 OvmsMetric* OvmsMetrics::Find(const char* metric)
   {
-  for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
-    {
-    if (strcmp(m->m_name,metric)==0) return m;
-    }
+  OvmsMetric* m = LowerBound(metric);
+  if (m && strcmp(m->m_name, metric) == 0)
+    return m;
   return NULL;
   }
 
 OvmsMetric* OvmsMetrics::FindUniquePrefix(const char* token) const
   {
+  // All names sharing the prefix form a contiguous range starting
+  // at the lower bound, an exact match being the first of these:
   size_t len = strlen(token);
-  OvmsMetric* found = NULL;
-  for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
-    {
-    if (strncmp(m->m_name, token, len) == 0)
-      {
-      if (len == strlen(m->m_name))
-        return m;
-      if (found)
-        return NULL;
-      else
-        found = m;
-      }
-    }
+  OvmsMetric* found = LowerBound(token);
+  if (!found || strncmp(found->m_name, token, len) != 0)
+    return NULL;
+  if (found->m_name[len] == 0)
+    return found;
+  if (found->m_next && strncmp(found->m_next->m_name, token, len) == 0)
+    return NULL;
   return found;
   }
+
 bool OvmsMetrics::GetCompletion(OvmsWriter* writer, const char* token) const
   {
     unsigned int index = 0;
@@ -1296,17 +1394,17 @@ bool OvmsMetrics::GetCompletion(OvmsWriter* writer, const char* token) const
     if (token)
       {
       size_t len = strlen(token);
-      for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
+      for (OvmsMetric* m = LowerBound(token); m != NULL; m = m->m_next)
         {
-        if (strncmp(m->m_name, token, len) == 0)
-        {
-          writer->SetCompletion(index++, m->m_name);
-          match = true;
-        }
+        if (strncmp(m->m_name, token, len) != 0)
+          break;
+        writer->SetCompletion(index++, m->m_name);
+        match = true;
       }
     }
     return match;
   }
+
 int OvmsMetrics::Validate(OvmsWriter* writer, int argc, const char* token, bool complete) const
   {
   if (complete)
@@ -1378,6 +1476,22 @@ OvmsMetricString* OvmsMetrics::InitString(const char* metric, uint16_t autostale
   return m;
   }
 
+/**
+ * ResolveListeners: attach a listener list to its metric(s)
+ *  The list pointer is cached on the metric (or as the wildcard list),
+ *  so NotifyModified() does not need to look up listeners by name.
+ */
+void OvmsMetrics::ResolveListeners(const std::string& name, MetricCallbackList* ml)
+  {
+  if (name == "*")
+    {
+    m_listeners_all = ml;
+    return;
+    }
+  for (OvmsMetric* m = LowerBound(name.c_str()); m && strcmp(m->m_name, name.c_str()) == 0; m = m->m_next)
+    m->m_listeners = ml;
+  }
+
 void OvmsMetrics::RegisterListener(std::string caller, std::string name, MetricCallback callback)
   {
   auto k = m_listeners.find(name);
@@ -1385,6 +1499,8 @@ void OvmsMetrics::RegisterListener(std::string caller, std::string name, MetricC
     {
     m_listeners[name] = new MetricCallbackList();
     k = m_listeners.find(name);
+    if (k != m_listeners.end())
+      ResolveListeners(name, k->second);
     }
   if (k == m_listeners.end())
     {
@@ -1418,6 +1534,7 @@ void OvmsMetrics::DeregisterListener(std::string caller)
       }
     if (ml->empty())
       {
+      ResolveListeners(itm->first, NULL);
       itm = m_listeners.erase(itm);
       delete ml;
       }
@@ -1430,6 +1547,7 @@ void OvmsMetrics::DeregisterListener(std::string caller)
 
 void OvmsMetrics::NotifyModified(OvmsMetric* metric)
   {
+  // Note: trace exclusions are only checked with tracing enabled
   if (m_trace &&
       strcmp(metric->m_name, "m.monotonic") != 0 &&
       strcmp(metric->m_name, "m.time.utc") != 0 &&
@@ -1441,22 +1559,18 @@ void OvmsMetrics::NotifyModified(OvmsMetric* metric)
       metric->m_name, metric->AsUnitString().c_str());
     }
 
-  auto k = m_listeners.find("*");
+  MetricCallbackList* ml = m_listeners_all;
   for (int x=0;x<2;x++)
     {
-    if (k != m_listeners.end())
+    if (ml)
       {
-      MetricCallbackList* ml = k->second;
-      if (ml)
+      for (MetricCallbackList::iterator itc=ml->begin(); itc!=ml->end(); ++itc)
         {
-        for (MetricCallbackList::iterator itc=ml->begin(); itc!=ml->end(); ++itc)
-          {
-          MetricCallbackEntry* ec = *itc;
-          ec->m_callback(metric);
-          }
+        MetricCallbackEntry* ec = *itc;
+        ec->m_callback(metric);
         }
       }
-    k = m_listeners.find(metric->m_name);
+    ml = metric->m_listeners;
     }
   }
 
@@ -1472,11 +1586,194 @@ void OvmsMetrics::InitialiseSlot(size_t modifier)
   unsigned long bit = 1ul << modifier;
   for (OvmsMetric* m = m_first; m != NULL; m = m->m_next)
     {
-     if (m->IsDefined())
-       m->m_modified |= bit;
+    if (m->IsDefined())
+      {
+      if ((m->m_modified.fetch_or(bit) & bit) == 0)
+        JournalModified(m, bit);
+      }
     }
   }
 
+void OvmsMetrics::AssignJournalSlot(OvmsMetric* metric)
+  {
+  if (!m_jslots)
+    {
+    m_jslots = (OvmsMetric**) ExternalRamCalloc(METRICS_JOURNAL_SLOTS, sizeof(OvmsMetric*));
+    if (!m_jslots)
+      {
+      metric->m_jslot = METRICS_JOURNAL_NOSLOT;
+      m_jslots_overflow = true;
+      return;
+      }
+    }
+
+  size_t slot;
+  if (!m_jslots_free.empty())
+    {
+    slot = m_jslots_free.back();
+    m_jslots_free.pop_back();
+    }
+  else if (m_jslots_used < METRICS_JOURNAL_SLOTS)
+    {
+    slot = m_jslots_used++;
+    }
+  else
+    {
+    // Journals fall back to scanning the list for these:
+    ESP_LOGW(TAG, "Journal slots exhausted, metric %s will not be journaled", metric->m_name);
+    metric->m_jslot = METRICS_JOURNAL_NOSLOT;
+    m_jslots_overflow = true;
+    return;
+    }
+
+  // Clear stale journal entries of a previous slot user:
+  size_t word = slot / METRICS_JOURNAL_WORDBITS;
+  unsigned long bit = 1ul << (slot % METRICS_JOURNAL_WORDBITS);
+  for (int i = 0; i < METRICS_MAX_MODIFIERS; i++)
+    {
+    if (m_journal[i])
+      m_journal[i][word] &= ~bit;
+    }
+
+  metric->m_jslot = slot;
+  m_jslots[slot] = metric;
+  }
+
+void OvmsMetrics::ReleaseJournalSlot(OvmsMetric* metric)
+  {
+  if (metric->m_jslot == METRICS_JOURNAL_NOSLOT)
+    return;
+  m_jslots[metric->m_jslot] = NULL;
+  m_jslots_free.push_back(metric->m_jslot);
+  metric->m_jslot = METRICS_JOURNAL_NOSLOT;
+  }
+
+/**
+ * EnableModifiedJournal: start tracking modifications for a modifier
+ *  Metrics currently flagged as modified for the modifier are added
+ *  to the journal, so a subsequent drain covers them as well.
+ */
+void OvmsMetrics::EnableModifiedJournal(size_t modifier)
+  {
+  if (modifier >= METRICS_MAX_MODIFIERS || m_journal[modifier])
+    return;
+  std::atomic_ulong* journal = (std::atomic_ulong*) ExternalRamCalloc(METRICS_JOURNAL_WORDS, sizeof(std::atomic_ulong));
+  if (!journal)
+    {
+    ESP_LOGE(TAG, "EnableModifiedJournal: out of memory for modifier %d", modifier);
+    return;
+    }
+  m_journal[modifier] = journal;
+  m_journal_mask |= 1ul << modifier;
+
+  for (OvmsMetric* m = m_first; m != NULL; m = m->m_next)
+    {
+    if (m->IsModified(modifier))
+      JournalModified(m, 1ul << modifier);
+    }
+  }
+
+/**
+ * JournalModified: add metric to the journals of the modifiers given
+ *  Called by OvmsMetric::SetModified() for the modifiers that were
+ *  not yet flagged, so repeated changes do not touch the journal.
+ */
+void OvmsMetrics::JournalModified(OvmsMetric* metric, unsigned long modifiers)
+  {
+  modifiers &= m_journal_mask;
+  if (!modifiers || metric->m_jslot == METRICS_JOURNAL_NOSLOT)
+    return;
+  size_t word = metric->m_jslot / METRICS_JOURNAL_WORDBITS;
+  unsigned long bit = 1ul << (metric->m_jslot % METRICS_JOURNAL_WORDBITS);
+  while (modifiers)
+    {
+    int modifier = __builtin_ctzl(modifiers);
+    modifiers &= ~(1ul << modifier);
+    m_journal[modifier][word].fetch_or(bit);
+    }
+  }
+
+/**
+ * DrainModified: visit and clear the metrics modified for a modifier
+ *  Calls the callback for up to max metrics that had the modifier flag set
+ *  (the flag is cleared before the callback is called). The callback may
+ *  return false to stop the drain. Returns the number of metrics visited.
+ *  Without a journal enabled for the modifier, this falls back to a full scan.
+ */
+size_t OvmsMetrics::DrainModified(size_t modifier, MetricDrainCallback callback, size_t max)
+  {
+  size_t cnt = 0;
+  std::atomic_ulong* journal = (modifier < METRICS_MAX_MODIFIERS) ? m_journal[modifier] : NULL;
+
+  if (journal && m_jslots)
+    {
+    // Resume at the word last drained, so a limited drain does not
+    //  starve metrics in higher slots:
+    size_t start = m_journal_pos[modifier];
+    for (size_t n = 0; n <= METRICS_JOURNAL_WORDS && cnt < max; n++)
+      {
+      size_t word = (start + n) % METRICS_JOURNAL_WORDS;
+      m_journal_pos[modifier] = word;
+      unsigned long bits = journal[word].load();
+      while (bits && cnt < max)
+        {
+        int b = __builtin_ctzl(bits);
+        unsigned long bit = 1ul << b;
+        bits &= ~bit;
+        journal[word].fetch_and(~bit);
+        OvmsMetric* m = m_jslots[word * METRICS_JOURNAL_WORDBITS + b];
+        if (m && m->IsModifiedAndClear(modifier))
+          {
+          cnt++;
+          if (!callback(m))
+            return cnt;
+          }
+        }
+      }
+    if (!m_jslots_overflow)
+      return cnt;
+    }
+
+  for (OvmsMetric* m = m_first; m != NULL && cnt < max; m = m->m_next)
+    {
+    if (journal && m->m_jslot != METRICS_JOURNAL_NOSLOT)
+      continue;
+    if (m->IsModifiedAndClear(modifier))
+      {
+      cnt++;
+      if (!callback(m))
+        return cnt;
+      }
+    }
+  return cnt;
+  }
+
+/**
+ * HasModified: check if any metric is flagged as modified for a modifier
+ */
+bool OvmsMetrics::HasModified(size_t modifier) const
+  {
+  std::atomic_ulong* journal = (modifier < METRICS_MAX_MODIFIERS) ? m_journal[modifier] : NULL;
+  if (journal && m_jslots)
+    {
+    for (size_t word = 0; word < METRICS_JOURNAL_WORDS; word++)
+      {
+      if (journal[word].load())
+        return true;
+      }
+    if (!m_jslots_overflow)
+      return false;
+    }
+  for (OvmsMetric* m = m_first; m != NULL; m = m->m_next)
+    {
+    if (journal && m->m_jslot != METRICS_JOURNAL_NOSLOT)
+      continue;
+    if (m->IsModified(modifier))
+      return true;
+    }
+  return false;
+  }
+
 void OvmsMetrics::SetAllUnitSend(size_t modifier)
   {
   for (OvmsMetric* m = m_first; m != NULL; m = m->m_next)
@@ -1507,6 +1804,8 @@ OvmsMetric::OvmsMetric(const char* name, uint16_t autostale, metric_unit_t units
   m_stale = false;
   m_units = units;
   m_next = NULL;
+  m_listeners = NULL;
+  m_jslot = METRICS_JOURNAL_NOSLOT;
   m_persist = false;          // only set by metrics supporting persistence
   MyMetrics.RegisterMetric(this);
   }
@@ -1590,7 +1889,9 @@ void OvmsMetric::SetModified(bool changed)
   m_lastmodified = monotonictime;
   if (changed)
     {
-    m_modified = ULONG_MAX;
+    unsigned long prev = m_modified.exchange(ULONG_MAX);
+    if (prev != ULONG_MAX)
+      MyMetrics.JournalModified(this, ~prev);
     MyMetrics.NotifyModified(this);
     }
   }
@@ -53,6 +53,11 @@
 #define TAG ((const char*)"metric")
 
 #define METRICS_MAX_MODIFIERS 32
+#define METRICS_INDEX_INITSIZE 512    // initial name index capacity (doubles on demand)
+#define METRICS_JOURNAL_SLOTS 2048    // max metrics tracked by modification journals
+#define METRICS_JOURNAL_NOSLOT 0xffff
+#define METRICS_JOURNAL_WORDBITS (sizeof(unsigned long)*8)
+#define METRICS_JOURNAL_WORDS (METRICS_JOURNAL_SLOTS / METRICS_JOURNAL_WORDBITS)
 
 using namespace std;
 
@@ -220,6 +225,9 @@ extern persistent_values *pmetrics_find(const std::string &name);
 extern persistent_values *pmetrics_register(const char *name);
 extern persistent_values *pmetrics_register(const std::string &name);
 
+class MetricCallbackEntry;
+typedef std::list<MetricCallbackEntry*> MetricCallbackList;
+
 class OvmsMetric
   {
   public:
@@ -278,6 +286,8 @@ class OvmsMetric
     std::atomic_ulong m_modified, m_sendunit;
     uint32_t m_lastmodified;
     uint16_t m_autostale;
+    MetricCallbackList* m_listeners;  // resolved by OvmsMetrics::RegisterListener
+    uint16_t m_jslot;           // modification journal slot
     metric_unit_t m_units;
     metric_defined_t m_defined;
     bool m_stale;
@@ -1125,6 +1135,7 @@ class OvmsMetricInt64 : public OvmsMetric64
   };
 
 typedef std::function<void(OvmsMetric*)> MetricCallback;
+typedef std::function<bool(OvmsMetric*)> MetricDrainCallback;
 
 class MetricCallbackEntry
   {
@@ -1163,7 +1174,6 @@ class UnitConfigMap
     void InitialiseSlot(size_t modifier);
   };
 
-typedef std::list<MetricCallbackEntry*> MetricCallbackList;
 typedef std::map<std::string, MetricCallbackList*> MetricCallbackMap;
 
 class OvmsMetrics
@@ -1176,6 +1186,10 @@ class OvmsMetrics
     void RegisterMetric(OvmsMetric* metric);
     void DeregisterMetric(OvmsMetric* metric);
 
+  protected:
+    size_t IndexLowerBound(const char* name) const;
+    OvmsMetric* LowerBound(const char* name) const;
+
   public:
     bool Set(const char* metric, const char* value, const char *unit = NULL);
     bool SetInt(const char* metric, int value);
@@ -1230,13 +1244,34 @@ class OvmsMetrics
     void RegisterListener(std::string caller, std::string name, MetricCallback callback);
     void DeregisterListener(std::string caller);
     void NotifyModified(OvmsMetric* metric);
+  protected:
+    void ResolveListeners(const std::string& name, MetricCallbackList* ml);
   protected:
     MetricCallbackMap m_listeners;
+    MetricCallbackList* m_listeners_all;     // wildcard "*" listeners
 
   public:
     size_t RegisterModifier();
     void InitialiseSlot(size_t modifier);
 
+  public:
+    // Modification journal: per modifier dirty set, allows consumers
+    //  to visit only the metrics modified since the last drain
+    void EnableModifiedJournal(size_t modifier);
+    void JournalModified(OvmsMetric* metric, unsigned long modifiers);
+    size_t DrainModified(size_t modifier, MetricDrainCallback callback, size_t max = SIZE_MAX);
+    bool HasModified(size_t modifier) const;
+  protected:
+    void AssignJournalSlot(OvmsMetric* metric);
+    void ReleaseJournalSlot(OvmsMetric* metric);
+    OvmsMetric** m_jslots;                                      // slot → metric
+    std::vector<uint16_t> m_jslots_free;                         // released slots
+    size_t m_jslots_used;                                        // high water slot count
+    bool m_jslots_overflow;                                      // metrics without slot exist
+    std::atomic_ulong* m_journal[METRICS_MAX_MODIFIERS];         // dirty bitmap per modifier
+    size_t m_journal_pos[METRICS_MAX_MODIFIERS];                 // drain resume position
+    std::atomic_ulong m_journal_mask;                            // modifiers with journal
+
   public:
     void EventSystemShutDown(std::string event, void* data);
 
@@ -1246,6 +1281,20 @@ class OvmsMetrics
   public:
     OvmsMetric* m_first;
     bool m_trace;
+
+  protected:
+    // Name index: sorted array of all registered metrics, kept in sync with
+    //  the m_first list (same order), used for binary search by name/prefix.
+    //  If the index cannot be extended, it is dropped and lookups fall back
+    //  to a linear search of the (still sorted) list.
+    OvmsMetric** m_index;
+    size_t m_index_count;
+    size_t m_index_size;
+    bool m_index_valid;
+    size_t m_count;
+
+  public:
+    size_t GetCount() const { return m_count; }
   };
 
 extern OvmsMetrics MyMetrics;
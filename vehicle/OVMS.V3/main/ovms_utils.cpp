@@ -249,6 +249,26 @@ std::string stripesc(const char* s)
   return res;
   }
 
+/**
+ * stripesc: remove terminal escape sequences from (log) buffer in place
+ *  Returns the new length.
+ */
+size_t stripesc(char* s, size_t len)
+  {
+  size_t out = 0;
+  bool skip = false;
+  for (size_t i = 0; i < len; i++)
+    {
+    if (s[i] == '\033' && i+1 < len && s[i+1] == '[')
+      skip = true;
+    else if (!skip)
+      s[out++] = s[i];
+    else if (s[i] == 'm')
+      skip = false;
+    }
+  return out;
+  }
+
 /**
  * replace_substrings: replace all `from` substrings by `to` in `text`
  */
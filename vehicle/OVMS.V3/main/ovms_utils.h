@@ -132,6 +132,7 @@ extram::string stripcr(const extram::string& text);
  * stripesc: remove terminal escape sequences from (log) string
  */
 std::string stripesc(const char* s);
+size_t stripesc(char* s, size_t len);
 
 /**
  * replace_substrings: replace all `from` substrings by `to` in `text`
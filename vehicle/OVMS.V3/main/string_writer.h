@@ -34,7 +34,6 @@
 #include <string>
 #include "ovms_command.h"
 
-class LogBuffers;
 class OvmsCommandMap;
 
 class StringWriter : public std::string, public OvmsWriter
@@ -49,7 +48,6 @@ class StringWriter : public std::string, public OvmsWriter
     ssize_t write(const void *buf, size_t nbyte);
 
   public:
-    void Log(LogBuffers* message) {}
     virtual bool IsInteractive() { return false; }
   };
 
@@ -45,6 +45,23 @@ static const char *TAG = "test";
 #include "metrics_standard.h"
 #include "ovms_config.h"
 #include "can.h"
+#ifdef CONFIG_OVMS_DEV_TESTBENCH
+#include "canutils.h"
+#include "canformat.h"
+#include "ovms_buffer.h"
+#include "can_ring.h"
+#include "dbc_app.h"
+#include "vehicle_bmsstats.h"
+#include "vehicle_bmshistory.h"
+#include "log_buffers.h"
+#include "log_binary.h"
+#ifdef CONFIG_OVMS_COMP_CELLULAR
+#include "gsmmux.h"
+#endif // #ifdef CONFIG_OVMS_COMP_CELLULAR
+#endif // #ifdef CONFIG_OVMS_DEV_TESTBENCH
+#include "ovms_utils.h"
+#include "esp_heap_caps.h"
+#include "freertos/queue.h"
 #if ESP_IDF_VERSION_MAJOR < 4
 #include "strverscmp.h"
 #endif
@@ -380,6 +397,1827 @@ void test_string(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
     (int)((esp_timer_get_time() - time_start_us) / 1000));
   }
 
+#ifdef CONFIG_OVMS_DEV_TESTBENCH
+// Benchmark rate: <count> per second in <elapsed> us
+static int64_t test_rate(int64_t count, int64_t elapsed)
+  {
+  return elapsed ? count * 1000000 / elapsed : 0;
+  }
+
+// Benchmark result line: "<label>: <count> <unit> in <elapsed> us = <rate> <unit>/s"
+static void test_report_rate(OvmsWriter* writer, const char* label, uint32_t count, const char* unit, int64_t elapsed)
+  {
+  writer->printf("%s: %u %s in %lld us = %lld %s/s\n",
+    label, count, unit, elapsed, test_rate(count, elapsed), unit);
+  }
+
+// CAN bus "can<number>" if registered, else NULL:
+static canbus* test_canbus(int number)
+  {
+  char name[8];
+  snprintf(name, sizeof(name), "can%d", number);
+  return (canbus*)MyPcpApp.FindDeviceByName(name);
+  }
+
+// First registered CAN bus, NULL if none:
+static canbus* test_first_canbus()
+  {
+  canbus* bus = NULL;
+  for (int k = 1; k <= CAN_MAXBUSES && !bus; k++)
+    bus = test_canbus(k);
+  return bus;
+  }
+
+static OvmsMetric* test_metrics_linearfind(const char* name)
+  {
+  // Reference: the former linear list scan
+  for (OvmsMetric* m=MyMetrics.m_first; m != NULL; m=m->m_next)
+    {
+    if (strcmp(m->m_name, name)==0) return m;
+    }
+  return NULL;
+  }
+
+void test_metrics(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int loops = (argc > 0) ? atoi(argv[0]) : 10;
+  int extra = (argc > 1) ? atoi(argv[1]) : 300;
+  if (loops < 1) loops = 1;
+
+  // Add synthetic vehicle metrics:
+  std::vector<OvmsMetricInt*> added;
+  std::vector<std::string> names;
+  names.reserve(extra);
+  for (int k = 0; k < extra; k++)
+    {
+    char name[32];
+    snprintf(name, sizeof(name), "xtb.bench.%03d", k);
+    names.push_back(name);
+    }
+  for (int k = 0; k < extra; k++)
+    added.push_back(new OvmsMetricInt(names[k].c_str()));
+
+  // Collect all names to look up:
+  std::vector<const char*> lookup;
+  for (OvmsMetric* m = MyMetrics.m_first; m != NULL; m = m->m_next)
+    lookup.push_back(m->m_name);
+  writer->printf("Metrics registered: %u, loops: %d\n", lookup.size(), loops);
+
+  int64_t started;
+  int64_t elapsed;
+  int errors = 0;
+  uint32_t count = lookup.size() * loops;
+
+  started = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    {
+    for (const char* name : lookup)
+      {
+      if (test_metrics_linearfind(name) == NULL) errors++;
+      }
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "Linear Find", count, "lookups", elapsed);
+
+  started = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    {
+    for (const char* name : lookup)
+      {
+      if (MyMetrics.Find(name) == NULL) errors++;
+      }
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "Index Find", count, "lookups", elapsed);
+
+  started = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    {
+    for (const char* name : lookup)
+      {
+      if (MyMetrics.FindUniquePrefix(name) == NULL) errors++;
+      }
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "Index FindUniquePrefix", count, "lookups", elapsed);
+
+  if (errors)
+    writer->printf("ERROR: %d lookups failed\n", errors);
+
+  for (OvmsMetricInt* m : added)
+    MyMetrics.DeregisterMetric(m);
+  }
+
+void test_metricnotify(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int count = (argc > 0) ? atoi(argv[0]) : 100000;
+  if (count < 1) count = 1;
+
+  OvmsMetricInt* metric = new OvmsMetricInt("xtb.notify");
+  int calls = 0;
+  const int listeners[] = { 0, 1, 5 };
+
+  for (int n : listeners)
+    {
+    for (int k = 0; k < n; k++)
+      MyMetrics.RegisterListener("test.metricnotify", "xtb.notify", [&calls](OvmsMetric* m) { calls++; });
+    calls = 0;
+
+    int64_t started = esp_timer_get_time();
+    for (int k = 0; k < count; k++)
+      metric->SetValue(k);
+    int64_t elapsed = esp_timer_get_time() - started;
+
+    writer->printf("%d listeners: %d SetValue() in %lld us = %lld calls/s, %d callbacks\n",
+      n, count, elapsed, test_rate(count, elapsed), calls);
+    MyMetrics.DeregisterListener("test.metricnotify");
+    }
+
+  MyMetrics.DeregisterMetric(metric);
+  }
+
+static const char test_dbcdecode_dbc[] =
+  "VERSION \"xtb\"\n"
+  "BO_ 1024 XTB_Drive: 8 Vector__XXX\n"
+  " SG_ Speed : 0|16@1+ (0.01,0) [0|655.35] \"km/h\" Vector__XXX\n"
+  " SG_ Torque : 23|12@0- (0.5,-100) [-1124|923] \"Nm\" Vector__XXX\n"
+  " SG_ Gear : 32|3@1+ (1,0) [0|7] \"\" Vector__XXX\n"
+  " SG_ Temp : 40|8@1- (1,0) [-128|127] \"\" Vector__XXX\n"
+  " SG_ Odo : 48|16@1+ (1,0) [0|65535] \"km\" Vector__XXX\n"
+  "BO_ 1025 XTB_Battery: 8 Vector__XXX\n"
+  " SG_ Mux M : 0|4@1+ (1,0) [0|15] \"\" Vector__XXX\n"
+  " SG_ CellA m0 : 8|16@1+ (0.001,0) [0|65.535] \"V\" Vector__XXX\n"
+  " SG_ CellB m1 : 8|16@1+ (0.001,0) [0|65.535] \"V\" Vector__XXX\n"
+  " SG_ SubMux m2M : 8|8@1+ (1,0) [0|255] \"\" Vector__XXX\n"
+  " SG_ SubTemp m2 : 16|16@1- (0.1,-40) [-3316.8|3236.7] \"\" Vector__XXX\n"
+  " SG_ State m3 : 8|2@1+ (1,0) [0|3] \"\" Vector__XXX\n"
+  "VAL_ 1024 Gear 0 \"P\" 1 \"R\" 2 \"N\" 3 \"D\" ;\n"
+  "VAL_ 1025 State 0 \"Off\" 1 \"Idle\" 2 \"Charge\" 3 \"Drive\" ;\n"
+  "SG_MUL_VAL_ 1025 SubTemp SubMux 3-5, 7-7;\n";
+
+static const char* const test_dbcdecode_crtd[] =
+  {
+  "1.000 1R11 400 10 27 f4 10 03 e7 a0 86",
+  "1.010 1R11 401 00 a4 0e 00 00 00 00 00",
+  "1.020 1R11 401 01 b2 0e 00 00 00 00 00",
+  "1.030 1R11 401 02 02 9a 01 00 00 00 00",
+  "1.040 1R11 401 02 04 66 fe 00 00 00 00",
+  "1.050 1R11 401 02 06 10 00 00 00 00 00",
+  "1.060 1R11 401 03 02 00 00 00 00 00 00",
+  "1.070 1R11 400 00 00 00 00 00 80 00 00",
+  "1.080 1R11 401 0f ff ff ff ff ff ff ff",
+  "1.090 1R11 400 ff ff ff ff 07 7f ff ff",
+  "1.100 1R11 401 02 07 00 80 00 00 00 00",
+  "1.110 1R11 400 12 34",
+  };
+
+class test_dbcdecode_recorder : public dbcMetric
+  {
+  public:
+    void SetValue(dbcNumber value, metric_unit_t unit) override { m_value = value; m_sets++; }
+    void SetValue(const std::string &value) override { m_text = value; m_sets++; }
+    metric_unit_t DefaultUnit() const override { return Other; }
+    bool Equals(const test_dbcdecode_recorder& other) const
+      {
+      if (m_sets != other.m_sets || m_text != other.m_text) return false;
+      if (m_value.IsDouble() != other.m_value.IsDouble() ||
+          m_value.IsSignedInteger() != other.m_value.IsSignedInteger() ||
+          m_value.IsUnsignedInteger() != other.m_value.IsUnsignedInteger()) return false;
+      if (m_value.IsDouble())
+        return m_value.GetDouble() == other.m_value.GetDouble();
+      return m_value.GetUnsignedInteger() == other.m_value.GetUnsignedInteger();
+      }
+    void Reset() { m_value.Clear(); m_text.clear(); m_sets = 0; }
+
+  public:
+    dbcNumber m_value;
+    std::string m_text;
+    int m_sets = 0;
+  };
+
+static bool test_dbcdecode_parse(const char* line, CAN_frame_t* frame)
+  {
+  // Minimal CRTD frame parser: <time> <bus>R11|R29 <id> <data bytes>
+  char type[8];
+  unsigned int id;
+  int len;
+  if (sscanf(line, "%*f %7s %x%n", type, &id, &len) != 2 || strchr(type, 'R') == NULL)
+    return false;
+  memset(frame, 0, sizeof(*frame));
+  frame->FIR.B.FF = (strstr(type, "R29") != NULL) ? CAN_frame_ext : CAN_frame_std;
+  frame->MsgID = id;
+  const char* p = line + len;
+  char* ep;
+  while (frame->FIR.B.DLC < 8)
+    {
+    unsigned long val = strtoul(p, &ep, 16);
+    if (ep == p) break;
+    frame->data.u8[frame->FIR.B.DLC++] = val;
+    p = ep;
+    }
+  return true;
+  }
+
+void test_dbcdecode(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int loops = (argc > 0) ? atoi(argv[0]) : 1000;
+  if (loops < 1) loops = 1;
+
+  // Load trace: built in or from CRTD file
+  std::vector<CAN_frame_t> trace;
+  CAN_frame_t frame;
+  if (argc > 1)
+    {
+    FILE* f = fopen(argv[1], "r");
+    if (!f)
+      {
+      writer->printf("Error: cannot open %s\n", argv[1]);
+      return;
+      }
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+      {
+      if (test_dbcdecode_parse(line, &frame))
+        trace.push_back(frame);
+      }
+    fclose(f);
+    }
+  else
+    {
+    for (const char* line : test_dbcdecode_crtd)
+      {
+      if (test_dbcdecode_parse(line, &frame))
+        trace.push_back(frame);
+      }
+    }
+  if (trace.empty())
+    {
+    writer->puts("Error: no frames in trace");
+    return;
+    }
+
+  dbcfile* dbc = MyDBC.LoadString("xtb.dbcdecode", test_dbcdecode_dbc);
+  if (!dbc)
+    {
+    writer->puts("Error: test DBC failed to load");
+    return;
+    }
+
+  // Attach recorders to all signals (owned by the signals):
+  std::vector<test_dbcdecode_recorder*> recorders;
+  for (auto it : dbc->m_messages.m_entrymap)
+    {
+    writer->printf("Message %s: %u signals, %u plan steps\n", it.second->GetName().c_str(),
+      it.second->m_signals.size(), it.second->GetDecodePlanSize());
+    for (dbcSignal* sig : it.second->m_signals)
+      {
+      test_dbcdecode_recorder* rec = new test_dbcdecode_recorder();
+      sig->AttachDbcMetric(rec);
+      recorders.push_back(rec);
+      }
+    }
+
+  // Check: both paths must produce identical metric values per frame
+  std::vector<test_dbcdecode_recorder> generic(recorders.size());
+  int errors = 0;
+  for (const CAN_frame_t& f : trace)
+    {
+    dbcMessage* msg = dbc->m_messages.FindMessage(f.FIR.B.FF, f.MsgID);
+    if (!msg) continue;
+    for (test_dbcdecode_recorder* rec : recorders) rec->Reset();
+    msg->DecodeSignalGeneric(f.data.u8, f.FIR.B.DLC);
+    for (size_t k = 0; k < recorders.size(); k++) generic[k] = *recorders[k];
+    for (test_dbcdecode_recorder* rec : recorders) rec->Reset();
+    if (!msg->DecodeSignalCompiled(f.data.u8, f.FIR.B.DLC))
+      {
+      writer->printf("ERROR: no decode plan for %s\n", msg->GetName().c_str());
+      errors++;
+      continue;
+      }
+    for (size_t k = 0; k < recorders.size(); k++)
+      {
+      if (!recorders[k]->Equals(generic[k]))
+        {
+        writer->printf("ERROR: mismatch on message %s signal #%u\n", msg->GetName().c_str(), k);
+        errors++;
+        }
+      }
+    }
+
+  // Benchmark:
+  uint32_t count = trace.size() * loops;
+  int64_t started = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    {
+    for (const CAN_frame_t& f : trace)
+      {
+      dbcMessage* msg = dbc->m_messages.FindMessage(f.FIR.B.FF, f.MsgID);
+      if (msg) msg->DecodeSignalGeneric(f.data.u8, f.FIR.B.DLC);
+      }
+    }
+  int64_t elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "Generic decode", count, "frames", elapsed);
+
+  started = esp_timer_get_time();
+  for (int j = 0; j < loops; j++)
+    {
+    for (const CAN_frame_t& f : trace)
+      {
+      dbcMessage* msg = dbc->m_messages.FindMessage(f.FIR.B.FF, f.MsgID);
+      if (msg) msg->DecodeSignalCompiled(f.data.u8, f.FIR.B.DLC);
+      }
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "Compiled decode", count, "frames", elapsed);
+
+  if (errors)
+    writer->printf("ERROR: %d decode mismatches\n", errors);
+  else
+    writer->printf("OK: %u frames decoded identically\n", trace.size());
+
+  MyDBC.Unload("xtb.dbcdecode");
+  }
+
+void test_canidmap(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int frames = (argc > 0) ? atoi(argv[0]) : 500000;
+  if (frames < 1) frames = 1;
+
+  // Typical DBC coverage: 120 standard + 40 extended IDs
+  static int handlers[160];
+  std::map<uint32_t, int*> idtree;
+  canidmap<int> idmap;
+  uint32_t seed = 12345;
+  for (int k = 0; k < 160; k++)
+    {
+    seed = seed * 1103515245 + 12345;
+    uint32_t key = (k < 120)
+      ? ((seed >> 8) & 0x7ff)
+      : (((seed >> 3) & 0x1fffffff) | CANIDMAP_EXT_FLAG);
+    idtree[key] = &handlers[k];
+    idmap.Set(key, &handlers[k]);
+    }
+  std::vector<uint32_t> known;
+  for (auto it : idtree)
+    known.push_back(it.first);
+  writer->printf("IDs: %u (map %u), index memory: %u bytes\n",
+    known.size(), idmap.GetCount(), idmap.GetMemoryUsage());
+
+  // Replay a synthetic log: 80% known IDs, 20% unknown IDs
+  int64_t started, elapsed;
+  uint32_t hits_tree = 0, hits_map = 0, sum_tree = 0, sum_map = 0;
+
+  seed = 1;
+  started = esp_timer_get_time();
+  for (int k = 0; k < frames; k++)
+    {
+    seed = seed * 1103515245 + 12345;
+    uint32_t key = ((seed >> 16) % 5 != 0)
+      ? known[(seed >> 4) % known.size()]
+      : ((seed & 0x100) ? ((seed >> 8) & 0x7ff) : (((seed >> 2) & 0x1fffffff) | CANIDMAP_EXT_FLAG));
+    auto search = idtree.find(key);
+    if (search != idtree.end())
+      {
+      hits_tree++;
+      sum_tree += search->second - handlers;
+      }
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "std::map", frames, "lookups", elapsed);
+
+  seed = 1;
+  started = esp_timer_get_time();
+  for (int k = 0; k < frames; k++)
+    {
+    seed = seed * 1103515245 + 12345;
+    uint32_t key = ((seed >> 16) % 5 != 0)
+      ? known[(seed >> 4) % known.size()]
+      : ((seed & 0x100) ? ((seed >> 8) & 0x7ff) : (((seed >> 2) & 0x1fffffff) | CANIDMAP_EXT_FLAG));
+    int* handler = idmap.Find(key);
+    if (handler)
+      {
+      hits_map++;
+      sum_map += handler - handlers;
+      }
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "canidmap", frames, "lookups", elapsed);
+
+  if (hits_tree != hits_map || sum_tree != sum_map)
+    writer->printf("ERROR: results differ: %u/%u hits, checksum %u/%u\n",
+      hits_tree, hits_map, sum_tree, sum_map);
+  else
+    writer->printf("OK: %u hits on both\n", hits_map);
+  }
+
+static bool test_canfilter_reference(const std::vector<CAN_filter_t>& filters, const CAN_frame_t* frame)
+  {
+  // Reference: the former list semantics
+  if (filters.empty()) return true;
+  uint8_t buskey = frame->origin ? (frame->origin->m_busnumber + 1) : 0;
+  for (const CAN_filter_t& filter : filters)
+    {
+    if ((filter.bus)&&(filter.bus != buskey)) continue;
+    if ((frame->MsgID >= filter.id_from) && (frame->MsgID <= filter.id_to))
+      return true;
+    }
+  return false;
+  }
+
+void test_canfilter(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int rounds = (argc > 0) ? atoi(argv[0]) : 100;
+  if (rounds < 1) rounds = 1;
+
+  // Frame origins: none + all registered buses
+  std::vector<canbus*> origins;
+  origins.push_back(NULL);
+  for (int k = 1; k <= CAN_MAXBUSES; k++)
+    {
+    canbus* bus = test_canbus(k);
+    if (bus) origins.push_back(bus);
+    }
+
+  uint32_t seed = 4711;
+  auto rnd = [&seed]() -> uint32_t { seed = seed * 1103515245 + 12345; return seed >> 8; };
+
+  int errors = 0;
+  uint32_t checks = 0;
+  int64_t time_list = 0, time_compiled = 0;
+  for (int r = 0; r < rounds; r++)
+    {
+    // Random filter set, biased to small ranges and the standard ID space:
+    canfilter filter;
+    std::vector<CAN_filter_t> reference;
+    int count = rnd() % 31;
+    for (int k = 0; k < count; k++)
+      {
+      CAN_filter_t f;
+      f.bus = rnd() % (CAN_MAXBUSES+1);
+      switch (rnd() % 4)
+        {
+        case 0:  f.id_from = rnd() % 0x800; f.id_to = f.id_from; break;
+        case 1:  f.id_from = rnd() % 0x800; f.id_to = f.id_from + rnd() % 0x100; break;
+        case 2:  f.id_from = rnd() % 0x20000000; f.id_to = f.id_from + rnd() % 0x10000; break;
+        default: f.id_from = rnd() % 0x1000; f.id_to = (rnd() & 1) ? UINT32_MAX : f.id_from + rnd(); break;
+        }
+      if (f.id_to < f.id_from) f.id_to = UINT32_MAX;
+      if (filter.AddFilter(f.bus, f.id_from, f.id_to))
+        reference.push_back(f);
+      }
+    // Remove some again to exercise recompilation:
+    if (!reference.empty() && (rnd() & 1))
+      {
+      auto it = reference.begin() + (rnd() % reference.size());
+      filter.RemoveFilter(it->bus, it->id_from, it->id_to);
+      reference.erase(it);
+      }
+
+    // Probe IDs: random standard & extended, plus all range borders
+    std::vector<uint32_t> ids;
+    for (int k = 0; k < 200; k++)
+      ids.push_back((k & 1) ? (rnd() % 0x800) : (rnd() % 0x20000000));
+    for (const CAN_filter_t& f : reference)
+      {
+      ids.push_back(f.id_from);
+      ids.push_back(f.id_to);
+      if (f.id_from > 0) ids.push_back(f.id_from - 1);
+      if (f.id_to < UINT32_MAX) ids.push_back(f.id_to + 1);
+      }
+
+    CAN_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    for (canbus* origin : origins)
+      {
+      frame.origin = origin;
+      for (uint32_t id : ids)
+        {
+        frame.MsgID = id;
+        bool expect = test_canfilter_reference(reference, &frame);
+        bool result = filter.IsFiltered(&frame);
+        checks++;
+        if (result != expect)
+          {
+          if (errors++ < 10)
+            writer->printf("ERROR: round %d bus %d id %" PRIx32 ": %d, expected %d\n",
+              r, origin ? origin->m_busnumber+1 : 0, id, result, expect);
+          }
+        }
+
+      int matches = 0;
+      int64_t started = esp_timer_get_time();
+      for (uint32_t id : ids)
+        {
+        frame.MsgID = id;
+        matches += test_canfilter_reference(reference, &frame);
+        }
+      int64_t mid = esp_timer_get_time();
+      for (uint32_t id : ids)
+        {
+        frame.MsgID = id;
+        matches -= filter.IsFiltered(&frame);
+        }
+      time_list += mid - started;
+      time_compiled += esp_timer_get_time() - mid;
+      if (matches != 0) errors++;
+      }
+    }
+
+  writer->printf("%u checks on %u origins: list %lld us, compiled %lld us\n",
+    checks, origins.size(), time_list, time_compiled);
+  if (errors)
+    writer->printf("ERROR: %d mismatches\n", errors);
+  else
+    writer->puts("OK: compiled filter matches list semantics");
+  }
+
+void test_canformat(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int frames = (argc > 0) ? atoi(argv[0]) : 20000;
+  if (frames < 1) frames = 1;
+
+  // Some formats need a bus as the frame origin:
+  canbus* bus = test_first_canbus();
+  if (!bus)
+    {
+    writer->puts("ERROR: no CAN bus found");
+    return;
+    }
+
+  // Synthetic trace: mostly RX/TX frames (80% standard, 20% extended),
+  // every 8th message a TX queue/fail frame, status or info message
+  static const CAN_log_type_t othertypes[] = {
+    CAN_LogFrame_TX_Queue, CAN_LogFrame_TX_Fail,
+    CAN_LogStatus_Error, CAN_LogStatus_Statistics,
+    CAN_LogInfo_Comment, CAN_LogInfo_Config, CAN_LogInfo_Event, CAN_LogInfo_Metric };
+  static char infotext[] = "xtb.canformat info, \"quoted\" text";
+  std::vector<CAN_log_message_t> trace(256);
+  uint32_t seed = 815;
+  for (int k = 0; k < 256; k++)
+    {
+    CAN_log_message_t& msg = trace[k];
+    seed = seed * 1103515245 + 12345;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = (k % 8 == 7) ? othertypes[(k / 8) % 8] : (seed & 0x10) ? CAN_LogFrame_RX : CAN_LogFrame_TX;
+    msg.timestamp.tv_sec = 1600000000 + (seed >> 20);
+    msg.timestamp.tv_usec = (seed >> 8) % 1000000;
+    msg.origin = bus;
+    if (msg.type == CAN_LogStatus_Error || msg.type == CAN_LogStatus_Statistics)
+      {
+      msg.status.interrupts = seed >> 8;
+      msg.status.packets_rx = seed >> 4;
+      msg.status.packets_tx = seed >> 12;
+      msg.status.error_flags = seed;
+      msg.status.errors_rx = seed % 128;
+      msg.status.txbuf_delay = seed % 1000;
+      }
+    else if (msg.type >= CAN_LogInfo_Comment)
+      {
+      msg.text = infotext;
+      }
+    else
+      {
+      msg.frame.FIR.B.FF = ((seed >> 16) % 5 != 0) ? CAN_frame_std : CAN_frame_ext;
+      msg.frame.MsgID = (msg.frame.FIR.B.FF == CAN_frame_std) ? (seed >> 8) & 0x7ff : (seed >> 3) & 0x1fffffff;
+      msg.frame.FIR.B.DLC = 1 + (seed >> 24) % 8;
+      for (int i = 0; i < 8; i++)
+        msg.frame.data.u8[i] = seed >> (i * 3);
+      }
+    }
+
+  uint8_t* batch = (uint8_t*)ExternalRamMalloc(4096);
+  if (!batch)
+    {
+    writer->puts("ERROR: out of memory");
+    return;
+    }
+
+  int errors = 0;
+  for (auto it : MyCanFormatFactory.m_fmap)
+    {
+    canformat* fmt = MyCanFormatFactory.NewFormat(it.first);
+    if (!fmt) continue;
+
+    // Batch output must equal the per message output byte by byte:
+    int mismatches = 0;
+    size_t used = 0;
+    for (int k = 0; k < 256; k++)
+      {
+      std::string ref = fmt->get(&trace[k]);
+      size_t len = fmt->format(&trace[k], batch + used, 4096 - used);
+      if (len == 0 && used > 0)
+        {
+        used = 0;
+        len = fmt->format(&trace[k], batch, 4096);
+        }
+      if (len != ref.size() || memcmp(batch + used, ref.data(), len) != 0)
+        {
+        if (mismatches++ < 3)
+          writer->printf("ERROR: %s message %d (%s): %u bytes differ from get() %u bytes\n",
+            it.first, k, GetCanLogTypeName(trace[k].type), len, ref.size());
+        }
+      used += len;
+      }
+    errors += mismatches;
+
+    int64_t started, time_get, time_format;
+    size_t bytes_get = 0, bytes_format = 0;
+    used = 0;
+
+    // Old path: one std::string per message
+    started = esp_timer_get_time();
+    for (int k = 0; k < frames; k++)
+      {
+      std::string result = fmt->get(&trace[k & 255]);
+      bytes_get += result.length();
+      }
+    time_get = esp_timer_get_time() - started;
+
+    // New path: serialise into a batch buffer
+    started = esp_timer_get_time();
+    for (int k = 0; k < frames; k++)
+      {
+      size_t len = fmt->format(&trace[k & 255], batch + used, 4096 - used);
+      if (len == 0 && used > 0)
+        {
+        used = 0;
+        len = fmt->format(&trace[k & 255], batch, 4096);
+        }
+      used += len;
+      bytes_format += len;
+      }
+    time_format = esp_timer_get_time() - started;
+
+    writer->printf("%-12s get: %lld frames/s, format: %lld frames/s (%u bytes)%s\n",
+      it.first,
+      test_rate(frames, time_get),
+      test_rate(frames, time_format),
+      bytes_format,
+      (bytes_get != bytes_format) ? " ERROR: output size differs" : "");
+    if (bytes_get != bytes_format)
+      errors++;
+    delete fmt;
+    }
+
+  free(batch);
+  if (errors)
+    writer->printf("ERROR: %d mismatches\n", errors);
+  else
+    writer->puts("OK: batch output matches get() for all formats");
+  }
+
+void test_canstamp(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  const int count = 64;
+  int errors = 0;
+
+  canbus* bus = test_first_canbus();
+  if (!bus)
+    {
+    writer->puts("ERROR: no CAN bus found");
+    return;
+    }
+
+  // Frames received up to ~2 seconds ago, converted to log messages as
+  // canlog::LogFrame() does. Wall time spacing must match the receive
+  // time spacing:
+  std::vector<CAN_log_message_t> trace(count);
+  int64_t now = esp_timer_get_time();
+  int64_t maxdev = 0;
+  for (int k = 0; k < count; k++)
+    {
+    CAN_log_message_t& msg = trace[k];
+    memset(&msg, 0, sizeof(msg));
+    msg.type = CAN_LogFrame_RX;
+    msg.frame.origin = bus;
+    msg.frame.FIR.B.FF = CAN_frame_std;
+    msg.frame.MsgID = 0x100 + k;
+    msg.frame.FIR.B.DLC = 8;
+    msg.frame.data.u64 = k * 0x0101010101010101ULL;
+    msg.frame.timestamp = now - (count - k) * 31337;
+    GetCanFrameTime(&msg.frame, &msg.timestamp);
+    int64_t wall = (int64_t)msg.timestamp.tv_sec * 1000000 + msg.timestamp.tv_usec;
+    int64_t wall0 = (int64_t)trace[0].timestamp.tv_sec * 1000000 + trace[0].timestamp.tv_usec;
+    int64_t dev = (wall - wall0) - (msg.frame.timestamp - trace[0].frame.timestamp);
+    if (dev < 0) dev = -dev;
+    if (dev > maxdev) maxdev = dev;
+    }
+  writer->printf("Wall time conversion: max deviation %lld us\n", maxdev);
+  if (maxdev > 1000)
+    {
+    writer->puts("ERROR: wall time spacing differs from receive time spacing");
+    errors++;
+    }
+
+  // Round trip through the formats carrying timestamps:
+  static const char* const formats[] = { "crtd", "pcap", "gvret-a" };
+  uint8_t buf[128];
+  for (const char* name : formats)
+    {
+    canformat* out = MyCanFormatFactory.NewFormat(name);
+    canformat* in = MyCanFormatFactory.NewFormat(name);
+    if (!out || !in)
+      {
+      writer->printf("%-8s: not available\n", name);
+      if (out) delete out;
+      if (in) delete in;
+      continue;
+      }
+    int ok = 0, bad = 0;
+    for (int k = 0; k < count; k++)
+      {
+      size_t len = out->format(&trace[k], buf, sizeof(buf));
+      CAN_log_message_t parsed;
+      memset(&parsed, 0, sizeof(parsed));
+      bool hasmore = false;
+      in->put(&parsed, buf, len, &hasmore);
+      int64_t want = (int64_t)trace[k].timestamp.tv_sec * 1000000 + trace[k].timestamp.tv_usec;
+      int64_t got = (int64_t)parsed.timestamp.tv_sec * 1000000 + parsed.timestamp.tv_usec;
+      if (strcmp(name, "gvret-a") == 0)
+        want = (uint32_t)want;    // GVRET: 32 bit microseconds
+      if (parsed.frame.MsgID == trace[k].frame.MsgID && got == want)
+        ok++;
+      else if (bad++ < 3)
+        writer->printf("ERROR: %s frame %d: time %lld, expected %lld\n", name, k, got, want);
+      }
+    writer->printf("%-8s: %d of %d timestamps preserved\n", name, ok, count);
+    errors += bad;
+    delete out;
+    delete in;
+    }
+
+  if (errors)
+    writer->printf("ERROR: %d failures\n", errors);
+  else
+    writer->puts("OK: frame timestamps propagate to log formats");
+  }
+
+// Reference: CRTD & GVRET ASCII line parsers as used before the allocation
+//  free rework (canformat_scanner), for equivalence testing. The line is
+//  padded, as the old parsers could read beyond the terminator.
+static void test_canparse_crtd_legacy(std::string line, CAN_log_message_t* message)
+  {
+  line.append(16, '\0');
+  const char *b = line.c_str();
+  if (!isdigit(b[0])) return;
+  message->timestamp.tv_sec = atol(b);
+  for (;isdigit(*b);b++) {}
+  if (*b == '.')
+    {
+    long usec = 0;
+    int digits = 0;
+    for (b++;isdigit(*b);b++)
+      {
+      if (digits++ < 6) usec = usec*10 + (*b-'0');
+      }
+    for (;digits<6;digits++) usec *= 10;
+    message->timestamp.tv_usec = usec;
+    }
+  for (;((*b != 0)&&(*b != ' '));b++) {}
+  if (*b == 0) return;
+  b++;
+  char bus = '1';
+  if (isdigit(*b))
+    {
+    bus = *b;
+    b++;
+    }
+  if ((b[0]=='R')&&(b[1]=='1')&&(b[2]=='1'))
+    { message->type = CAN_LogFrame_RX; message->frame.FIR.B.FF = CAN_frame_std; }
+  else if ((b[0]=='R')&&(b[1]=='2')&&(b[2]=='9'))
+    { message->type = CAN_LogFrame_RX; message->frame.FIR.B.FF = CAN_frame_ext; }
+  else if ((b[0]=='T')&&(b[1]=='1')&&(b[2]=='1'))
+    { message->type = CAN_LogFrame_TX; message->frame.FIR.B.FF = CAN_frame_std; }
+  else if ((b[0]=='T')&&(b[1]=='2')&&(b[2]=='9'))
+    { message->type = CAN_LogFrame_TX; message->frame.FIR.B.FF = CAN_frame_ext; }
+  else
+    return;   // also control commands (no connection here)
+  if (b[3] != ' ') return;
+  b += 4;
+  char *p;
+  errno = 0;
+  message->frame.MsgID = (uint32_t)strtol(b,&p,16);
+  if ((message->frame.MsgID == 0)&&(errno != 0)) return;
+  b = p;
+  for (int k=0;k<8;k++)
+    {
+    if (*b==0) break;
+    b++;
+    errno = 0;
+    long d = strtol(b,&p,16);
+    if ((d==0)&&(errno != 0)) break;
+    message->frame.data.u8[k] = (uint8_t)d;
+    message->frame.FIR.B.DLC++;
+    b = p;
+    }
+  message->origin = MyCan.GetBus(bus - '1');
+  }
+
+static void test_canparse_gvret_legacy(std::string line, CAN_log_message_t* message)
+  {
+  line.append(16, '\0');
+  char *b = &line[0];
+  message->type = CAN_LogFrame_RX;
+  uint32_t timestamp = strtoul(b,&b,10);
+  message->timestamp.tv_sec = timestamp / 1000000;
+  message->timestamp.tv_usec = timestamp % 1000000;
+  b += 2;
+  message->frame.MsgID = strtol(b,&b,16);
+  if (b[1] == 'S')
+    message->frame.FIR.B.FF = CAN_frame_std;
+  else if (b[1] == 'X')
+    message->frame.FIR.B.FF = CAN_frame_ext;
+  else
+    return;
+  b += 2;
+  uint32_t busnumber = strtol(b,&b,10);
+  message->frame.FIR.B.DLC = strtol(b,&b,10);
+  if (message->frame.FIR.B.DLC > 8)
+    return;
+  for (size_t x=0;x<message->frame.FIR.B.DLC;x++)
+    message->frame.data.u8[x] = strtol(b,&b,16);
+  message->origin = MyCan.GetBus(busnumber);
+  }
+
+static bool test_canparse_equal(const CAN_log_message_t& a, const CAN_log_message_t& b)
+  {
+  return a.type == b.type
+    && a.timestamp.tv_sec == b.timestamp.tv_sec && a.timestamp.tv_usec == b.timestamp.tv_usec
+    && a.frame.origin == b.frame.origin && a.frame.FIR.U == b.frame.FIR.U
+    && a.frame.MsgID == b.frame.MsgID && a.frame.data.u64 == b.frame.data.u64;
+  }
+
+void test_canparse(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int lines = (argc > 0) ? atoi(argv[0]) : 1000000;
+  int rounds = (argc > 1) ? atoi(argv[1]) : 100000;
+  if (lines < 1) lines = 1;
+  if (rounds < 0) rounds = 0;
+
+  static const char* const formats[] = { "crtd", "gvret-a" };
+  static const char* const seeds[2][3] =
+    {
+      { "1524311386.811100 1R11 100 01 02 03", "1524311386.811200 2R29 1ABCDEF0 01 02 03 04 05 06 07 08",
+        "1524311386.9 1T11 7e8 ff" },
+      { "1000 - 100 S 0 4 01 02 03 04", "4294967295 - 1fffffff X 1 8 1 2 3 4 5 6 7 8", "7 - 7E8 S 0 1 ff" },
+    };
+  static const char alphabet[] = "0123456789abcdefABCDEFxX -+.RTSC129 \t";
+  int errors = 0;
+  uint32_t seed = 4711;
+
+  for (int f = 0; f < 2; f++)
+    {
+    canformat* fmt = MyCanFormatFactory.NewFormat(formats[f]);
+    if (!fmt)
+      continue;
+
+    // Benchmark: a 64 line trace fed in 512 byte pieces (like network input)
+    std::string chunk;
+    for (int k = 0; k < 64; k++)
+      {
+      chunk.append(seeds[f][k % 3]);
+      chunk.append((k & 7) ? "\n" : "\r\n");
+      }
+    int chunks = (lines + 63) / 64;
+
+    OvmsBuffer buf(CANFORMAT_SERVE_BUFFERSIZE);
+    int parsed_legacy = 0, parsed = 0;
+    int64_t started = esp_timer_get_time();
+    for (int c = 0; c < chunks; c++)
+      {
+      for (size_t pos = 0; pos < chunk.size(); )
+        {
+        size_t n = std::min(chunk.size() - pos, (size_t)512);
+        buf.Push((uint8_t*)chunk.data() + pos, n);
+        pos += n;
+        while (buf.HasLine() >= 0)
+          {
+          CAN_log_message_t msg;
+          memset(&msg, 0, sizeof(msg));
+          std::string line = buf.ReadLine();
+          if (f == 0)
+            test_canparse_crtd_legacy(line, &msg);
+          else
+            test_canparse_gvret_legacy(line, &msg);
+          if (msg.frame.MsgID) parsed_legacy++;
+          }
+        }
+      }
+    int64_t time_legacy = esp_timer_get_time() - started;
+
+    started = esp_timer_get_time();
+    for (int c = 0; c < chunks; c++)
+      {
+      for (size_t pos = 0; pos < chunk.size(); )
+        {
+        size_t end = std::min(chunk.size(), (pos & ~511) + 512);
+        CAN_log_message_t msg;
+        memset(&msg, 0, sizeof(msg));
+        bool hasmore = false;
+        size_t used = fmt->put(&msg, (uint8_t*)chunk.data() + pos, end - pos, &hasmore);
+        if (used == 0)
+          break;
+        pos += used;
+        if (msg.frame.MsgID) parsed++;
+        }
+      }
+    int64_t time_new = esp_timer_get_time() - started;
+
+    writer->printf("%-8s %d lines: std::string %lld lines/s, scanner %lld lines/s%s\n",
+      formats[f], chunks * 64,
+      test_rate((int64_t)chunks * 64, time_legacy),
+      test_rate((int64_t)chunks * 64, time_new),
+      (parsed != parsed_legacy) ? " ERROR: frame count differs" : "");
+    if (parsed != parsed_legacy)
+      errors++;
+
+    // Fuzz: mutated lines must parse exactly as before, also when split
+    //  across two inputs (partial line assembly)
+    int mismatches = 0;
+    for (int r = 0; r < rounds; r++)
+      {
+      seed = seed * 1103515245 + 12345;
+      std::string line = seeds[f][(seed >> 16) % 3];
+      int edits = (seed >> 8) % 6;
+      for (int e = 0; e < edits; e++)
+        {
+        seed = seed * 1103515245 + 12345;
+        size_t pos = (seed >> 8) % (line.size() + 1);
+        char ch = alphabet[(seed >> 20) % (sizeof(alphabet) - 1)];
+        switch ((seed >> 28) & 3)
+          {
+          case 0: if (pos < line.size()) line[pos] = ch; break;
+          case 1: line.insert(pos, 1, ch); break;
+          case 2: if (pos < line.size()) line.erase(pos, 1); break;
+          default: if ((seed & 3) == 0) line.resize(pos); break;
+          }
+        }
+
+      CAN_log_message_t want, got;
+      memset(&want, 0, sizeof(want));
+      memset(&got, 0, sizeof(got));
+      if (f == 0)
+        test_canparse_crtd_legacy(line, &want);
+      else
+        test_canparse_gvret_legacy(line, &want);
+
+      std::string input = line + "\n";
+      size_t split = (seed & 4) ? (seed >> 4) % input.size() : 0;
+      bool hasmore = false;
+      if (split)
+        fmt->put(&got, (uint8_t*)input.data(), split, &hasmore);
+      fmt->put(&got, (uint8_t*)input.data() + split, input.size() - split, &hasmore);
+
+      if (!test_canparse_equal(want, got) && mismatches++ < 5)
+        writer->printf("ERROR: %s mismatch on '%s'\n", formats[f], line.c_str());
+      }
+    if (rounds)
+      writer->printf("%-8s fuzz: %d lines, %d mismatches\n", formats[f], rounds, mismatches);
+    errors += mismatches;
+    delete fmt;
+    }
+
+  if (errors)
+    writer->printf("ERROR: %d failures\n", errors);
+  else
+    writer->puts("OK: parsers equivalent");
+  }
+
+void test_config(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int loops = (argc > 0) ? atoi(argv[0]) : 100000;
+  if (loops < 1) loops = 1;
+
+  ConfigHandle<float> cfg_float("vehicle", "bms.dev.voltage.maxgrad", 0.010);
+  ConfigHandle<int> cfg_int("server.v2", "timeout.rx", 960);
+  ConfigHandle<bool> cfg_bool("vehicle", "can.autooff", true);
+
+  int64_t started, elapsed;
+  float sum_direct = 0, sum_handle = 0;
+
+  started = esp_timer_get_time();
+  for (int k = 0; k < loops; k++)
+    {
+    sum_direct += MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.maxgrad", 0.010);
+    sum_direct += MyConfig.GetParamValueInt("server.v2", "timeout.rx", 960);
+    sum_direct += MyConfig.GetParamValueBool("vehicle", "can.autooff", true);
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "GetParamValue", loops*3, "reads", elapsed);
+
+  started = esp_timer_get_time();
+  for (int k = 0; k < loops; k++)
+    {
+    sum_handle += cfg_float.Get();
+    sum_handle += cfg_int.Get();
+    sum_handle += cfg_bool.Get();
+    }
+  elapsed = esp_timer_get_time() - started;
+  test_report_rate(writer, "ConfigHandle", loops*3, "reads", elapsed);
+
+  if (sum_direct != sum_handle)
+    writer->printf("ERROR: results differ: %f / %f\n", sum_direct, sum_handle);
+  else
+    writer->puts("OK: results match");
+  }
+
+void test_bmsstats(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int loops = (argc > 0) ? atoi(argv[0]) : 1000;
+  if (loops < 1) loops = 1;
+
+  static const int packs[] = { 96, 108, 192, 288 };
+  bool ok = true;
+
+  for (int cells : packs)
+    {
+    float* values = new float[cells];
+    for (int i = 0; i < cells; i++)
+      values[i] = 3.7f + (esp_random() % 5000) / 100000.0f + i * 0.00001f;
+
+    // Reference: former double precision two pass calculation
+    int64_t started = esp_timer_get_time();
+    double avg = 0, stddev = 0, grad = 0;
+    for (int k = 0; k < loops; k++)
+      {
+      double sum = 0, sqrsum = 0;
+      for (int i = 0; i < cells; i++)
+        {
+        sum += values[i];
+        sqrsum += SQR(values[i]);
+        }
+      avg = sum / cells;
+      stddev = sqrt(LIMIT_MIN((sqrsum / cells) - SQR(avg), 0));
+      double sumn = 0, sumd = 0, centre = (cells - 1) / 2.0;
+      for (int i = 0; i < cells; i++)
+        {
+        sumn += (i - centre) * (values[i] - avg);
+        sumd += SQR(i - centre);
+        }
+      grad = (sumn / sumd) * cells;
+      }
+    int64_t elapsed_ref = esp_timer_get_time() - started;
+
+    // Single pass float:
+    BmsCellStats batch;
+    batch.SetCount(cells);
+    started = esp_timer_get_time();
+    for (int k = 0; k < loops; k++)
+      batch.Compute(values);
+    int64_t elapsed_batch = esp_timer_get_time() - started;
+
+    // Incremental per cell:
+    BmsCellStats incr;
+    incr.SetCount(cells);
+    started = esp_timer_get_time();
+    for (int k = 0; k < loops; k++)
+      {
+      incr.Reset();
+      for (int i = 0; i < cells; i++)
+        incr.Add(i, values[i]);
+      }
+    int64_t elapsed_incr = esp_timer_get_time() - started;
+
+    writer->printf("%3d cells: double %lld us, batch %lld us, incremental %lld us per %d series\n",
+      cells, elapsed_ref, elapsed_batch, elapsed_incr, loops);
+
+    const BmsCellStats* res[2] = { &batch, &incr };
+    for (int r = 0; r < 2; r++)
+      {
+      if (!res[r]->IsComplete() ||
+          fabs(res[r]->Mean() - avg) > 1e-5 ||
+          fabs(res[r]->StdDev() - stddev) > 1e-5 ||
+          fabs(res[r]->Gradient() - grad) > 1e-4)
+        {
+        writer->printf("ERROR: %s result mismatch: avg %f/%f stddev %f/%f grad %f/%f\n",
+          r ? "incremental" : "batch", res[r]->Mean(), avg, res[r]->StdDev(), stddev,
+          res[r]->Gradient(), grad);
+        ok = false;
+        }
+      }
+
+    delete[] values;
+    }
+
+  if (ok)
+    writer->puts("OK: results match");
+  }
+
+void test_bmshistory(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int size = (argc > 0) ? atoi(argv[0]) : 256;
+  if (size < 1) size = 1;
+
+  // Synthetic week at 1 record per minute: 192 cells, 16 temperature sensors,
+  // daily charge/discharge cycle, fixed cell offsets, ±1 mV noise
+  const int vcnt = 192, tcnt = 16, samples = 7 * 24 * 60;
+  BmsHistory hist;
+  if (!hist.SetCapacity(size * 1024))
+    {
+    writer->puts("ERROR: can't allocate history buffer (PSRAM required)");
+    return;
+    }
+
+  float volt[vcnt], temp[tcnt], offset[vcnt];
+  for (int i = 0; i < vcnt; i++)
+    offset[i] = ((int)(esp_random() % 21) - 10) / 1000.0f;
+
+  BmsHistoryCursor follower;
+  BmsHistorySample sample;
+  int errors = 0;
+  int64_t elapsed_add = 0, elapsed_read = 0, started;
+
+  for (int n = 0; n < samples; n++)
+    {
+    float phase = (n % 1440) / 1440.0f;
+    float pack = 3.6f + 0.5f * fabsf(2 * phase - 1);
+    for (int i = 0; i < vcnt; i++)
+      volt[i] = pack + offset[i] + ((int)(esp_random() % 3) - 1) / 1000.0f;
+    for (int i = 0; i < tcnt; i++)
+      temp[i] = 20.0f + 8.0f * phase + (i % 4) * 0.5f;
+
+    started = esp_timer_get_time();
+    bool added = hist.Add(n * 60, vcnt, volt, tcnt, temp);
+    elapsed_add += esp_timer_get_time() - started;
+
+    started = esp_timer_get_time();
+    bool read = added && hist.Read(follower, sample);
+    elapsed_read += esp_timer_get_time() - started;
+
+    if (!read || sample.time != (uint32_t)(n * 60) ||
+        sample.voltages.size() != vcnt || sample.temperatures.size() != tcnt)
+      {
+      if (errors++ < 5)
+        writer->printf("ERROR: record %d not read back\n", n);
+      continue;
+      }
+    for (int i = 0; i < vcnt; i++)
+      {
+      if (fabsf(sample.voltages[i] - volt[i]) > 0.0006f)
+        {
+        if (errors++ < 5)
+          writer->printf("ERROR: record %d voltage %d: %.4f != %.4f\n", n, i, sample.voltages[i], volt[i]);
+        break;
+        }
+      }
+    for (int i = 0; i < tcnt; i++)
+      {
+      if (fabsf(sample.temperatures[i] - temp[i]) > 0.06f)
+        {
+        if (errors++ < 5)
+          writer->printf("ERROR: record %d temperature %d: %.2f != %.2f\n", n, i, sample.temperatures[i], temp[i]);
+        break;
+        }
+      }
+    }
+
+  // Read back the retained history:
+  BmsHistoryCursor cursor;
+  int retained = 0;
+  started = esp_timer_get_time();
+  while (hist.Read(cursor, sample))
+    retained++;
+  int64_t elapsed_scan = esp_timer_get_time() - started;
+
+  float bps = (float) hist.GetTotalBytes() / hist.GetTotalRecords();
+  writer->printf("Encoded %d samples of %d cells + %d temperatures: %.1f bytes/sample (raw float: %d bytes, %.1f%%)\n",
+    samples, vcnt, tcnt, bps, (int)((vcnt + tcnt) * sizeof(float)), bps * 100 / ((vcnt + tcnt) * sizeof(float)));
+  writer->printf("Add: %lld us/sample, follower read: %lld us/sample\n",
+    elapsed_add / samples, elapsed_read / samples);
+  writer->printf("Buffer %d kB holds %" PRIu32 " records = %.1f hours, %d readable from key frame (scan %lld us)\n",
+    size, hist.GetCount(), hist.GetCount() / 60.0f, retained, elapsed_scan);
+
+  if (errors)
+    writer->printf("ERROR: %d mismatches\n", errors);
+  else
+    writer->puts("OK: all samples decoded correctly");
+  }
+
+struct test_logring_producer_t
+  {
+  LogRing* ring;                // NULL = legacy LogBuffers path
+  QueueHandle_t queue;          // legacy: LogBuffers* to reader
+  int id;
+  int lines;
+  volatile bool* start;
+  volatile bool done;
+  };
+
+static void test_logring_write(test_logring_producer_t* p, const char* fmt, ...)
+  {
+  va_list args;
+  va_start(args, fmt);
+  if (p->ring)
+    {
+    p->ring->Write(esp_log_timestamp(), NULL, fmt, args);
+    }
+  else
+    {
+    LogBuffers* lb = new LogBuffers;
+    lb->append(fmt, args);
+    lb->set(1);
+    if (xQueueSend(p->queue, &lb, portMAX_DELAY) != pdTRUE)
+      lb->release();
+    }
+  va_end(args);
+  }
+
+static void test_logring_producer(void* arg)
+  {
+  test_logring_producer_t* p = (test_logring_producer_t*) arg;
+  while (!*p->start)
+    vTaskDelay(1);
+  for (int i = 0; i < p->lines; i++)
+    test_logring_write(p, "\033[0;32mD (%" PRIu32 ") xtb: producer %d line %d value=%d\033[0m\n",
+      esp_log_timestamp(), p->id, i, i * 7);
+  p->done = true;
+  vTaskDelete(NULL);
+  }
+
+static void test_logring_run(OvmsWriter* writer, bool legacy, int tasks, int lines)
+  {
+  LogRing ring;
+  if (!legacy && !ring.Init(64*1024, 1024))
+    {
+    writer->puts("ERROR: can't allocate log ring");
+    return;
+    }
+  QueueHandle_t queue = legacy ? xQueueCreate(64, sizeof(LogBuffers*)) : NULL;
+  volatile bool start = false;
+  std::vector<test_logring_producer_t> prod(tasks);
+  for (int k = 0; k < tasks; k++)
+    {
+    prod[k].ring = legacy ? NULL : &ring;
+    prod[k].queue = queue;
+    prod[k].id = k;
+    prod[k].lines = lines;
+    prod[k].start = &start;
+    prod[k].done = false;
+    xTaskCreatePinnedToCore(test_logring_producer, "xtb.logring", 3*1024, &prod[k], 5, NULL, CORE(k & 1));
+    }
+
+  LogRingCursor cursor;
+  ring.Attach(cursor);
+  std::string line;
+  line.reserve(LOGRING_MAXLINE);
+  std::vector<int> last(tasks, -1);
+  int read = 0, errors = 0, gaps = 0;
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  size_t blocks_base = info.allocated_blocks, blocks_max = blocks_base;
+
+  int64_t started = esp_timer_get_time();
+  start = true;
+  for (;;)
+    {
+    bool got;
+    if (legacy)
+      {
+      LogBuffers* lb;
+      got = (xQueueReceive(queue, &lb, 0) == pdTRUE);
+      if (got)
+        {
+        line = stripesc(lb->front());
+        lb->release();
+        }
+      }
+    else
+      {
+      got = ring.Read(cursor, line);
+      if (got)
+        line.resize(stripesc(&line[0], line.size()));
+      }
+    if (!got || (read & 255) == 0)
+      {
+      heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+      if (info.allocated_blocks > blocks_max)
+        blocks_max = info.allocated_blocks;
+      }
+    if (!got)
+      {
+      bool done = true;
+      for (int k = 0; k < tasks; k++)
+        done = done && prod[k].done;
+      if (done && (legacy ? uxQueueMessagesWaiting(queue) == 0 : ring.GetNextSeq() == cursor.seq))
+        break;
+      vTaskDelay(1);
+      continue;
+      }
+    read++;
+    int id, no;
+    const char* s = strstr(line.c_str(), "producer ");
+    if (!s || sscanf(s, "producer %d line %d", &id, &no) != 2 || id < 0 || id >= tasks
+        || no <= last[id] || line.back() != '\n' || line.find('\033') != std::string::npos)
+      {
+      if (errors++ < 5)
+        writer->printf("ERROR: bad line: %s", line.c_str());
+      continue;
+      }
+    gaps += no - last[id] - 1;
+    last[id] = no;
+    }
+  int64_t elapsed = esp_timer_get_time() - started;
+
+  for (int k = 0; k < tasks; k++)
+    gaps += lines - 1 - last[k];
+  if (!legacy && gaps != (int)cursor.lost)
+    {
+    errors++;
+    writer->printf("ERROR: %d lines missing, %" PRIu32 " reported lost\n", gaps, cursor.lost);
+    }
+
+  writer->printf("%-10s %d tasks: %d lines in %lld us = %lld lines/s, %d read, %d lost, heap blocks +%d peak\n",
+    legacy ? "LogBuffers" : "LogRing", tasks, tasks * lines, elapsed,
+    test_rate((int64_t)tasks * lines, elapsed), read, gaps,
+    (int)(blocks_max - blocks_base));
+  if (errors)
+    writer->printf("ERROR: %d invalid lines\n", errors);
+  if (queue)
+    vQueueDelete(queue);
+  }
+
+void test_logring(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int tasks = (argc > 0) ? atoi(argv[0]) : 4;
+  int lines = (argc > 1) ? atoi(argv[1]) : 5000;
+  if (tasks < 1) tasks = 1;
+  if (tasks > 8) tasks = 8;
+  if (lines < 1) lines = 1;
+
+  // Legacy path: one LogBuffers + vasprintf() per line, std::string for stripesc()
+  test_logring_run(writer, true, tasks, lines);
+  // Log ring: formatted in place, read at cursor, lines may get lost on overrun
+  test_logring_run(writer, false, tasks, lines);
+  }
+
+struct test_canring_consumer_t
+  {
+  CanRingReader* reader;        // NULL = legacy listener queue
+  QueueHandle_t queue;
+  uint32_t received;
+  uint32_t errors;
+  uint32_t checksum;
+  volatile bool stop;
+  volatile bool done;
+  };
+
+static void test_canring_consumer(void* arg)
+  {
+  test_canring_consumer_t* c = (test_canring_consumer_t*) arg;
+  CAN_frame_t frame;
+  uint32_t last = 0;
+  for (;;)
+    {
+    bool got;
+    if (c->reader)
+      got = c->reader->Read(&frame, pdMS_TO_TICKS(10));
+    else
+      got = (xQueueReceive(c->queue, &frame, pdMS_TO_TICKS(10)) == pdTRUE);
+    if (!got)
+      {
+      if (c->stop)
+        break;
+      continue;
+      }
+    uint32_t no;
+    memcpy(&no, frame.data.u8, sizeof(no));
+    if (c->received && no <= last)
+      c->errors++;
+    last = no;
+    c->received++;
+    for (int i = 0; i < frame.FIR.B.DLC; i++)
+      c->checksum += frame.data.u8[i];
+    }
+  c->done = true;
+  vTaskDelete(NULL);
+  }
+
+static void test_canring_run(OvmsWriter* writer, bool legacy, int consumers, int frames)
+  {
+  CanRing ring;
+  if (!legacy && !ring.Init(CONFIG_OVMS_HW_CAN_RING_SIZE))
+    {
+    writer->puts("ERROR: can't allocate frame ring");
+    return;
+    }
+  std::vector<test_canring_consumer_t> cons(consumers);
+  for (int k = 0; k < consumers; k++)
+    {
+    cons[k].reader = legacy ? NULL : new CanRingReader("xtb.canring", false, &ring);
+    cons[k].queue = legacy ? xQueueCreate(CONFIG_OVMS_VEHICLE_CAN_RX_QUEUE_SIZE, sizeof(CAN_frame_t)) : NULL;
+    cons[k].received = cons[k].errors = cons[k].checksum = 0;
+    cons[k].stop = cons[k].done = false;
+    xTaskCreatePinnedToCore(test_canring_consumer, "xtb.canring", 3*1024, &cons[k], 5, NULL, CORE(k & 1));
+    }
+
+  CAN_frame_t frame = {};
+  frame.FIR.B.DLC = 8;
+  frame.MsgID = 0x7e8;
+  uint32_t drops = 0;
+  int64_t started = esp_timer_get_time();
+  for (int i = 0; i < frames; i++)
+    {
+    uint32_t no = i;
+    memcpy(frame.data.u8, &no, sizeof(no));
+    frame.data.u8[4] = i * 7;
+    if (legacy)
+      {
+      // as can::NotifyListeners() did: one copy per listener queue
+      for (int k = 0; k < consumers; k++)
+        if (xQueueSend(cons[k].queue, &frame, 0) != pdTRUE)
+          drops++;
+      }
+    else
+      ring.Write(&frame, false);
+    if ((i & 63) == 63)
+      taskYIELD();
+    }
+
+  // wait for consumers to catch up:
+  for (int k = 0; k < consumers; k++)
+    {
+    while (legacy ? uxQueueMessagesWaiting(cons[k].queue) > 0 : cons[k].reader->GetBacklog() > 0)
+      vTaskDelay(1);
+    }
+  int64_t elapsed = esp_timer_get_time() - started;
+  for (int k = 0; k < consumers; k++)
+    cons[k].stop = true;
+  for (int k = 0; k < consumers; k++)
+    {
+    while (!cons[k].done)
+      vTaskDelay(1);
+    }
+
+  uint32_t errors = 0, lost = 0;
+  writer->printf("%-10s %d consumers: %d frames in %lld us = %lld frames/s\n",
+    legacy ? "Queues" : "CanRing", consumers, frames, elapsed,
+    test_rate(frames, elapsed));
+  for (int k = 0; k < consumers; k++)
+    {
+    uint32_t missing = frames - cons[k].received;
+    errors += cons[k].errors;
+    if (!legacy && missing != cons[k].reader->GetLostCount())
+      {
+      errors++;
+      writer->printf("ERROR: consumer %d: %" PRIu32 " frames missing, %" PRIu32 " reported lost\n",
+        k, missing, cons[k].reader->GetLostCount());
+      }
+    lost += missing;
+    writer->printf("  consumer %d: %" PRIu32 " received, %" PRIu32 " lost\n", k, cons[k].received, missing);
+    if (cons[k].reader)
+      delete cons[k].reader;
+    if (cons[k].queue)
+      vQueueDelete(cons[k].queue);
+    }
+  if (legacy)
+    writer->printf("  %" PRIu32 " queue sends dropped\n", drops);
+  if (errors)
+    writer->printf("ERROR: %" PRIu32 " frames out of order / miscounted\n", errors);
+  }
+
+void test_canring(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int consumers = (argc > 0) ? atoi(argv[0]) : 4;
+  int frames = (argc > 1) ? atoi(argv[1]) : 20000;
+  if (consumers < 1) consumers = 1;
+  if (consumers > CANRING_MAXREADERS) consumers = CANRING_MAXREADERS;
+  if (frames < 1) frames = 1;
+
+  // Legacy path: frame copied into every listener queue, full queues drop
+  test_canring_run(writer, true, consumers, frames);
+  // Frame ring: frame stored once, read at each consumer's cursor
+  test_canring_run(writer, false, consumers, frames);
+  }
+
+class test_logbinary_writer : public OvmsWriter
+  {
+  public:
+    ssize_t write(const void *buf, size_t nbyte)
+      {
+      m_bytes += nbyte;
+      m_hash = (m_hash ^ nbyte) * 16777619u;
+      for (size_t i = 0; i < nbyte; i++)
+        m_hash = (m_hash ^ ((const uint8_t*)buf)[i]) * 16777619u;
+      return nbyte;
+      }
+  public:
+    size_t m_bytes = 0;
+    uint32_t m_hash = 2166136261u;
+  };
+
+void test_logbinary(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int lines = (argc > 0) ? atoi(argv[0]) : 20000;
+  std::string dir = (argc > 1) ? argv[1] : "/sd";
+  if (lines < 1) lines = 1;
+  std::string txtpath = dir + "/logbintest.txt";
+  std::string binpath = dir + "/logbintest.bin";
+  static const char* const tags[] = { "ovms-server-v2", "v-twizy", "vehicle-poll", "webserver",
+    "events", "canlog", "modem", "gps", "housekeeping", "metrics", "netmanager", "xtb" };
+  static const char levels[] = "EWIDVIIDDV";
+
+  // Generate synthetic text log:
+  FILE* txt = fopen(txtpath.c_str(), "w");
+  if (!txt)
+    {
+    writer->printf("ERROR: cannot create %s\n", txtpath.c_str());
+    return;
+    }
+  int64_t t0 = (int64_t)time(NULL) * 1000 - (int64_t)lines * 450;
+  int64_t t = t0;
+  uint32_t stamp = 100000;
+  LogRecord rec;
+  std::string line;
+  char msg[128];
+  for (int i = 0; i < lines; i++)
+    {
+    uint32_t delta = 1 + esp_random() % 900;
+    t += delta;
+    stamp += delta;
+    rec.time = t;
+    rec.stamp = stamp;
+    rec.lineend = true;
+    if (i % 97 == 5)
+      {
+      rec.level = 0;
+      rec.msglen = snprintf(msg, sizeof(msg), "unformatted line %d", i);
+      }
+    else
+      {
+      rec.level = levels[esp_random() % 10];
+      rec.tag = tags[esp_random() % 12];
+      rec.taglen = strlen(rec.tag);
+      rec.msglen = snprintf(msg, sizeof(msg), "message %d value=%" PRIu32 " state %s",
+        i, esp_random() % 1000, (i & 1) ? "on" : "off");
+      }
+    rec.msg = msg;
+    LogFormatLine(line, rec);
+    fwrite(line.data(), 1, line.size(), txt);
+    }
+  fclose(txt);
+
+  // Convert to binary:
+  int64_t started = esp_timer_get_time();
+  txt = fopen(txtpath.c_str(), "r");
+  FILE* bin = fopen(binpath.c_str(), "w");
+  char* buf = (char*) ExternalRamMalloc(LOGBIN_MAXMSG);
+  if (!txt || !bin || !buf)
+    {
+    writer->puts("ERROR: cannot open test files");
+    if (txt) fclose(txt);
+    if (bin) fclose(bin);
+    if (buf) free(buf);
+    return;
+    }
+  LogBinaryWriter binwriter;
+  LogTimeCache cache;
+  size_t txtsize = 0, binsize = binwriter.Open(bin, 0);
+  rec = LogRecord();
+  while (fgets(buf, LOGBIN_MAXMSG, txt))
+    {
+    size_t len = strlen(buf);
+    txtsize += len;
+    LogParseTextLine(buf, len, rec, cache);
+    binsize += binwriter.Write(rec);
+    }
+  binwriter.Close();
+  fclose(bin);
+  int64_t elapsed = esp_timer_get_time() - started;
+  writer->printf("Convert: %d lines, text %u bytes, binary %u bytes (%u%%), %" PRId64 " ms\n",
+    lines, (unsigned)txtsize, (unsigned)binsize, (unsigned)(binsize * 100 / (txtsize ? txtsize : 1)),
+    elapsed / 1000);
+
+  // Verify round trip:
+  LogBinaryReader reader;
+  int count = 0, errors = 0;
+  if (reader.Open(binpath.c_str()))
+    {
+    rewind(txt);
+    while (reader.Read(rec))
+      {
+      LogFormatLine(line, rec);
+      if (!fgets(buf, LOGBIN_MAXMSG, txt) || line != buf)
+        errors++;
+      count++;
+      }
+    if (fgets(buf, LOGBIN_MAXMSG, txt))
+      errors++;
+    writer->printf("Verify: %d records in %" PRIu32 " blocks, %d mismatches\n",
+      count, reader.GetBlockCount(), errors);
+    reader.Close();
+    }
+  else
+    {
+    writer->puts("ERROR: cannot read binary file");
+    }
+  fclose(txt);
+  free(buf);
+
+  // Range queries, text scan vs. binary index:
+  for (int k = 0; k < 4; k++)
+    {
+    LogQuery qtxt;
+    qtxt.from = t0 + (t - t0) * (k * 2 + 1) / 9;
+    qtxt.to = qtxt.from + 5 * 60 * 1000;
+    qtxt.tag = (k == 1) ? "v-*" : (k == 2) ? "xtb" : "";
+    qtxt.level = (k == 3) ? 2 : 5;
+    LogQuery qbin = qtxt;
+    test_logbinary_writer otxt, obin;
+    int64_t t1 = esp_timer_get_time();
+    LogSearch(&otxt, txtpath.c_str(), qtxt);
+    int64_t t2 = esp_timer_get_time();
+    LogSearch(&obin, binpath.c_str(), qbin);
+    int64_t t3 = esp_timer_get_time();
+    writer->printf("Query %d: text %" PRIu32 " lines (%" PRIu32 " scanned) %" PRId64 " ms,"
+      " binary %" PRIu32 " lines (%" PRIu32 " scanned) %" PRId64 " ms, %s\n",
+      k, qtxt.lines, qtxt.scanned, (t2 - t1) / 1000, qbin.lines, qbin.scanned, (t3 - t2) / 1000,
+      (otxt.m_bytes == obin.m_bytes && otxt.m_hash == obin.m_hash) ? "equal" : "DIFFERENT");
+    }
+
+  unlink(txtpath.c_str());
+  unlink(binpath.c_str());
+  }
+#endif // #ifdef CONFIG_OVMS_DEV_TESTBENCH
+
+#if defined(CONFIG_OVMS_DEV_TESTBENCH) && defined(CONFIG_OVMS_COMP_CELLULAR)
+// GSM 07.10 FCS (reversed CRC-8, polynomial 0x07) over the frame header:
+static uint8_t test_gsmmux_fcs(const uint8_t* data, size_t len)
+  {
+  uint8_t fcs = 0xFF;
+  while (len--)
+    {
+    fcs ^= *data++;
+    for (int k = 0; k < 8; k++)
+      fcs = (fcs & 1) ? (fcs >> 1) ^ 0xE0 : (fcs >> 1);
+    }
+  return 0xFF - fcs;
+  }
+
+// Stub modem: checks the payload stream of each channel against the sample.
+//  PPP data (channel 2) is taken directly from the frame, except every 16th
+//  offer, which falls back to the channel buffer as in the modem's non-PPP
+//  states.
+class test_gsmmux_sink : public GsmMuxReceiver
+  {
+  public:
+    std::string m_expect[5];
+    size_t m_pos[5] = {};
+    uint64_t m_total[5] = {};
+    uint64_t m_direct = 0, m_buffered = 0;
+    uint32_t m_offers = 0, m_errors = 0;
+
+  public:
+    void Check(int channel, const uint8_t* data, size_t len)
+      {
+      const std::string& expect = m_expect[channel];
+      m_total[channel] += len;
+      if (expect.empty())
+        {
+        m_errors++;
+        return;
+        }
+      while (len > 0)
+        {
+        size_t n = std::min(len, expect.size() - m_pos[channel]);
+        if (memcmp(data, expect.data() + m_pos[channel], n) != 0)
+          m_errors++;
+        data += n;
+        len -= n;
+        m_pos[channel] = (m_pos[channel] + n) % expect.size();
+        }
+      }
+    void IncomingMuxData(GsmMuxChannel* channel)
+      {
+      uint8_t* data;
+      size_t n;
+      while ((n = channel->m_buffer.ReadSpan(&data)) > 0)
+        {
+        Check(channel->m_channel, data, n);
+        m_buffered += n;
+        channel->m_buffer.Consume(n);
+        }
+      }
+    bool IncomingMuxData(GsmMuxChannel* channel, uint8_t* data, size_t len)
+      {
+      if (channel->m_channel != 2 || (++m_offers % 16) == 0)
+        return false;
+      Check(channel->m_channel, data, len);
+      m_direct += len;
+      return true;
+      }
+  };
+
+void test_gsmmux(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  int kbytes = (argc > 0) ? atoi(argv[0]) : 4096;
+  if (kbytes < 1) kbytes = 1;
+
+  // Build a traffic sample like an LTE modem during a download:
+  //  full size PPP frames on DLCI 2, some AT/NMEA frames, noise between frames.
+  test_gsmmux_sink sink;
+  std::string traffic;
+  int frames = 0;
+  uint32_t seed = 4711;
+  while (traffic.size() < 32*1024)
+    {
+    seed = seed * 1103515245 + 12345;
+    int channel = ((seed >> 16) % 8) ? 2 : 1 + (seed >> 20) % 4;
+    size_t len = (channel == 2) ? 1500 - (seed >> 8) % 64 : 10 + (seed >> 8) % 100;
+    uint8_t hdr[5] = { 0xF9, (uint8_t)((channel << 2) + 1), 0xEF, 0, 0 };
+    size_t ipos;
+    if (len < 128)
+      {
+      hdr[3] = (len << 1) + 1;
+      ipos = 4;
+      }
+    else
+      {
+      hdr[3] = (len % 128) << 1;
+      hdr[4] = len / 128;
+      ipos = 5;
+      }
+    traffic.append((const char*)hdr, ipos);
+    for (size_t k = 0; k < len; k++)
+      {
+      traffic.push_back((char)(seed >> (k % 24)));
+      sink.m_expect[channel].push_back(traffic.back());
+      }
+    traffic.push_back((char)test_gsmmux_fcs(hdr + 1, ipos - 1));
+    traffic.push_back((char)0xF9);
+    if ((seed & 0x1f) == 0)
+      traffic.append("\r\n+noise\r\n");
+    frames++;
+    }
+
+  GsmMux mux(NULL, 4);
+  mux.m_receiver = &sink;
+  for (int k = 0; k <= 4; k++)
+    {
+    GsmMuxChannel* chan = new GsmMuxChannel(&mux, k, CONFIG_OVMS_HW_CELLULAR_MODEM_MUXCHANNEL_SIZE);
+    if (k > 0) chan->m_state = GsmMuxChannel::ChanOpen;
+    mux.m_channels.push_back(chan);
+    }
+  OvmsBuffer buf(CONFIG_OVMS_HW_CELLULAR_MODEM_BUFFER_SIZE);
+
+  // Feed the sample like the UART task does, in varying read sizes:
+  size_t total = (size_t)kbytes * 1024;
+  size_t done = 0;
+  int rounds = 0;
+  int64_t started = esp_timer_get_time();
+  while (done < total)
+    {
+    for (size_t pos = 0; pos < traffic.size(); )
+      {
+      seed = seed * 1103515245 + 12345;
+      size_t n = std::min(traffic.size() - pos, (size_t)(1 + (seed >> 16) % 512));
+      n = std::min(n, buf.FreeSpace());
+      buf.Push((uint8_t*)traffic.data() + pos, n);
+      pos += n;
+      mux.Process(&buf);
+      }
+    done += traffic.size();
+    rounds++;
+    }
+  int64_t elapsed = esp_timer_get_time() - started;
+
+  writer->printf("%u bytes, %d frames in %" PRId64 " us: %.2f MB/s\n",
+    (unsigned)done, frames * rounds, elapsed,
+    elapsed ? (double)done / elapsed : 0.0);
+  writer->printf("Payload: %" PRIu64 " bytes direct, %" PRIu64 " bytes via channel buffers\n",
+    sink.m_direct, sink.m_buffered);
+
+  int errors = 0;
+  if (mux.m_rxframecount != (uint32_t)(frames * rounds) || mux.m_framingerrors != 0)
+    {
+    writer->printf("ERROR: %" PRIu32 " frames received, %" PRIu32 " framing errors\n",
+      mux.m_rxframecount, mux.m_framingerrors);
+    errors++;
+    }
+  for (int k = 1; k <= 4; k++)
+    {
+    uint64_t expect = (uint64_t)sink.m_expect[k].size() * rounds;
+    if (sink.m_total[k] != expect)
+      {
+      writer->printf("ERROR: channel %d: %" PRIu64 " payload bytes delivered, expected %" PRIu64 "\n",
+        k, sink.m_total[k], expect);
+      errors++;
+      }
+    }
+  if (sink.m_errors)
+    {
+    writer->printf("ERROR: %" PRIu32 " payload mismatches\n", sink.m_errors);
+    errors++;
+    }
+  if (sink.m_direct == 0 || sink.m_buffered == 0)
+    {
+    writer->puts("ERROR: direct or buffered delivery not exercised");
+    errors++;
+    }
+  if (!errors)
+    writer->puts("OK: all frames received, payload delivered in order");
+  }
+#endif // #if defined(CONFIG_OVMS_DEV_TESTBENCH) && defined(CONFIG_OVMS_COMP_CELLULAR)
+
 void test_command(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   MyCommandApp.Display(writer);
@@ -413,4 +2251,29 @@ TestFrameworkInit::TestFrameworkInit()
   cmd_test->RegisterCommand("string", "Test std::string memory corruption", test_string, "<loopcnt> <mode>\n"
     "mode: 1=m.AsJSON, 2=m.AsString, 3=m.name, 4=const cfg string, 5=const local cstr, 6=const local string", 2, 2);
   cmd_test->RegisterCommand("commands", "List command tree", test_command);
+#ifdef CONFIG_OVMS_DEV_TESTBENCH
+  cmd_test->RegisterCommand("metrics", "Test metrics lookup performance", test_metrics, "[<loops>] [<extra>]\n"
+    "loops: number of lookup rounds over all metrics (default 10)\n"
+    "extra: number of synthetic metrics to add during the test (default 300)", 0, 2);
+  cmd_test->RegisterCommand("metricnotify", "Test metrics change notification performance", test_metricnotify, "[<count>]", 0, 1);
+  cmd_test->RegisterCommand("dbcdecode", "Test DBC decode plan correctness and performance", test_dbcdecode, "[<loops>] [<crtdfile>]\n"
+    "loops: number of decode rounds over the trace (default 1000)\n"
+    "crtdfile: CRTD trace to decode instead of the built in one", 0, 2);
+  cmd_test->RegisterCommand("canfilter", "Test CAN filter equivalence and performance", test_canfilter, "[<rounds>]", 0, 1);
+  cmd_test->RegisterCommand("canidmap", "Test CAN ID dispatch lookup performance", test_canidmap, "[<frames>]", 0, 1);
+  cmd_test->RegisterCommand("canstamp", "Test CAN frame timestamp propagation to log formats", test_canstamp);
+  cmd_test->RegisterCommand("canparse", "Test CAN log text parser performance and equivalence", test_canparse, "[<lines>] [<fuzzrounds>]", 0, 2);
+  cmd_test->RegisterCommand("config", "Test config read performance", test_config, "[<loops>]", 0, 1);
+  cmd_test->RegisterCommand("canformat", "Test CAN log formatting performance", test_canformat, "[<frames>]", 0, 1);
+  cmd_test->RegisterCommand("bmsstats", "Test BMS cell statistics performance", test_bmsstats, "[<loops>]", 0, 1);
+  cmd_test->RegisterCommand("bmshistory", "Test BMS cell history encoding", test_bmshistory, "[<kB>]", 0, 1);
+  cmd_test->RegisterCommand("logring", "Test log ring throughput and allocations", test_logring, "[<tasks>] [<lines>]", 0, 2);
+  cmd_test->RegisterCommand("canring", "Test CAN frame ring fan-out throughput", test_canring, "[<consumers>] [<frames>]", 0, 2);
+  cmd_test->RegisterCommand("logbinary", "Test binary log round trip and range queries", test_logbinary, "[<lines>] [<dir>]\n"
+    "lines: number of synthetic log lines (default 20000)\n"
+    "dir: directory for the test files (default /sd)", 0, 2);
+#ifdef CONFIG_OVMS_COMP_CELLULAR
+  cmd_test->RegisterCommand("gsmmux", "Test GSM mux framing throughput & payload delivery", test_gsmmux, "[<kB>]", 0, 1);
+#endif // #ifdef CONFIG_OVMS_COMP_CELLULAR
+#endif // #ifdef CONFIG_OVMS_DEV_TESTBENCH
   }